@@ -92,7 +92,8 @@ void Align::align_with_ais(bool ais_crop_flag) {
 #endif
     SaveFile saveFile(m_savingMode, m_minLum, m_maxLum, deflateCompression);
     futureWatcher.setFuture(
-        QtConcurrent::map(m_data.begin(), m_data.end(), saveFile));
+        QtConcurrent::map(m_data.begin(), m_data.end(),
+                          withThreadShare(saveFile, m_data.size())));
     futureWatcher.waitForFinished();
 
     if (futureWatcher.isCanceled()) return;
@@ -157,7 +158,8 @@ void Align::ais_finished(int exitcode, QProcess::ExitStatus exitstatus) {
         connect(&m_futureWatcher, &QFutureWatcherBase::finished, this,
                 &Align::alignedFilesLoaded, Qt::DirectConnection);
         m_futureWatcher.setFuture(
-            QtConcurrent::map(m_data.begin(), m_data.end(), LoadFile()));
+            QtConcurrent::map(m_data.begin(), m_data.end(),
+                              withThreadShare(LoadFile(), m_data.size())));
     } else {
         qDebug() << "align_image_stack exited with exit code " << exitcode;
         removeTempFiles();
@@ -41,6 +41,7 @@
 
 #include <boost/bind.hpp>
 #include <memory>
+#include <vector>
 
 #include <Libpfs/frame.h>
 
@@ -60,7 +61,8 @@ BatchHDRDialog::BatchHDRDialog(QWidget *p)
       m_errors(false),
       m_loading_error(false),
       m_abort(false),
-      m_processing(false) {
+      m_processing(false),
+      m_streaming(false) {
     m_Ui->setupUi(this);
 
     m_Ui->closeButton->hide();
@@ -78,6 +80,8 @@ BatchHDRDialog::BatchHDRDialog(QWidget *p)
             &BatchHDRDialog::align_selection_clicked);
     connect(m_Ui->aisRadioButton, &QAbstractButton::clicked, this,
             &BatchHDRDialog::align_selection_clicked);
+    connect(m_Ui->streamingCheckBox, &QAbstractButton::toggled, this,
+            &BatchHDRDialog::streaming_toggled);
     connect(m_Ui->threshold_horizontalSlider, &QAbstractSlider::valueChanged,
             this, &BatchHDRDialog::updateThresholdSlider);
     connect(m_Ui->threshold_doubleSpinBox, SIGNAL(valueChanged(double)), this,
@@ -322,6 +326,11 @@ void BatchHDRDialog::on_startButton_clicked() {
         return;
     }
 
+    // check the brackets on the headers of the files, before decoding them
+    if (doStart) {
+        doStart = checkBrackets();
+    }
+
     if (doStart) {
         m_Ui->horizontalSlider->setEnabled(false);
         m_Ui->spinBox->setEnabled(false);
@@ -330,6 +339,7 @@ void BatchHDRDialog::on_startButton_clicked() {
         m_Ui->groupBoxAg->setEnabled(false);
         m_Ui->groupBoxIO->setEnabled(false);
         m_Ui->startButton->setEnabled(false);
+        m_streaming = m_Ui->streamingCheckBox->isChecked();
         m_total = m_bracketed.count() / m_Ui->spinBox->value();
         m_Ui->progressBar->setMaximum(m_total);
         m_Ui->textEdit->append(tr("Started processing..."));
@@ -339,6 +349,55 @@ void BatchHDRDialog::on_startButton_clicked() {
     }
 }
 
+bool BatchHDRDialog::checkBrackets() {
+    std::vector<pfs::io::FrameInfo> infos;
+    try {
+        infos = HdrCreationManager::probeFiles(m_bracketed);
+    } catch (std::exception &e) {
+        // the error is reported when the bracket is loaded
+        qDebug() << "BatchHDRDialog::checkBrackets(): " << e.what();
+        return true;
+    }
+
+    const int bracketSize = m_Ui->spinBox->value();
+    bool sameExposures = false;
+    for (int first = 0; first < m_bracketed.count(); first += bracketSize) {
+        const pfs::io::FrameInfo &reference = infos[first];
+        for (int i = first + 1; i < first + bracketSize; ++i) {
+            if (infos[i].width != reference.width ||
+                infos[i].height != reference.height) {
+                QMessageBox::warning(
+                    0, tr("Warning"),
+                    tr("The images of the bracket starting with %1 have "
+                       "different size.")
+                        .arg(QFileInfo(m_bracketed.at(first)).fileName()),
+                    QMessageBox::Ok, QMessageBox::NoButton);
+                return false;
+            }
+            for (int j = first; j < i; ++j) {
+                sameExposures = sameExposures ||
+                                (infos[i].exif.isValid() &&
+                                 infos[j].exif.isValid() &&
+                                 infos[i].exif.getAverageSceneLuminance() ==
+                                     infos[j].exif.getAverageSceneLuminance());
+            }
+        }
+    }
+
+    // two images with the same exposure in a bracket usually mean that the
+    // number of bracketed images is wrong
+    if (sameExposures) {
+        return QMessageBox::Yes ==
+               QMessageBox::warning(
+                   0, tr("Warning"),
+                   tr("Some brackets contain images with the same exposure: "
+                      "the number of bracketed images might be wrong. "
+                      "\n\nContinue?"),
+                   QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+    }
+    return true;
+}
+
 void BatchHDRDialog::batch_hdr() {
     m_processing = true;
 
@@ -362,6 +421,20 @@ void BatchHDRDialog::batch_hdr() {
         }
         qDebug() << "BatchHDRDialog::batch_hdr() Files to process: "
                  << toProcess;
+        if (m_streaming) {
+            m_Ui->textEdit->append(tr("Creating HDR..."));
+            applyConfig();
+            m_future = QtConcurrent::run([this, toProcess]() -> pfs::Frame * {
+                try {
+                    return m_hdrCreationManager->createHdrStreaming(toProcess);
+                } catch (std::exception &e) {
+                    m_streamingError = QString::fromStdString(e.what());
+                    return NULL;
+                }
+            });
+            m_futureWatcher.setFuture(m_future);
+            return;
+        }
         // DAVIDE _ HDR CREATION
         QtConcurrent::run(boost::bind(&HdrCreationManager::loadFiles,
                                       m_hdrCreationManager, toProcess));
@@ -405,11 +478,7 @@ void BatchHDRDialog::align() {
         create_hdr(0);
 }
 
-void BatchHDRDialog::create_hdr(int) {
-    qDebug() << "BatchHDRDialog::create_hdr()";
-
-    m_Ui->progressBar->hide();
-    m_Ui->textEdit->append(tr("Creating HDR..."));
+void BatchHDRDialog::applyConfig() {
     int idx = m_Ui->profileComboBox->currentIndex();
 
     const FusionOperatorConfig *cfg = NULL;
@@ -422,6 +491,14 @@ void BatchHDRDialog::create_hdr(int) {
     m_hdrCreationManager->setFusionOperator(cfg->fusionOperator);
     m_hdrCreationManager->getWeightFunction().setType(cfg->weightFunction);
     m_hdrCreationManager->getResponseCurve().setType(cfg->responseCurve);
+}
+
+void BatchHDRDialog::create_hdr(int) {
+    qDebug() << "BatchHDRDialog::create_hdr()";
+
+    m_Ui->progressBar->hide();
+    m_Ui->textEdit->append(tr("Creating HDR..."));
+    applyConfig();
 
     if (m_Ui->autoAG_checkBox->isChecked()) {
         m_Ui->textEdit->append(tr("Doing auto anti-ghosting..."));
@@ -449,6 +526,14 @@ void BatchHDRDialog::create_hdr(int) {
 
 void BatchHDRDialog::createHdrFinished() {
     std::unique_ptr<pfs::Frame> resultHDR(m_future.result());
+    if (resultHDR.get() == NULL && m_streaming && !m_abort) {
+        qDebug() << m_streamingError;
+        m_Ui->textEdit->append(tr("Error: ") + m_streamingError);
+        m_errors = true;
+        m_hdrCreationManager->reset();
+        batch_hdr();
+        return;
+    }
     if (resultHDR.get() == NULL) {
         qDebug() << "Aborted";
         QApplication::restoreOverrideCursor();
@@ -564,6 +649,11 @@ void BatchHDRDialog::loadFilesAborted() {
     this->reject();
 }
 
+void BatchHDRDialog::streaming_toggled(bool checked) {
+    m_Ui->groupBoxAlignment->setEnabled(!checked);
+    m_Ui->groupBoxAg->setEnabled(!checked);
+}
+
 void BatchHDRDialog::updateThresholdSlider(int newValue) {
     float newThreshold = ((float)newValue) / 10000.f;
     bool oldState = m_Ui->threshold_doubleSpinBox->blockSignals(true);
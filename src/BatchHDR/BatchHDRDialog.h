@@ -76,8 +76,17 @@ class BatchHDRDialog : public QDialog {
     void ais_failed(QProcess::ProcessError);
     void createHdrFinished();
     void loadFilesAborted();
+    void streaming_toggled(bool);
 
    protected:
+    //! \brief set the fusion operator, weight and response of the selected
+    //! profile into the HdrCreationManager
+    void applyConfig();
+    //! \brief check, on the headers of the files, that the images of every
+    //! bracket have the same size and different exposures
+    //! \return false if the processing must not start
+    bool checkBrackets();
+
     // Application-wide settings, loaded via QSettings
     QString m_batchHdrInputDir;
     QString m_batchHdrOutputDir;
@@ -94,6 +103,8 @@ class BatchHDRDialog : public QDialog {
     bool m_loading_error;
     bool m_abort;
     bool m_processing;
+    bool m_streaming;
+    QString m_streamingError;
     QVector<FusionOperatorConfig> m_customConfig;
     QFutureWatcher<void> m_futureWatcher;
     QFuture<pfs::Frame *> m_future;
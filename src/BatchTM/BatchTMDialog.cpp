@@ -44,7 +44,9 @@
 #include <Common/config.h>
 #include <Core/TonemappingOptions.h>
 #include <Exif/ExifOperations.h>
+#include <Libpfs/utils/threadbudget.h>
 #include <OsIntegration/osintegration.h>
+#include <TonemappingOperators/pfstmo.h>
 
 BatchTMDialog::BatchTMDialog(QWidget *p, QSqlDatabase db)
     : QDialog(p), m_Ui(new Ui::BatchTMDialog), m_abort(false), m_db(db) {
@@ -400,7 +402,8 @@ void BatchTMDialog::start_batch_thread() {
             BatchTMJob *job_thread = new BatchTMJob(
                 t_id, HDRs_list.at(m_next_hdr_file), &m_tm_options_list,
                 m_Ui->out_folder_widgets->text(), fileExtension,
-                m_formatHelper.getParams());
+                m_formatHelper.getParams(),
+                pfs::utils::ThreadBudget::instance().share(m_max_num_threads));
 
             // Thread deletes itself when it has done with its job
             connect(job_thread, &QThread::finished, job_thread,
@@ -601,6 +604,9 @@ void BatchTMDialog::from_database() {
                     tm_opt->operator_options.durandoptions.base =
                         query.value(2).toFloat();
                     tm_opt->pregamma = query.value(3).toFloat();
+                    tm_opt->operator_options.durandoptions.bilateralgrid =
+                        query.record().value(QStringLiteral("bilateralgrid"))
+                            .toBool();
                 }
             } else if (tmOperator == QLatin1String("fattal")) {
                 m_Ui->listWidget_TMopts->addItem(tmOperator + ": " + comment);
@@ -619,7 +625,15 @@ void BatchTMDialog::from_database() {
                     tm_opt->operator_options.fattaloptions.newfattal =
                         !query.value(4).toBool();
                     tm_opt->operator_options.fattaloptions.fftsolver =
-                        !query.value(4).toBool();
+                        FATTAL02_SOLVER_FFT;
+                    if (query.value(4).toBool())
+                        tm_opt->operator_options.fattaloptions.fftsolver =
+                            FATTAL02_SOLVER_MULTIGRID;
+                    else if (query.record()
+                                 .value(QStringLiteral("multigrid"))
+                                 .toBool())
+                        tm_opt->operator_options.fattaloptions.fftsolver =
+                            FATTAL02_SOLVER_REDBLACK;
                     tm_opt->pregamma = query.value(5).toFloat();
                 }
             } else if (tmOperator == QLatin1String("ferradans")) {
@@ -37,6 +37,7 @@
 #include <Libpfs/manip/resize.h>
 #include <Libpfs/progress.h>
 #include <Libpfs/tm/TonemapOperator.h>
+#include <Libpfs/utils/threadbudget.h>
 
 #include <Common/LuminanceOptions.h>
 #include <Core/IOWorker.h>
@@ -44,13 +45,14 @@
 BatchTMJob::BatchTMJob(int thread_id, const QString &filename,
                        const QList<TonemappingOptions *> *tm_options,
                        const QString &output_folder, const QString &format,
-                       pfs::Params params)
+                       pfs::Params params, int num_threads)
     : m_thread_id(thread_id),
       m_file_name(filename),
       m_tm_options(tm_options),
       m_output_folder(output_folder),
       m_ldr_output_format(format),
-      m_params(params) {
+      m_params(params),
+      m_num_threads(num_threads) {
     // m_ldr_output_format = LuminanceOptions().getBatchTmLdrFormat();
 
     m_output_file_name_base =
@@ -60,6 +62,9 @@ BatchTMJob::BatchTMJob(int thread_id, const QString &filename,
 BatchTMJob::~BatchTMJob() {}
 
 void BatchTMJob::run() {
+    // the OpenMP and FFTW teams of this job use its share of the budget
+    pfs::utils::ThreadLease lease(m_num_threads);
+
     pfs::Progress prog_helper;
     IOWorker io_worker;
 
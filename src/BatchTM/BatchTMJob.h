@@ -44,7 +44,7 @@ class BatchTMJob : public QThread {
     BatchTMJob(int thread_id, const QString &filename,
                const QList<TonemappingOptions *> *tm_options,
                const QString &output_folder, const QString &ldr_output_format,
-               pfs::Params params);
+               pfs::Params params, int num_threads);
     virtual ~BatchTMJob();
    signals:
     void done(int thread_id);
@@ -63,6 +63,8 @@ class BatchTMJob : public QThread {
     QString m_output_file_name_base;
     QString m_ldr_output_format;
     pfs::Params m_params;
+    // threads leased from the budget for the tonemapping of the job
+    int m_num_threads;
 };
 
 #endif  // BATCHTMJOB_H
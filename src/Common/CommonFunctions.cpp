@@ -28,12 +28,16 @@
 #include <QFileInfo>
 #include <QRgb>
 #include <QUuid>
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <valarray>
 
 #include <Core/IOWorker.h>
 #include <Exif/ExifOperations.h>
 #include <Libpfs/colorspace/colorspace.h>
 #include <Libpfs/colorspace/convert.h>
+#include <Libpfs/colorspace/gamma.h>
 #include <Libpfs/colorspace/normalizer.h>
 #include <Libpfs/frame.h>
 #include <Libpfs/io/framereader.h>
@@ -48,6 +52,7 @@
 #include <Libpfs/manip/shift.h>
 #include <Libpfs/params.h>
 #include <Libpfs/utils/msec_timer.h>
+#include <Libpfs/utils/trace.h>
 #include <Libpfs/utils/transform.h>
 #include <Libpfs/exif/exifdata.hpp>
 #include <Common/CommonFunctions.h>
@@ -265,6 +270,112 @@ void ConvertToQRgb::operator()(float r, float g, float b, QRgb &rgb) const {
     rgb = qRgb(r8u, g8u, b8u);
 }
 
+//! \brief longest side of the preview shown by the HdrWizard
+static const size_t PREVIEW_SIZE = 1024;
+
+//! \brief decimation factor of the preview of a \a width x \a height image
+static size_t previewStep(size_t width, size_t height) {
+    return std::max<size_t>(
+        1, (std::max(width, height) + PREVIEW_SIZE - 1) / PREVIEW_SIZE);
+}
+
+//! \brief rows of an exposure decoded at a time by readCompact()
+static const size_t LOAD_BAND_HEIGHT = 128;
+
+//! \brief read the file of \a reader band by band, encoding each band as
+//! soon as it is decoded, such that the float frame is never held in memory
+//! (only the readers that override FrameReader::readBand() stream the file).
+//! 8 and 16 bits exposures are stored as integer codes, RAW files are decoded
+//! by RAWReader with a 1.8 gamma. \a minRed and \a maxRed are set to the
+//! range of the red channel.
+//! \return NULL if the samples are not integer codes (e.g. HDR files)
+static CompactFrame *readCompact(FrameReader &reader, const Params &params,
+                                 float &minRed, float &maxRed) {
+    const FrameInfo info = reader.probe(params);
+    if (info.isFloat) {
+        return NULL;
+    }
+
+    reader.openBands(params);
+    const size_t W = reader.width();
+    const size_t H = reader.height();
+
+    const int bitDepths[] = {8, 16, 16};
+    const float exponents[] = {1.f, 1.f, colorspace::Gamma1_8::gamma()};
+    Frame band;
+    for (int e = 0; e < 3; ++e) {
+        // a sample of the file is not one of the codes of a smaller depth
+        if (bitDepths[e] < info.bitDepth) continue;
+
+        std::unique_ptr<CompactFrame> compact(
+            new CompactFrame(W, H, bitDepths[e], exponents[e]));
+        minRed = std::numeric_limits<float>::max();
+        maxRed = -std::numeric_limits<float>::max();
+
+        bool encoded = true;
+        for (size_t y0 = 0; y0 < H; y0 += LOAD_BAND_HEIGHT) {
+            const size_t rows = std::min(LOAD_BAND_HEIGHT, H - y0);
+            reader.readBand(band, y0, rows, params);
+            encoded = compact->encodeBand(band, y0);
+            if (!encoded) break;
+
+            const Channel *red;
+            const Channel *green;
+            const Channel *blue;
+            band.getXYZChannels(red, green, blue);
+            std::pair<Array2Df::const_iterator, Array2Df::const_iterator>
+                minmaxRed = boost::minmax_element(red->begin(), red->end());
+            minRed = std::min(minRed, *minmaxRed.first);
+            maxRed = std::max(maxRed, *minmaxRed.second);
+        }
+        if (encoded) {
+            copyTags(band.getTags(), compact->getTags());
+            return compact.release();
+        }
+    }
+    return NULL;
+}
+
+//! \brief fill \a image with one pixel of \a frame every \a step in both
+//! directions. If \a normalize is true, only the red channel is used,
+//! normalized between \a minRed and \a maxRed
+static void buildQImage(const Frame &frame, size_t step, bool normalize,
+                        float minRed, float maxRed, QImage &image) {
+    const size_t W = (frame.getWidth() + step - 1) / step;
+    const size_t H = (frame.getHeight() + step - 1) / step;
+    QImage tempImage(W, H, QImage::Format_ARGB32_Premultiplied);
+    QRgb *qimageData = reinterpret_cast<QRgb *>(tempImage.bits());
+
+    const Channel *red;
+    const Channel *green;
+    const Channel *blue;
+    frame.getXYZChannels(red, green, blue);
+
+    const pfs::colorspace::Normalizer normalizer =
+        normalize ? pfs::colorspace::Normalizer(minRed, maxRed)
+                  : pfs::colorspace::Normalizer(0.f, 1.f);
+    const ConvertToQRgb convert(normalize ? 2.2f : 1.0f);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (int y = 0; y < int(H); ++y) {
+        for (size_t x = 0; x < W; ++x) {
+            const size_t xi = x * step;
+            const size_t yi = size_t(y) * step;
+            QRgb &rgb = qimageData[size_t(y) * W + x];
+            if (normalize) {
+                const float v = normalizer((*red)(xi, yi));
+                convert(v, v, v, rgb);
+            } else {
+                convert((*red)(xi, yi), (*green)(xi, yi), (*blue)(xi, yi),
+                        rgb);
+            }
+        }
+    }
+
+    image.swap(tempImage);
+}
+
 void LoadFile::operator()(HdrCreationItem &currentItem) {
     if (currentItem.filename().isEmpty()) {
         return;
@@ -272,33 +383,75 @@ void LoadFile::operator()(HdrCreationItem &currentItem) {
 
     QFileInfo qfi(currentItem.alignedFilename());
 
+    pfs::utils::TraceScope trace(m_previewOnly ? "read_preview" : "read_ldr",
+                                 "io");
+    trace.setBytes(qfi.size());
+
     try {
         QByteArray filePath = QFile::encodeName(qfi.filePath());
+        trace.setDetail(filePath.constData());
 
         qDebug() << QStringLiteral("LoadFile: Loading data for %1")
                         .arg(filePath.constData());
 
+        const pfs::Params params = getRawSettings();
         FrameReaderPtr reader = FrameReaderFactory::open(filePath.constData());
-        reader->read(*currentItem.frame(), getRawSettings());
 
-        // read Average Luminance
-        pfs::exif::ExifData exifData(currentItem.filename().toStdString());
-        currentItem.setAverageLuminance(exifData.getAverageSceneLuminance());
+        // a pending item has already been previewed, and its EV might have
+        // been edited by the user
+        const bool wasPending = currentItem.isDecodePending();
+        CompactFramePtr compact;
+        float minRed = 0.f;
+        float maxRed = 0.f;
+        if (m_previewOnly) {
+            const FrameInfo info = reader->probe(params);
+            reader->readPreview(*currentItem.frame(), PREVIEW_SIZE, params);
+            currentItem.setDecodePending(info.width, info.height);
+        } else {
+            if (!m_fromFITS) {
+                compact.reset(readCompact(*reader, params, minRed, maxRed));
+            }
+            if (!compact) {
+                // the bands might have left the reader anywhere in the file
+                reader = FrameReaderFactory::open(filePath.constData());
+                reader->read(*currentItem.frame(), params);
+            }
+            currentItem.clearDecodePending();
+        }
 
-        // read Exposure Time
-        currentItem.setExposureTime(
-            ExifOperations::getExposureTime(filePath.constData()));
+        if (!wasPending) {
+            // read Average Luminance
+            pfs::exif::ExifData exifData(currentItem.filename().toStdString());
+            currentItem.setAverageLuminance(
+                exifData.getAverageSceneLuminance());
 
-        qDebug() << QStringLiteral("LoadFile: Average Luminance for %1 is %2")
-                        .arg(currentItem.filename())
-                        .arg(currentItem.getAverageLuminance());
+            // read Exposure Time
+            currentItem.setExposureTime(
+                ExifOperations::getExposureTime(filePath.constData()));
 
-        // build QImage
-        QImage tempImage(currentItem.frame()->getWidth(),
-                         currentItem.frame()->getHeight(),
-                         QImage::Format_ARGB32_Premultiplied);
+            qDebug() << QStringLiteral(
+                            "LoadFile: Average Luminance for %1 is %2")
+                            .arg(currentItem.filename())
+                            .arg(currentItem.getAverageLuminance());
+        }
 
-        QRgb *qimageData = reinterpret_cast<QRgb *>(tempImage.bits());
+        if (compact) {
+            // OK, already in [0..1] range: the HdrWizard only needs a small
+            // preview, the full size QImage is built by
+            // HdrCreationManager::buildQImages() for the editing tools
+            const std::unique_ptr<Frame> preview(compact->toFrame(
+                previewStep(compact->getWidth(), compact->getHeight())));
+            buildQImage(*preview, 1, false, minRed, maxRed,
+                        currentItem.preview());
+
+            qDebug() << QStringLiteral("LoadFile: %1 stored with %2 bits")
+                            .arg(currentItem.filename())
+                            .arg(compact->getBitDepth());
+            currentItem.setMin(minRed);
+            currentItem.setMax(maxRed);
+            currentItem.setCompactFrame(compact);
+            return;
+        }
 
         Channel *red;
         Channel *green;
@@ -315,8 +468,8 @@ void LoadFile::operator()(HdrCreationItem &currentItem) {
         std::pair<pfs::Array2Df::const_iterator, pfs::Array2Df::const_iterator>
             minmaxRed = boost::minmax_element(red->begin(), red->end());
 
-        float minRed = *minmaxRed.first;
-        float maxRed = *minmaxRed.second;
+        minRed = *minmaxRed.first;
+        maxRed = *minmaxRed.second;
 
         // Only useful for FitsImporter. Is there another way???
         currentItem.setMin(minRed);
@@ -327,30 +480,25 @@ void LoadFile::operator()(HdrCreationItem &currentItem) {
         std::cout << "LoadFile:datamax = " << maxRed << std::endl;
 #endif
 
-        // if ((fabs(minRed) > std::numeric_limits<float>::epsilon()) ||
-        // (fabs(maxRed - 1.f) > std::numeric_limits<float>::epsilon()))
         if (m_fromFITS) {
-#ifndef NDEBUG
-            std::cout << "LoadFile: Normalizing data" << std::endl;
-#endif
-
             // Let's normalize thumbnails for FitsImporter. Again, all channels
-            // are
-            // equal
-            Channel c(currentItem.frame()->getWidth(),
-                      currentItem.frame()->getHeight(), "X");
-            pfs::colorspace::Normalizer normalize(minRed, maxRed);
-
-            std::transform(red->begin(), red->end(), c.begin(), normalize);
-            utils::transform(c.begin(), c.end(), c.begin(), c.begin(),
-                             qimageData, ConvertToQRgb(2.2f));
-        } else  // OK, already in [0..1] range.
-        {
-            utils::transform(red->begin(), red->end(), green->begin(),
-                             blue->begin(), qimageData, ConvertToQRgb());
+            // are equal
+            buildQImage(*currentItem.frame(), 1, true, minRed, maxRed,
+                        currentItem.qimage());
+            return;
         }
 
-        currentItem.qimage().swap(tempImage);
+        // OK, already in [0..1] range: the HdrWizard only needs a small
+        // preview, the full size QImage is built by
+        // HdrCreationManager::buildQImages() for the editing tools
+        const Frame &frame = *currentItem.frame();
+        buildQImage(frame, previewStep(frame.getWidth(), frame.getHeight()),
+                    false, minRed, maxRed, currentItem.preview());
+
+        if (m_previewOnly) {
+            // the reduced image is not needed anymore
+            currentItem.frame() = std::make_shared<pfs::Frame>();
+        }
     } catch (std::runtime_error &err) {
         qDebug() << QStringLiteral("LoadFile: Cannot load %1: %2")
                         .arg(currentItem.filename(),
@@ -402,35 +550,37 @@ void RefreshPreview::operator()(HdrCreationItem &currentItem) {
                     .arg(currentItem.filename());
 
     try {
-        // build QImage
-        QImage tempImage(currentItem.frame()->getWidth(),
-                         currentItem.frame()->getHeight(),
-                         QImage::Format_ARGB32_Premultiplied);
-
-        QRgb *qimageData = reinterpret_cast<QRgb *>(tempImage.bits());
+        const bool fullSize = m_buildQImage || !currentItem.qimage().isNull();
+
+        // compact exposures are decoded in a temporary frame, at the smallest
+        // resolution needed
+        std::unique_ptr<Frame> decoded;
+        const Frame *frame = NULL;
+        const CompactFramePtr compactPtr = currentItem.compactFrame();
+        if (compactPtr) {
+            const CompactFrame &compact = *compactPtr;
+            decoded.reset(compact.toFrame(
+                fullSize ? 1 : previewStep(compact.getWidth(),
+                                           compact.getHeight())));
+            frame = decoded.get();
+        } else {
+            frame = currentItem.frame().get();
+        }
 
-        Channel *red;
-        Channel *green;
-        Channel *blue;
-        currentItem.frame()->getXYZChannels(red, green, blue);
+        const Channel *red;
+        const Channel *green;
+        const Channel *blue;
+        frame->getXYZChannels(red, green, blue);
 
         float m = *std::min_element(red->begin(), red->end());
         float M = *std::max_element(red->begin(), red->end());
-        if (m != 0.0f || M != 1.0f) {
-            Channel redNorm(currentItem.frame()->getWidth(),
-                            currentItem.frame()->getHeight(), "X");
-            pfs::colorspace::Normalizer normalize(m, M);
-            ConvertToQRgb convert(2.2f);
-            std::transform(red->begin(), red->end(), redNorm.begin(),
-                           normalize);
-            utils::transform(redNorm.begin(), redNorm.end(), redNorm.begin(),
-                             redNorm.begin(), qimageData, convert);
-        } else {
-            utils::transform(red->begin(), red->end(), green->begin(),
-                             blue->begin(), qimageData, ConvertToQRgb());
-        }
+        const bool normalize = (m != 0.0f || M != 1.0f);
 
-        currentItem.qimage().swap(tempImage);
+        buildQImage(*frame, previewStep(frame->getWidth(), frame->getHeight()),
+                    normalize, m, M, currentItem.preview());
+        if (fullSize) {
+            buildQImage(*frame, 1, normalize, m, M, currentItem.qimage());
+        }
     } catch (std::runtime_error &err) {
         qDebug() << QStringLiteral("RefreshPreview: Cannot load %1: %2")
                         .arg(currentItem.filename(),
@@ -30,6 +30,7 @@
 #include <HdrCreation/fusionoperator.h>
 #include <HdrWizard/HdrCreationItem.h>
 #include <Libpfs/utils/minmax.h>
+#include <Libpfs/utils/threadbudget.h>
 
 void computeAutolevels(const QImage *data, const float threshold, float &minL,
                        float &maxL, float &gammaL);
@@ -131,8 +132,12 @@ struct ConvertToQRgb {
     void operator()(float r, float g, float b, QRgb &rgb) const;
 };
 
+//! \brief read an item from its file. With \a previewOnly, only a reduced
+//! image is decoded to build the preview, and the item is left pending
+//! until it is loaded again without \a previewOnly
 struct LoadFile {
-    explicit LoadFile(bool fromFITS = false) : m_datamax(0.f), m_datamin(0.f) {
+    explicit LoadFile(bool fromFITS = false, bool previewOnly = false)
+        : m_datamax(0.f), m_datamin(0.f), m_previewOnly(previewOnly) {
         m_fromFITS = fromFITS;
     }
     void operator()(HdrCreationItem &currentItem);
@@ -140,6 +145,7 @@ struct LoadFile {
     float m_datamax;
     float m_datamin;
     bool m_fromFITS;
+    bool m_previewOnly;
 };
 
 struct SaveFile {
@@ -152,10 +158,37 @@ struct SaveFile {
     void operator()(HdrCreationItem &currentItem);
 };
 
+//! \brief rebuild the preview of an item, and its full size QImage if it
+//! already exists or if \a buildQImage is true
 struct RefreshPreview {
+    explicit RefreshPreview(bool buildQImage = false)
+        : m_buildQImage(buildQImage) {}
     void operator()(HdrCreationItem &currentItem);
+    bool m_buildQImage;
 };
 
+//! \brief \a Function applied to items processed concurrently by
+//! QtConcurrent::map: each item leases its share of the thread budget, so
+//! that the OpenMP teams of the items do not oversubscribe the machine
+template <typename Function>
+struct WithThreadShare {
+    WithThreadShare(const Function &function, size_t items)
+        : m_function(function),
+          m_threads(pfs::utils::ThreadBudget::instance().share(items)) {}
+    void operator()(HdrCreationItem &currentItem) {
+        pfs::utils::ThreadLease lease(m_threads);
+        m_function(currentItem);
+    }
+    Function m_function;
+    size_t m_threads;
+};
+
+template <typename Function>
+WithThreadShare<Function> withThreadShare(const Function &function,
+                                          size_t items) {
+    return WithThreadShare<Function>(function, items);
+}
+
 QString getQString(libhdr::fusion::FusionOperator fo);
 QString getQString(libhdr::fusion::WeightFunctionType wf);
 QString getQString(libhdr::fusion::ResponseCurveType rf);
@@ -29,6 +29,8 @@
  *
  */
 
+#include <algorithm>
+
 #include <QtGlobal>
 #include <QApplication>
 #include <QDate>
@@ -39,10 +41,14 @@
 #include <QMessageBox>
 #include <QString>
 #include <QStyleFactory>
+#include <QThreadPool>
 
 #include "Common/LuminanceOptions.h"
 #include "Common/config.h"
 
+#include <Libpfs/utils/bufferpool.h>
+#include <Libpfs/utils/threadbudget.h>
+
 #if defined(Q_OS_WIN)
 const QString LuminanceOptions::LUMINANCE_HDR_HOME_FOLDER = "LuminanceHDR";
 #elif defined(Q_OS_MACOS)
@@ -673,6 +679,37 @@ void LuminanceOptions::setTempDir(const QString &path) {
     m_settingHolder->setValue(KEY_TEMP_RESULT_PATH, path);
 }
 
+int LuminanceOptions::getFileBackedThreshold() {
+    return m_settingHolder->value(KEY_FILE_BACKED_THRESHOLD, 0).toInt();
+}
+
+void LuminanceOptions::setFileBackedThreshold(int mb) {
+    m_settingHolder->setValue(KEY_FILE_BACKED_THRESHOLD, mb);
+}
+
+void LuminanceOptions::applyFileBackedStorage() {
+    const size_t threshold =
+        static_cast<size_t>(std::max(getFileBackedThreshold(), 0));
+    pfs::utils::BufferPool::instance().setFileBacking(
+        QFile::encodeName(getTempDir()).constData(), threshold << 20);
+}
+
+int LuminanceOptions::getThreadBudget() {
+    return m_settingHolder->value(KEY_THREAD_BUDGET, 0).toInt();
+}
+
+void LuminanceOptions::setThreadBudget(int threads) {
+    m_settingHolder->setValue(KEY_THREAD_BUDGET, threads);
+}
+
+void LuminanceOptions::applyThreadBudget() {
+    pfs::utils::ThreadBudget &budget = pfs::utils::ThreadBudget::instance();
+    budget.setSize(static_cast<size_t>(std::max(getThreadBudget(), 0)));
+    // the QtConcurrent jobs run one per thread of the budget
+    QThreadPool::globalInstance()->setMaxThreadCount(
+        static_cast<int>(budget.size()));
+}
+
 QString LuminanceOptions::getDefaultPathHdrIn() {
     return m_settingHolder->value(KEY_RECENT_PATH_LOAD_HDR, QDir::currentPath())
         .toString();
@@ -194,6 +194,17 @@ class LuminanceOptions : public QObject {
     QString getDefaultPathTmoSettings();
 
     void setTempDir(const QString &);
+    // Size (in MB) above which the image buffers are mapped on scratch
+    // files in getTempDir(), 0 to keep them in memory
+    int getFileBackedThreshold();
+    void setFileBackedThreshold(int);
+    // pass the temporary directory and the threshold to Libpfs
+    void applyFileBackedStorage();
+    // Total number of threads shared by all the jobs, 0 for all the cores
+    int getThreadBudget();
+    void setThreadBudget(int);
+    // pass the budget to Libpfs and to the Qt thread pool
+    void applyThreadBudget();
     void setDefaultPathHdrIn(const QString &);
     void setDefaultPathHdrOut(const QString &);
     void setDefaultPathLdrIn(const QString &);  // HdrWizard
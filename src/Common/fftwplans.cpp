@@ -0,0 +1,271 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \author agent <agent@local>
+
+#include <Common/fftwplans.h>
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include <boost/thread/locks.hpp>
+
+#include <Common/LuminanceOptions.h>
+#include <Common/init_fftw.h>
+#include <Libpfs/utils/threadbudget.h>
+
+namespace {
+//! \brief destroy a plan released by the cache and by its users. The planner
+//! of FFTW is not reentrant: destructions and creations are serialized.
+void destroyPlan(fftwf_plan plan) {
+    boost::lock_guard<boost::mutex> lock(FFTW_MUTEX::fftw_mutex_plan);
+    fftwf_destroy_plan(plan);
+}
+
+//! \brief arrays the plans are made on: the arrays of the caller when the
+//! planner does not write them (FFTW_ESTIMATE, FFTW_WISDOM_ONLY), scratch
+//! arrays otherwise, because FFTW_MEASURE and above overwrite them
+class Scratch {
+   public:
+    //! \brief \a inBytes for the input, \a outBytes for the output, the
+    //! same array for both if \a in == \a out
+    Scratch(void *in, void *out, size_t inBytes, size_t outBytes,
+            unsigned flags)
+        : m_owned((flags & (FFTW_ESTIMATE | FFTW_WISDOM_ONLY)) == 0),
+          m_in(in),
+          m_out(out) {
+        if (m_owned) {
+            const bool inPlace = (in == out);
+            m_in = fftwf_malloc(inPlace ? std::max(inBytes, outBytes)
+                                        : inBytes);
+            m_out = inPlace ? m_in : fftwf_malloc(outBytes);
+        }
+    }
+    ~Scratch() {
+        if (!m_owned) return;
+        if (m_out != m_in) fftwf_free(m_out);
+        fftwf_free(m_in);
+    }
+
+    template <typename T>
+    T *in() const {
+        return static_cast<T *>(m_in);
+    }
+    template <typename T>
+    T *out() const {
+        return static_cast<T *>(m_out);
+    }
+
+   private:
+    Scratch(const Scratch &);
+    Scratch &operator=(const Scratch &);
+
+    bool m_owned;
+    void *m_in;
+    void *m_out;
+};
+}
+
+bool FftwPlans::Key::operator<(const Key &other) const {
+    return std::tie(transform, n0, n1, param0, param1, flags, inPlace,
+                    threads) < std::tie(other.transform, other.n0, other.n1,
+                                        other.param0, other.param1,
+                                        other.flags, other.inPlace,
+                                        other.threads);
+}
+
+FftwPlans &FftwPlans::instance() {
+    static FftwPlans s_plans;
+    return s_plans;
+}
+
+FftwPlans::FftwPlans(size_t maxPlans)
+    : m_stamp(0), m_maxPlans(maxPlans), m_wisdomLoaded(false) {}
+
+FftwPlans::~FftwPlans() {}
+
+size_t FftwPlans::size() const {
+    boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+    return m_plans.size();
+}
+
+void FftwPlans::clear() {
+    std::vector<Plan> released;
+    {
+        boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+        for (auto &plan : m_plans) {
+            released.push_back(plan.second->plan);
+        }
+        m_plans.clear();
+    }
+    // destroyed here, without the lock of the cache
+}
+
+void FftwPlans::setWisdomFile(const std::string &filename) {
+    boost::lock_guard<boost::mutex> lock(FFTW_MUTEX::fftw_mutex_plan);
+    m_wisdomFile = filename;
+    m_wisdomLoaded = false;
+}
+
+void FftwPlans::loadWisdom() {
+    if (m_wisdomLoaded) return;
+
+    if (m_wisdomFile.empty()) {
+        m_wisdomFile =
+            LuminanceOptions().getFftwWisdomFileName().toStdString();
+    }
+    // a missing file is not an error: the wisdom is written by the first
+    // measured plan
+    fftwf_import_wisdom_from_filename(m_wisdomFile.c_str());
+    m_wisdomLoaded = true;
+}
+
+template <typename Create>
+FftwPlans::Plan FftwPlans::lookup(Key key, const void *in, const void *out,
+                                  Create create) {
+    key.inPlace = (in == out);
+    if (fftwf_alignment_of((float *)in) != 0 ||
+        fftwf_alignment_of((float *)out) != 0) {
+        key.flags |= FFTW_UNALIGNED;
+    }
+    key.threads = static_cast<int>(pfs::utils::ThreadLease::current());
+
+    {
+        boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+        auto it = m_plans.find(key);
+        if (it != m_plans.end()) {
+            it->second->used = ++m_stamp;
+            return it->second->plan;
+        }
+    }
+
+    init_fftw();
+
+    // destroyed after the locks are released
+    std::vector<Plan> evicted;
+    Plan plan;
+    {
+        boost::lock_guard<boost::mutex> planner(FFTW_MUTEX::fftw_mutex_plan);
+        {
+            // planned by another thread in the meantime
+            boost::shared_lock<boost::shared_mutex> lock(m_mutex);
+            auto it = m_plans.find(key);
+            if (it != m_plans.end()) {
+                it->second->used = ++m_stamp;
+                return it->second->plan;
+            }
+        }
+
+        loadWisdom();
+        fftwf_plan_with_nthreads(key.threads);
+        fftwf_plan p = create(key.flags);
+        if (p == NULL) {
+            // FFTW_WISDOM_ONLY without wisdom
+            return plan;
+        }
+        if ((key.flags & (FFTW_ESTIMATE | FFTW_WISDOM_ONLY)) == 0) {
+            fftwf_export_wisdom_to_filename(m_wisdomFile.c_str());
+        }
+        plan = Plan(p, &destroyPlan);
+
+        boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+        std::unique_ptr<Entry> entry(new Entry);
+        entry->plan = plan;
+        entry->used = ++m_stamp;
+        m_plans[key] = std::move(entry);
+
+        // evict the least recently used plans not in use
+        while (m_plans.size() > m_maxPlans) {
+            auto oldest = m_plans.end();
+            for (auto it = m_plans.begin(); it != m_plans.end(); ++it) {
+                if (it->second->plan.use_count() > 1) continue;
+                if (oldest == m_plans.end() ||
+                    it->second->used < oldest->second->used) {
+                    oldest = it;
+                }
+            }
+            if (oldest == m_plans.end()) break;
+            evicted.push_back(oldest->second->plan);
+            m_plans.erase(oldest);
+        }
+    }
+    return plan;
+}
+
+FftwPlans::Plan FftwPlans::r2r1d(int n, float *in, float *out,
+                                 fftwf_r2r_kind kind, unsigned flags) {
+    const Key key = {R2R_1D, n, 1, kind, 0, flags, false, 0};
+    return lookup(key, in, out, [&](unsigned planFlags) {
+        Scratch scratch(in, out, sizeof(float) * n, sizeof(float) * n,
+                        planFlags);
+        return fftwf_plan_r2r_1d(n, scratch.in<float>(), scratch.out<float>(),
+                                 kind, planFlags);
+    });
+}
+
+FftwPlans::Plan FftwPlans::r2r2d(int n0, int n1, float *in, float *out,
+                                 fftwf_r2r_kind kind0, fftwf_r2r_kind kind1,
+                                 unsigned flags) {
+    const Key key = {R2R_2D, n0, n1, kind0, kind1, flags, false, 0};
+    return lookup(key, in, out, [&](unsigned planFlags) {
+        const size_t bytes = sizeof(float) * n0 * n1;
+        Scratch scratch(in, out, bytes, bytes, planFlags);
+        return fftwf_plan_r2r_2d(n0, n1, scratch.in<float>(),
+                                 scratch.out<float>(), kind0, kind1,
+                                 planFlags);
+    });
+}
+
+FftwPlans::Plan FftwPlans::dft2d(int n0, int n1, fftwf_complex *in,
+                                 fftwf_complex *out, int sign,
+                                 unsigned flags) {
+    const Key key = {DFT_2D, n0, n1, sign, 0, flags, false, 0};
+    return lookup(key, in, out, [&](unsigned planFlags) {
+        const size_t bytes = sizeof(fftwf_complex) * n0 * n1;
+        Scratch scratch(in, out, bytes, bytes, planFlags);
+        return fftwf_plan_dft_2d(n0, n1, scratch.in<fftwf_complex>(),
+                                 scratch.out<fftwf_complex>(), sign,
+                                 planFlags);
+    });
+}
+
+FftwPlans::Plan FftwPlans::r2c2d(int n0, int n1, float *in,
+                                 fftwf_complex *out, unsigned flags) {
+    const Key key = {R2C_2D, n0, n1, 0, 0, flags, false, 0};
+    return lookup(key, in, out, [&](unsigned planFlags) {
+        Scratch scratch(in, out, sizeof(float) * n0 * n1,
+                        sizeof(fftwf_complex) * n0 * (n1 / 2 + 1), planFlags);
+        return fftwf_plan_dft_r2c_2d(n0, n1, scratch.in<float>(),
+                                     scratch.out<fftwf_complex>(), planFlags);
+    });
+}
+
+FftwPlans::Plan FftwPlans::c2r2d(int n0, int n1, fftwf_complex *in,
+                                 float *out, unsigned flags) {
+    const Key key = {C2R_2D, n0, n1, 0, 0, flags, false, 0};
+    return lookup(key, in, out, [&](unsigned planFlags) {
+        Scratch scratch(in, out, sizeof(fftwf_complex) * n0 * (n1 / 2 + 1),
+                        sizeof(float) * n0 * n1, planFlags);
+        return fftwf_plan_dft_c2r_2d(n0, n1, scratch.in<fftwf_complex>(),
+                                     scratch.out<float>(), planFlags);
+    });
+}
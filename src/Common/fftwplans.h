@@ -0,0 +1,139 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief Process-wide cache of FFTW plans, backed by the wisdom file of
+//! the user
+//! \author agent <agent@local>
+
+#ifndef FFTWPLANS_H
+#define FFTWPLANS_H
+
+#include <fftw3.h>
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <boost/thread/shared_mutex.hpp>
+
+//! \brief Plans shared by all the FFT based operators.
+//!
+//! A plan is looked up by its transform, size, flags, in-placeness,
+//! alignment and number of threads, and created on first use only. Jobs
+//! working on frames of the same size then plan once per process (and once
+//! per machine for the flags above FFTW_ESTIMATE, thanks to the wisdom).
+//!
+//! FFTW_ESTIMATE plans are created on the arrays of the caller, which that
+//! planner does not write. FFTW_MEASURE and above are planned on scratch
+//! arrays, so they never touch the data of the caller. The plans are run
+//! with the new-array execute functions of FFTW (fftwf_execute_r2r(),
+//! fftwf_execute_dft(), ...), which may be called concurrently on the same
+//! plan. The arrays passed to a lookup are not written: the plan can be run
+//! on any array with the same alignment and in-placeness.
+//!
+//! Lookups of cached plans take a shared lock; only the creation of a plan
+//! goes through the FFTW planner, which is serialized by
+//! FFTW_MUTEX::fftw_mutex_plan.
+class FftwPlans {
+   public:
+    //! \brief cached plan, destroyed when released by the cache and by all
+    //! of its users
+    typedef std::shared_ptr<fftwf_plan_s> Plan;
+
+    //! \brief the plans of the process
+    static FftwPlans &instance();
+
+    //! \brief the cache keeps at most \a maxPlans plans not in use
+    explicit FftwPlans(size_t maxPlans = 32);
+    ~FftwPlans();
+
+    //! \brief real to real transform of \a n samples
+    Plan r2r1d(int n, float *in, float *out, fftwf_r2r_kind kind,
+               unsigned flags);
+    //! \brief real to real transform of \a n0 rows of \a n1 samples
+    Plan r2r2d(int n0, int n1, float *in, float *out, fftwf_r2r_kind kind0,
+               fftwf_r2r_kind kind1, unsigned flags);
+    //! \brief complex transform of \a n0 rows of \a n1 samples
+    Plan dft2d(int n0, int n1, fftwf_complex *in, fftwf_complex *out,
+               int sign, unsigned flags);
+    //! \brief real to complex transform of \a n0 rows of \a n1 samples
+    Plan r2c2d(int n0, int n1, float *in, fftwf_complex *out,
+               unsigned flags);
+    //! \brief complex to real transform of \a n0 rows of \a n1 samples
+    Plan c2r2d(int n0, int n1, fftwf_complex *in, float *out,
+               unsigned flags);
+
+    //! \brief number of cached plans
+    size_t size() const;
+    //! \brief drop the cached plans (the ones in use live on with their
+    //! users)
+    void clear();
+
+    //! \brief wisdom file read before the first plan and written after the
+    //! plans measured (FFTW_MEASURE and above). By default, the wisdom file
+    //! in the folder of the user settings (see LuminanceOptions).
+    void setWisdomFile(const std::string &filename);
+
+   private:
+    FftwPlans(const FftwPlans &);
+    FftwPlans &operator=(const FftwPlans &);
+
+    enum Transform { R2R_1D, R2R_2D, DFT_2D, R2C_2D, C2R_2D };
+
+    struct Key {
+        Transform transform;
+        int n0;
+        int n1;
+        int param0;  //!< kind of the first dimension, or sign
+        int param1;  //!< kind of the second dimension
+        unsigned flags;
+        bool inPlace;
+        int threads;
+
+        bool operator<(const Key &other) const;
+    };
+
+    struct Entry {
+        Plan plan;
+        //! \brief lookup stamp, for the eviction of the least recently used
+        std::atomic<size_t> used;
+    };
+
+    //! \brief the cached plan of \a key, planned by \a create on a miss
+    template <typename Create>
+    Plan lookup(Key key, const void *in, const void *out, Create create);
+
+    //! \brief read the wisdom file, once. Called with the planner locked.
+    void loadWisdom();
+
+    mutable boost::shared_mutex m_mutex;
+    std::map<Key, std::unique_ptr<Entry>> m_plans;
+    std::atomic<size_t> m_stamp;
+    size_t m_maxPlans;
+
+    // guarded by the planner mutex
+    std::string m_wisdomFile;
+    bool m_wisdomLoaded;
+};
+
+#endif  // FFTWPLANS_H
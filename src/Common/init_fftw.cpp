@@ -20,32 +20,29 @@
 */
 
 #include <fftw3.h>
-#ifdef _OPENMP
-#include <omp.h>
-#endif
+
+#include <boost/thread/locks.hpp>
 
 #include <Common/init_fftw.h>
+#include <Libpfs/utils/threadbudget.h>
 
 using namespace std;
 
-boost::mutex FFTW_MUTEX::fftw_mutex_global;
 boost::mutex FFTW_MUTEX::fftw_mutex_plan;
-boost::mutex FFTW_MUTEX::fftw_mutex_destroy_plan;
 boost::mutex FFTW_MUTEX::fftw_mutex_alloc;
 boost::mutex FFTW_MUTEX::fftw_mutex_free;
 
 void init_fftw() {
-    FFTW_MUTEX::fftw_mutex_global.lock();
+    // the thread count is state of the planner: set under the same lock as
+    // the plans, so that another job cannot change it in between
+    boost::lock_guard<boost::mutex> lock(FFTW_MUTEX::fftw_mutex_plan);
     static bool is_init_threads = false;
     // activate parallel execution of fft routines
     if (!is_init_threads) {
         fftwf_init_threads();
-#ifdef _OPENMP
-        fftwf_plan_with_nthreads(omp_get_max_threads());
-#else
-        fftwf_plan_with_nthreads(2);
-#endif
         is_init_threads = true;
     }
-    FFTW_MUTEX::fftw_mutex_global.unlock();
+    // the next plans use the threads leased by the calling job
+    fftwf_plan_with_nthreads(
+        static_cast<int>(pfs::utils::ThreadLease::current()));
 }
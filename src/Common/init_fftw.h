@@ -26,13 +26,14 @@
 
 class FFTW_MUTEX {
    public:
-    static boost::mutex fftw_mutex_global;
     static boost::mutex fftw_mutex_plan;
-    static boost::mutex fftw_mutex_destroy_plan;
     static boost::mutex fftw_mutex_alloc;
     static boost::mutex fftw_mutex_free;
 };
 
+//! \brief initialize the FFTW threads, and make the next plans of the
+//! calling thread use its share of the thread budget (see
+//! pfs::utils::ThreadLease)
 void init_fftw();
 
 #endif
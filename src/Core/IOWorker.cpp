@@ -27,6 +27,7 @@
  *
  */
 
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
@@ -46,6 +47,8 @@
 #include <Libpfs/io/exrwriter.h>  // default for HDR saving
 #include <Libpfs/io/framereaderfactory.h>
 #include <Libpfs/io/framewriterfactory.h>
+#include <Libpfs/utils/threadbudget.h>
+#include <Libpfs/utils/trace.h>
 
 using namespace pfs;
 using namespace pfs::io;
@@ -88,11 +91,19 @@ bool IOWorker::write_hdr_frame(pfs::Frame *hdr_frame, const QString &filename,
     QString absoluteFileName = qfi.absoluteFilePath();
     QByteArray encodedName = QFile::encodeName(absoluteFileName);
 
+    pfs::utils::TraceScope trace("write_hdr", "io");
+    trace.setDetail(encodedName.constData());
+
     // add parameters for TiffWriter HDR
     pfs::Params writerParams(params);
     if (!writerParams.count("tiff_mode")) {
         writerParams.set("tiff_mode", 2);
     }
+    if (!writerParams.count("exr.threads")) {
+        writerParams.set(
+            "exr.threads",
+            static_cast<int>(pfs::utils::ThreadLease::current()));
+    }
 
     try {
         FrameWriterPtr writer =
@@ -109,6 +120,8 @@ bool IOWorker::write_hdr_frame(pfs::Frame *hdr_frame, const QString &filename,
     }
 
     if (status) {
+        qfi.refresh();
+        trace.setBytes(qfi.size());
         emit write_hdr_success(hdr_frame, filename);
     } else {
         emit write_hdr_failed(filename);
@@ -160,6 +173,9 @@ bool IOWorker::write_ldr_frame(pfs::Frame *ldr_input, const QString &filename,
     QString absoluteFileName = qfi.absoluteFilePath();
     QByteArray encodedName = QFile::encodeName(absoluteFileName);
 
+    pfs::utils::TraceScope trace("write_ldr", "io");
+    trace.setDetail(encodedName.constData());
+
     try {
         FrameWriterPtr writer =
             FrameWriterFactory::open(encodedName.constData(), params);
@@ -219,6 +235,8 @@ bool IOWorker::write_ldr_frame(pfs::Frame *ldr_input, const QString &filename,
                                          comment.toStdString(), true, false);
         }
 
+        qfi.refresh();
+        trace.setBytes(qfi.size());
         emit write_ldr_success(ldr_input, filename);
     } else {
         emit write_ldr_failed(filename);
@@ -243,13 +261,45 @@ pfs::Frame *IOWorker::read_hdr_frame(const QString &filename) {
         return NULL;
     }
 
+    pfs::utils::TraceScope trace("read_hdr", "io");
+    trace.setBytes(qfi.size());
+
     QScopedPointer<pfs::Frame> hdrpfsframe(new pfs::Frame());
     try {
         QByteArray encodedFileName = QFile::encodeName(qfi.absoluteFilePath());
+        trace.setDetail(encodedFileName.constData());
 
         pfs::Params params = getRawSettings();
+        params.set("exr.threads",
+                   static_cast<int>(pfs::utils::ThreadLease::current()));
+        // HALF OpenEXR samples are kept in half precision (see
+        // pfs::Frame::isHalf()), at half the memory of the float channels
+        params.set("exr.half", true);
         FrameReaderPtr reader =
             FrameReaderFactory::open(encodedFileName.constData());
+
+        // the header is enough to reject an empty frame, or one too large to
+        // be addressed, before decoding it
+        const FrameInfo info = reader->probe(params);
+        if (info.width == 0 || info.height == 0) {
+            throw pfs::io::InvalidHeader("the file holds no image");
+        }
+        if (info.height >
+            std::numeric_limits<size_t>::max() / info.width / 3 /
+                sizeof(float)) {
+            throw pfs::io::InvalidHeader("the image is too large");
+        }
+        qDebug() << QStringLiteral(
+                        "IOWorker::read_hdr_frame(): %1x%2, %3 channels of "
+                        "%4 bits%5, %6 MB needed to decode")
+                        .arg(info.width)
+                        .arg(info.height)
+                        .arg(info.channels)
+                        .arg(info.bitDepth)
+                        .arg(info.isFloat ? QStringLiteral(" float")
+                                          : QString())
+                        .arg(info.frameBytes() >> 20);
+
         reader->read(*hdrpfsframe, params);
         reader->close();
     } catch (pfs::io::UnsupportedFormat &exUnsupported) {
@@ -32,14 +32,20 @@
 #include <QVector>
 
 #include <Core/IOWorker.h>
+#include <Libpfs/colorspace/gamma.h>
+#include <Libpfs/colorspace/saturation.h>
 #include <Libpfs/frame.h>
+#include <Libpfs/frameview.h>
 #include <Libpfs/manip/copy.h>
 #include <Libpfs/manip/cut.h>
-#include <Libpfs/manip/gamma.h>
+#include <Libpfs/manip/pixelpipeline.h>
 #include <Libpfs/manip/resize.h>
-#include <Libpfs/manip/saturation.h>
 #include <Libpfs/params.h>
 #include <Libpfs/tm/TonemapOperator.h>
+#include <Libpfs/utils/bufferpool.h>
+#include <Libpfs/utils/chain.h>
+#include <Libpfs/utils/threadbudget.h>
+#include <Libpfs/utils/trace.h>
 #include <Common/ProgressHelper.h>
 #include <Core/TonemappingOptions.h>
 
@@ -167,8 +173,27 @@ void TMWorker::tonemapFrame(pfs::Frame *working_frame,
     TonemapOperator *tmEngine =
         TonemapOperator::getTonemapOperator(tm_options->tmoperator);
 
-    // build object, pass new frame to it and collect the result
-    tmEngine->tonemapFrame(*working_frame, tm_options, *m_Callback);
+    // build object, pass new frame to it and collect the result, with the
+    // threads of the budget not used by the other jobs
+    {
+        pfs::utils::ThreadLease lease;
+        pfs::utils::TraceScope trace("tonemap", "tonemap");
+        if (trace.isEnabled()) {
+            trace.setDetail(tm_options->getPostfix().toStdString());
+            trace.setBytes(working_frame->getWidth() *
+                           working_frame->getHeight() * 3 * sizeof(float));
+        }
+        tmEngine->tonemapFrame(*working_frame, tm_options, *m_Callback);
+    }
+
+#ifdef QT_DEBUG
+    pfs::utils::BufferPoolStats stats =
+        pfs::utils::BufferPool::instance().stats();
+    qDebug() << "TMWorker::tonemapFrame() buffer pool: hits" << stats.hits
+             << "misses" << stats.misses << "cached MB"
+             << stats.cachedBytes / (1024 * 1024) << "mapped MB"
+             << stats.mappedBytes / (1024 * 1024);
+#endif
 
     emit tonemapEnd();
     delete tmEngine;
@@ -177,42 +202,71 @@ void TMWorker::tonemapFrame(pfs::Frame *working_frame,
 pfs::Frame *TMWorker::preprocessFrame(pfs::Frame *input_frame,
                                       TonemappingOptions *tm_options,
                                       InterpolationMethod m) {
+    pfs::utils::TraceScope trace("tonemap_preprocess", "tonemap");
     pfs::Frame *working_frame = NULL;
+    const bool pregamma = (tm_options->pregamma != 1.0f);
 
-    if (tm_options->tonemapSelection) {
-        // workingframe = "crop"
-        // std::cout << "crop:[" << opts.selection_x_up_left <<", " <<
-        // opts.selection_y_up_left <<"],";
-        // std::cout << "[" << opts.selection_x_bottom_right <<", " <<
-        // opts.selection_y_bottom_right <<"]" << std::endl;
-        working_frame = pfs::cut(input_frame, tm_options->selection_x_up_left,
+    if (tm_options->tonemapSelection ||
+        tm_options->xsize == tm_options->origxsize) {
+        // workingframe = "crop" or "full res"
+        const pfs::FrameView view =
+            tm_options->tonemapSelection
+                ? pfs::FrameView(*input_frame, tm_options->selection_x_up_left,
                                  tm_options->selection_y_up_left,
                                  tm_options->selection_x_bottom_right,
-                                 tm_options->selection_y_bottom_right);
-    } else if (tm_options->xsize != tm_options->origxsize) {
+                                 tm_options->selection_y_bottom_right)
+                : pfs::FrameView(*input_frame);
+
+        if (pregamma && !input_frame->isHalf()) {
+            // copy and gamma in a single pass
+            return pfs::transformRGB(
+                view, pfs::colorspace::ChangeGamma(tm_options->pregamma));
+        }
+        // a half precision source stays in half: only the working frame is
+        // inflated
+        working_frame = view.isFullFrame() ? pfs::copy(input_frame)
+                                           : pfs::cut(view);
+        if (pregamma) {
+            pfs::transformRGB(
+                *working_frame,
+                pfs::colorspace::ChangeGamma(tm_options->pregamma));
+        }
+    } else {
         // workingframe = "resize"
         working_frame = pfs::resize(input_frame, tm_options->xsize, m);
-    } else {
-        // workingframe = "full res"
-        working_frame = pfs::copy(input_frame);
-    }
-
-    if (tm_options->pregamma != 1.0f) {
-        pfs::applyGamma(working_frame, tm_options->pregamma);
+        // on the (smaller) resized frame
+        if (pregamma) {
+            pfs::transformRGB(
+                *working_frame,
+                pfs::colorspace::ChangeGamma(tm_options->pregamma));
+        }
     }
 
     return working_frame;
 }
 
 void TMWorker::postprocessFrame(pfs::Frame *working_frame, TonemappingOptions *tm_options) {
+    pfs::utils::TraceScope trace("tonemap_postprocess", "tonemap");
     // auto-level?
     // black-point?
     // white-point?
-    if (tm_options->postsaturation != 1.0) {
-        pfs::applySaturation(working_frame, tm_options->postsaturation);
-    }
-    if (tm_options->postgamma != 1.0) {
-        pfs::applyGamma(working_frame, tm_options->postgamma);
+    const bool postsaturation = (tm_options->postsaturation != 1.0);
+    const bool postgamma = (tm_options->postgamma != 1.0);
+
+    if (postsaturation && postgamma) {
+        // both in a single pass
+        pfs::transformRGB(
+            *working_frame,
+            pfs::utils::chain(
+                pfs::colorspace::ChangeSaturation(tm_options->postsaturation),
+                pfs::colorspace::ChangeGamma(tm_options->postgamma)));
+    } else if (postsaturation) {
+        pfs::transformRGB(
+            *working_frame,
+            pfs::colorspace::ChangeSaturation(tm_options->postsaturation));
+    } else if (postgamma) {
+        pfs::transformRGB(*working_frame,
+                          pfs::colorspace::ChangeGamma(tm_options->postgamma));
     }
 
 }
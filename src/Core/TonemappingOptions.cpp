@@ -37,6 +37,7 @@
 #include <Common/config.h>
 #include <Core/TonemappingOptions.h>
 #include <TonemappingOperators/pfstmdefaultparams.h>
+#include <TonemappingOperators/pfstmo.h>
 
 void TonemappingOptions::setDefaultTonemapParameters() {
     // Mantiuk06
@@ -63,7 +64,7 @@ void TonemappingOptions::setDefaultTonemapParameters() {
     operator_options.fattaloptions.color = FATTAL02_COLOR;
     operator_options.fattaloptions.noiseredux = FATTAL02_NOISE_REDUX;
     operator_options.fattaloptions.newfattal = FATTAL02_NEWFATTAL;
-    operator_options.fattaloptions.fftsolver = true;
+    operator_options.fattaloptions.fftsolver = FATTAL02_SOLVER_FFT;
 
     // Ferradans
     operator_options.ferradansoptions.rho = FERRADANS11_RHO;
@@ -84,6 +85,7 @@ void TonemappingOptions::setDefaultTonemapParameters() {
     operator_options.durandoptions.spatial = DURAND02_SPATIAL;
     operator_options.durandoptions.range = DURAND02_RANGE;
     operator_options.durandoptions.base = DURAND02_BASE;
+    operator_options.durandoptions.bilateralgrid = false;
 
     // Reinhard 02
     operator_options.reinhard02options.scales = REINHARD02_SCALES;
@@ -221,7 +223,7 @@ const QString TonemappingOptions::getPostfix() {
             float beta = operator_options.fattaloptions.beta;
             float saturation2 = operator_options.fattaloptions.color;
             float noiseredux = operator_options.fattaloptions.noiseredux;
-            bool fftsolver = operator_options.fattaloptions.fftsolver;
+            int fftsolver = operator_options.fattaloptions.fftsolver;
             postfix += QStringLiteral("alpha_%1_").arg(alpha);
             postfix += QStringLiteral("beta_%1_").arg(beta);
             postfix += QStringLiteral("saturation_%1_").arg(saturation2);
@@ -279,6 +281,9 @@ const QString TonemappingOptions::getPostfix() {
             postfix += QStringLiteral("spatial_%1_").arg(spatial);
             postfix += QStringLiteral("range_%1_").arg(range);
             postfix += QStringLiteral("base_%1").arg(base);
+            if (operator_options.durandoptions.bilateralgrid) {
+                postfix += QLatin1String("_bilateralgrid");
+            }
         } break;
         case pattanaik: {
             float multiplier = operator_options.pattanaikoptions.multiplier;
@@ -394,7 +399,7 @@ const QString TonemappingOptions::getCaption(bool includePregamma,
             float beta = operator_options.fattaloptions.beta;
             float saturation2 = operator_options.fattaloptions.color;
             float noiseredux = operator_options.fattaloptions.noiseredux;
-            bool fftsolver = operator_options.fattaloptions.fftsolver;
+            int fftsolver = operator_options.fattaloptions.fftsolver;
             caption += "Fattal:" + separator;
             caption +=
                 QString(QObject::tr("Alpha") + "=%1").arg(alpha) + separator;
@@ -461,7 +466,10 @@ const QString TonemappingOptions::getCaption(bool includePregamma,
                        separator;
             caption +=
                 QString(QObject::tr("Range") + "=%1").arg(range) + separator;
-            caption += QString(QObject::tr("Base") + "=%1").arg(base);
+            caption +=
+                QString(QObject::tr("Base") + "=%1").arg(base) + separator;
+            caption += QString(QObject::tr("BilateralGrid") + "=%1")
+                           .arg(operator_options.durandoptions.bilateralgrid);
         } break;
         case pattanaik: {
             float multiplier = operator_options.pattanaikoptions.multiplier;
@@ -655,6 +663,9 @@ TonemappingOptions *TMOptionsOperations::parseFile(const QString &fname) {
                     value.toInt();
         } else if (field == QLatin1String("BASE")) {
             toreturn->operator_options.durandoptions.base = value.toFloat();
+        } else if (field == QLatin1String("BILATERALGRID")) {
+            toreturn->operator_options.durandoptions.bilateralgrid =
+                (value == QLatin1String("YES"));
         } else if (field == QLatin1String("ALPHA")) {
             toreturn->operator_options.fattaloptions.alpha = value.toFloat();
         } else if (field == QLatin1String("BETA")) {
@@ -668,7 +679,16 @@ TonemappingOptions *TMOptionsOperations::parseFile(const QString &fname) {
             toreturn->operator_options.fattaloptions.newfattal =
                 true;  // This is the new version of fattal pre FFT (always yes)
             toreturn->operator_options.fattaloptions.fftsolver =
-                (value == QLatin1String("NO"));
+                (value == QLatin1String("NO")) ? FATTAL02_SOLVER_FFT
+                                               : FATTAL02_SOLVER_MULTIGRID;
+        } else if (field == QLatin1String("MULTIGRID")) {
+            // red-black multigrid in place of the fft solver
+            if (value == QLatin1String("YES") &&
+                toreturn->operator_options.fattaloptions.fftsolver ==
+                    FATTAL02_SOLVER_FFT) {
+                toreturn->operator_options.fattaloptions.fftsolver =
+                    FATTAL02_SOLVER_REDBLACK;
+            }
         } else if (field == QLatin1String("RHO")) {
             toreturn->operator_options.ferradansoptions.rho = value.toFloat();
         } else if (field == QLatin1String("INV_ALPHA")) {
@@ -871,6 +891,11 @@ QString TMOptionsOperations::getExifComment() {
             exif_comment +=
                 QStringLiteral("Range Kernel Sigma: %1\n").arg(range);
             exif_comment += QStringLiteral("Base Contrast: %1\n").arg(base);
+            exif_comment +=
+                QStringLiteral("Bilateral Grid: %1\n")
+                    .arg(opts->operator_options.durandoptions.bilateralgrid
+                             ? QLatin1String("YES")
+                             : QLatin1String("NO"));
         } break;
         case pattanaik: {
             float multiplier =
@@ -35,6 +35,10 @@
 #include <QObject>
 #include <QString>
 
+#include <memory>
+
+class Mantiuk06WarmStart;
+
 //----------------- DO NOT CHANGE ENUMERATION ORDER -----------------------
 // all is used by SavedParametersDialog to select comments from all operators
 enum TMOperator : unsigned short {
@@ -79,6 +83,7 @@ class TonemappingOptions {
             float spatial;
             float range;
             float base;
+            bool bilateralgrid;
         } durandoptions;
         struct {
             float alpha;
@@ -86,7 +91,7 @@ class TonemappingOptions {
             float color;
             float noiseredux;
             bool newfattal;
-            bool fftsolver;
+            int fftsolver;  //!< Fattal02Solver
         } fattaloptions;
         struct {
             float rho;
@@ -117,6 +122,9 @@ class TonemappingOptions {
             float saturationfactor;
             float detailfactor;
             bool contrastequalization;
+            //! solution of the previous run of the tone mapping panel
+            //! session, empty (batch, command line) to solve from scratch
+            std::shared_ptr<Mantiuk06WarmStart> warmstart;
         } mantiuk06options;
         struct {
             float colorsaturation;
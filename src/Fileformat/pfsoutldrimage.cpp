@@ -36,6 +36,7 @@
 #include <QImage>
 
 #include <assert.h>
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
@@ -44,7 +45,8 @@
 #include <Libpfs/colorspace/rgbremapper.h>
 #include <Libpfs/exception.h>
 #include <Libpfs/frame.h>
-#include <Libpfs/utils/msec_timer.h>
+#include <Libpfs/halfframe.h>
+#include <Libpfs/utils/trace.h>
 #include <Libpfs/utils/transform.h>
 
 using namespace std;
@@ -65,10 +67,7 @@ void QRgbRemapper::operator()(float r, float g, float b, QRgb &qrgb) const {
 
 QImage *fromLDRPFStoQImage(pfs::Frame *in_frame, float min_luminance,
                            float max_luminance, RGBMappingType mapping_method) {
-#ifdef TIMER_PROFILING
-    msec_timer stop_watch;
-    stop_watch.start();
-#endif
+    pfs::utils::TraceScope trace("encode_qimage", "encode");
 
     qDebug() << "Min Luminance: " << min_luminance;
     qDebug() << "Max Luminance: " << max_luminance;
@@ -76,22 +75,35 @@ QImage *fromLDRPFStoQImage(pfs::Frame *in_frame, float min_luminance,
 
     assert(in_frame != NULL);
 
-    pfs::Channel *Xc, *Yc, *Zc;
-    in_frame->getXYZChannels(Xc, Yc, Zc);
-    assert(Xc != NULL && Yc != NULL && Zc != NULL);
-
     QImage *temp_qimage = new QImage(
         in_frame->getWidth(), in_frame->getHeight(), QImage::Format_RGB32);
+    QRgb *pixels = reinterpret_cast<QRgb *>(temp_qimage->bits());
 
     QRgbRemapper remapper(min_luminance, max_luminance, mapping_method);
-    utils::transform(Xc->begin(), Xc->end(), Yc->begin(), Zc->begin(),
-                     reinterpret_cast<QRgb *>(temp_qimage->bits()), remapper);
-
-#ifdef TIMER_PROFILING
-    stop_watch.stop_and_update();
-    std::cout << "fromLDRPFStoQImage() = " << stop_watch.get_time() << " msec"
-              << std::endl;
-#endif
+    if (in_frame->isHalf()) {
+        // the frame stays in half precision: one band at a time
+        const HalfFrame &half = *in_frame->halfChannels();
+        const size_t width = half.getWidth();
+        Frame band;
+        for (size_t row = 0; row < half.getHeight(); row += HALF_BAND_ROWS) {
+            half.decodeRows(
+                row, std::min(HALF_BAND_ROWS, half.getHeight() - row), band);
+
+            pfs::Channel *Xc, *Yc, *Zc;
+            band.getXYZChannels(Xc, Yc, Zc);
+            assert(Xc != NULL && Yc != NULL && Zc != NULL);
+            utils::transform(Xc->begin(), Xc->end(), Yc->begin(),
+                             Zc->begin(), pixels + row * width, remapper);
+        }
+    } else {
+        pfs::Channel *Xc, *Yc, *Zc;
+        in_frame->getXYZChannels(Xc, Yc, Zc);
+        assert(Xc != NULL && Yc != NULL && Zc != NULL);
+
+        utils::transform(Xc->begin(), Xc->end(), Yc->begin(), Zc->begin(),
+                         pixels, remapper);
+    }
+    trace.setBytes(in_frame->getWidth() * in_frame->getHeight() * sizeof(QRgb));
 
     return temp_qimage;
 }
@@ -0,0 +1,224 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ *  Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ */
+
+//! \author agent <agent@local>
+
+#include <HdrCreation/compactframe.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+#include <Libpfs/channel.h>
+
+using namespace std;
+using namespace pfs;
+
+namespace libhdr {
+namespace fusion {
+
+namespace {
+//! \brief code of \a value in \a table, or -1 if \a value is not in the
+//! table. \a guess is the approximate inverse of the decoding curve.
+inline long findCode(const vector<float> &table, float value, double guess) {
+    const long maxCode = long(table.size()) - 1;
+    if (!(guess > -1.0 && guess < double(maxCode) + 1.0)) return -1;
+
+    const long code = std::min(std::max(lrint(guess), 0L), maxCode);
+    if (table[code] == value) return code;
+    if (code > 0 && table[code - 1] == value) return code - 1;
+    if (code < maxCode && table[code + 1] == value) return code + 1;
+    return -1;
+}
+
+//! \brief encode the three channels of \a frame into \a out, which have
+//! room for its samples
+//! \return false if a sample is not represented in \a table
+template <typename T>
+bool encodeChannels(const Frame &frame, const vector<float> &table,
+                    float exponent, T *const out[3]) {
+    const Channel *Ch[3];
+    frame.getXYZChannels(Ch[0], Ch[1], Ch[2]);
+
+    const int W = frame.getWidth();
+    const int H = frame.getHeight();
+    const double maxCode = double(table.size() - 1);
+    const double inverse = 1.0 / exponent;
+    const bool linear = (exponent == 1.f);
+
+    // one flag per row, such that no synchronization is needed
+    vector<char> failedRows(H, 0);
+    for (int c = 0; c < 3; ++c) {
+        const float *in = Ch[c]->data();
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+        for (int y = 0; y < H; ++y) {
+            if (failedRows[y]) continue;
+            for (int x = 0; x < W; ++x) {
+                const size_t idx = size_t(y) * W + x;
+                const float v = in[idx];
+                const double guess = linear
+                                         ? double(v) * maxCode
+                                         : std::pow(double(v), inverse) *
+                                               maxCode;
+                const long code = findCode(table, v, guess);
+                if (code < 0) {
+                    failedRows[y] = 1;
+                    break;
+                }
+                out[c][idx] = static_cast<T>(code);
+            }
+        }
+    }
+
+    return std::find(failedRows.begin(), failedRows.end(), 1) ==
+           failedRows.end();
+}
+
+template <typename T>
+void codesRange(const vector<T> (&data)[3], unsigned &minCode,
+                unsigned &maxCode) {
+    T m = std::numeric_limits<T>::max();
+    T M = 0;
+    for (int c = 0; c < 3; ++c) {
+        if (data[c].empty()) continue;
+        pair<typename vector<T>::const_iterator,
+             typename vector<T>::const_iterator>
+            mm = std::minmax_element(data[c].begin(), data[c].end());
+        m = std::min(m, *mm.first);
+        M = std::max(M, *mm.second);
+    }
+    minCode = m;
+    maxCode = M;
+}
+}
+
+CompactFrame::CompactFrame(size_t width, size_t height, int bitDepth,
+                           float exponent)
+    : m_width(width),
+      m_height(height),
+      m_bitDepth(bitDepth),
+      m_exponent(exponent),
+      m_table(size_t(1) << bitDepth) {
+    assert(bitDepth == 8 || bitDepth == 16);
+
+    // same arithmetic as the readers: colorspace::ConvertSample, followed
+    // by colorspace::Gamma when exponent is not 1
+    const float maxCode = float(m_table.size() - 1);
+    for (size_t code = 0; code < m_table.size(); ++code) {
+        const float v = float(code) / maxCode;
+        m_table[code] = (exponent == 1.f) ? v : std::pow(v, exponent);
+    }
+
+    for (int c = 0; c < 3; ++c) {
+        if (bitDepth == 8) {
+            m_data8[c].resize(width * height);
+        } else {
+            m_data16[c].resize(width * height);
+        }
+    }
+}
+
+CompactFrame *CompactFrame::encode(const Frame &frame, int bitDepth,
+                                   float exponent) {
+    const Channel *X, *Y, *Z;
+    frame.getXYZChannels(X, Y, Z);
+    if (X == NULL || Y == NULL || Z == NULL) return NULL;
+
+    std::unique_ptr<CompactFrame> compact(new CompactFrame(
+        frame.getWidth(), frame.getHeight(), bitDepth, exponent));
+    if (!compact->encodeBand(frame, 0)) return NULL;
+
+    copyTags(frame.getTags(), compact->m_tags);
+    return compact.release();
+}
+
+CompactFrame *CompactFrame::encode(const Frame &frame) {
+    CompactFrame *compact = encode(frame, 8);
+    if (compact == NULL) {
+        compact = encode(frame, 16);
+    }
+    return compact;
+}
+
+bool CompactFrame::encodeBand(const Frame &band, size_t firstRow) {
+    const Channel *X, *Y, *Z;
+    band.getXYZChannels(X, Y, Z);
+    if (X == NULL || Y == NULL || Z == NULL) return false;
+    if (band.getWidth() != m_width ||
+        firstRow + band.getHeight() > m_height) {
+        return false;
+    }
+
+    const size_t offset = firstRow * m_width;
+    if (m_bitDepth == 8) {
+        uint8_t *const out[3] = {m_data8[0].data() + offset,
+                                 m_data8[1].data() + offset,
+                                 m_data8[2].data() + offset};
+        return encodeChannels(band, m_table, m_exponent, out);
+    }
+    uint16_t *const out[3] = {m_data16[0].data() + offset,
+                              m_data16[1].data() + offset,
+                              m_data16[2].data() + offset};
+    return encodeChannels(band, m_table, m_exponent, out);
+}
+
+void CompactFrame::minMaxCodes(unsigned &minCode, unsigned &maxCode) const {
+    if (m_bitDepth == 8) {
+        codesRange(m_data8, minCode, maxCode);
+    } else {
+        codesRange(m_data16, minCode, maxCode);
+    }
+}
+
+Frame *CompactFrame::toFrame(size_t step) const {
+    assert(step > 0);
+    const size_t W = (m_width + step - 1) / step;
+    const size_t H = (m_height + step - 1) / step;
+
+    std::unique_ptr<Frame> frame(new Frame(W, H));
+    Channel *Ch[3];
+    frame->createXYZChannels(Ch[0], Ch[1], Ch[2]);
+
+    const float *table = m_table.data();
+    for (int c = 0; c < 3; ++c) {
+        float *out = Ch[c]->data();
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+        for (int y = 0; y < int(H); ++y) {
+            const size_t row = size_t(y) * step * m_width;
+            for (size_t x = 0; x < W; ++x) {
+                out[size_t(y) * W + x] = table[code(c, row + x * step)];
+            }
+        }
+    }
+    copyTags(m_tags, frame->getTags());
+
+    return frame.release();
+}
+
+}  // fusion
+}  // libhdr
@@ -0,0 +1,136 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ *  Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ */
+
+//! \brief Integer storage of an LDR exposure used during HDR creation
+//! \author agent <agent@local>
+//!
+//! The readers of 8 and 16 bits images produce floats that are a function of
+//! the integer samples of the file. A CompactFrame keeps the integer codes
+//! (1 or 2 bytes per sample instead of 4) and the table that maps every code
+//! back to the float produced by the reader, so that the encoding is lossless
+//! and the fusion operators can work directly on codes through lookup tables.
+
+#ifndef LIBHDR_FUSION_COMPACTFRAME_H
+#define LIBHDR_FUSION_COMPACTFRAME_H
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+#include <Libpfs/frame.h>
+#include <Libpfs/tag.h>
+
+namespace libhdr {
+namespace fusion {
+
+class CompactFrame {
+   public:
+    //! \brief build an empty frame, whose samples are decoded as
+    //! <tt>pow(code / (2^bitDepth - 1), exponent)</tt>
+    //! \param bitDepth 8 or 16
+    CompactFrame(size_t width, size_t height, int bitDepth,
+                 float exponent = 1.f);
+
+    //! \brief encode \a frame with \a bitDepth bits per sample, decoded with
+    //! \a exponent (e.g. the gamma applied by the RAW reader)
+    //! \return NULL if any sample of \a frame is not exactly one of the
+    //! values of the decoding table
+    static CompactFrame *encode(const pfs::Frame &frame, int bitDepth,
+                                float exponent = 1.f);
+
+    //! \brief encode \a frame with the smallest linear bit depth (8 or 16)
+    //! able to represent it exactly
+    //! \return NULL if the frame is not the output of an 8 or 16 bits linear
+    //! decoding
+    static CompactFrame *encode(const pfs::Frame &frame);
+
+    //! \brief encode \a band, whose width is the one of this frame, into the
+    //! rows starting from \a firstRow. Lets the readers that decode a file
+    //! band by band store it without holding the float frame.
+    //! \return false if any sample of \a band is not exactly one of the
+    //! values of the decoding table (the rows are then left undefined)
+    bool encodeBand(const pfs::Frame &band, size_t firstRow);
+
+    size_t getWidth() const { return m_width; }
+    size_t getHeight() const { return m_height; }
+    int getBitDepth() const { return m_bitDepth; }
+    float getExponent() const { return m_exponent; }
+
+    //! \brief decoding table: \c table()[code] is the value of \c code
+    const float *table() const { return m_table.data(); }
+    size_t numCodes() const { return m_table.size(); }
+
+    const uint8_t *data8(int channel) const {
+        assert(m_bitDepth == 8);
+        return m_data8[channel].data();
+    }
+    uint8_t *data8(int channel) {
+        assert(m_bitDepth == 8);
+        return m_data8[channel].data();
+    }
+    const uint16_t *data16(int channel) const {
+        assert(m_bitDepth == 16);
+        return m_data16[channel].data();
+    }
+    uint16_t *data16(int channel) {
+        assert(m_bitDepth == 16);
+        return m_data16[channel].data();
+    }
+
+    //! \brief code of pixel \a idx of \a channel
+    unsigned code(int channel, size_t idx) const {
+        return (m_bitDepth == 8) ? m_data8[channel][idx]
+                                 : m_data16[channel][idx];
+    }
+
+    //! \brief min and max code of the three channels
+    void minMaxCodes(unsigned &minCode, unsigned &maxCode) const;
+
+    //! \brief tags of the source frame
+    pfs::TagContainer &getTags() { return m_tags; }
+    const pfs::TagContainer &getTags() const { return m_tags; }
+
+    //! \brief decode into a float frame, keeping one pixel every \a step in
+    //! both directions
+    pfs::Frame *toFrame(size_t step = 1) const;
+
+   private:
+    size_t m_width;
+    size_t m_height;
+    int m_bitDepth;
+    float m_exponent;
+
+    std::vector<float> m_table;
+    std::vector<uint8_t> m_data8[3];
+    std::vector<uint16_t> m_data16[3];
+
+    pfs::TagContainer m_tags;
+};
+
+typedef std::shared_ptr<CompactFrame> CompactFramePtr;
+
+}  // fusion
+}  // libhdr
+
+#endif  // LIBHDR_FUSION_COMPACTFRAME_H
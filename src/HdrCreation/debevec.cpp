@@ -27,11 +27,12 @@
 //! \author Davide Anastasia <davideanastasia@users.sourceforge.net>
 
 #include "HdrCreation/debevec.h"
-#include <Libpfs/colorspace/normalizer.h>
-#include <Libpfs/utils/msec_timer.h>
 #include <Libpfs/utils/numeric.h>
+#include <Libpfs/utils/trace.h>
+#include <Libpfs/utils/vecmath.h>
 
 #include <QtGlobal>
+#include <algorithm>
 #include <limits>
 #include <boost/numeric/conversion/bounds.hpp>
 #include <cassert>
@@ -41,7 +42,6 @@
 #include <iostream>
 #include <vector>
 #include "../sleef.c"
-#include "../opthelper.h"
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -57,207 +57,304 @@
 using namespace pfs;
 using namespace std;
 using namespace utils;
-using namespace colorspace;
-using namespace boost::math;
 
 namespace libhdr {
 namespace fusion {
 
-void DebevecOperator::computeFusion(ResponseCurve &response,
-                                    WeightFunction &weight,
-                                    const vector<FrameEnhanced> &images,
-                                    pfs::Frame &frame) {
-
-#ifdef TIMER_PROFILING
-    msec_timer f_timer;
-    f_timer.start();
-#endif
-    assert(images.size() != 0);
-
-    vector<float> times;
-
-    const int W = images[0].frame()->getWidth();
-    const int H = images[0].frame()->getHeight();
-
-    for (size_t idx = 0; idx < images.size(); ++idx) {
-        times.push_back(images[idx].averageLuminance());
+namespace {
+//! \brief width of the tiles processed by the fused merge kernel: all the
+//! scratch buffers of a tile fit in the L1 cache
+const int TILE_WIDTH = 512;
+
+//! \brief weight and log response (plus the exposure offset) of every code
+//! of a CompactFrame exposure
+struct CodeTables {
+    vector<float> weights;
+    vector<float> logResponses;
+};
+
+//! \brief accumulate \a n pixels of a CompactFrame exposure into \a out:
+//! the same computation of the float path, with normalize -> weight ->
+//! response -> log replaced by two table lookups
+template <typename T>
+inline void accumulateCodes(const T *const in[3], int n, float cmul,
+                            const CodeTables &tables, float *wsum,
+                            float *const out[3]) {
+    const float *wl = tables.weights.data();
+    const float *rl = tables.logResponses.data();
+    for (int x = 0; x < n; ++x) {
+        const T c0 = in[0][x];
+        const T c1 = in[1][x];
+        const T c2 = in[2][x];
+
+        const float w = cmul * (wl[c0] + wl[c1] + wl[c2]);
+        wsum[x] += w;
+        out[0][x] += rl[c0] * w;
+        out[1][x] += rl[c1] * w;
+        out[2][x] += rl[c2] * w;
     }
+}
+}
 
-    const int channels = 3;
-    const size_t size = W * H;
-
-    vector<float> exp_values(times);
-
-    transform(exp_values.begin(), exp_values.end(), exp_values.begin(), logf);
+void DebevecOperator::channelsMinMax(const Frame &frame, float &minValue,
+                                     float &maxValue) {
+    const Channel *Ch[3];
+    frame.getXYZChannels(Ch[0], Ch[1], Ch[2]);
 
-    frame.resize(W, H);
-    Channel *Ch[3];
-    frame.createXYZChannels(Ch[0], Ch[1], Ch[2]);
-    Array2Df *resultCh[channels] = {Ch[0], Ch[1], Ch[2]};
+    const int H = frame.getHeight();
+    const int W = frame.getWidth();
 
 #ifdef _OPENMP
-    #pragma omp parallel for
+    vector<float> minValues(omp_get_max_threads(), numeric_limits<float>::max());
+    vector<float> maxValues(omp_get_max_threads(), numeric_limits<float>::min());
+    #pragma omp parallel
+#else
+    vector<float> minValues(1, numeric_limits<float>::max());
+    vector<float> maxValues(1, numeric_limits<float>::min());
 #endif
-    for (int c = 0; c < channels; c++) {
-        resultCh[c]->fill(0.f);
-    }
-    Array2Df weight_sum(W, H);
-    weight_sum.fill(0.f);
-
-    int length = images.size();
-
+    {
 #ifdef _OPENMP
-    int numthreads = omp_get_max_threads();
-    int nestedthreads = std::max(numthreads / length, 1);
-    bool oldNested = omp_get_nested();
-    if(nestedthreads > 1) {
-        omp_set_nested(true);
-    }
-    #pragma omp parallel for
+        const int t = omp_get_thread_num();
+#else
+        const int t = 0;
 #endif
-    for (int i = 0; i < length; i++) {
-        Channel *Ch[channels];
-        images[i].frame()->getXYZChannels(Ch[0], Ch[1], Ch[2]);
-        Array2Df *imagesCh[channels] = {Ch[0], Ch[1], Ch[2]};
-
-        float cmax[3];
-        float cmin[3];
+        float minval = numeric_limits<float>::max();
+        float maxval = numeric_limits<float>::min();
 #ifdef _OPENMP
-        #pragma omp parallel for num_threads(nestedthreads) if (nestedthreads>1)
+        #pragma omp for
 #endif
-        for (int c = 0; c < channels; c++) {
-            float minval = numeric_limits<float>::max();
-            float maxval = numeric_limits<float>::min();
-            for (size_t k = 0; k < size; k++) {
-                minval = std::min(minval, (*imagesCh[c])(k));
-                maxval = std::max(maxval, (*imagesCh[c])(k));
+        for (int y = 0; y < H; ++y) {
+            for (int c = 0; c < 3; ++c) {
+                const float *in = Ch[c]->data() + y * W;
+                for (int x = 0; x < W; ++x) {
+                    minval = std::min(minval, in[x]);
+                    maxval = std::max(maxval, in[x]);
+                }
             }
-            cmax[c] = maxval;
-            cmin[c] = minval;
         }
+        minValues[t] = minval;
+        maxValues[t] = maxval;
+    }
 
-        float Max = max(cmax[0], max(cmax[1], cmax[2]));
-        float Min = min(cmin[0], min(cmin[1], cmin[2]));
+    minValue = *std::min_element(minValues.begin(), minValues.end());
+    maxValue = *std::max_element(maxValues.begin(), maxValues.end());
+}
 
-#ifdef _OPENMP
-        #pragma omp parallel for num_threads(nestedthreads) if (nestedthreads>1)
-#endif
-        for (int c = 0; c < channels; c++) {
-            transform(Ch[c]->begin(), Ch[c]->end(), Ch[c]->begin(),
-                      Normalizer(Min, Max));
-        }
+void DebevecOperator::channelsMinMax(const CompactFrame &frame,
+                                     float &minValue, float &maxValue) {
+    // the decoding table is monotonic
+    unsigned minCode, maxCode;
+    frame.minMaxCodes(minCode, maxCode);
+    minValue = frame.table()[minCode];
+    maxValue = frame.table()[maxCode];
+}
 
-        Array2Df response_img(W, H);
-        Array2Df w(W, H);
+float DebevecOperator::mergeRows(const ResponseCurve &response,
+                                 const WeightFunction &weight,
+                                 const vector<Exposure> &exposures,
+                                 float *const outputs[3], size_t width,
+                                 size_t height) {
+    const int channels = 3;
+    const int length = exposures.size();
+    const int W = width;
 
-        float cmul = 1.f / channels;
-#ifdef _OPENMP
-        #pragma omp parallel for num_threads(nestedthreads) if (nestedthreads>1)
-#endif
-        for (size_t k = 0; k < size; k++) {
-            w(k) = cmul * (weight((*imagesCh[0])(k)) + weight((*imagesCh[1])(k)) + weight((*imagesCh[2])(k)));
-        }
-        float cadd = -logf(times.at((int)i));
-        for (int c = 0; c < channels; c++) {
-            #pragma omp parallel for num_threads(nestedthreads) if (nestedthreads>1)
-            for (size_t k = 0; k < size; k++) {
-                (response_img)(k) = response((*imagesCh[c])(k));
-            }
-#ifdef __SSE2__
-            vfloat caddv = F2V(cadd);
-#ifdef _OPENMP
-            #pragma omp parallel for num_threads(nestedthreads) if (nestedthreads>1)
-#endif
-            for (size_t k = 0; k < size - 3; k+=4) {
-                STVFU((response_img)(k), (xlogf(LVFU((response_img)(k))) + caddv) * LVFU(w(k)));
-            }
-            for (size_t k = size - (size % 4); k < size; k++) {
-                (response_img)(k) = (xlogf((response_img)(k)) + cadd) * w(k);
-            }
-#else
-#ifdef _OPENMP
-            #pragma omp parallel for num_threads(nestedthreads) if (nestedthreads>1)
-#endif
-            for (size_t k = 0; k < size; k++) {
-                (response_img)(k) = (xlogf((response_img)(k)) + cadd) * w(k);
-            }
-#endif
+    vector<float> cadds(length);
+    for (int i = 0; i < length; ++i) {
+        assert(exposures[i].maxValue != exposures[i].minValue);
+        cadds[i] = -logf(exposures[i].averageLuminance);
+    }
 
+    // the CompactFrame exposures have at most 65536 distinct values: the
+    // whole per sample computation is tabulated once
+    vector<CodeTables> codeTables(length);
+    for (int i = 0; i < length; ++i) {
+        const CompactFrame *compact = exposures[i].compact;
+        if (compact == NULL) continue;
+
+        const float Min = exposures[i].minValue;
+        const float range = exposures[i].maxValue - Min;
+        const int numCodes = compact->numCodes();
+        CodeTables &tables = codeTables[i];
+        tables.weights.resize(numCodes);
+        tables.logResponses.resize(numCodes);
 #ifdef _OPENMP
-            #pragma omp critical
+        #pragma omp parallel for
 #endif
-            vadd(resultCh[c], &response_img, resultCh[c], size);
+        for (int code = 0; code < numCodes; ++code) {
+            const float value = compact->table()[code];
+            // codes outside the range of the exposure never occur
+            if (value < Min || value > exposures[i].maxValue) continue;
+
+            const float v = (value - Min) / range;
+            tables.weights[code] = weight(v);
+            tables.logResponses[code] = xlogf(response(v)) + cadds[i];
         }
+    }
+
+    // Every tile of the output is owned by a single thread, which streams the
+    // same tile of all the exposures through normalize -> weight -> response
+    // -> log and accumulates in place, so no synchronisation is needed.
+    // Exposure of the merged values happens in the same pass, while the tile
+    // is still in cache.
+    const float cmul = 1.f / channels;
+    const int tilesPerRow = (W + TILE_WIDTH - 1) / TILE_WIDTH;
+    const int numTiles = tilesPerRow * int(height);
 
 #ifdef _OPENMP
-        #pragma omp critical
+    vector<float> maxValues(omp_get_max_threads(), numeric_limits<float>::min());
+    #pragma omp parallel
+#else
+    vector<float> maxValues(1, numeric_limits<float>::min());
 #endif
-        vadd(&weight_sum, &w, &weight_sum, size);
-    }
+    {
 #ifdef _OPENMP
-    omp_set_nested(oldNested);
+        const int t = omp_get_thread_num();
+#else
+        const int t = 0;
 #endif
+        vector<float> wsum(TILE_WIDTH);
+        vector<float> w(TILE_WIDTH);
+        vector<float> resp(channels * TILE_WIDTH);
+        float maxval = numeric_limits<float>::min();
 
-    for (int c = 0; c < channels; c++) {
 #ifdef _OPENMP
-        #pragma omp parallel for
+        #pragma omp for schedule(dynamic, 16)
 #endif
-        for(int y = 0; y < H; ++y) {
-            int x = 0;
-#ifdef __SSE2__
-            for(; x < W - 3; x += 4) {
-                STVFU((*resultCh[c])(x, y), xexpf(LVFU((*resultCh[c])(x,y)) / LVFU(weight_sum(x,y))));
+        for (int tile = 0; tile < numTiles; ++tile) {
+            const int y = tile / tilesPerRow;
+            const int x0 = (tile % tilesPerRow) * TILE_WIDTH;
+            const int n = std::min(TILE_WIDTH, W - x0);
+            const size_t offset = size_t(y) * W + x0;
+
+            float *out[channels];
+            for (int c = 0; c < channels; ++c) {
+                out[c] = outputs[c] + offset;
+                std::fill(out[c], out[c] + n, 0.f);
             }
-#endif
-            for(; x < W; ++x) {
-                (*resultCh[c])(x, y) = xexpf((*resultCh[c])(x,y) / weight_sum(x,y));
+            std::fill(wsum.begin(), wsum.begin() + n, 0.f);
+
+            for (int i = 0; i < length; ++i) {
+                const CompactFrame *compact = exposures[i].compact;
+                if (compact != NULL) {
+                    if (compact->getBitDepth() == 8) {
+                        const uint8_t *in[channels];
+                        for (int c = 0; c < channels; ++c) {
+                            in[c] = compact->data8(c) + offset;
+                        }
+                        accumulateCodes(in, n, cmul, codeTables[i],
+                                        wsum.data(), out);
+                    } else {
+                        const uint16_t *in[channels];
+                        for (int c = 0; c < channels; ++c) {
+                            in[c] = compact->data16(c) + offset;
+                        }
+                        accumulateCodes(in, n, cmul, codeTables[i],
+                                        wsum.data(), out);
+                    }
+                    continue;
+                }
+
+                const float *in[channels];
+                for (int c = 0; c < channels; ++c) {
+                    in[c] = exposures[i].channels[c] + offset;
+                }
+                const float Min = exposures[i].minValue;
+                const float range = exposures[i].maxValue - Min;
+
+                for (int x = 0; x < n; ++x) {
+                    const float v0 = (in[0][x] - Min) / range;
+                    const float v1 = (in[1][x] - Min) / range;
+                    const float v2 = (in[2][x] - Min) / range;
+
+                    w[x] = cmul * (weight(v0) + weight(v1) + weight(v2));
+                    resp[x] = response(v0);
+                    resp[TILE_WIDTH + x] = response(v1);
+                    resp[2 * TILE_WIDTH + x] = response(v2);
+                    wsum[x] += w[x];
+                }
+
+                for (int c = 0; c < channels; ++c) {
+                    vlogAccumulate(resp.data() + c * TILE_WIDTH, w.data(),
+                                   cadds[i], out[c], n);
+                }
             }
-        }
-    }
-    float cmax[3];
-    for (int c = 0; c < channels; c++) {
-        float max = numeric_limits<float>::min();
-#ifdef _OPENMP
-    #pragma omp parallel for reduction(max:max)
-#endif
-        for (size_t k = 0; k < size; k++) {
-            float val = (*resultCh[c])(k);
-            if(std::isnormal(val)) {
-                max = std::max(max, val);
+
+            for (int c = 0; c < channels; ++c) {
+                float *o = out[c];
+                vexpDiv(o, wsum.data(), o, n);
+                for (int x = 0; x < n; ++x) {
+                    if (std::isnormal(o[x])) {
+                        maxval = std::max(maxval, o[x]);
+                    }
+                }
             }
         }
-        cmax[c] = max;
+        maxValues[t] = maxval;
     }
 
-    float Max = max(cmax[0], max(cmax[1], cmax[2]));
+    return *std::max_element(maxValues.begin(), maxValues.end());
+}
 
-    for (int c = 0; c < channels; c++) {
+void DebevecOperator::finalize(float *const outputs[3], size_t size,
+                               float maxValue) {
+    // TODO: Investigate why scaling hdr yields better result
+    for (int c = 0; c < 3; c++) {
+        float *out = outputs[c];
 #ifdef _OPENMP
     #pragma omp parallel for
 #endif
-        for (size_t k = 0; k < size; k++) {
-            float val = (*resultCh[c])(k);
-            if(!std::isnormal(val)) {
-                (*resultCh[c])(k) = Max;
-            }
+        for (int k = 0; k < int(size); k++) {
+            const float val = out[k];
+            out[k] = 0.1f * (std::isnormal(val) ? val : maxValue);
         }
     }
+}
 
-    // TODO: Investigate why scaling hdr yields better result
-    for (int c = 0; c < channels; c++) {
-#ifdef _OPENMP
-    #pragma omp parallel for
-#endif
-        for (size_t k = 0; k < size; k++) {
-            (*resultCh[c])(k) *= 0.1f;
+void DebevecOperator::computeFusion(ResponseCurve &response,
+                                    WeightFunction &weight,
+                                    const vector<FrameEnhanced> &images,
+                                    pfs::Frame &frame) {
+    pfs::utils::TraceScope trace("merge_debevec", "fusion");
+    assert(images.size() != 0);
+
+    const size_t W = images[0].getWidth();
+    const size_t H = images[0].getHeight();
+    trace.setBytes(W * H * 3 * sizeof(float));
+
+    // the inputs are not modified: each exposure is normalized on the fly
+    vector<Exposure> exposures(images.size());
+    for (size_t i = 0; i < images.size(); ++i) {
+        exposures[i].averageLuminance = images[i].averageLuminance();
+        if (images[i].isCompact()) {
+            const CompactFrame &image = *images[i].compactFrame();
+            assert(image.getWidth() == W);
+            assert(image.getHeight() == H);
+
+            exposures[i].compact = &image;
+            channelsMinMax(image, exposures[i].minValue,
+                           exposures[i].maxValue);
+            continue;
+        }
+
+        const Frame &image = *images[i].frame();
+        assert(image.getWidth() == W);
+        assert(image.getHeight() == H);
+
+        const Channel *Ch[3];
+        image.getXYZChannels(Ch[0], Ch[1], Ch[2]);
+        for (int c = 0; c < 3; ++c) {
+            exposures[i].channels[c] = Ch[c]->data();
         }
+        channelsMinMax(image, exposures[i].minValue, exposures[i].maxValue);
     }
 
-#ifdef TIMER_PROFILING
-    f_timer.stop_and_update();
-    cout << "MergeDebevec = " << f_timer.get_time() << " msec"
-              << endl;
-#endif
+    frame.resize(W, H);
+    Channel *Ch[3];
+    frame.createXYZChannels(Ch[0], Ch[1], Ch[2]);
+    float *const resultCh[3] = {Ch[0]->data(), Ch[1]->data(), Ch[2]->data()};
+
+    const float Max = mergeRows(response, weight, exposures, resultCh, W, H);
+    finalize(resultCh, W * H, Max);
 }
 
 }  // libhdr
@@ -43,6 +43,47 @@ class DebevecOperator : public IFusionOperator {
 
     FusionOperator getType() const { return DEBEVEC; }
 
+    //! \brief exposure, as read by mergeRows(): pointers to its three
+    //! channels (or its CompactFrame), plus the range used to normalize them
+    struct Exposure {
+        Exposure()
+            : compact(NULL),
+              minValue(0.f),
+              maxValue(0.f),
+              averageLuminance(0.f) {
+            channels[0] = channels[1] = channels[2] = NULL;
+        }
+
+        const float *channels[3];
+        //! \brief when not NULL, the samples are read from the codes of the
+        //! CompactFrame and \c channels is ignored
+        const CompactFrame *compact;
+        float minValue;
+        float maxValue;
+        float averageLuminance;
+    };
+
+    //! \brief min and max value of the three channels of \a frame
+    static void channelsMinMax(const pfs::Frame &frame, float &minValue,
+                               float &maxValue);
+    static void channelsMinMax(const CompactFrame &frame, float &minValue,
+                               float &maxValue);
+
+    //! \brief merge \a height rows of \a width pixels of \a exposures into
+    //! the three channels \a outputs. The weight and the log response of
+    //! CompactFrame exposures are tabulated once per code.
+    //! \return max normal value of the merged pixels, to be passed to
+    //! finalize()
+    static float mergeRows(const ResponseCurve &response,
+                           const WeightFunction &weight,
+                           const std::vector<Exposure> &exposures,
+                           float *const outputs[3], size_t width,
+                           size_t height);
+
+    //! \brief replace the non normal values of the merged channels with
+    //! \a maxValue and scale them to the final range
+    static void finalize(float *const outputs[3], size_t size, float maxValue);
+
    private:
     void computeFusion(ResponseCurve &response, WeightFunction &weight,
                        const std::vector<FrameEnhanced> &frames,
@@ -0,0 +1,840 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ *  Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ */
+
+#include "feature_alignment.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <Libpfs/array2d.h>
+#include <Libpfs/colorspace/xyz.h>
+#include <Libpfs/frame.h>
+#include <Libpfs/utils/trace.h>
+
+using namespace std;
+using namespace pfs;
+
+#ifndef NDEBUG
+#define PRINT_DEBUG(str) std::cerr << "FeatureAlignment: " << str << std::endl
+#else
+#define PRINT_DEBUG(str)
+#endif
+
+namespace libhdr {
+
+AlignmentTransform::AlignmentTransform() {
+    std::fill(m_h, m_h + 9, 0.);
+    m_h[0] = m_h[4] = m_h[8] = 1.;
+}
+
+AlignmentTransform AlignmentTransform::translation(double dx, double dy) {
+    AlignmentTransform t;
+    t(0, 2) = dx;
+    t(1, 2) = dy;
+    return t;
+}
+
+void AlignmentTransform::apply(double x, double y, double &xo,
+                               double &yo) const {
+    const double w = m_h[6] * x + m_h[7] * y + m_h[8];
+    xo = (m_h[0] * x + m_h[1] * y + m_h[2]) / w;
+    yo = (m_h[3] * x + m_h[4] * y + m_h[5]) / w;
+}
+
+AlignmentTransform AlignmentTransform::operator*(
+    const AlignmentTransform &first) const {
+    AlignmentTransform r;
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            double v = 0.;
+            for (int k = 0; k < 3; ++k) {
+                v += (*this)(i, k) * first(k, j);
+            }
+            r(i, j) = v;
+        }
+    }
+    return r;
+}
+
+namespace {
+
+//! \brief level 0 is at working resolution, each following level is half the
+//! size of the previous one
+typedef std::vector<Array2Df> Pyramid;
+
+struct Feature {
+    int x;
+    int y;
+};
+
+struct Match {
+    double x, y;  // position in the first image
+    double u, v;  // position in the second image
+};
+
+//! \brief luminance of \a frame, box filtered and decimated by \a factor
+void getDecimatedLuminance(const Frame &frame, size_t factor, Array2Df &out) {
+    const Channel *R;
+    const Channel *G;
+    const Channel *B;
+    frame.getXYZChannels(R, G, B);
+
+    const size_t width = frame.getWidth() / factor;
+    const size_t height = frame.getHeight() / factor;
+    out.resize(width, height);
+
+    const float norm = 1.f / (factor * factor);
+    const colorspace::ConvertRGB2Y toY;
+
+#pragma omp parallel for
+    for (int y = 0; y < static_cast<int>(height); ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            float sum = 0.f;
+            for (size_t j = y * factor; j < (y + 1) * factor; ++j) {
+                for (size_t i = x * factor; i < (x + 1) * factor; ++i) {
+                    float lum;
+                    toY((*R)(i, j), (*G)(i, j), (*B)(i, j), lum);
+                    sum += lum;
+                }
+            }
+            out(x, y) = sum * norm;
+        }
+    }
+}
+
+//! \brief replace every value with its rank in [0, 1], which makes the
+//! image independent from the exposure (as long as the response is
+//! monotonic)
+void equalize(Array2Df &img) {
+    static const size_t NUM_BINS = 4096;
+    static const float MIN_LUM = 1e-8f;
+
+    float minLog = std::numeric_limits<float>::max();
+    float maxLog = -std::numeric_limits<float>::max();
+    for (Array2Df::iterator it = img.begin(); it != img.end(); ++it) {
+        *it = std::log(std::max(*it, MIN_LUM));
+        minLog = std::min(minLog, *it);
+        maxLog = std::max(maxLog, *it);
+    }
+
+    if (maxLog - minLog <= 0.f) {
+        img.fill(0.5f);
+        return;
+    }
+
+    const float scale = (NUM_BINS - 1) / (maxLog - minLog);
+
+    std::vector<float> cdf(NUM_BINS, 0.f);
+    for (Array2Df::iterator it = img.begin(); it != img.end(); ++it) {
+        cdf[static_cast<size_t>((*it - minLog) * scale)] += 1.f;
+    }
+    // centered cdf: pixels in the same bin share the mid rank
+    float acc = 0.f;
+    const float norm = 1.f / img.size();
+    for (size_t i = 0; i < NUM_BINS; ++i) {
+        const float count = cdf[i];
+        cdf[i] = (acc + 0.5f * count) * norm;
+        acc += count;
+    }
+
+    for (Array2Df::iterator it = img.begin(); it != img.end(); ++it) {
+        *it = cdf[static_cast<size_t>((*it - minLog) * scale)];
+    }
+}
+
+void halve(const Array2Df &in, Array2Df &out) {
+    const size_t width = in.getCols() / 2;
+    const size_t height = in.getRows() / 2;
+    out.resize(width, height);
+
+#pragma omp parallel for
+    for (int y = 0; y < static_cast<int>(height); ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            out(x, y) = 0.25f * (in(2 * x, 2 * y) + in(2 * x + 1, 2 * y) +
+                                 in(2 * x, 2 * y + 1) +
+                                 in(2 * x + 1, 2 * y + 1));
+        }
+    }
+}
+
+void buildPyramid(const Frame &frame, size_t factor, Pyramid &pyramid) {
+    static const size_t COARSEST_SIZE = 128;
+
+    pyramid.resize(1);
+    getDecimatedLuminance(frame, factor, pyramid[0]);
+    equalize(pyramid[0]);
+
+    while (std::max(pyramid.back().getCols(), pyramid.back().getRows()) >
+               COARSEST_SIZE &&
+           std::min(pyramid.back().getCols(), pyramid.back().getRows()) >= 32) {
+        Array2Df next;
+        halve(pyramid.back(), next);
+        pyramid.push_back(Array2Df());
+        pyramid.back().swap(next);
+    }
+}
+
+//! \brief mean absolute difference between a(x) and b(x + (dx, dy)) over the
+//! overlapping area
+float translationError(const Array2Df &a, const Array2Df &b, int dx, int dy) {
+    const int width = a.getCols();
+    const int height = a.getRows();
+
+    const int x0 = std::max(0, -dx);
+    const int x1 = std::min(width, width - dx);
+    const int y0 = std::max(0, -dy);
+    const int y1 = std::min(height, height - dy);
+
+    if (x1 - x0 < width / 2 || y1 - y0 < height / 2) {
+        return std::numeric_limits<float>::max();
+    }
+
+    double err = 0.;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            err += std::fabs(a(x, y) - b(x + dx, y + dy));
+        }
+    }
+    return static_cast<float>(err / ((x1 - x0) * (y1 - y0)));
+}
+
+//! \brief coarse to fine search of the translation t such that
+//! b(x + t) ~ a(x), in pixels of level 0
+void coarseTranslation(const Pyramid &a, const Pyramid &b, int &tx, int &ty) {
+    static const int COARSEST_RADIUS = 6;
+
+    tx = 0;
+    ty = 0;
+    for (int level = static_cast<int>(a.size()) - 1; level >= 0; --level) {
+        const int radius =
+            (level == static_cast<int>(a.size()) - 1) ? COARSEST_RADIUS : 1;
+
+        float minErr = std::numeric_limits<float>::max();
+        int bestX = tx;
+        int bestY = ty;
+        for (int j = -radius; j <= radius; ++j) {
+            for (int i = -radius; i <= radius; ++i) {
+                float err = translationError(a[level], b[level], tx + i,
+                                             ty + j);
+                if (err < minErr) {
+                    minErr = err;
+                    bestX = tx + i;
+                    bestY = ty + j;
+                }
+            }
+        }
+        tx = bestX;
+        ty = bestY;
+
+        if (level > 0) {
+            tx *= 2;
+            ty *= 2;
+        }
+    }
+}
+
+//! \brief Shi-Tomasi corners, at most one per cell of a regular grid
+void detectFeatures(const Array2Df &img, const FeatureAlignmentParams &params,
+                    std::vector<Feature> &features) {
+    static const int WINDOW = 2;
+
+    const int width = img.getCols();
+    const int height = img.getRows();
+    const int margin = params.patchRadius + params.searchRadius + WINDOW + 2;
+
+    features.clear();
+    if (width <= 2 * margin || height <= 2 * margin) return;
+
+    Array2Df gxx(width, height);
+    Array2Df gxy(width, height);
+    Array2Df gyy(width, height);
+
+#pragma omp parallel for
+    for (int y = 1; y < height - 1; ++y) {
+        for (int x = 1; x < width - 1; ++x) {
+            const float gx = 0.5f * (img(x + 1, y) - img(x - 1, y));
+            const float gy = 0.5f * (img(x, y + 1) - img(x, y - 1));
+            gxx(x, y) = gx * gx;
+            gxy(x, y) = gx * gy;
+            gyy(x, y) = gy * gy;
+        }
+    }
+
+    Array2Df score(width, height);
+    score.fill(0.f);
+
+#pragma omp parallel for
+    for (int y = margin; y < height - margin; ++y) {
+        for (int x = margin; x < width - margin; ++x) {
+            float sxx = 0.f;
+            float sxy = 0.f;
+            float syy = 0.f;
+            for (int j = -WINDOW; j <= WINDOW; ++j) {
+                for (int i = -WINDOW; i <= WINDOW; ++i) {
+                    sxx += gxx(x + i, y + j);
+                    sxy += gxy(x + i, y + j);
+                    syy += gyy(x + i, y + j);
+                }
+            }
+            // smallest eigenvalue of the structure tensor
+            const float tr = 0.5f * (sxx + syy);
+            const float det = sxx * syy - sxy * sxy;
+            const float s = tr - std::sqrt(std::max(tr * tr - det, 0.f));
+
+            score(x, y) = s;
+        }
+    }
+
+    const float maxScore = *std::max_element(score.begin(), score.end());
+    if (maxScore <= 0.f) return;
+    const float minScore = 1e-3f * maxScore;
+
+    const int cellSize = std::max<int>(
+        2 * WINDOW + 1, std::max(width, height) / std::max<int>(
+                                                      params.gridSize, 1));
+    for (int cy = margin; cy < height - margin; cy += cellSize) {
+        for (int cx = margin; cx < width - margin; cx += cellSize) {
+            Feature best = {-1, -1};
+            float bestScore = minScore;
+
+            for (int y = cy; y < std::min(cy + cellSize, height - margin);
+                 ++y) {
+                for (int x = cx; x < std::min(cx + cellSize, width - margin);
+                     ++x) {
+                    if (score(x, y) > bestScore) {
+                        bestScore = score(x, y);
+                        best.x = x;
+                        best.y = y;
+                    }
+                }
+            }
+
+            if (best.x >= 0) features.push_back(best);
+        }
+    }
+}
+
+//! \brief normalized cross correlation between the patch of \a a centered in
+//! (\a ax, \a ay) and the one of \a b centered in (\a bx, \a by)
+float correlation(const Array2Df &a, int ax, int ay, const Array2Df &b, int bx,
+                  int by, int radius) {
+    const int n = (2 * radius + 1) * (2 * radius + 1);
+
+    float sa = 0.f, sb = 0.f, saa = 0.f, sbb = 0.f, sab = 0.f;
+    for (int j = -radius; j <= radius; ++j) {
+        for (int i = -radius; i <= radius; ++i) {
+            const float va = a(ax + i, ay + j);
+            const float vb = b(bx + i, by + j);
+            sa += va;
+            sb += vb;
+            saa += va * va;
+            sbb += vb * vb;
+            sab += va * vb;
+        }
+    }
+
+    const float cov = sab - sa * sb / n;
+    const float varA = saa - sa * sa / n;
+    const float varB = sbb - sb * sb / n;
+    const float den = std::sqrt(varA * varB);
+
+    return den > 1e-12f ? cov / den : 0.f;
+}
+
+//! \brief vertex of the parabola through (-1, l), (0, c), (1, r)
+double subpixelOffset(float l, float c, float r) {
+    const double den = l - 2. * c + r;
+    if (std::fabs(den) < 1e-12) return 0.;
+    return std::max(-0.5, std::min(0.5, 0.5 * (l - r) / den));
+}
+
+void matchFeatures(const Array2Df &a, const Array2Df &b,
+                   const std::vector<Feature> &features, int tx, int ty,
+                   const FeatureAlignmentParams &params,
+                   std::vector<Match> &matches) {
+    const int width = b.getCols();
+    const int height = b.getRows();
+    const int pr = params.patchRadius;
+    const int sr = params.searchRadius;
+    const int numFeatures = features.size();
+
+    std::vector<Match> candidates(numFeatures);
+    std::vector<char> valid(numFeatures, 0);
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int f = 0; f < numFeatures; ++f) {
+        const Feature &p = features[f];
+        const int qx = p.x + tx;
+        const int qy = p.y + ty;
+
+        // the search window, plus one pixel for the subpixel refinement, must
+        // be inside the second image
+        if (qx - sr - pr - 1 < 0 || qx + sr + pr + 1 >= width ||
+            qy - sr - pr - 1 < 0 || qy + sr + pr + 1 >= height) {
+            continue;
+        }
+
+        float best = -2.f;
+        int bx = qx;
+        int by = qy;
+        for (int j = -sr; j <= sr; ++j) {
+            for (int i = -sr; i <= sr; ++i) {
+                float c = correlation(a, p.x, p.y, b, qx + i, qy + j, pr);
+                if (c > best) {
+                    best = c;
+                    bx = qx + i;
+                    by = qy + j;
+                }
+            }
+        }
+
+        if (best < params.minCorrelation) continue;
+
+        const double ox = subpixelOffset(
+            correlation(a, p.x, p.y, b, bx - 1, by, pr), best,
+            correlation(a, p.x, p.y, b, bx + 1, by, pr));
+        const double oy = subpixelOffset(
+            correlation(a, p.x, p.y, b, bx, by - 1, pr), best,
+            correlation(a, p.x, p.y, b, bx, by + 1, pr));
+
+        Match &m = candidates[f];
+        m.x = p.x;
+        m.y = p.y;
+        m.u = bx + ox;
+        m.v = by + oy;
+        valid[f] = 1;
+    }
+
+    matches.clear();
+    for (int f = 0; f < numFeatures; ++f) {
+        if (valid[f]) matches.push_back(candidates[f]);
+    }
+}
+
+//! \brief solve the n x n system A x = b (row major) by Gaussian elimination
+//! with partial pivoting. \a A and \a b are overwritten.
+bool solve(std::vector<double> &A, std::vector<double> &b, int n) {
+    for (int col = 0; col < n; ++col) {
+        int pivot = col;
+        for (int row = col + 1; row < n; ++row) {
+            if (std::fabs(A[row * n + col]) > std::fabs(A[pivot * n + col])) {
+                pivot = row;
+            }
+        }
+        if (std::fabs(A[pivot * n + col]) < 1e-12) return false;
+
+        if (pivot != col) {
+            for (int k = 0; k < n; ++k) {
+                std::swap(A[col * n + k], A[pivot * n + k]);
+            }
+            std::swap(b[col], b[pivot]);
+        }
+
+        for (int row = col + 1; row < n; ++row) {
+            const double f = A[row * n + col] / A[col * n + col];
+            for (int k = col; k < n; ++k) {
+                A[row * n + k] -= f * A[col * n + k];
+            }
+            b[row] -= f * b[col];
+        }
+    }
+
+    for (int row = n - 1; row >= 0; --row) {
+        double v = b[row];
+        for (int k = row + 1; k < n; ++k) {
+            v -= A[row * n + k] * b[k];
+        }
+        b[row] = v / A[row * n + row];
+    }
+    return true;
+}
+
+//! \brief similarity moving the centroid of the points in the origin and
+//! their average distance to sqrt(2)
+AlignmentTransform normalization(const std::vector<Match> &matches,
+                                 const std::vector<size_t> &subset,
+                                 bool second) {
+    double cx = 0., cy = 0.;
+    for (size_t i = 0; i < subset.size(); ++i) {
+        const Match &m = matches[subset[i]];
+        cx += second ? m.u : m.x;
+        cy += second ? m.v : m.y;
+    }
+    cx /= subset.size();
+    cy /= subset.size();
+
+    double dist = 0.;
+    for (size_t i = 0; i < subset.size(); ++i) {
+        const Match &m = matches[subset[i]];
+        const double dx = (second ? m.u : m.x) - cx;
+        const double dy = (second ? m.v : m.y) - cy;
+        dist += std::sqrt(dx * dx + dy * dy);
+    }
+    dist /= subset.size();
+
+    const double s = dist > 1e-12 ? std::sqrt(2.) / dist : 1.;
+
+    AlignmentTransform t;
+    t(0, 0) = t(1, 1) = s;
+    t(0, 2) = -s * cx;
+    t(1, 2) = -s * cy;
+    return t;
+}
+
+AlignmentTransform inverseNormalization(const AlignmentTransform &t) {
+    const double s = t(0, 0);
+    AlignmentTransform r;
+    r(0, 0) = r(1, 1) = 1. / s;
+    r(0, 2) = -t(0, 2) / s;
+    r(1, 2) = -t(1, 2) / s;
+    return r;
+}
+
+size_t minimalSampleSize(FeatureAlignmentModel model) {
+    switch (model) {
+        case FEATURE_ALIGN_TRANSLATION:
+            return 1;
+        case FEATURE_ALIGN_AFFINE:
+            return 3;
+        case FEATURE_ALIGN_HOMOGRAPHY:
+        default:
+            return 4;
+    }
+}
+
+//! \brief least squares fit of \a model on the matches in \a subset
+bool fitModel(FeatureAlignmentModel model, const std::vector<Match> &matches,
+              const std::vector<size_t> &subset, AlignmentTransform &result) {
+    if (subset.size() < minimalSampleSize(model)) return false;
+
+    if (model == FEATURE_ALIGN_TRANSLATION) {
+        double dx = 0., dy = 0.;
+        for (size_t i = 0; i < subset.size(); ++i) {
+            dx += matches[subset[i]].u - matches[subset[i]].x;
+            dy += matches[subset[i]].v - matches[subset[i]].y;
+        }
+        result = AlignmentTransform::translation(dx / subset.size(),
+                                                 dy / subset.size());
+        return true;
+    }
+
+    const AlignmentTransform np = normalization(matches, subset, false);
+    const AlignmentTransform nq = normalization(matches, subset, true);
+
+    const int n = (model == FEATURE_ALIGN_AFFINE) ? 6 : 8;
+    std::vector<double> AtA(n * n, 0.);
+    std::vector<double> Atb(n, 0.);
+    double row[8];
+
+    for (size_t i = 0; i < subset.size(); ++i) {
+        const Match &m = matches[subset[i]];
+        double x, y, u, v;
+        np.apply(m.x, m.y, x, y);
+        nq.apply(m.u, m.v, u, v);
+
+        for (int eq = 0; eq < 2; ++eq) {
+            std::fill(row, row + n, 0.);
+            const int off = eq * 3;
+            const double rhs = (eq == 0) ? u : v;
+
+            row[off + 0] = x;
+            row[off + 1] = y;
+            row[off + 2] = 1.;
+            if (model == FEATURE_ALIGN_HOMOGRAPHY) {
+                row[6] = -rhs * x;
+                row[7] = -rhs * y;
+            }
+
+            for (int r = 0; r < n; ++r) {
+                for (int c = 0; c < n; ++c) {
+                    AtA[r * n + c] += row[r] * row[c];
+                }
+                Atb[r] += row[r] * rhs;
+            }
+        }
+    }
+
+    if (!solve(AtA, Atb, n)) return false;
+
+    AlignmentTransform h;
+    for (int k = 0; k < 6; ++k) {
+        h(k / 3, k % 3) = Atb[k];
+    }
+    if (model == FEATURE_ALIGN_HOMOGRAPHY) {
+        h(2, 0) = Atb[6];
+        h(2, 1) = Atb[7];
+    }
+
+    result = inverseNormalization(nq) * h * np;
+    if (std::fabs(result(2, 2)) < 1e-12) return false;
+
+    // keep h22 = 1
+    const double scale = 1. / result(2, 2);
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            result(r, c) *= scale;
+        }
+    }
+    return true;
+}
+
+void findInliers(const AlignmentTransform &t, const std::vector<Match> &matches,
+                 double threshold, std::vector<size_t> &inliers) {
+    const double threshold2 = threshold * threshold;
+
+    inliers.clear();
+    for (size_t i = 0; i < matches.size(); ++i) {
+        double u, v;
+        t.apply(matches[i].x, matches[i].y, u, v);
+
+        const double du = u - matches[i].u;
+        const double dv = v - matches[i].v;
+        if (du * du + dv * dv < threshold2) inliers.push_back(i);
+    }
+}
+
+bool ransac(const std::vector<Match> &matches,
+            const FeatureAlignmentParams &params, AlignmentTransform &result) {
+    const size_t sampleSize = minimalSampleSize(params.model);
+    if (matches.size() < std::max(sampleSize, params.minInliers)) return false;
+
+    // fixed seed: the same input produces the same alignment
+    std::mt19937 rng(5489u);
+    std::uniform_int_distribution<size_t> pick(0, matches.size() - 1);
+
+    std::vector<size_t> sample;
+    std::vector<size_t> inliers;
+    std::vector<size_t> bestInliers;
+
+    for (int it = 0; it < params.ransacIterations; ++it) {
+        sample.clear();
+        while (sample.size() < sampleSize) {
+            const size_t idx = pick(rng);
+            if (std::find(sample.begin(), sample.end(), idx) == sample.end()) {
+                sample.push_back(idx);
+            }
+        }
+
+        AlignmentTransform hypothesis;
+        if (!fitModel(params.model, matches, sample, hypothesis)) continue;
+
+        findInliers(hypothesis, matches, params.inlierThreshold, inliers);
+        if (inliers.size() > bestInliers.size()) {
+            bestInliers.swap(inliers);
+            if (bestInliers.size() == matches.size()) break;
+        }
+    }
+
+    if (bestInliers.size() < params.minInliers) return false;
+
+    // refine on the consensus set (twice, since the set can grow)
+    for (int refine = 0; refine < 2; ++refine) {
+        if (!fitModel(params.model, matches, bestInliers, result)) {
+            return false;
+        }
+        findInliers(result, matches, params.inlierThreshold, inliers);
+        if (inliers.size() < params.minInliers) return false;
+        bestInliers.swap(inliers);
+    }
+
+    PRINT_DEBUG("RANSAC: " << bestInliers.size() << " inliers out of "
+                           << matches.size() << " matches");
+    return true;
+}
+
+//! \brief transform mapping the coordinates of \a a into the coordinates of
+//! \a b, at working resolution
+AlignmentTransform estimatePair(const Pyramid &a, const Pyramid &b,
+                                const FeatureAlignmentParams &params) {
+    int tx;
+    int ty;
+    coarseTranslation(a, b, tx, ty);
+    PRINT_DEBUG("coarse translation (" << tx << "," << ty << ")");
+
+    std::vector<Feature> features;
+    detectFeatures(a[0], params, features);
+
+    std::vector<Match> matches;
+    matchFeatures(a[0], b[0], features, tx, ty, params, matches);
+    PRINT_DEBUG(features.size() << " features, " << matches.size()
+                                << " matches");
+
+    AlignmentTransform result;
+    if (!ransac(matches, params, result)) {
+        PRINT_DEBUG("not enough inliers, using the coarse translation");
+        return AlignmentTransform::translation(tx, ty);
+    }
+    return result;
+}
+
+//! \brief move a transform estimated on images decimated by \a factor to full
+//! resolution
+AlignmentTransform toFullResolution(const AlignmentTransform &t,
+                                    size_t factor) {
+    const double f = factor;
+    const double c = 0.5 * (f - 1.);
+
+    AlignmentTransform s;
+    s(0, 0) = s(1, 1) = f;
+    s(0, 2) = s(1, 2) = c;
+
+    AlignmentTransform sInv;
+    sInv(0, 0) = sInv(1, 1) = 1. / f;
+    sInv(0, 2) = sInv(1, 2) = -c / f;
+
+    return s * t * sInv;
+}
+}  // anonymous namespace
+
+std::vector<AlignmentTransform> feature_alignment_estimate(
+    const std::vector<pfs::FramePtr> &framePtrList,
+    const FeatureAlignmentParams &params) {
+    const int numFrames = framePtrList.size();
+    std::vector<AlignmentTransform> transforms(numFrames);
+    if (numFrames <= 1) return transforms;
+
+    const size_t width = framePtrList[0]->getWidth();
+    const size_t height = framePtrList[0]->getHeight();
+    const size_t factor =
+        std::max<size_t>(1, (std::max(width, height) + params.workingSize - 1) /
+                                std::max<size_t>(params.workingSize, 1));
+    PRINT_DEBUG("width=" << width << ", height=" << height
+                         << ", decimation=" << factor);
+
+    std::vector<Pyramid> pyramids(numFrames);
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < numFrames; ++i) {
+        buildPyramid(*framePtrList[i], factor, pyramids[i]);
+    }
+
+    // pairs are made of adjacent exposures, which are the most similar, and
+    // walk away from the reference. pairTransform[i] maps the frame closer to
+    // the reference into frame i.
+    const int reference = numFrames / 2;
+    std::vector<AlignmentTransform> pairTransform(numFrames);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < numFrames; ++i) {
+        if (i == reference) continue;
+
+        const int previous = (i > reference) ? i - 1 : i + 1;
+        pairTransform[i] = toFullResolution(
+            estimatePair(pyramids[previous], pyramids[i], params), factor);
+    }
+
+    for (int i = reference + 1; i < numFrames; ++i) {
+        transforms[i] = pairTransform[i] * transforms[i - 1];
+    }
+    for (int i = reference - 1; i >= 0; --i) {
+        transforms[i] = pairTransform[i] * transforms[i + 1];
+    }
+
+    return transforms;
+}
+
+void feature_alignment_warp(pfs::Frame &frame,
+                            const AlignmentTransform &transform) {
+    const int width = frame.getWidth();
+    const int height = frame.getHeight();
+
+    Frame warped(width, height);
+
+    const ChannelContainer &channels = frame.getChannels();
+    std::vector<const Channel *> in;
+    std::vector<Channel *> out;
+    for (ChannelContainer::const_iterator it = channels.begin();
+         it != channels.end(); ++it) {
+        in.push_back(*it);
+        out.push_back(warped.createChannel((*it)->getName()));
+    }
+    const size_t numChannels = in.size();
+
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            double sx;
+            double sy;
+            transform.apply(x, y, sx, sy);
+
+            if (!(sx >= 0. && sy >= 0. && sx <= width - 1 &&
+                  sy <= height - 1)) {
+                for (size_t c = 0; c < numChannels; ++c) {
+                    (*out[c])(x, y) = 0.f;
+                }
+                continue;
+            }
+
+            const int x0 = static_cast<int>(sx);
+            const int y0 = static_cast<int>(sy);
+            const int x1 = std::min(x0 + 1, width - 1);
+            const int y1 = std::min(y0 + 1, height - 1);
+
+            const float fx = static_cast<float>(sx - x0);
+            const float fy = static_cast<float>(sy - y0);
+
+            const float w00 = (1.f - fx) * (1.f - fy);
+            const float w10 = fx * (1.f - fy);
+            const float w01 = (1.f - fx) * fy;
+            const float w11 = fx * fy;
+
+            for (size_t c = 0; c < numChannels; ++c) {
+                const Channel &src = *in[c];
+                (*out[c])(x, y) = w00 * src(x0, y0) + w10 * src(x1, y0) +
+                                  w01 * src(x0, y1) + w11 * src(x1, y1);
+            }
+        }
+    }
+
+    pfs::copyTags(&frame, &warped);
+    frame.swap(warped);
+}
+
+void feature_alignment(std::vector<pfs::FramePtr> &framePtrList,
+                       const FeatureAlignmentParams &params) {
+    if (framePtrList.size() <= 1) return;
+
+    pfs::utils::TraceScope trace("align_features", "alignment");
+    trace.setBytes(framePtrList.size() * framePtrList[0]->getWidth() *
+                   framePtrList[0]->getHeight() * 3 * sizeof(float));
+
+    std::vector<AlignmentTransform> transforms =
+        feature_alignment_estimate(framePtrList, params);
+
+    for (size_t i = 0; i < framePtrList.size(); ++i) {
+        const AlignmentTransform &t = transforms[i];
+        if (t(0, 0) == 1. && t(0, 1) == 0. && t(0, 2) == 0. &&
+            t(1, 0) == 0. && t(1, 1) == 1. && t(1, 2) == 0. &&
+            t(2, 0) == 0. && t(2, 1) == 0.) {
+            continue;
+        }
+
+        PRINT_DEBUG("warping frame " << i);
+        feature_alignment_warp(*framePtrList[i], t);
+    }
+}
+
+}  // libhdr
@@ -0,0 +1,123 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ *  Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ */
+
+//! \brief In-memory, feature based alignment of a bracketed set of images
+//! \author agent <agent@local>
+//!
+//! Corners are detected on an exposure invariant (histogram equalized)
+//! luminance at reduced resolution, matched between adjacent exposures with
+//! normalized cross correlation and fed to a RANSAC estimator of an affine or
+//! projective transform. All the frames are then warped towards the middle
+//! exposure, channel by channel in a single parallel pass. No temporary files
+//! and no external process are involved.
+
+#ifndef LIBHDR_FEATURE_ALIGNMENT_H
+#define LIBHDR_FEATURE_ALIGNMENT_H
+
+#include <cstddef>
+#include <vector>
+
+#include <Libpfs/frame.h>
+
+namespace libhdr {
+
+enum FeatureAlignmentModel {
+    FEATURE_ALIGN_TRANSLATION = 0,
+    FEATURE_ALIGN_AFFINE,
+    FEATURE_ALIGN_HOMOGRAPHY
+};
+
+struct FeatureAlignmentParams {
+    FeatureAlignmentParams()
+        : model(FEATURE_ALIGN_HOMOGRAPHY),
+          workingSize(1536),
+          gridSize(24),
+          patchRadius(6),
+          searchRadius(5),
+          minCorrelation(0.8f),
+          ransacIterations(1000),
+          inlierThreshold(1.5f),
+          minInliers(12) {}
+
+    //! \brief transformation estimated between the exposures
+    FeatureAlignmentModel model;
+    //! \brief maximum size (in pixels) of the longest side of the images
+    //! used for detection and matching
+    size_t workingSize;
+    //! \brief the image is divided in gridSize x gridSize cells, and at most
+    //! one feature is retained in each cell
+    size_t gridSize;
+    //! \brief radius of the correlation window
+    int patchRadius;
+    //! \brief radius of the search window around the predicted position
+    int searchRadius;
+    //! \brief minimum normalized cross correlation of a valid match
+    float minCorrelation;
+    //! \brief number of RANSAC hypotheses
+    int ransacIterations;
+    //! \brief reprojection error (in pixels at working resolution) of an
+    //! inlier
+    float inlierThreshold;
+    //! \brief below this number of inliers the model falls back to the
+    //! translation found by the coarse search
+    size_t minInliers;
+};
+
+//! \brief 3x3 transformation of homogeneous pixel coordinates, row major
+class AlignmentTransform {
+   public:
+    AlignmentTransform();
+
+    static AlignmentTransform translation(double dx, double dy);
+
+    double &operator()(int row, int col) { return m_h[row * 3 + col]; }
+    double operator()(int row, int col) const { return m_h[row * 3 + col]; }
+
+    //! \brief map (\a x, \a y) into (\a xo, \a yo)
+    void apply(double x, double y, double &xo, double &yo) const;
+
+    //! \brief transformation equivalent to applying \a first and then *this
+    AlignmentTransform operator*(const AlignmentTransform &first) const;
+
+   private:
+    double m_h[9];
+};
+
+//! \brief estimate, for each frame, the transform mapping the coordinates of
+//! the reference frame (the middle one) into the coordinates of that frame
+std::vector<AlignmentTransform> feature_alignment_estimate(
+    const std::vector<pfs::FramePtr> &framePtrList,
+    const FeatureAlignmentParams &params = FeatureAlignmentParams());
+
+//! \brief resample \a frame, such that pixel \c p of the result is pixel
+//! <tt>transform(p)</tt> of the input. Pixels falling outside are set to 0.
+void feature_alignment_warp(pfs::Frame &frame,
+                            const AlignmentTransform &transform);
+
+//! \brief align \a framePtrList in place
+void feature_alignment(
+    std::vector<pfs::FramePtr> &framePtrList,
+    const FeatureAlignmentParams &params = FeatureAlignmentParams());
+
+}  // libhdr
+
+#endif  // LIBHDR_FEATURE_ALIGNMENT_H
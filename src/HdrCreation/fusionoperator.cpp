@@ -29,6 +29,7 @@
 
 #include <Libpfs/frame.h>
 #include <Libpfs/utils/string.h>
+#include <Libpfs/utils/trace.h>
 
 using namespace pfs;
 using namespace std;
@@ -43,8 +44,38 @@ IFusionOperator::IFusionOperator() {}
 pfs::Frame *IFusionOperator::computeFusion(
     ResponseCurve &response, WeightFunction &weight,
     const std::vector<FrameEnhanced> &frames) {
+    assert(!frames.empty());
+    pfs::utils::TraceScope trace("fusion", "fusion");
+    trace.setBytes(frames.size() * frames[0].getWidth() *
+                   frames[0].getHeight() * 3 * sizeof(float));
+
+    bool mixed = false;
+    for (size_t i = 1; i < frames.size(); ++i) {
+        if (frames[i].isCompact() != frames[0].isCompact() ||
+            (frames[i].isCompact() &&
+             frames[i].compactFrame()->getBitDepth() !=
+                 frames[0].compactFrame()->getBitDepth())) {
+            mixed = true;
+        }
+    }
+
     pfs::Frame *frame = new pfs::Frame;
-    computeFusion(response, weight, frames, *frame);
+    if (!mixed) {
+        computeFusion(response, weight, frames, *frame);
+        return frame;
+    }
+
+    std::vector<FrameEnhanced> floatFrames;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (frames[i].isCompact()) {
+            floatFrames.push_back(
+                FrameEnhanced(FramePtr(frames[i].compactFrame()->toFrame()),
+                              frames[i].averageLuminance()));
+        } else {
+            floatFrames.push_back(frames[i]);
+        }
+    }
+    computeFusion(response, weight, floatFrames, *frame);
     return frame;
 }
 
@@ -83,6 +114,8 @@ void fillDataLists(const vector<FrameEnhanced> &frames, DataList &redChannels,
 
     // build temporary data structure
     for (size_t exp = 0; exp < frames.size(); ++exp) {
+        assert(!frames[exp].isCompact());
+
         Channel *red;
         Channel *green;
         Channel *blue;
@@ -29,6 +29,7 @@
 //! merged image, ready for tonemap or other processing
 //! \note This the first header written specifically for LibHDR (milestone!)
 
+#include <HdrCreation/compactframe.h>
 #include <HdrCreation/responses.h>
 #include <HdrCreation/weights.h>
 #include <Libpfs/frame.h>
@@ -37,17 +38,34 @@ namespace libhdr {
 namespace fusion {
 
 //! \brief This class contains a (shared) pointer to a frame, plus its average
-//! luminance, to be used during the fusion process
+//! luminance, to be used during the fusion process. The frame is either a
+//! float frame or a CompactFrame.
 class FrameEnhanced {
    public:
     FrameEnhanced(const pfs::FramePtr &frame, float averageLuminance)
         : m_frame(frame), m_averageLuminance(averageLuminance) {}
 
+    FrameEnhanced(const CompactFramePtr &frame, float averageLuminance)
+        : m_compactFrame(frame), m_averageLuminance(averageLuminance) {}
+
+    //! \brief float frame, NULL if the exposure is stored as a CompactFrame
     const pfs::FramePtr &frame() const { return m_frame; }
+    const CompactFramePtr &compactFrame() const { return m_compactFrame; }
+    bool isCompact() const { return m_compactFrame.get() != NULL; }
+
+    size_t getWidth() const {
+        return isCompact() ? m_compactFrame->getWidth() : m_frame->getWidth();
+    }
+    size_t getHeight() const {
+        return isCompact() ? m_compactFrame->getHeight()
+                           : m_frame->getHeight();
+    }
+
     float averageLuminance() const { return m_averageLuminance; }
 
    private:
     pfs::FramePtr m_frame;
+    CompactFramePtr m_compactFrame;
     float m_averageLuminance;
 };
 
@@ -69,6 +87,9 @@ class IFusionOperator {
     //! Valid values are "debevec", "robertson" and "robertson-auto"
     static FusionOperator fromString(const std::string &type);
 
+    //! \brief merge \a frames. The exposures can be float frames or
+    //! CompactFrame: when both kinds (or CompactFrame of different bit depth)
+    //! are mixed, the compact ones are decoded to float first.
     pfs::Frame *computeFusion(ResponseCurve &response, WeightFunction &weight,
                               const std::vector<FrameEnhanced> &frames);
 
@@ -77,6 +98,8 @@ class IFusionOperator {
    protected:
     IFusionOperator();
 
+    //! \brief \a frames are either all float frames, or all CompactFrame with
+    //! the same bit depth
     virtual void computeFusion(ResponseCurve &response, WeightFunction &weight,
                                const std::vector<FrameEnhanced> &frames,
                                pfs::Frame &outFrame) = 0;
@@ -84,6 +107,7 @@ class IFusionOperator {
 
 typedef vector<float *> DataList;
 
+//! \brief pointers to the channels of \a frames, which must be float frames
 void fillDataLists(const vector<FrameEnhanced> &frames, DataList &redChannels,
                    DataList &greenChannels, DataList &blueChannels);
 
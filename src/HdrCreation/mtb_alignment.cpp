@@ -22,12 +22,14 @@
  */
 
 #include "mtb_alignment.h"
+#include "mtb_bitmap.h"
 
 #include <iso646.h>
 #include <boost/lexical_cast.hpp>
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <vector>
 
 #include <Common/global.h>
@@ -37,6 +39,7 @@
 #include <Libpfs/frame.h>
 #include <Libpfs/manip/resize.h>
 #include <Libpfs/manip/shift.h>
+#include <Libpfs/utils/trace.h>
 #include <Libpfs/utils/transform.h>
 
 #include <Libpfs/io/jpegwriter.h>
@@ -52,97 +55,109 @@ using namespace pfs;
 #endif
 
 typedef Array2D<uint8_t> Array2D8u;
-typedef Array2D<bool> Array2Db;
 
 namespace libhdr {
 
-long XORimages(const Array2Db &img1, const Array2Db &mask1,
-               const Array2Db &img2, const Array2Db &mask2) {
-    long err = 0;
-    for (size_t i = 0; i < img1.getRows(); i++) {
-        Array2Db::const_iterator p1 = img1.row_begin(i);
-        Array2Db::const_iterator p2 = img2.row_begin(i);
-        Array2Db::const_iterator m1 = mask1.row_begin(i);
-        Array2Db::const_iterator m2 = mask2.row_begin(i);
-
-        for (size_t j = 0; j < img1.getCols(); j++) {
-            err += (long)((*p1++ xor *p2++) and *m1++ and *m2++);
-        }
-    }
-    return err;
-}
-
 // setThreshold gets the data from the input image and creates the threshold
 // and mask images.
 // Those are bitmap (0,1 valued) with depth()=1
 void setThreshold(const Array2D8u &in, const int threshold, const int noise,
-                  Array2Db &threshold_out, Array2Db &mask_out) {
+                  MTBBitmap &threshold_out, MTBBitmap &mask_out) {
     assert(in.getCols() == threshold_out.getCols());
     assert(in.getRows() == threshold_out.getRows());
     assert(in.getCols() == mask_out.getCols());
     assert(in.getRows() == mask_out.getRows());
 
+    const size_t cols = in.getCols();
+    const size_t wordsPerRow = threshold_out.getWordsPerRow();
+
     for (size_t i = 0; i < in.getRows(); i++) {
         Array2D8u::const_iterator inp = in.row_begin(i);
 
-        Array2Db::iterator outp = threshold_out.row_begin(i);
-        Array2Db::iterator maskp = mask_out.row_begin(i);
+        MTBBitmap::WordType *outp = threshold_out.row(i);
+        MTBBitmap::WordType *maskp = mask_out.row(i);
+
+        for (size_t w = 0; w < wordsPerRow; ++w) {
+            MTBBitmap::WordType outWord = 0;
+            MTBBitmap::WordType maskWord = 0;
+
+            const size_t bits = std::min<size_t>(
+                MTBBitmap::BITS_PER_WORD, cols - w * MTBBitmap::BITS_PER_WORD);
+            for (size_t b = 0; b < bits; ++b, ++inp) {
+                const int value = *inp;
+
+                outWord |= MTBBitmap::WordType(value >= threshold) << b;
+                maskWord |= MTBBitmap::WordType(value <= (threshold - noise) ||
+                                                value >= (threshold + noise))
+                            << b;
+            }
 
-        for (size_t j = 0; j < in.getCols(); j++) {
-            *outp++ = *inp < threshold ? 0 : 1;
-            *maskp++ =
-                (*inp > (threshold - noise)) && (*inp < (threshold + noise))
-                    ? 0
-                    : 1;
-            ++inp;
+            outp[w] = outWord;
+            maskp[w] = maskWord;
         }
     }
 }
 
-void getExpShift(const Array2D8u &img1, const int median1,
-                 const Array2D8u &img2, const int median2, const int noise,
-                 const int shift_bits, int &shift_x, int &shift_y) {
-    assert(img1.getCols() == img2.getCols());
-    assert(img1.getRows() == img2.getRows());
+namespace {
 
-    int curr_x = 0;
-    int curr_y = 0;
+//! \brief threshold and exclusion bitmaps of one level of the MTB pyramid
+struct MTBLevel {
+    MTBBitmap threshold;
+    MTBBitmap mask;
+};
+
+//! \brief level 0 is at full resolution, each following level is half the
+//! size of the previous one
+typedef std::vector<MTBLevel> MTBPyramid;
+
+void buildPyramid(const Array2D8u &lum, const int median, const int noise,
+                  const int shift_bits, MTBPyramid &pyramid) {
+    pyramid.resize(shift_bits + 1);
 
-    if (shift_bits > 0) {
-        Array2D8u img1small(img1.getCols() / 2, img1.getRows() / 2);
-        Array2D8u img2small(img2.getCols() / 2, img2.getRows() / 2);
+    Array2D8u current(lum);
+    for (int level = 0; level <= shift_bits; ++level) {
+        MTBLevel &l = pyramid[level];
+
+        l.threshold = MTBBitmap(current.getCols(), current.getRows());
+        l.mask = MTBBitmap(current.getCols(), current.getRows());
+        setThreshold(current, median, noise, l.threshold, l.mask);
+
+        if (level < shift_bits) {
+            Array2D8u smaller(current.getCols() / 2, current.getRows() / 2);
+            pfs::resize(current, smaller, BilinearInterp);
+            current.swap(smaller);
+        }
+    }
+}
 
-        pfs::resize(img1, img1small, BilinearInterp);
-        pfs::resize(img2, img2small, BilinearInterp);
+void getExpShift(const MTBPyramid &img1, const MTBPyramid &img2,
+                 const int level, int &shift_x, int &shift_y) {
+    int curr_x = 0;
+    int curr_y = 0;
 
-        getExpShift(img1small, median1, img2small, median2, noise,
-                    shift_bits - 1, curr_x, curr_y);
+    if (level + 1 < static_cast<int>(img1.size())) {
+        getExpShift(img1, img2, level + 1, curr_x, curr_y);
         curr_x *= 2;
         curr_y *= 2;
     }
 
-    Array2Db img1threshold(img1.getCols(), img1.getRows());
-    Array2Db img1mask(img1.getCols(), img1.getRows());
-    Array2Db img2threshold(img2.getCols(), img2.getRows());
-    Array2Db img2mask(img2.getCols(), img2.getRows());
+    const MTBLevel &l1 = img1[level];
+    const MTBLevel &l2 = img2[level];
 
-    setThreshold(img1, median1, noise, img1threshold, img1mask);
-    setThreshold(img2, median2, noise, img2threshold, img2mask);
+    assert(l1.threshold.getCols() == l2.threshold.getCols());
+    assert(l1.threshold.getRows() == l2.threshold.getRows());
 
-    Array2Db img2_shifted(img2.getCols(), img2.getRows());
-    Array2Db img2mask_shifted(img2.getCols(), img2.getRows());
+    shift_x = curr_x;
+    shift_y = curr_y;
 
-    int minerr = img1.size();
+    long minerr = std::numeric_limits<long>::max();
     for (int i = -1; i <= 1; i++) {
         for (int j = -1; j <= 1; j++) {
             int dx = curr_x + i;
             int dy = curr_y + j;
 
-            pfs::shift(img2threshold, dx, dy, img2_shifted);
-            pfs::shift(img2mask, dx, dy, img2mask_shifted);
-
-            long err = XORimages(img1threshold, img1mask, img2_shifted,
-                                 img2mask_shifted);
+            long err = XORimages(l1.threshold, l1.mask, l2.threshold, l2.mask,
+                                 dx, dy);
 
             if (err < minerr) {
                 minerr = err;
@@ -152,9 +167,10 @@ void getExpShift(const Array2D8u &img1, const int median1,
         }
     }
 
-    PRINT_DEBUG("getExpShift::Level " << shift_bits << " shift (" << shift_x
-                                      << "," << shift_y << ")");
+    PRINT_DEBUG("getExpShift::Level " << level << " shift (" << shift_x << ","
+                                      << shift_y << ")");
 }
+}  // anonymous namespace
 
 int getLum(const Frame &in, Array2D8u &out, double quantile) {
     assert(quantile >= 0.0);
@@ -194,24 +210,6 @@ int getLum(const Frame &in, Array2D8u &out, double quantile) {
     return idx;
 }
 
-void mtbalign(const pfs::Frame &image1, const pfs::Frame &image2,
-              const double quantile, const int noise, const int shift_bits,
-              int &shift_x, int &shift_y) {
-    Array2D8u img1lum;
-    Array2D8u img2lum;
-
-    int median1 = getLum(image1, img1lum, quantile);
-    int median2 = getLum(image2, img2lum, quantile);
-
-    PRINT_DEBUG("align::medians, image 1: " << median1
-                                            << ", image 2: " << median2);
-    getExpShift(img1lum, median1, img2lum, median2, noise, shift_bits, shift_x,
-                shift_y);
-
-    PRINT_DEBUG("align::done, final shift is (" << shift_x << "," << shift_y
-                                                << ")");
-}
-
 static const double quantile = 0.5;
 static const int noise = 4;
 
@@ -221,40 +219,66 @@ void mtb_alignment(std::vector<pfs::FramePtr> &framePtrList) {
     int width = framePtrList[0]->getWidth();
     int height = framePtrList[0]->getHeight();
 
+    pfs::utils::TraceScope trace("align_mtb", "alignment");
+    trace.setBytes(framePtrList.size() * width * height * 3 * sizeof(float));
+
     int shift_bits =
         std::max((int)floor(log2((double)std::min(width, height))) - 6, 0);
     PRINT_DEBUG("width=" << width << ", height=" << height
                          << ", shift_bits=" << shift_bits);
 
+    const int numFrames = framePtrList.size();
+
+    // build the bitmap pyramids once per image: every image but the first and
+    // the last one is part of two pairs
+    vector<MTBPyramid> pyramids(numFrames);
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < numFrames; i++) {
+        Array2D8u lum;
+        int median = getLum(*framePtrList[i], lum, quantile);
+
+        PRINT_DEBUG("median of image " << i << ": " << median);
+
+        buildPyramid(lum, median, noise, shift_bits, pyramids[i]);
+    }
+
     // these arrays contain the shifts of each image (except the 0-th) wrt the
     // previous one
-    vector<int> shiftsX(framePtrList.size() - 1);
-    vector<int> shiftsY(framePtrList.size() - 1);
+    vector<int> shiftsX(numFrames - 1);
+    vector<int> shiftsY(numFrames - 1);
 
-    // find the shitfs
-    for (size_t i = 0; i < framePtrList.size() - 1; i++) {
-        mtbalign(*framePtrList[i], *framePtrList[i + 1], quantile, noise,
-                 shift_bits, shiftsX[i], shiftsY[i]);
+    // find the shifts: all the pairs are independent
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < numFrames - 1; i++) {
+        getExpShift(pyramids[i], pyramids[i + 1], 0, shiftsX[i], shiftsY[i]);
+
+        PRINT_DEBUG("align::done, shift " << i << " is (" << shiftsX[i] << ","
+                                          << shiftsY[i] << ")");
     }
+    pyramids.clear();
 
     PRINT_DEBUG("shifting the images");
-    int originalsize = framePtrList.size();
 
-    int cumulativeX = 0;
-    int cumulativeY = 0;
     // shift the images (apply the shifts starting from the second (index=1))
-    for (int i = 1; i < originalsize; i++) {
-        cumulativeX += shiftsX[i - 1];
-        cumulativeY += shiftsY[i - 1];
+    vector<int> cumulativeX(numFrames, 0);
+    vector<int> cumulativeY(numFrames, 0);
+    for (int i = 1; i < numFrames; i++) {
+        cumulativeX[i] = cumulativeX[i - 1] + shiftsX[i - 1];
+        cumulativeY[i] = cumulativeY[i - 1] + shiftsY[i - 1];
+    }
 
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 1; i < numFrames; i++) {
         // avoid shifting if cumulativeX and cumulativeY are zero
-        if (cumulativeX || cumulativeY) {
+        if (cumulativeX[i] || cumulativeY[i]) {
             PRINT_DEBUG("Cumulative shift for image "
-                        << i << " = (" << cumulativeX << "," << cumulativeY
-                        << ")");
+                        << i << " = (" << cumulativeX[i] << ","
+                        << cumulativeY[i] << ")");
 
-            FramePtr shiftedFrame(
-                pfs::shift(*framePtrList[i], cumulativeX, cumulativeY));
+            // pfs::shift on a Frame moves the content by (dx, dy), which is
+            // the opposite of the convention used by getExpShift
+            FramePtr shiftedFrame(pfs::shift(
+                *framePtrList[i], -cumulativeX[i], -cumulativeY[i]));
 
             framePtrList[i]->swap(*shiftedFrame);
         }
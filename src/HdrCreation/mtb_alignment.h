@@ -27,6 +27,10 @@
 //! \author Davide Anastasia <davideanastasia@users.sourceforge.net>
 //! Remove dependency from Qt and refactoring for new libhdr library
 
+#ifndef LIBHDR_MTB_ALIGNMENT_H
+#define LIBHDR_MTB_ALIGNMENT_H
+
+#include <stdint.h>
 #include <vector>
 
 #include <Libpfs/array2d_fwd.h>
@@ -34,6 +38,19 @@
 
 namespace libhdr {
 
+class MTBBitmap;
+
+//! \brief Build the threshold bitmap (pixels above the median) and the
+//! exclusion bitmap (pixels further than \a noise from the median) of \a in
+void setThreshold(const pfs::Array2D<uint8_t> &in, const int threshold,
+                  const int noise, MTBBitmap &threshold_out,
+                  MTBBitmap &mask_out);
+
+//! \brief Align \a framePtrList in place. Each image is aligned with respect
+//! to the previous one: the bitmap pyramids are built once per image and all
+//! the pairs are searched concurrently.
 void mtb_alignment(std::vector<pfs::FramePtr> &framePtrList);
 
 }  // libhdr
+
+#endif  // LIBHDR_MTB_ALIGNMENT_H
@@ -0,0 +1,165 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ *  Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ */
+
+//! \brief Bit-packed bitmap used by the MTB alignment
+//! \author agent <agent@local>
+
+#ifndef LIBHDR_MTB_BITMAP_H
+#define LIBHDR_MTB_BITMAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace libhdr {
+
+//! \brief Number of bits set in \a v
+inline int popcount(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(v);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(v));
+#else
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((v * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+//! \brief Two dimensional bitmap storing 64 pixels per word.
+//!
+//! Pixel \c x of a row is stored in bit <tt>x % 64</tt> of word
+//! <tt>x / 64</tt>. Every row starts on a new word and the padding bits at the
+//! end of a row are always zero, so that whole words can be combined with
+//! bitwise operators and counted with \c popcount.
+class MTBBitmap {
+   public:
+    typedef uint64_t WordType;
+    static const size_t BITS_PER_WORD = 64;
+
+    MTBBitmap() : m_data(), m_cols(0), m_rows(0), m_wordsPerRow(0) {}
+
+    MTBBitmap(size_t cols, size_t rows)
+        : m_data(((cols + BITS_PER_WORD - 1) / BITS_PER_WORD) * rows, 0),
+          m_cols(cols),
+          m_rows(rows),
+          m_wordsPerRow((cols + BITS_PER_WORD - 1) / BITS_PER_WORD) {}
+
+    size_t getCols() const { return m_cols; }
+    size_t getRows() const { return m_rows; }
+    size_t getWordsPerRow() const { return m_wordsPerRow; }
+
+    WordType *row(size_t r) { return m_data.data() + r * m_wordsPerRow; }
+    const WordType *row(size_t r) const {
+        return m_data.data() + r * m_wordsPerRow;
+    }
+
+    bool operator()(size_t x, size_t y) const {
+        assert(x < m_cols && y < m_rows);
+        return (row(y)[x / BITS_PER_WORD] >> (x % BITS_PER_WORD)) & 1u;
+    }
+
+    void set(size_t x, size_t y, bool value) {
+        assert(x < m_cols && y < m_rows);
+        WordType &w = row(y)[x / BITS_PER_WORD];
+        const WordType bit = WordType(1) << (x % BITS_PER_WORD);
+        if (value) {
+            w |= bit;
+        } else {
+            w &= ~bit;
+        }
+    }
+
+    //! \brief word \a idx of row \a r, with the image shifted by \a dx
+    //! pixels, such that pixel \c x of the result is pixel \c x+dx of the
+    //! source (as in \c pfs::shift). Pixels outside the bitmap are zero.
+    WordType shiftedWord(size_t r, ptrdiff_t idx, ptrdiff_t dx) const {
+        const WordType *data = row(r);
+        const ptrdiff_t wpr = static_cast<ptrdiff_t>(m_wordsPerRow);
+        const ptrdiff_t bit = idx * ptrdiff_t(BITS_PER_WORD) + dx;
+
+        // floor division, valid for negative values of bit
+        ptrdiff_t q = bit / ptrdiff_t(BITS_PER_WORD);
+        ptrdiff_t s = bit % ptrdiff_t(BITS_PER_WORD);
+        if (s < 0) {
+            s += BITS_PER_WORD;
+            --q;
+        }
+
+        const WordType lo = (q >= 0 && q < wpr) ? data[q] : 0;
+        if (s == 0) return lo;
+
+        const WordType hi = (q + 1 >= 0 && q + 1 < wpr) ? data[q + 1] : 0;
+        return (lo >> s) | (hi << (BITS_PER_WORD - s));
+    }
+
+   private:
+    std::vector<WordType> m_data;
+
+    size_t m_cols;
+    size_t m_rows;
+    size_t m_wordsPerRow;
+};
+
+//! \brief Count the pixels where the threshold bitmaps differ and both
+//! exclusion masks are set, with the second image shifted by (\a dx, \a dy)
+//!
+//! Equivalent to shifting \a img2 and \a mask2 with \c pfs::shift and
+//! counting <tt>(img1 xor img2) and mask1 and mask2</tt>, but without
+//! materializing the shifted bitmaps.
+inline long XORimages(const MTBBitmap &img1, const MTBBitmap &mask1,
+                      const MTBBitmap &img2, const MTBBitmap &mask2, int dx,
+                      int dy) {
+    assert(img1.getCols() == img2.getCols());
+    assert(img1.getRows() == img2.getRows());
+
+    const ptrdiff_t rows = static_cast<ptrdiff_t>(img1.getRows());
+    const ptrdiff_t wpr = static_cast<ptrdiff_t>(img1.getWordsPerRow());
+
+    long err = 0;
+    for (ptrdiff_t r = std::max<ptrdiff_t>(0, -dy),
+                   rEnd = std::min<ptrdiff_t>(rows, rows - dy);
+         r < rEnd; ++r) {
+        const MTBBitmap::WordType *p1 = img1.row(r);
+        const MTBBitmap::WordType *m1 = mask1.row(r);
+        const size_t r2 = static_cast<size_t>(r + dy);
+
+        for (ptrdiff_t w = 0; w < wpr; ++w) {
+            const MTBBitmap::WordType p2 = img2.shiftedWord(r2, w, dx);
+            const MTBBitmap::WordType m2 = mask2.shiftedWord(r2, w, dx);
+
+            err += popcount((p1[w] ^ p2) & m1[w] & m2);
+        }
+    }
+    return err;
+}
+
+}  // libhdr
+
+#endif  // LIBHDR_MTB_BITMAP_H
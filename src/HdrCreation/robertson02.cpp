@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <iterator>
 #include <vector>
@@ -40,6 +41,7 @@
 #include <boost/numeric/conversion/bounds.hpp>
 
 #include <Libpfs/array2d.h>
+#include <stdint.h>
 
 #ifndef NDEBUG
 #define PRINT_DEBUG(str) std::cerr << "Robertson: " << str << std::endl
@@ -50,18 +52,82 @@
 using namespace pfs;
 using namespace std;
 
-namespace libhdr {
-namespace fusion {
+namespace {
+using namespace libhdr::fusion;
 
-void RobertsonOperator::applyResponse(
-    ResponseCurve &response, WeightFunction &weight, ResponseChannel channel,
-    const DataList &inputData, float *outputData, size_t width, size_t height,
-    float minAllowedValue, float maxAllowedValue, const float *arrayofexptime) {
-    assert(inputData.size());
+//! \brief samples of one channel of float exposures
+class FloatSamples {
+   public:
+    explicit FloatSamples(const DataList &data) : m_data(data) {}
+
+    FloatSamples(const vector<FrameEnhanced> &frames, int channel)
+        : m_data(frames.size()) {
+        for (size_t i = 0; i < frames.size(); ++i) {
+            Channel *Ch[3];
+            frames[i].frame()->getXYZChannels(Ch[0], Ch[1], Ch[2]);
+            m_data[i] = Ch[channel]->data();
+        }
+    }
+
+    size_t size() const { return m_data.size(); }
+    float operator()(size_t i, size_t j) const { return m_data[i][j]; }
+
+   private:
+    DataList m_data;
+};
+
+//! \brief samples of one channel of CompactFrame exposures, decoded through
+//! the table of each exposure
+template <typename T>
+class CompactSamples {
+   public:
+    CompactSamples(const vector<FrameEnhanced> &frames, int channel)
+        : m_codes(frames.size()), m_tables(frames.size()) {
+        for (size_t i = 0; i < frames.size(); ++i) {
+            const CompactFrame &frame = *frames[i].compactFrame();
+            m_codes[i] = codes(frame, channel);
+            m_tables[i] = frame.table();
+        }
+    }
+
+    size_t size() const { return m_codes.size(); }
+    float operator()(size_t i, size_t j) const {
+        return m_tables[i][m_codes[i][j]];
+    }
 
-    size_t saturatedPixels = 0;
+   private:
+    static const T *codes(const CompactFrame &frame, int channel);
+
+    vector<const T *> m_codes;
+    vector<const float *> m_tables;
+};
+
+template <>
+const uint8_t *CompactSamples<uint8_t>::codes(const CompactFrame &frame,
+                                              int channel) {
+    return frame.data8(channel);
+}
+
+template <>
+const uint16_t *CompactSamples<uint16_t>::codes(const CompactFrame &frame,
+                                                int channel) {
+    return frame.data16(channel);
+}
+
+template <typename Samples>
+void applyResponse(ResponseCurve &response, WeightFunction &weight,
+                   ResponseChannel channel, const Samples &samples,
+                   float *outputData, size_t width, size_t height,
+                   float minAllowedValue, float maxAllowedValue,
+                   const float *arrayofexptime) {
+    assert(samples.size());
+
+    long saturatedPixels = 0;
 
     int numPixels = (int)width * height;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+ : saturatedPixels)
+#endif
     for (int j = 0; j < numPixels; ++j) {
         // all exposures for each pixel
         float sum = 0.0f;
@@ -70,8 +136,8 @@ void RobertsonOperator::applyResponse(
         float minti = +1e6f;
 
         // for all exposures
-        for (int i = 0; i < (int)inputData.size(); ++i) {
-            float m = inputData[i][j];
+        for (int i = 0; i < (int)samples.size(); ++i) {
+            float m = samples(i, j);
             float ti = arrayofexptime[i];
 
             float w = weight(m);
@@ -126,70 +192,6 @@ void RobertsonOperator::applyResponse(
     PRINT_DEBUG("Saturated pixels: " << saturatedPixels);
 }
 
-void RobertsonOperator::computeFusion(ResponseCurve &response,
-                                      WeightFunction &weight,
-                                      const std::vector<FrameEnhanced> &frames,
-                                      pfs::Frame &frame) {
-    assert(frames.size());
-
-    size_t numExposures = frames.size();
-    Frame tempFrame(frames[0].frame()->getWidth(),
-                    frames[0].frame()->getHeight());
-
-    Channel *outputRed;
-    Channel *outputGreen;
-    Channel *outputBlue;
-    tempFrame.createXYZChannels(outputRed, outputGreen, outputBlue);
-
-    DataList redChannels(numExposures);
-    DataList greenChannels(numExposures);
-    DataList blueChannels(numExposures);
-
-    fillDataLists(frames, redChannels, greenChannels, blueChannels);
-
-    float maxAllowedValue = weight.maxTrustedValue();
-    float minAllowedValue = weight.minTrustedValue();
-
-    std::vector<float> averageLuminances;
-    std::transform(frames.begin(), frames.end(),
-                   std::back_inserter(averageLuminances),
-                   boost::bind(&FrameEnhanced::averageLuminance, _1));
-
-    applyResponse(response, weight, RESPONSE_CHANNEL_RED, redChannels,
-                  outputRed->data(), tempFrame.getWidth(),
-                  tempFrame.getHeight(), minAllowedValue, maxAllowedValue,
-                  averageLuminances.data());  // red
-    applyResponse(response, weight, RESPONSE_CHANNEL_BLUE, blueChannels,
-                  outputBlue->data(), tempFrame.getWidth(),
-                  tempFrame.getHeight(), minAllowedValue, maxAllowedValue,
-                  averageLuminances.data());  // blue
-    applyResponse(response, weight, RESPONSE_CHANNEL_GREEN, greenChannels,
-                  outputGreen->data(), tempFrame.getWidth(),
-                  tempFrame.getHeight(), minAllowedValue, maxAllowedValue,
-                  averageLuminances.data());  // green
-
-    float cmax[3];
-    cmax[0] = *max_element(outputRed->begin(), outputRed->end());
-    cmax[1] = *max_element(outputGreen->begin(), outputGreen->end());
-    cmax[2] = *max_element(outputBlue->begin(), outputBlue->end());
-    float Max = std::max(cmax[0], std::max(cmax[1], cmax[2]));
-
-    replace_if(outputRed->begin(), outputRed->end(),
-               [](float f) { return !isnormal(f); }, Max);
-    replace_if(outputGreen->begin(), outputGreen->end(),
-               [](float f) { return !isnormal(f); }, Max);
-    replace_if(outputBlue->begin(), outputBlue->end(),
-               [](float f) { return !isnormal(f); }, Max);
-
-    frame.swap(tempFrame);
-}
-
-}  // namespace fusion
-}  // namespace libhdr
-
-namespace {
-using namespace libhdr::fusion;
-
 // maximum iterations after algorithm accepts local minima
 const int MAXIT = 35;  // 500;
 
@@ -258,18 +260,15 @@ void pseudoSort(const float* arrayofexptime, int* i_lower, int* i_upper, int N)
 }
 */
 
-}  // anonymous
-
-namespace libhdr {
-namespace fusion {
-
-void RobertsonOperatorAuto::computeResponse(
-    ResponseCurve &response, WeightFunction &weight, ResponseChannel channel,
-    const DataList &inputData, float *outputData, size_t width, size_t height,
-    float minAllowedValue, float maxAllowedValue, const float *arrayofexptime) {
+template <typename Samples>
+void computeResponse(ResponseCurve &response, WeightFunction &weight,
+                     ResponseChannel channel, const Samples &samples,
+                     float *outputData, size_t width, size_t height,
+                     float minAllowedValue, float maxAllowedValue,
+                     const float *arrayofexptime) {
     typedef ResponseCurve::ResponseContainer ResponseContainer;
 
-    int N = inputData.size();
+    int N = samples.size();
 
     // 0 . initialization
     // a. normalize response
@@ -280,7 +279,7 @@ void RobertsonOperatorAuto::computeResponse(
     // c. set previous delta
     double pdelta = 0.0;
 
-    applyResponse(response, weight, channel, inputData, outputData, width,
+    applyResponse(response, weight, channel, samples, outputData, width,
                   height, minAllowedValue, maxAllowedValue, arrayofexptime);
 
     std::vector<long> cardEm(ResponseCurve::NUM_BINS);
@@ -301,7 +300,7 @@ void RobertsonOperatorAuto::computeResponse(
             // this is probably uglier than necessary, (I copy th FOR in order
             // not to do the IFs inside them) but I don't know how to improve it
             for (size_t j = 0; j < width * height; ++j) {
-                size_t sample = response.getIdx(inputData[i][j]);
+                size_t sample = response.getIdx(samples(i, j));
                 // if ((sample < ResponseCurve::NUM_BINS) && (sample >= 0)) //
                 // sample is
                 // unsigned so always >= 0
@@ -329,8 +328,9 @@ void RobertsonOperatorAuto::computeResponse(
         normalizeI(I);
 
         // 3. Apply new response
-        applyResponse(response, weight, channel, inputData, outputData, width,
-                      height, minAllowedValue, maxAllowedValue, arrayofexptime);
+        applyResponse(response, weight, channel, samples, outputData, width,
+                      height, minAllowedValue, maxAllowedValue,
+                      arrayofexptime);
 
         // 4. Check stopping condition
         double delta = 0.0;
@@ -366,25 +366,134 @@ void RobertsonOperatorAuto::computeResponse(
     }
 }
 
-void RobertsonOperatorAuto::computeFusion(
-    ResponseCurve &response, WeightFunction &weight,
-    const std::vector<FrameEnhanced> &frames, pfs::Frame &frame) {
-    assert(frames.size());
+//! \brief subset of the pixels of \a Samples, addressed through a list of
+//! pixel indices
+template <typename Samples>
+class IndexedSamples {
+   public:
+    IndexedSamples(const Samples &samples, const vector<size_t> &pixels)
+        : m_samples(samples), m_pixels(pixels) {}
+
+    size_t size() const { return m_samples.size(); }
+    float operator()(size_t i, size_t j) const {
+        return m_samples(i, m_pixels[j]);
+    }
 
-    size_t numExposures = frames.size();
-    Frame tempFrame(frames[0].frame()->getWidth(),
-                    frames[0].frame()->getHeight());
+   private:
+    const Samples &m_samples;
+    const vector<size_t> &m_pixels;
+};
+
+// number of irradiance strata of the calibration subset
+const size_t NUM_STRATA = 64;
+
+// candidates examined for each pixel of the calibration subset
+const size_t CANDIDATES_PER_SAMPLE = 4;
+
+//! \brief choose about \a numSamples pixels to calibrate the response.
+//! Candidates on a regular grid are split in strata of (log) irradiance,
+//! estimated from the exposures with a hat weight, so that the whole range
+//! of the sensor is covered. In every stratum the pixels with the lowest
+//! gradient are kept, being the least sensitive to misalignment and noise.
+//! \return indices of the chosen pixels, in increasing order
+template <typename Samples>
+vector<size_t> calibrationPixels(const Samples &samples, size_t width,
+                                 size_t height, const float *arrayofexptime,
+                                 size_t numSamples) {
+    const size_t N = samples.size();
+    const size_t step = std::max<size_t>(
+        1, size_t(std::sqrt(double(width) * height /
+                            double(CANDIDATES_PER_SAMPLE * numSamples))));
+
+    if (width < 2 || height < 2) return vector<size_t>();
+
+    // the gradient needs the next pixel and the next row
+    const size_t cols = (width - 1 + step - 1) / step;
+    const size_t rows = (height - 1 + step - 1) / step;
+
+    vector<float> logIrradiance(cols * rows);
+    vector<float> gradient(cols * rows);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (int r = 0; r < int(rows); ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            const size_t j = size_t(r) * step * width + c * step;
+            float sum = 0.f;
+            float div = 0.f;
+            float grad = 0.f;
+            for (size_t i = 0; i < N; ++i) {
+                const float m = samples(i, j);
+                const float w = 1.001f - std::fabs(2.f * m - 1.f);
+                sum += w * m / arrayofexptime[i];
+                div += w;
+                grad += std::fabs(samples(i, j + 1) - m) +
+                        std::fabs(samples(i, j + width) - m);
+            }
+            const size_t k = size_t(r) * cols + c;
+            logIrradiance[k] = std::log(std::max(sum / div, 1e-8f));
+            gradient[k] = grad;
+        }
+    }
 
-    Channel *outputRed;
-    Channel *outputGreen;
-    Channel *outputBlue;
-    tempFrame.createXYZChannels(outputRed, outputGreen, outputBlue);
+    const float minLog =
+        *std::min_element(logIrradiance.begin(), logIrradiance.end());
+    const float maxLog =
+        *std::max_element(logIrradiance.begin(), logIrradiance.end());
+    const float scale =
+        (maxLog > minLog) ? (NUM_STRATA - 1) / (maxLog - minLog) : 0.f;
 
-    DataList redChannels(numExposures);
-    DataList greenChannels(numExposures);
-    DataList blueChannels(numExposures);
+    vector<vector<size_t> > strata(NUM_STRATA);
+    for (size_t k = 0; k < logIrradiance.size(); ++k) {
+        strata[size_t((logIrradiance[k] - minLog) * scale)].push_back(k);
+    }
 
-    fillDataLists(frames, redChannels, greenChannels, blueChannels);
+    // fill the strata from the smallest, such that the samples left by the
+    // strata with few candidates go to the others
+    std::sort(strata.begin(), strata.end(),
+              [](const vector<size_t> &a, const vector<size_t> &b) {
+                  return a.size() < b.size();
+              });
+
+    vector<size_t> pixels;
+    pixels.reserve(numSamples);
+    size_t remaining = numSamples;
+    for (size_t s = 0; s < strata.size(); ++s) {
+        vector<size_t> &stratum = strata[s];
+        const size_t quota =
+            std::min(stratum.size(), remaining / (strata.size() - s));
+        remaining -= quota;
+
+        std::nth_element(stratum.begin(), stratum.begin() + quota,
+                         stratum.end(), [&gradient](size_t a, size_t b) {
+                             return gradient[a] < gradient[b];
+                         });
+        for (size_t q = 0; q < quota; ++q) {
+            const size_t r = stratum[q] / cols;
+            const size_t c = stratum[q] % cols;
+            pixels.push_back(r * step * width + c * step);
+        }
+    }
+    std::sort(pixels.begin(), pixels.end());
+
+    PRINT_DEBUG("Calibration on " << pixels.size() << " pixels (step "
+                                  << step << ")");
+    return pixels;
+}
+
+//! \brief merge the three channels of \a frames into \a frame, calibrating
+//! the response first when \a calibrate is true
+template <typename Samples>
+void robertsonFusion(bool calibrate, size_t calibrationSamples,
+                     ResponseCurve &response, WeightFunction &weight,
+                     const std::vector<FrameEnhanced> &frames,
+                     pfs::Frame &frame) {
+    const size_t width = frames[0].getWidth();
+    const size_t height = frames[0].getHeight();
+    Frame tempFrame(width, height);
+
+    Channel *outputs[3];
+    tempFrame.createXYZChannels(outputs[0], outputs[1], outputs[2]);
 
     float maxAllowedValue = weight.maxTrustedValue();
     float minAllowedValue = weight.minTrustedValue();
@@ -394,37 +503,108 @@ void RobertsonOperatorAuto::computeFusion(
                    std::back_inserter(averageLuminances),
                    boost::bind(&FrameEnhanced::averageLuminance, _1));
 
-    // red
-    computeResponse(response, weight, RESPONSE_CHANNEL_RED, redChannels,
-                    outputRed->data(), tempFrame.getWidth(),
-                    tempFrame.getHeight(), minAllowedValue, maxAllowedValue,
-                    averageLuminances.data());
-    // green
-    computeResponse(response, weight, RESPONSE_CHANNEL_GREEN, greenChannels,
-                    outputGreen->data(), tempFrame.getWidth(),
-                    tempFrame.getHeight(), minAllowedValue, maxAllowedValue,
-                    averageLuminances.data());
-    // blue
-    computeResponse(response, weight, RESPONSE_CHANNEL_BLUE, blueChannels,
-                    outputBlue->data(), tempFrame.getWidth(),
-                    tempFrame.getHeight(), minAllowedValue, maxAllowedValue,
-                    averageLuminances.data());
+    const ResponseChannel channels[3] = {
+        RESPONSE_CHANNEL_RED, RESPONSE_CHANNEL_GREEN, RESPONSE_CHANNEL_BLUE};
+
+    // the calibration of large images runs on a subset of the pixels, the
+    // calibrated response is then applied to the whole image
+    const bool sampled = calibrate && calibrationSamples != 0 &&
+                         width * height > calibrationSamples;
+    if (calibrate) {
+        // every channel has its own response: they are calibrated in
+        // parallel
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+        for (int c = 0; c < 3; ++c) {
+            const Samples samples(frames, c);
+            if (!sampled) {
+                computeResponse(response, weight, channels[c], samples,
+                                outputs[c]->data(), width, height,
+                                minAllowedValue, maxAllowedValue,
+                                averageLuminances.data());
+                continue;
+            }
+
+            const vector<size_t> pixels =
+                calibrationPixels(samples, width, height,
+                                  averageLuminances.data(), calibrationSamples);
+            vector<float> calibrated(pixels.size());
+            computeResponse(response, weight, channels[c],
+                            IndexedSamples<Samples>(samples, pixels),
+                            calibrated.data(), pixels.size(), 1,
+                            minAllowedValue, maxAllowedValue,
+                            averageLuminances.data());
+        }
+    }
+    if (!calibrate || sampled) {
+        for (int c = 0; c < 3; ++c) {
+            applyResponse(response, weight, channels[c], Samples(frames, c),
+                          outputs[c]->data(), width, height, minAllowedValue,
+                          maxAllowedValue, averageLuminances.data());
+        }
+    }
 
     float cmax[3];
-    cmax[0] = *max_element(outputRed->begin(), outputRed->end());
-    cmax[1] = *max_element(outputGreen->begin(), outputGreen->end());
-    cmax[2] = *max_element(outputBlue->begin(), outputBlue->end());
+    for (int c = 0; c < 3; ++c) {
+        cmax[c] = *max_element(outputs[c]->begin(), outputs[c]->end());
+    }
     float Max = std::max(cmax[0], std::max(cmax[1], cmax[2]));
 
-    replace_if(outputRed->begin(), outputRed->end(),
-               [](float f) { return !isnormal(f); }, Max);
-    replace_if(outputGreen->begin(), outputGreen->end(),
-               [](float f) { return !isnormal(f); }, Max);
-    replace_if(outputBlue->begin(), outputBlue->end(),
-               [](float f) { return !isnormal(f); }, Max);
+    for (int c = 0; c < 3; ++c) {
+        replace_if(outputs[c]->begin(), outputs[c]->end(),
+                   [](float f) { return !isnormal(f); }, Max);
+    }
 
     frame.swap(tempFrame);
 }
 
+//! \brief dispatch on the storage of \a frames
+void robertsonFusion(bool calibrate, size_t calibrationSamples,
+                     ResponseCurve &response, WeightFunction &weight,
+                     const std::vector<FrameEnhanced> &frames,
+                     pfs::Frame &frame) {
+    assert(frames.size());
+
+    if (!frames[0].isCompact()) {
+        robertsonFusion<FloatSamples>(calibrate, calibrationSamples, response,
+                                      weight, frames, frame);
+    } else if (frames[0].compactFrame()->getBitDepth() == 8) {
+        robertsonFusion<CompactSamples<uint8_t> >(
+            calibrate, calibrationSamples, response, weight, frames, frame);
+    } else {
+        robertsonFusion<CompactSamples<uint16_t> >(
+            calibrate, calibrationSamples, response, weight, frames, frame);
+    }
+}
+
+}  // anonymous
+
+namespace libhdr {
+namespace fusion {
+
+void RobertsonOperator::applyResponse(
+    ResponseCurve &response, WeightFunction &weight, ResponseChannel channel,
+    const DataList &inputData, float *outputData, size_t width, size_t height,
+    float minAllowedValue, float maxAllowedValue, const float *arrayofexptime) {
+    ::applyResponse(response, weight, channel, FloatSamples(inputData),
+                    outputData, width, height, minAllowedValue,
+                    maxAllowedValue, arrayofexptime);
+}
+
+void RobertsonOperator::computeFusion(ResponseCurve &response,
+                                      WeightFunction &weight,
+                                      const std::vector<FrameEnhanced> &frames,
+                                      pfs::Frame &frame) {
+    robertsonFusion(false, 0, response, weight, frames, frame);
+}
+
+void RobertsonOperatorAuto::computeFusion(
+    ResponseCurve &response, WeightFunction &weight,
+    const std::vector<FrameEnhanced> &frames, pfs::Frame &frame) {
+    robertsonFusion(true, m_calibrationSamples, response, weight, frames,
+                    frame);
+}
+
 }  // namespace fusion
 }  // namespace libhdr
@@ -39,35 +39,47 @@ class RobertsonOperator : public IFusionOperator {
 
     FusionOperator getType() const { return ROBERTSON; }
 
+    //! \brief merge \a channel of the \a width x \a height pixels of
+    //! \a inputData into \a outputData. Rows are independent, so the
+    //! exposures can be merged one band at the time.
+    static void applyResponse(ResponseCurve &response, WeightFunction &weight,
+                              ResponseChannel channel,
+                              const DataList &inputData, float *outputData,
+                              size_t width, size_t height,
+                              float minAllowedValue, float maxAllowedValue,
+                              const float *arrayofexptime);
+
    private:
     void computeFusion(ResponseCurve &response, WeightFunction &weight,
                        const std::vector<FrameEnhanced> &frames,
                        pfs::Frame &frame);
-
-   protected:
-    void applyResponse(ResponseCurve &response, WeightFunction &weight,
-                       ResponseChannel channel, const DataList &inputData,
-                       float *outputData, size_t width, size_t height,
-                       float minAllowedValue, float maxAllowedValue,
-                       const float *arrayofexptime);
 };
 
 class RobertsonOperatorAuto : public RobertsonOperator {
    public:
-    RobertsonOperatorAuto() : RobertsonOperator() {}
+    //! \brief pixels (per channel) used by default to calibrate the response
+    static const size_t DEFAULT_CALIBRATION_SAMPLES = (1 << 17);
+
+    //! \param calibrationSamples images larger than \a calibrationSamples
+    //! pixels calibrate the response on a stratified subset of this size,
+    //! then apply it to the whole image. 0 calibrates on all the pixels
+    explicit RobertsonOperatorAuto(
+        size_t calibrationSamples = DEFAULT_CALIBRATION_SAMPLES)
+        : RobertsonOperator(), m_calibrationSamples(calibrationSamples) {}
 
     FusionOperator getType() const { return ROBERTSON_AUTO; }
 
+    size_t getCalibrationSamples() const { return m_calibrationSamples; }
+    void setCalibrationSamples(size_t samples) {
+        m_calibrationSamples = samples;
+    }
+
    private:
     void computeFusion(ResponseCurve &response, WeightFunction &weight,
                        const std::vector<FrameEnhanced> &frames,
                        pfs::Frame &outFrame);
 
-    void computeResponse(ResponseCurve &response, WeightFunction &weight,
-                         ResponseChannel channel, const DataList &inputData,
-                         float *outputData, size_t width, size_t height,
-                         float minAllowedValue, float maxAllowedValue,
-                         const float *arrayofexptime);
+    size_t m_calibrationSamples;
 };
 
 }  // fusion
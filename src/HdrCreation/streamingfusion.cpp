@@ -0,0 +1,270 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ */
+
+//! \author agent <agent@local>
+
+#include <HdrCreation/streamingfusion.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+#include <HdrCreation/debevec.h>
+#include <HdrCreation/robertson02.h>
+#include <Libpfs/frame.h>
+#include <Libpfs/utils/trace.h>
+
+#ifndef NDEBUG
+#define PRINT_DEBUG(str) std::cerr << "StreamingFusion: " << str << std::endl
+#else
+#define PRINT_DEBUG(str)
+#endif
+
+using namespace std;
+using namespace pfs;
+using namespace pfs::io;
+
+namespace libhdr {
+namespace fusion {
+
+namespace {
+//! \brief range and decimated copy of the exposures, gathered by the first
+//! scan of the files
+struct ExposureStats {
+    ExposureStats()
+        : minValue(numeric_limits<float>::max()),
+          maxValue(numeric_limits<float>::min()) {}
+
+    float minValue;
+    float maxValue;
+    FramePtr decimated;
+};
+
+//! \brief copy every \a step -th pixel of every \a step -th row of \a band
+//! (whose first row is \a firstRow of the image) into \a decimated
+void decimateBand(const Frame &band, size_t firstRow, size_t step,
+                  Frame &decimated) {
+    const Channel *in[3];
+    band.getXYZChannels(in[0], in[1], in[2]);
+    Channel *out[3];
+    decimated.getXYZChannels(out[0], out[1], out[2]);
+
+    const size_t W = decimated.getWidth();
+    for (size_t y = (step - firstRow % step) % step; y < band.getHeight();
+         y += step) {
+        const size_t yo = (firstRow + y) / step;
+        if (yo >= decimated.getHeight()) break;
+
+        for (int c = 0; c < 3; ++c) {
+            for (size_t x = 0; x < W; ++x) {
+                (*out[c])(x, yo) = (*in[c])(x * step, y);
+            }
+        }
+    }
+}
+
+//! \brief first scan of the exposures: range of every exposure, and
+//! decimated copy for the response calibration
+void scanExposures(const vector<StreamingExposure> &exposures, size_t W,
+                   size_t H, bool needsDecimated,
+                   const StreamingFusionParams &params,
+                   vector<ExposureStats> &stats) {
+    const size_t step = std::max<size_t>(
+        1, (std::max(W, H) + params.calibrationSize - 1) /
+               params.calibrationSize);
+
+    Frame band;
+    for (size_t i = 0; i < exposures.size(); ++i) {
+        FrameReader &reader = *exposures[i].reader();
+        if (needsDecimated) {
+            stats[i].decimated.reset(new Frame(W / step, H / step));
+            Channel *X, *Y, *Z;
+            stats[i].decimated->createXYZChannels(X, Y, Z);
+        }
+
+        for (size_t y0 = 0; y0 < H; y0 += params.bandHeight) {
+            const size_t rows = std::min(params.bandHeight, H - y0);
+            reader.readBand(band, y0, rows, params.readParams);
+
+            float minValue, maxValue;
+            DebevecOperator::channelsMinMax(band, minValue, maxValue);
+            stats[i].minValue = std::min(stats[i].minValue, minValue);
+            stats[i].maxValue = std::max(stats[i].maxValue, maxValue);
+
+            if (needsDecimated) {
+                decimateBand(band, y0, step, *stats[i].decimated);
+            }
+        }
+    }
+}
+
+//! \brief replace the non normal values of the merged channels with
+//! \a maxValue, as RobertsonOperator does
+void replaceNonNormal(float *const outputs[3], size_t size, float maxValue) {
+    for (int c = 0; c < 3; ++c) {
+        float *out = outputs[c];
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+        for (int k = 0; k < int(size); ++k) {
+            if (!std::isnormal(out[k])) {
+                out[k] = maxValue;
+            }
+        }
+    }
+}
+}
+
+void streamingFusion(FusionOperator type, ResponseCurve &response,
+                     WeightFunction &weight,
+                     const vector<StreamingExposure> &exposures,
+                     Frame &outFrame, const StreamingFusionParams &params) {
+    pfs::utils::TraceScope trace("fusion_streaming", "fusion");
+    assert(exposures.size() != 0);
+    assert(params.bandHeight > 0);
+
+    for (size_t i = 0; i < exposures.size(); ++i) {
+        exposures[i].reader()->openBands(params.readParams);
+    }
+
+    const size_t W = exposures[0].reader()->width();
+    const size_t H = exposures[0].reader()->height();
+    for (size_t i = 1; i < exposures.size(); ++i) {
+        if (exposures[i].reader()->width() != W ||
+            exposures[i].reader()->height() != H) {
+            throw std::runtime_error(
+                "StreamingFusion: the images have different size");
+        }
+    }
+
+    // first scan: DEBEVEC needs the range of each exposure, ROBERTSON_AUTO
+    // a decimated copy of the data to calibrate the response
+    vector<ExposureStats> stats(exposures.size());
+    if (type == DEBEVEC || type == ROBERTSON_AUTO) {
+        scanExposures(exposures, W, H, type == ROBERTSON_AUTO, params, stats);
+    }
+    if (type == ROBERTSON_AUTO) {
+        vector<FrameEnhanced> decimated;
+        for (size_t i = 0; i < exposures.size(); ++i) {
+            decimated.push_back(FrameEnhanced(
+                stats[i].decimated, exposures[i].averageLuminance()));
+        }
+        // the merged frame is discarded: only the calibrated curve is needed
+        FusionOperatorPtr calibration = IFusionOperator::build(ROBERTSON_AUTO);
+        std::unique_ptr<Frame> discarded(
+            calibration->computeFusion(response, weight, decimated));
+
+        stats.clear();
+        stats.resize(exposures.size());
+    }
+
+    Frame tempFrame(W, H);
+    Channel *outCh[3];
+    tempFrame.createXYZChannels(outCh[0], outCh[1], outCh[2]);
+    float *const outputs[3] = {outCh[0]->data(), outCh[1]->data(),
+                               outCh[2]->data()};
+
+    vector<float> averageLuminances(exposures.size());
+    for (size_t i = 0; i < exposures.size(); ++i) {
+        averageLuminances[i] = exposures[i].averageLuminance();
+    }
+    const float maxAllowedValue = weight.maxTrustedValue();
+    const float minAllowedValue = weight.minTrustedValue();
+
+    // second scan: merge one band at the time
+    vector<FramePtr> bands(exposures.size());
+    for (size_t i = 0; i < bands.size(); ++i) {
+        bands[i].reset(new Frame);
+    }
+    float Max = (type == DEBEVEC) ? numeric_limits<float>::min()
+                                  : -numeric_limits<float>::max();
+    for (size_t y0 = 0; y0 < H; y0 += params.bandHeight) {
+        const size_t rows = std::min(params.bandHeight, H - y0);
+        PRINT_DEBUG("Merging rows " << y0 << " to " << y0 + rows - 1);
+
+        for (size_t i = 0; i < exposures.size(); ++i) {
+            exposures[i].reader()->readBand(*bands[i], y0, rows,
+                                            params.readParams);
+        }
+        float *const bandOutputs[3] = {outputs[0] + y0 * W,
+                                       outputs[1] + y0 * W,
+                                       outputs[2] + y0 * W};
+
+        if (type == DEBEVEC) {
+            vector<DebevecOperator::Exposure> inputs(exposures.size());
+            for (size_t i = 0; i < exposures.size(); ++i) {
+                const Channel *Ch[3];
+                bands[i]->getXYZChannels(Ch[0], Ch[1], Ch[2]);
+                for (int c = 0; c < 3; ++c) {
+                    inputs[i].channels[c] = Ch[c]->data();
+                }
+                inputs[i].minValue = stats[i].minValue;
+                inputs[i].maxValue = stats[i].maxValue;
+                inputs[i].averageLuminance = averageLuminances[i];
+            }
+            Max = std::max(Max, DebevecOperator::mergeRows(
+                                    response, weight, inputs, bandOutputs, W,
+                                    rows));
+        } else {
+            DataList redChannels(exposures.size());
+            DataList greenChannels(exposures.size());
+            DataList blueChannels(exposures.size());
+            for (size_t i = 0; i < exposures.size(); ++i) {
+                Channel *Ch[3];
+                bands[i]->getXYZChannels(Ch[0], Ch[1], Ch[2]);
+                redChannels[i] = Ch[0]->data();
+                greenChannels[i] = Ch[1]->data();
+                blueChannels[i] = Ch[2]->data();
+            }
+            const DataList *inputs[3] = {&redChannels, &greenChannels,
+                                         &blueChannels};
+            const ResponseChannel channels[3] = {RESPONSE_CHANNEL_RED,
+                                                 RESPONSE_CHANNEL_GREEN,
+                                                 RESPONSE_CHANNEL_BLUE};
+            for (int c = 0; c < 3; ++c) {
+                RobertsonOperator::applyResponse(
+                    response, weight, channels[c], *inputs[c], bandOutputs[c],
+                    W, rows, minAllowedValue, maxAllowedValue,
+                    averageLuminances.data());
+                Max = std::max(Max, *std::max_element(bandOutputs[c],
+                                                      bandOutputs[c] +
+                                                          W * rows));
+            }
+        }
+    }
+
+    if (type == DEBEVEC) {
+        DebevecOperator::finalize(outputs, W * H, Max);
+    } else {
+        replaceNonNormal(outputs, W * H, Max);
+    }
+
+    outFrame.swap(tempFrame);
+    trace.setBytes(W * H * 3 * sizeof(float));
+}
+
+}  // fusion
+}  // libhdr
@@ -0,0 +1,87 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ */
+
+//! \brief Out-of-core fusion: the exposures are read from disk one band at
+//! the time, so that the memory used by the inputs does not depend on their
+//! size
+//! \author agent <agent@local>
+
+#ifndef LIBHDR_FUSION_STREAMINGFUSION_H
+#define LIBHDR_FUSION_STREAMINGFUSION_H
+
+#include <cstddef>
+#include <vector>
+
+#include <HdrCreation/fusionoperator.h>
+#include <Libpfs/io/framereader.h>
+#include <Libpfs/params.h>
+
+namespace libhdr {
+namespace fusion {
+
+//! \brief exposure read band by band through \c reader
+class StreamingExposure {
+   public:
+    StreamingExposure(const pfs::io::FrameReaderPtr &reader,
+                      float averageLuminance)
+        : m_reader(reader), m_averageLuminance(averageLuminance) {}
+
+    const pfs::io::FrameReaderPtr &reader() const { return m_reader; }
+    float averageLuminance() const { return m_averageLuminance; }
+
+   private:
+    pfs::io::FrameReaderPtr m_reader;
+    float m_averageLuminance;
+};
+
+struct StreamingFusionParams {
+    StreamingFusionParams() : bandHeight(128), calibrationSize(1024) {}
+
+    //! \brief number of rows of each exposure held in memory at the same time
+    size_t bandHeight;
+    //! \brief longest side of the decimated copy of the exposures used to
+    //! calibrate the response curve (ROBERTSON_AUTO only)
+    size_t calibrationSize;
+    //! \brief parameters forwarded to the readers (e.g. RAW settings)
+    pfs::Params readParams;
+};
+
+//! \brief merge \a exposures into \a outFrame, with the same result as
+//! \c IFusionOperator::computeFusion on the fully loaded exposures.
+//!
+//! Peak memory is the merged frame plus <tt>bandHeight</tt> rows of each
+//! exposure whose reader streams its bands (FrameReader::streamsBands()):
+//! the others hold their whole decoded image, from openBands() to the last
+//! band of the merge. DEBEVEC needs the range of each exposure, hence the
+//! files are scanned twice. ROBERTSON_AUTO calibrates \a response on a
+//! decimated copy of the exposures, built during the first scan, and then
+//! merges at full resolution with the calibrated curve.
+//! \throw std::runtime_error if the exposures have different size
+void streamingFusion(
+    FusionOperator type, ResponseCurve &response, WeightFunction &weight,
+    const std::vector<StreamingExposure> &exposures, pfs::Frame &outFrame,
+    const StreamingFusionParams &params = StreamingFusionParams());
+
+}  // fusion
+}  // libhdr
+
+#endif  // LIBHDR_FUSION_STREAMINGFUSION_H
@@ -36,8 +36,12 @@ HdrCreationItem::HdrCreationItem(const QString &filename)
       m_exposureTime(-1.f),
       m_datamin(0.f),
       m_datamax(1.f),
+      m_pendingWidth(0),
+      m_pendingHeight(0),
       m_frame(std::make_shared<pfs::Frame>()),
-      m_thumbnail(new QImage()) {
+      m_mutex(std::make_shared<std::mutex>()),
+      m_thumbnail(new QImage()),
+      m_preview(new QImage()) {
     // qDebug() << QString("Building HdrCreationItem for %1").arg(m_filename);
 }
 
@@ -50,9 +54,61 @@ HdrCreationItem::HdrCreationItem(const QString &filename,
       m_exposureTime(-1.f),
       m_datamin(0.f),
       m_datamax(1.f),
+      m_pendingWidth(0),
+      m_pendingHeight(0),
       m_frame(std::make_shared<pfs::Frame>()),
-      m_thumbnail(new QImage()) {}
+      m_mutex(std::make_shared<std::mutex>()),
+      m_thumbnail(new QImage()),
+      m_preview(new QImage()) {}
 
 HdrCreationItem::~HdrCreationItem() {
     // qDebug() << QString("Destroying HdrCreationItem for %1").arg(m_filename);
 }
+
+bool HdrCreationItem::isValid() const {
+    if (isDecodePending()) {
+        return m_pendingHeight > 0;
+    }
+    std::lock_guard<std::mutex> lock(*m_mutex);
+    if (m_compactFrame) {
+        return (m_compactFrame->getWidth() > 0 &&
+                m_compactFrame->getHeight() > 0);
+    }
+    return m_frame->isValid();
+}
+
+void HdrCreationItem::setCompactFrame(
+    const libhdr::fusion::CompactFramePtr &compact) {
+    std::lock_guard<std::mutex> lock(*m_mutex);
+    m_compactFrame = compact;
+    m_frame = std::make_shared<pfs::Frame>();
+}
+
+libhdr::fusion::CompactFramePtr HdrCreationItem::compactFrame() const {
+    std::lock_guard<std::mutex> lock(*m_mutex);
+    return m_compactFrame;
+}
+
+size_t HdrCreationItem::getWidth() const {
+    if (isDecodePending()) {
+        return m_pendingWidth;
+    }
+    std::lock_guard<std::mutex> lock(*m_mutex);
+    return m_compactFrame ? m_compactFrame->getWidth() : m_frame->getWidth();
+}
+
+size_t HdrCreationItem::getHeight() const {
+    if (isDecodePending()) {
+        return m_pendingHeight;
+    }
+    std::lock_guard<std::mutex> lock(*m_mutex);
+    return m_compactFrame ? m_compactFrame->getHeight() : m_frame->getHeight();
+}
+
+void HdrCreationItem::expand() const {
+    std::lock_guard<std::mutex> lock(*m_mutex);
+    if (!m_compactFrame) return;
+
+    m_frame.reset(m_compactFrame->toFrame());
+    m_compactFrame.reset();
+}
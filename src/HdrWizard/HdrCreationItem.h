@@ -24,12 +24,15 @@
 #ifndef HDRCREATIONITEM_H
 #define HDRCREATIONITEM_H
 
+#include <HdrCreation/compactframe.h>
 #include <Libpfs/frame.h>
 #include <QImage>
 #include <QSharedPointer>
 #include <QString>
 
 #include <cmath>
+#include <memory>
+#include <mutex>
 #include "arch/math.h"
 
 // defines an element that contains all the informations for this particular
@@ -46,9 +49,39 @@ class HdrCreationItem {
     const QString &alignedFilename() const { return m_alignedFilename; }
     void setAlignedFilename(const QString &f) { m_alignedFilename = f; }
 
-    const pfs::FramePtr &frame() const { return m_frame; }
-    pfs::FramePtr &frame() { return m_frame; }
-    bool isValid() const { return m_frame->isValid(); }
+    //! \brief float data of the exposure. If the item is stored as a
+    //! CompactFrame, it is decoded on first access and the compact storage
+    //! is released. The decoding is guarded by a lock: the GUI thread can
+    //! ask for the frame of an item a worker is reading.
+    const pfs::FramePtr &frame() const {
+        expand();
+        return m_frame;
+    }
+    pfs::FramePtr &frame() {
+        expand();
+        return m_frame;
+    }
+    bool isValid() const;
+
+    //! \brief store the exposure as integer codes, releasing the float frame
+    void setCompactFrame(const libhdr::fusion::CompactFramePtr &compact);
+    //! \brief compact storage of the exposure, NULL if it is stored (or
+    //! has been decoded) as a float frame
+    libhdr::fusion::CompactFramePtr compactFrame() const;
+    bool hasCompactFrame() const { return compactFrame().get() != NULL; }
+
+    //! \brief size of the exposure, without decoding the compact storage
+    size_t getWidth() const;
+    size_t getHeight() const;
+
+    //! \brief the file has only been previewed: frame() is empty until
+    //! LoadFile decodes it, preview() and the size are available
+    bool isDecodePending() const { return m_pendingWidth != 0; }
+    void setDecodePending(size_t width, size_t height) {
+        m_pendingWidth = width;
+        m_pendingHeight = height;
+    }
+    void clearDecodePending() { setDecodePending(0, 0); }
 
     bool hasAverageLuminance() const { return (m_averageLuminance != -1.f); }
     void setAverageLuminance(float avl) { m_averageLuminance = avl; }
@@ -70,7 +103,13 @@ class HdrCreationItem {
     QImage &qimage() { return *m_thumbnail; }
     const QImage &qimage() const { return *m_thumbnail; }
 
+    //! \brief downsampled version of qimage(), used by the wizard
+    QImage &preview() { return *m_preview; }
+    const QImage &preview() const { return *m_preview; }
+
    private:
+    void expand() const;
+
     QString m_filename;
     QString m_convertedFilename;
     QString m_alignedFilename;
@@ -78,8 +117,14 @@ class HdrCreationItem {
     float m_exposureTime;
     float m_datamin;
     float m_datamax;
-    pfs::FramePtr m_frame;
+    size_t m_pendingWidth;
+    size_t m_pendingHeight;
+    mutable pfs::FramePtr m_frame;
+    mutable libhdr::fusion::CompactFramePtr m_compactFrame;
+    //! guards m_frame and m_compactFrame; shared by the copies of the item
+    std::shared_ptr<std::mutex> m_mutex;
     QSharedPointer<QImage> m_thumbnail;
+    QSharedPointer<QImage> m_preview;
 };
 
 typedef std::vector<HdrCreationItem> HdrCreationItemContainer;
@@ -46,9 +46,11 @@
 #include <vector>
 
 #include <Common/CommonFunctions.h>
+#include <Core/IOWorker.h>
 #include <Libpfs/colorspace/colorspace.h>
 #include <Libpfs/colorspace/convert.h>
 #include <Libpfs/colorspace/normalizer.h>
+#include <Libpfs/exif/exifdata.hpp>
 #include <Libpfs/frame.h>
 #include <Libpfs/io/framereader.h>
 #include <Libpfs/io/framereaderfactory.h>
@@ -60,10 +62,13 @@
 #include <Libpfs/manip/cut.h>
 #include <Libpfs/manip/shift.h>
 #include <Libpfs/utils/msec_timer.h>
+#include <Libpfs/utils/threadbudget.h>
 #include <Libpfs/utils/transform.h>
 
 #include <Exif/ExifOperations.h>
+#include <HdrCreation/feature_alignment.h>
 #include <HdrCreation/mtb_alignment.h>
+#include <HdrCreation/streamingfusion.h>
 #include <HdrWizard/WhiteBalance.h>
 #include <TonemappingOperators/fattal02/pde.h>
 #include <arch/math.h>
@@ -105,6 +110,29 @@ QImage *shiftQImage(const QImage *in, int dx, int dy) {
     return out;
 }
 
+//! \brief EV used as offset of the exposures: the median of \a evs
+float medianEV(std::vector<float> evs) {
+    assert(!evs.empty());
+
+    // only one image available
+    if (evs.size() == 1) {
+        return evs[0];
+    }
+
+    // sort...
+    std::sort(evs.begin(), evs.end());
+    return evs[(evs.size() + 1) / 2 - 1];
+}
+
+//! \brief decode the items that have only been previewed by loadFiles()
+struct DecodePendingItem {
+    void operator()(HdrCreationItem &item) const {
+        if (item.isDecodePending()) {
+            LoadFile()(item);
+        }
+    }
+};
+
 void shiftItem(HdrCreationItem &item, int dx, int dy) {
     FramePtr shiftedFrame(pfs::shift(*item.frame(), dx, dy));
     item.frame().swap(shiftedFrame);
@@ -143,13 +171,76 @@ void HdrCreationManager::loadFiles(const QStringList &filenames) {
         }
     }
 
+    // the headers are enough to reject images of different size, before
+    // decoding them
+    QStringList newFiles;
+    for (const auto &hdrCreationItem : m_tmpdata) {
+        newFiles << hdrCreationItem.filename();
+    }
+    try {
+        const vector<FrameInfo> infos = probeFiles(newFiles);
+        size_t frameBytes = 0;
+        bool sameSize = true;
+        for (const auto &info : infos) {
+            frameBytes += info.frameBytes();
+            sameSize = sameSize && info.width == infos[0].width &&
+                       info.height == infos[0].height;
+        }
+        qDebug() << QStringLiteral(
+                        "HdrCreationManager::loadFiles(): %1 MB needed to "
+                        "decode %2 files")
+                        .arg(frameBytes >> 20)
+                        .arg(infos.size());
+
+        if (!sameSize) {
+            m_tmpdata.clear();
+            emit errorWhileLoading(
+                tr("HdrCreationManager::loadFiles(): The images have "
+                   "different size."));
+            return;
+        }
+    } catch (std::exception &e) {
+        // LoadFile() reports the error
+        qDebug() << QStringLiteral("HdrCreationManager::loadFiles(): %1")
+                        .arg(QString::fromStdString(e.what()));
+    }
+
     // parallel load of the data...
     connect(&m_futureWatcher, &QFutureWatcherBase::finished, this,
             &HdrCreationManager::loadFilesDone, Qt::DirectConnection);
 
     // Start the computation.
     m_futureWatcher.setFuture(
-        QtConcurrent::map(m_tmpdata.begin(), m_tmpdata.end(), LoadFile()));
+        QtConcurrent::map(m_tmpdata.begin(), m_tmpdata.end(),
+                          withThreadShare(LoadFile(false, m_deferredDecoding),
+                                          m_tmpdata.size())));
+}
+
+bool HdrCreationManager::decodeFiles() {
+    QFutureWatcher<void> futureWatcher;
+    futureWatcher.setFuture(
+        QtConcurrent::map(m_data.begin(), m_data.end(),
+                          withThreadShare(DecodePendingItem(), m_data.size())));
+    try {
+        futureWatcher.waitForFinished();
+    } catch (...) {
+        // LoadFile() has already logged the error
+        return false;
+    }
+    return true;
+}
+
+std::vector<FrameInfo> HdrCreationManager::probeFiles(
+    const QStringList &filenames) {
+    const pfs::Params params = getRawSettings();
+
+    std::vector<FrameInfo> infos;
+    for (const auto &filename : filenames) {
+        FrameReaderPtr reader =
+            FrameReaderFactory::open(QFile::encodeName(filename).constData());
+        infos.push_back(reader->probe(params));
+    }
+    return infos;
 }
 
 void HdrCreationManager::loadFilesDone() {
@@ -219,15 +310,7 @@ void HdrCreationManager::refreshEVOffset() {
         return;
     }
 
-    // only one image available
-    if (evs.size() == 1) {
-        m_evOffset = evs[0];
-        return;
-    }
-
-    // sort...
-    std::sort(evs.begin(), evs.end());
-    m_evOffset = evs[(evs.size() + 1) / 2 - 1];
+    m_evOffset = medianEV(evs);
 
     qDebug() << QStringLiteral(
                     "HdrCreationManager::refreshEVOffset(): offset = %1")
@@ -274,7 +357,8 @@ HdrCreationManager::HdrCreationManager(bool fromCommandLine)
       m_align(),
       m_ais_crop_flag(false),
       fromCommandLine(fromCommandLine),
-      m_isLoadResponseCurve(false) {
+      m_isLoadResponseCurve(false),
+      m_deferredDecoding(false) {
     // setConfig(predef_confs[0]);
     setFusionOperator(predef_confs[0].fusionOperator);
 
@@ -318,13 +402,12 @@ QVector<float> HdrCreationManager::getExpotimes() const {
 }
 
 bool HdrCreationManager::framesHaveSameSize() {
-    size_t width = m_data[0].frame()->getWidth();
-    size_t height = m_data[0].frame()->getHeight();
+    size_t width = m_data[0].getWidth();
+    size_t height = m_data[0].getHeight();
     for (HdrCreationItemContainer::const_iterator it = m_data.begin() + 1,
                                                   itEnd = m_data.end();
          it != itEnd; ++it) {
-        if (it->frame()->getWidth() != width ||
-            it->frame()->getHeight() != height)
+        if (it->getWidth() != width || it->getHeight() != height)
             return false;
     }
     return true;
@@ -343,13 +426,43 @@ void HdrCreationManager::align_with_mtb() {
     // rebuild previews
     QFutureWatcher<void> futureWatcher;
     futureWatcher.setFuture(
-        QtConcurrent::map(m_data.begin(), m_data.end(), RefreshPreview()));
+        QtConcurrent::map(m_data.begin(), m_data.end(),
+                          withThreadShare(RefreshPreview(), m_data.size())));
+    futureWatcher.waitForFinished();
+
+    // emit finished
+    emit finishedAligning(0);
+}
+
+void HdrCreationManager::align_with_features() {
+    // build temporary container...
+    vector<FramePtr> frames;
+    for (size_t i = 0; i < m_data.size(); ++i) {
+        frames.push_back(m_data[i].frame());
+    }
+
+    // run the in-memory feature based alignment
+    libhdr::feature_alignment(frames);
+
+    // rebuild previews
+    QFutureWatcher<void> futureWatcher;
+    futureWatcher.setFuture(
+        QtConcurrent::map(m_data.begin(), m_data.end(),
+                          withThreadShare(RefreshPreview(), m_data.size())));
     futureWatcher.waitForFinished();
 
     // emit finished
     emit finishedAligning(0);
 }
 
+void HdrCreationManager::buildQImages() {
+    QFutureWatcher<void> futureWatcher;
+    futureWatcher.setFuture(QtConcurrent::map(
+        m_data.begin(), m_data.end(),
+        withThreadShare(RefreshPreview(true), m_data.size())));
+    futureWatcher.waitForFinished();
+}
+
 void HdrCreationManager::set_ais_crop_flag(bool flag) {
     m_ais_crop_flag = flag;
 }
@@ -377,13 +490,20 @@ pfs::Frame *HdrCreationManager::createHdr() {
     std::vector<FrameEnhanced> frames;
 
     for (size_t idx = 0; idx < m_data.size(); ++idx) {
-        frames.push_back(
-            FrameEnhanced(m_data[idx].frame(),
-                          std::pow(2.f, m_data[idx].getEV() - m_evOffset)));
+        const float averageLuminance =
+            std::pow(2.f, m_data[idx].getEV() - m_evOffset);
+        const CompactFramePtr compact = m_data[idx].compactFrame();
+        if (compact) {
+            frames.push_back(FrameEnhanced(compact, averageLuminance));
+        } else {
+            frames.push_back(
+                FrameEnhanced(m_data[idx].frame(), averageLuminance));
+        }
     }
 
     libhdr::fusion::FusionOperatorPtr fusionOperatorPtr =
         IFusionOperator::build(m_fusionOperator);
+    pfs::utils::ThreadLease lease;
     pfs::Frame *outputFrame(
         fusionOperatorPtr->computeFusion(*m_response, *m_weight, frames));
 
@@ -395,6 +515,79 @@ pfs::Frame *HdrCreationManager::createHdr() {
     return outputFrame;
 }
 
+pfs::Frame *HdrCreationManager::createHdrStreaming(
+    const QStringList &filenames, const QList<float> &evs) {
+    if (filenames.isEmpty()) {
+        throw std::runtime_error(
+            "HdrCreationManager::createHdrStreaming(): no input files");
+    }
+    if (!evs.isEmpty() && evs.size() != filenames.size()) {
+        throw std::runtime_error(
+            "HdrCreationManager::createHdrStreaming(): the number of EV values "
+            "is different from the number of input files");
+    }
+
+    // the EVs come from the command line or, when missing, from the Exif data
+    std::vector<float> fileEVs;
+    for (int idx = 0; idx < filenames.size(); ++idx) {
+        if (!evs.isEmpty()) {
+            fileEVs.push_back(evs[idx]);
+            continue;
+        }
+        pfs::exif::ExifData exifData(filenames[idx].toStdString());
+        if (!exifData.isValid()) {
+            throw std::runtime_error(
+                "HdrCreationManager::createHdrStreaming(): Exif data missing "
+                "in " +
+                filenames[idx].toStdString());
+        }
+        fileEVs.push_back(log2(exifData.getAverageSceneLuminance()));
+    }
+    const float evOffset = medianEV(fileEVs);
+
+    if (isLoadResponseCurve()) {
+        m_response->readFromFile(
+            QFile::encodeName(getResponseCurveInputFilename()).constData());
+        setLoadResponseCurve(false);
+    }
+
+    vector<StreamingExposure> exposures;
+    QStringList decodedWhole;
+    for (int idx = 0; idx < filenames.size(); ++idx) {
+        FrameReaderPtr reader = FrameReaderFactory::open(
+            QFile::encodeName(filenames[idx]).constData());
+        if (!reader->streamsBands()) {
+            decodedWhole << filenames[idx];
+        }
+        exposures.push_back(StreamingExposure(
+            reader, std::pow(2.f, fileEVs[idx] - evOffset)));
+    }
+    // e.g. RAW, RGBE and rotated files: the bands of these files are served
+    // from the whole decoded image, held while the files are merged
+    if (!decodedWhole.isEmpty()) {
+        qWarning() << QStringLiteral(
+                          "HdrCreationManager::createHdrStreaming(): %1 "
+                          "cannot be read band by band, and will be decoded "
+                          "whole")
+                          .arg(decodedWhole.join(QStringLiteral(", ")));
+    }
+
+    StreamingFusionParams params;
+    params.readParams = getRawSettings();
+
+    std::unique_ptr<pfs::Frame> outputFrame(new pfs::Frame);
+    pfs::utils::ThreadLease lease;
+    streamingFusion(m_fusionOperator, *m_response, *m_weight, exposures,
+                    *outputFrame, params);
+
+    if (!m_responseCurveOutputFilename.isEmpty()) {
+        m_response->writeToFile(
+            QFile::encodeName(m_responseCurveOutputFilename).constData());
+    }
+
+    return outputFrame.release();
+}
+
 void HdrCreationManager::applyShiftsToItems(
     const QList<QPair<int, int>> &hvOffsets) {
     int size = m_data.size();
@@ -39,6 +39,7 @@
 #include <HdrCreation/createhdr.h>
 #include <HdrCreation/fusionoperator.h>
 #include <Libpfs/frame.h>
+#include <Libpfs/io/framereader.h>
 
 #include <Alignment/Align.h>
 #include <Common/LuminanceOptions.h>
@@ -66,6 +67,14 @@ class HdrCreationManager : public QObject {
     const HdrCreationItem &getFile(size_t idx) const { return m_data[idx]; }
 
     void loadFiles(const QStringList &filenames);
+    //! \brief with deferred decoding, loadFiles() only reads a reduced image
+    //! of each file to build its preview, and decodeFiles() has to be called
+    //! before working on the frames
+    void setDeferredDecoding(bool b) { m_deferredDecoding = b; }
+    bool isDeferredDecoding() const { return m_deferredDecoding; }
+    //! \brief decode the files loaded with deferred decoding
+    //! \return false if a file cannot be read
+    bool decodeFiles();
     void removeFile(int idx);
     void clearFiles() {
         m_data.clear();
@@ -122,9 +131,31 @@ class HdrCreationManager : public QObject {
 
     pfs::Frame *createHdr();
 
+    //! \brief merge \a filenames reading them band by band, without loading
+    //! them in memory (no alignment and no anti-ghosting). The files whose
+    //! reader cannot stream its bands (see FrameReader::streamsBands()) are
+    //! decoded whole, and a warning is logged.
+    //! \param evs EV of each file; when empty, the EVs are read from the Exif
+    //! data
+    //! \throw std::runtime_error if the EVs are not available or the files
+    //! cannot be read
+    pfs::Frame *createHdrStreaming(const QStringList &filenames,
+                                   const QList<float> &evs = QList<float>());
+
+    //! \brief read the headers of \a filenames, without decoding their
+    //! pixels
+    //! \throw std::runtime_error if a file cannot be opened
+    static std::vector<pfs::io::FrameInfo> probeFiles(
+        const QStringList &filenames);
+
     void set_ais_crop_flag(bool flag);
     void align_with_ais();
     void align_with_mtb();
+    void align_with_features();
+
+    //! \brief build the full size QImage of every item, as needed by the
+    //! EditingTools (the HdrWizard only uses the previews)
+    void buildQImages();
 
     const HdrCreationItemContainer &getData() const { return m_data; }
     // const QList<QImage*>& getAntiGhostingMasksList() const  { return
@@ -200,6 +231,7 @@ class HdrCreationManager : public QObject {
     int m_agGoodImageIndex;
     bool m_patches[agGridSize][agGridSize];
     bool m_isLoadResponseCurve;
+    bool m_deferredDecoding;
 
    private slots:
     void ais_failed_slot(QProcess::ProcessError);
@@ -113,6 +113,10 @@ HdrWizard::HdrWizard(QWidget *p, const QStringList &files,
     setAcceptDrops(true);
     setupConnections();
 
+    // the first page only shows previews: the files are decoded when the
+    // user moves on
+    m_hdrCreationManager->setDeferredDecoding(true);
+
     m_Ui->tableWidget->setHorizontalHeaderLabels(
         QStringList() << tr("Image Filename") << tr("Exposure"));
     m_Ui->tableWidget->horizontalHeader()->setSectionResizeMode(
@@ -421,7 +425,7 @@ void HdrWizard::inputHdrFileSelected(int currentRow) {
         // load QImage...
         m_Ui->previewLabel->setPixmap(QPixmap::fromImage(
             m_hdrCreationManager->getFile(currentRow)
-                .qimage()
+                .preview()
                 .scaled(m_Ui->previewLabel->size(), Qt::KeepAspectRatio)));
 
         m_Ui->ImageEVdsb->setFocus();
@@ -661,6 +665,9 @@ void HdrWizard::NextFinishButtonClicked() {
     int currentpage = m_Ui->pagestack->currentIndex();
     switch (currentpage) {
         case 0: {
+            if (!decodeInputFiles()) {
+                return;
+            }
             // now align, if requested
             if (m_Ui->alignCheckBox->isChecked()) {
                 QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
@@ -707,6 +714,24 @@ void HdrWizard::NextFinishButtonClicked() {
     }
 }
 
+bool HdrWizard::decodeInputFiles() {
+    const QString label = m_Ui->confirmloadlabel->text();
+    m_Ui->confirmloadlabel->setText("<center><h3><b>" + tr("Loading...") +
+                                    "</b></h3></center>");
+    QApplication::setOverrideCursor(QCursor(Qt::BusyCursor));
+    repaint();
+
+    const bool decoded = m_hdrCreationManager->decodeFiles();
+
+    QApplication::restoreOverrideCursor();
+    if (!decoded) {
+        errorWhileLoading(tr("Error loading a file."));
+        return false;
+    }
+    m_Ui->confirmloadlabel->setText(label);
+    return true;
+}
+
 void HdrWizard::startComputation() {
     m_processing = true;
     repaint();
@@ -827,6 +852,7 @@ void HdrWizard::currentPageChangedInto(int newindex) {
         int num_images = m_hdrCreationManager->getData().size();
         if (m_Ui->checkBoxEditingTools->isChecked() && num_images >= 2) {
             this->setDisabled(true);
+            m_hdrCreationManager->buildQImages();
             EditingTools *editingtools =
                 new EditingTools(m_hdrCreationManager.data(),
                                  m_Ui->autoAG_checkBox->isChecked());
@@ -1054,7 +1080,7 @@ void HdrWizard::resizeEvent(QResizeEvent *) {
     if (currentRow >= 0 && currentRow < numberOfRow) {
         m_Ui->previewLabel->setPixmap(QPixmap::fromImage(
             m_hdrCreationManager->getFile(currentRow)
-                .qimage()
+                .preview()
                 .scaled(m_Ui->previewLabel->size(), Qt::KeepAspectRatio)));
     } else {
         m_Ui->previewLabel->setText(QString());
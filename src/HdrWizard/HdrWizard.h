@@ -92,6 +92,8 @@ class HdrWizard : public QDialog {
     void updateTableGrid();
     void enableNextOrWarning(const QStringList &filesWithoutExif);
     void updateLabelMaybeNext(size_t numFilesWithoutExif);
+    //! \brief full decode of the files, which have only been previewed
+    bool decodeInputFiles();
 
    signals:
     void setValue(int value);
@@ -23,11 +23,15 @@
 #define PFS_ARRAY2D_H
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <memory>
 #include <vector>
 
+#include <Libpfs/array2dexpr.h>
 #include <Libpfs/strideiterator.h>
+#include <Libpfs/utils/pooledallocator.h>
 
 //! \file array2d.h
 //! \brief general 2d array interface
@@ -45,10 +49,19 @@ namespace pfs {
 //! It offers an undirect access to the data (using (x)(y) or (elem) ) or a
 //! direct access to the data (using getRawData() or data()).
 //!
+//! Copies share the same buffer (copy-on-write): the buffer is duplicated
+//! by the first non-const access (element, iterator or data()) to an
+//! instance whose buffer is shared, so read-only copies are O(1). The
+//! duplication is thread safe, so a shared instance can be written from
+//! an OpenMP loop. Pointers and iterators obtained from a non-const
+//! accessor must not be used to write after the instance has been copied.
+//!
 template <typename Type>
 class Array2D {
    public:
-    typedef std::vector<Type> DataBuffer;
+    //! \brief buffers are aligned to utils::BUFFER_ALIGNMENT bytes and
+    //! recycled through utils::BufferPool
+    typedef std::vector<Type, utils::PooledAllocator<Type> > DataBuffer;
     typedef typename DataBuffer::value_type value_type;
     typedef Array2D<Type> self;
 
@@ -58,14 +71,38 @@ class Array2D {
     //! \brief init \c Array2D with a matrix of \a cols times \a rows
     Array2D(size_t cols, size_t rows);  // (width, height)
 
-    //! \brief copy ctor
-    //! \note If you want to build an empty \c Array2D with the same size of the
-    //! source, use the ctor that takes dimension and you will spare the copy
+    //! \brief copy ctor (shares the buffer of \a rhs until either is
+    //! written)
     Array2D(const self &rhs);
 
-    //! \brief assignment operator (always performs deep copy)
+    //! \brief assignment operator (shares the buffer of \a other until either
+    //! is written)
     self &operator=(const self &other);
 
+    //! \brief evaluate \a expr (see array2dexpr.h) in a single pass, without
+    //! temporaries. An empty array takes the size of the expression.
+    template <typename Derived>
+    self &operator=(const ArrayExpr<Derived> &expr);
+
+    //! \brief elementwise arithmetic with an array, an expression or a
+    //! scalar, in a single pass
+    template <typename T>
+    self &operator+=(const T &rhs) {
+        return *this = *this + rhs;
+    }
+    template <typename T>
+    self &operator-=(const T &rhs) {
+        return *this = *this - rhs;
+    }
+    template <typename T>
+    self &operator*=(const T &rhs) {
+        return *this = *this * rhs;
+    }
+    template <typename T>
+    self &operator/=(const T &rhs) {
+        return *this = *this / rhs;
+    }
+
     //! \brief virtual destructor
     virtual ~Array2D() {}
 
@@ -99,9 +136,12 @@ class Array2D {
     void resize(size_t width, size_t height);
 
     //! \brief Direct access to the raw data
-    Type *data() { return m_data.data(); }
+    Type *data() {
+        detach();
+        return m_data->data();
+    }
     //! \brief Direct access to the raw data
-    const Type *data() const { return m_data.data(); }
+    const Type *data() const { return m_data->data(); }
 
     //! \brief fill the entire vector data to the value "value"
     void fill(const Type &value);
@@ -111,25 +151,35 @@ class Array2D {
     //! \brief Swap the content of the current instance with \a other
     void swap(self &other);
 
+    //! \brief true if the buffer is shared with another instance
+    bool isShared() const { return m_data.use_count() > 1; }
+
+    //! \brief make the buffer exclusive to this instance, copying it if it is
+    //! shared. Called by all the non-const accessors.
+    void detach();
+
    public:
     // element/row iterator
     typedef typename DataBuffer::iterator iterator;
     typedef typename DataBuffer::const_iterator const_iterator;
 
-    iterator begin() { return m_data.begin(); }
-    iterator end() { return m_data.begin() + size(); }
+    iterator begin() {
+        detach();
+        return m_data->begin();
+    }
+    iterator end() { return begin() + size(); }
 
-    const_iterator begin() const { return m_data.begin(); }
-    const_iterator end() const { return m_data.begin() + size(); }
+    const_iterator begin() const { return m_data->begin(); }
+    const_iterator end() const { return m_data->begin() + size(); }
 
-    iterator row_begin(size_t r) { return m_data.begin() + r * m_cols; }
-    iterator row_end(size_t r) { return m_data.begin() + (r + 1) * m_cols; }
+    iterator row_begin(size_t r) { return begin() + r * m_cols; }
+    iterator row_end(size_t r) { return begin() + (r + 1) * m_cols; }
 
     const_iterator row_begin(size_t r) const {
-        return m_data.begin() + r * m_cols;
+        return m_data->begin() + r * m_cols;
     }
     const_iterator row_end(size_t r) const {
-        return m_data.begin() + (r + 1) * m_cols;
+        return m_data->begin() + (r + 1) * m_cols;
     }
 
     //! \brief subscript operators, returns the row \a n
@@ -153,7 +203,14 @@ class Array2D {
     }
 
    private:
-    DataBuffer m_data;
+    //! \brief copy the shared buffer (or allocate a new one of the same size
+    //! if \a keepData is false)
+    void detachShared(bool keepData = true);
+
+    std::shared_ptr<DataBuffer> m_data;
+    //! \brief set when m_data might be shared with another instance: the
+    //! non-const accessors test this flag only
+    mutable std::atomic<bool> m_shared;
 
     size_t m_cols;
     size_t m_rows;
@@ -29,6 +29,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <mutex>
 
 #include <Libpfs/array2d.h>
 #include <Libpfs/utils/numeric.h>
@@ -38,18 +39,29 @@ using namespace std;
 namespace pfs {
 
 template <typename Type>
-Array2D<Type>::Array2D() : m_data(), m_cols(0), m_rows(0) {}
+Array2D<Type>::Array2D()
+    : m_data(std::make_shared<DataBuffer>()),
+      m_shared(false),
+      m_cols(0),
+      m_rows(0) {}
 
 template <typename Type>
 Array2D<Type>::Array2D(size_t cols, size_t rows)
-    : m_data(cols * rows), m_cols(cols), m_rows(rows) {
-    assert(m_data.size() >= m_cols * m_rows);
+    : m_data(std::make_shared<DataBuffer>(cols * rows)),
+      m_shared(false),
+      m_cols(cols),
+      m_rows(rows) {
+    assert(m_data->size() >= m_cols * m_rows);
 }
 
 template <typename Type>
 Array2D<Type>::Array2D(const self &rhs)
-    : m_data(rhs.m_data), m_cols(rhs.m_cols), m_rows(rhs.m_rows) {
-    assert(m_data.size() >= m_cols * m_rows);
+    : m_data(rhs.m_data),
+      m_shared(true),
+      m_cols(rhs.m_cols),
+      m_rows(rhs.m_rows) {
+    rhs.m_shared.store(true, std::memory_order_relaxed);
+    assert(m_data->size() >= m_cols * m_rows);
 }
 
 template <typename Type>
@@ -62,13 +74,33 @@ Array2D<Type> &Array2D<Type>::operator=(const Array2D<Type> &other) {
     return *this;
 }
 
+template <typename Type>
+template <typename Derived>
+Array2D<Type> &Array2D<Type>::operator=(const ArrayExpr<Derived> &expr) {
+    const Derived &e = expr.self();
+    if (size() == 0) {
+        Array2D<Type> newState(e.getCols(), e.getRows());
+        swap(newState);
+    }
+    assert(e.getCols() * e.getRows() == size());
+
+    if (m_shared.load(std::memory_order_acquire)) {
+        // the current content is copied only if the expression reads it
+        detachShared(e.references(m_data->data()));
+    }
+    assign(m_data->data(), size(), e);
+
+    return *this;
+}
+
 template <typename Type>
 void Array2D<Type>::resize(size_t width, size_t height) {
-    m_data.resize(width * height);
+    detach();
+    m_data->resize(width * height);
     m_cols = width;
     m_rows = height;
 
-    assert(m_data.size() >= m_cols * m_rows);
+    assert(m_data->size() >= m_cols * m_rows);
 }
 
 template <typename Type>
@@ -76,52 +108,90 @@ void Array2D<Type>::swap(self &other) {
     std::swap(m_cols, other.m_cols);
     std::swap(m_rows, other.m_rows);
     std::swap(m_data, other.m_data);
+
+    bool shared = m_shared.load(std::memory_order_relaxed);
+    m_shared.store(other.m_shared.load(std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+    other.m_shared.store(shared, std::memory_order_relaxed);
+}
+
+template <typename Type>
+inline void Array2D<Type>::detach() {
+    if (m_shared.load(std::memory_order_acquire)) {
+        detachShared();
+    }
+}
+
+template <typename Type>
+void Array2D<Type>::detachShared(bool keepData) {
+    // serialize the threads writing to the same instance for the first time
+    static std::mutex s_mutex;
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    if (!m_shared.load(std::memory_order_relaxed)) {
+        // detached by another thread
+        return;
+    }
+    if (m_data.use_count() > 1) {
+        if (keepData) {
+            m_data = std::make_shared<DataBuffer>(*m_data);
+        } else {
+            m_data = std::make_shared<DataBuffer>(m_data->size());
+        }
+    }
+    m_shared.store(false, std::memory_order_release);
 }
 
 template <typename Type>
 inline Type &Array2D<Type>::operator()(size_t cols, size_t rows) {
+    detach();
 #ifndef NDEBUG
-    return m_data.at(rows * m_cols + cols);
+    return m_data->at(rows * m_cols + cols);
 #else
-    return m_data[rows * m_cols + cols];
+    return (*m_data)[rows * m_cols + cols];
 #endif
 }
 
 template <typename Type>
 inline const Type &Array2D<Type>::operator()(size_t cols, size_t rows) const {
 #ifndef NDEBUG
-    return m_data.at(rows * m_cols + cols);
+    return m_data->at(rows * m_cols + cols);
 #else
-    return m_data[rows * m_cols + cols];
+    return (*m_data)[rows * m_cols + cols];
 #endif
 }
 
 template <typename Type>
 inline Type &Array2D<Type>::operator()(size_t index) {
+    detach();
 #ifndef NDEBUG
-    return m_data.at(index);
+    return m_data->at(index);
 #else
-    return m_data[index];
+    return (*m_data)[index];
 #endif
 }
 
 template <typename Type>
 inline const Type &Array2D<Type>::operator()(size_t index) const {
 #ifndef NDEBUG
-    return m_data.at(index);
+    return m_data->at(index);
 #else
-    return m_data[index];
+    return (*m_data)[index];
 #endif
 }
 
 template <typename Type>
 void Array2D<Type>::fill(const Type &value) {
-    std::fill(m_data.begin(), m_data.end(), value);
+    // the current content is lost: do not copy it
+    if (m_shared.load(std::memory_order_acquire)) {
+        detachShared(false);
+    }
+    std::fill(m_data->begin(), m_data->end(), value);
 }
 
 template <typename Type>
 void Array2D<Type>::reset() {
-    std::fill(m_data.begin(), m_data.end(), Type());
+    fill(Type());
 }
 
 }  // Libpfs
@@ -27,6 +27,8 @@
 namespace pfs {
 template <typename Type>
 class Array2D;
+template <typename Type>
+class Array2DView;
 
 //! \brief typedef provided for backward compatibility with the old API
 typedef Array2D<float> Array2Df;
@@ -0,0 +1,339 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+
+#ifndef PFS_ARRAY2DEXPR_H
+#define PFS_ARRAY2DEXPR_H
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+#include <Libpfs/array2d_fwd.h>
+
+//! \file array2dexpr.h
+//! \brief lazy elementwise arithmetic on Array2D
+//! \author agent <agent@local>
+//!
+//! The arithmetic operators on Array2D (and on raw buffers wrapped by
+//! arrayExpr()) do not compute anything: they build an expression, which is
+//! evaluated element by element by Array2D::operator=() or assign(). A
+//! statement like
+//! \code
+//! A = B * C + s * D;
+//! \endcode
+//! then runs as a single parallel and vectorizable loop, with no temporary
+//! array, instead of one pass over the memory per operator.
+//! An expression keeps pointers to the buffers of its operands: it must be
+//! evaluated in the statement that builds it.
+
+namespace pfs {
+
+//! \brief base of all the expressions (CRTP)
+template <typename Derived>
+struct ArrayExpr {
+    const Derived &self() const { return static_cast<const Derived &>(*this); }
+};
+
+//! \brief leaf of an expression: a buffer of \c size elements
+template <typename Type>
+class ArrayTerminal : public ArrayExpr<ArrayTerminal<Type> > {
+   public:
+    typedef Type value_type;
+
+    ArrayTerminal(const Type *data, size_t cols, size_t rows)
+        : m_data(data), m_cols(cols), m_rows(rows) {}
+
+    Type eval(size_t idx) const { return m_data[idx]; }
+
+    size_t getCols() const { return m_cols; }
+    size_t getRows() const { return m_rows; }
+    //! \brief true if the expression reads the buffer starting at \a data
+    bool references(const void *data) const { return m_data == data; }
+
+   private:
+    const Type *m_data;
+    size_t m_cols;
+    size_t m_rows;
+};
+
+//! \brief scalar operand, broadcast to every element
+template <typename Type>
+class ArrayScalar : public ArrayExpr<ArrayScalar<Type> > {
+   public:
+    typedef Type value_type;
+
+    explicit ArrayScalar(const Type &value) : m_value(value) {}
+
+    Type eval(size_t) const { return m_value; }
+
+    // the size is the one of the other operand
+    size_t getCols() const { return 0; }
+    size_t getRows() const { return 0; }
+    bool references(const void *) const { return false; }
+
+   private:
+    Type m_value;
+};
+
+//! \brief \a op applied to the elements of two expressions
+template <typename Left, typename Op, typename Right>
+class ArrayBinary : public ArrayExpr<ArrayBinary<Left, Op, Right> > {
+   public:
+    typedef typename Left::value_type value_type;
+
+    ArrayBinary(const Left &left, const Right &right)
+        : m_left(left), m_right(right) {
+        assert(left.getCols() == 0 || right.getCols() == 0 ||
+               (left.getCols() == right.getCols() &&
+                left.getRows() == right.getRows()));
+    }
+
+    value_type eval(size_t idx) const {
+        return Op::apply(m_left.eval(idx), m_right.eval(idx));
+    }
+
+    size_t getCols() const {
+        return m_left.getCols() ? m_left.getCols() : m_right.getCols();
+    }
+    size_t getRows() const {
+        return m_left.getCols() ? m_left.getRows() : m_right.getRows();
+    }
+    bool references(const void *data) const {
+        return m_left.references(data) || m_right.references(data);
+    }
+
+   private:
+    Left m_left;
+    Right m_right;
+};
+
+//! \brief opposite of the elements of an expression
+template <typename Operand>
+class ArrayNegate : public ArrayExpr<ArrayNegate<Operand> > {
+   public:
+    typedef typename Operand::value_type value_type;
+
+    explicit ArrayNegate(const Operand &operand) : m_operand(operand) {}
+
+    value_type eval(size_t idx) const { return -m_operand.eval(idx); }
+
+    size_t getCols() const { return m_operand.getCols(); }
+    size_t getRows() const { return m_operand.getRows(); }
+    bool references(const void *data) const {
+        return m_operand.references(data);
+    }
+
+   private:
+    Operand m_operand;
+};
+
+namespace detail {
+
+struct ExprPlus {
+    template <typename T>
+    static T apply(const T &a, const T &b) {
+        return a + b;
+    }
+};
+
+struct ExprMinus {
+    template <typename T>
+    static T apply(const T &a, const T &b) {
+        return a - b;
+    }
+};
+
+struct ExprMultiplies {
+    template <typename T>
+    static T apply(const T &a, const T &b) {
+        return a * b;
+    }
+};
+
+struct ExprDivides {
+    template <typename T>
+    static T apply(const T &a, const T &b) {
+        return a / b;
+    }
+};
+
+//! \brief element type of Array2D and of the classes derived from it
+//! (Channel...), void for any other type
+template <typename Type>
+Type array2DValue(const Array2D<Type> *);
+void array2DValue(...);
+
+template <typename T>
+struct Array2DValue {
+    typedef decltype(array2DValue(static_cast<const T *>(0))) type;
+};
+
+//! \brief kind of an operand: array, expression or anything else (scalar)
+enum OperandKind { SCALAR_OPERAND, ARRAY_OPERAND, EXPR_OPERAND };
+
+template <typename T>
+struct OperandTraits {
+    static const OperandKind kind =
+        std::is_base_of<ArrayExpr<T>, T>::value
+            ? EXPR_OPERAND
+            : (std::is_void<typename Array2DValue<T>::type>::value
+                   ? SCALAR_OPERAND
+                   : ARRAY_OPERAND);
+};
+
+//! \brief true for the types that can be operands of an expression:
+//! arrays and the expressions themselves
+template <typename T>
+struct IsArrayOperand
+    : std::integral_constant<bool, OperandTraits<T>::kind != SCALAR_OPERAND> {
+};
+
+//! \brief expression node of an operand: expressions are used as they are,
+//! arrays are wrapped in an ArrayTerminal and scalars in an ArrayScalar of
+//! \c ValueType (the element type of the other operand)
+template <typename T, typename ValueType,
+          OperandKind Kind = OperandTraits<T>::kind>
+struct ToExpr {
+    typedef ArrayScalar<ValueType> type;
+    static type get(const T &value) { return type(ValueType(value)); }
+};
+
+template <typename T, typename ValueType>
+struct ToExpr<T, ValueType, ARRAY_OPERAND> {
+    typedef typename Array2DValue<T>::type Type;
+    typedef ArrayTerminal<Type> type;
+    static type get(const Array2D<Type> &array) {
+        return type(array.data(), array.getCols(), array.getRows());
+    }
+};
+
+template <typename T, typename ValueType>
+struct ToExpr<T, ValueType, EXPR_OPERAND> {
+    typedef T type;
+    static const T &get(const T &expr) { return expr; }
+};
+
+//! \brief element type of an operand (void for scalars)
+template <typename T, OperandKind Kind = OperandTraits<T>::kind>
+struct OperandValue {
+    typedef void type;
+};
+
+template <typename T>
+struct OperandValue<T, ARRAY_OPERAND> {
+    typedef typename Array2DValue<T>::type type;
+};
+
+template <typename T>
+struct OperandValue<T, EXPR_OPERAND> {
+    typedef typename T::value_type type;
+};
+
+//! \brief node computing \c Op on \c L and \c R, if at least one of them is
+//! an array or an expression and the other one is an array, an expression
+//! or an arithmetic scalar
+template <typename L, typename Op, typename R>
+struct BinaryExpr {
+    typedef typename std::conditional<
+        IsArrayOperand<L>::value, typename OperandValue<L>::type,
+        typename OperandValue<R>::type>::type value_type;
+
+    static const bool enabled =
+        (IsArrayOperand<L>::value &&
+         (IsArrayOperand<R>::value || std::is_arithmetic<R>::value)) ||
+        (IsArrayOperand<R>::value && std::is_arithmetic<L>::value);
+
+    typedef ArrayBinary<typename ToExpr<L, value_type>::type, Op,
+                        typename ToExpr<R, value_type>::type>
+        type;
+
+    static type get(const L &l, const R &r) {
+        return type(ToExpr<L, value_type>::get(l),
+                    ToExpr<R, value_type>::get(r));
+    }
+};
+
+}  // namespace detail
+
+//! \brief wrap \a size elements starting at \a data in an expression
+template <typename Type>
+ArrayTerminal<Type> arrayExpr(const Type *data, size_t size) {
+    return ArrayTerminal<Type>(data, size, 1);
+}
+
+template <typename L, typename R>
+typename std::enable_if<
+    detail::BinaryExpr<L, detail::ExprPlus, R>::enabled,
+    typename detail::BinaryExpr<L, detail::ExprPlus, R>::type>::type
+operator+(const L &l, const R &r) {
+    return detail::BinaryExpr<L, detail::ExprPlus, R>::get(l, r);
+}
+
+template <typename L, typename R>
+typename std::enable_if<
+    detail::BinaryExpr<L, detail::ExprMinus, R>::enabled,
+    typename detail::BinaryExpr<L, detail::ExprMinus, R>::type>::type
+operator-(const L &l, const R &r) {
+    return detail::BinaryExpr<L, detail::ExprMinus, R>::get(l, r);
+}
+
+template <typename L, typename R>
+typename std::enable_if<
+    detail::BinaryExpr<L, detail::ExprMultiplies, R>::enabled,
+    typename detail::BinaryExpr<L, detail::ExprMultiplies, R>::type>::type
+operator*(const L &l, const R &r) {
+    return detail::BinaryExpr<L, detail::ExprMultiplies, R>::get(l, r);
+}
+
+template <typename L, typename R>
+typename std::enable_if<
+    detail::BinaryExpr<L, detail::ExprDivides, R>::enabled,
+    typename detail::BinaryExpr<L, detail::ExprDivides, R>::type>::type
+operator/(const L &l, const R &r) {
+    return detail::BinaryExpr<L, detail::ExprDivides, R>::get(l, r);
+}
+
+template <typename T>
+typename std::enable_if<
+    detail::IsArrayOperand<T>::value,
+    ArrayNegate<typename detail::ToExpr<
+        T, typename detail::OperandValue<T>::type>::type> >::type
+operator-(const T &operand) {
+    typedef detail::ToExpr<T, typename detail::OperandValue<T>::type> Wrap;
+    return ArrayNegate<typename Wrap::type>(Wrap::get(operand));
+}
+
+//! \brief evaluate \a expr into the \a size elements of \a out, in a single
+//! parallel loop. \a out can be one of the buffers read by the expression.
+template <typename Type, typename Derived>
+void assign(Type *out, size_t size, const ArrayExpr<Derived> &expr) {
+    const Derived &e = expr.self();
+    const int numElem = static_cast<int>(size);
+#pragma omp parallel for
+    for (int idx = 0; idx < numElem; ++idx) {
+        out[idx] = e.eval(idx);
+    }
+}
+
+}  // namespace pfs
+
+#endif  // PFS_ARRAY2DEXPR_H
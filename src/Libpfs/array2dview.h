@@ -0,0 +1,169 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#ifndef PFS_ARRAY2DVIEW_H
+#define PFS_ARRAY2DVIEW_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+#include <Libpfs/array2d.h>
+
+//! \file array2dview.h
+//! \brief non-owning view on a rectangle of an Array2D
+//! \author agent <agent@local>
+
+namespace pfs {
+
+//!
+//! \brief Non-owning view on a rectangle of a 2D array in row-major order
+//!
+//! The view stores a pointer to its first element, its size and the stride
+//! (in elements) between two rows, so a sub-rectangle of an \c Array2D can be
+//! read (Array2DView<const Type>) or written (Array2DView<Type>) without
+//! copying it. The view is valid as long as the buffer of the viewed array is
+//! not reallocated (resize() or, for writable views, a copy-on-write detach
+//! of the array).
+//!
+template <typename Type>
+class Array2DView {
+   public:
+    typedef typename std::remove_const<Type>::type value_type;
+    typedef Array2DView<Type> self;
+    //! \brief \c const Array2D for read-only views
+    typedef typename std::conditional<std::is_const<Type>::value,
+                                      const Array2D<value_type>,
+                                      Array2D<value_type> >::type ArrayType;
+
+    typedef Type *iterator;
+
+    //! \brief empty view
+    Array2DView() : m_data(NULL), m_cols(0), m_rows(0), m_stride(0) {}
+
+    //! \brief view on \a cols times \a rows elements starting at \a data,
+    //! with \a stride elements between the beginning of two rows
+    Array2DView(Type *data, size_t cols, size_t rows, size_t stride)
+        : m_data(data), m_cols(cols), m_rows(rows), m_stride(stride) {
+        assert(stride >= cols);
+    }
+
+    //! \brief view on the whole \a array
+    Array2DView(ArrayType &array)
+        : m_data(array.data()),
+          m_cols(array.getCols()),
+          m_rows(array.getRows()),
+          m_stride(array.getCols()) {}
+
+    //! \brief view on the rectangle [x_ul, x_br) x [y_ul, y_br) of \a array
+    Array2DView(ArrayType &array, size_t x_ul, size_t y_ul, size_t x_br,
+                size_t y_br)
+        : m_data(NULL), m_cols(0), m_rows(0), m_stride(array.getCols()) {
+        assert(x_ul <= x_br && x_br <= array.getCols());
+        assert(y_ul <= y_br && y_br <= array.getRows());
+
+        m_data = array.data() + y_ul * m_stride + x_ul;
+        m_cols = x_br - x_ul;
+        m_rows = y_br - y_ul;
+    }
+
+    //! \brief a writable view can be read through a read-only one
+    template <typename OtherType>
+    Array2DView(const Array2DView<OtherType> &other,
+                typename std::enable_if<
+                    std::is_convertible<OtherType *, Type *>::value>::type * =
+                    NULL)
+        : m_data(other.data()),
+          m_cols(other.getCols()),
+          m_rows(other.getRows()),
+          m_stride(other.getStride()) {}
+
+    //! \brief Get number of columns or, in case of an image, width.
+    size_t getCols() const { return m_cols; }
+    //! \brief Get number of rows or, in case of an image, height.
+    size_t getRows() const { return m_rows; }
+    //! \brief elements between the beginning of two rows
+    size_t getStride() const { return m_stride; }
+
+    size_t size() const { return m_rows * m_cols; }
+    bool empty() const { return size() == 0; }
+
+    //! \brief true if the rows are stored one after the other, so that the
+    //! view can be processed as a single vector of size() elements
+    bool isContiguous() const { return m_stride == m_cols || m_rows <= 1; }
+
+    //! \brief first element of the view
+    Type *data() const { return m_data; }
+
+    Type &operator()(size_t col, size_t row) const {
+        assert(col < m_cols && row < m_rows);
+        return m_data[row * m_stride + col];
+    }
+
+    iterator row_begin(size_t r) const { return m_data + r * m_stride; }
+    iterator row_end(size_t r) const { return row_begin(r) + m_cols; }
+
+    //! \brief subscript operators, returns the row \a n
+    iterator operator[](size_t n) const { return row_begin(n); }
+
+    //! \brief view on the rectangle [x_ul, x_br) x [y_ul, y_br) of this view
+    self subView(size_t x_ul, size_t y_ul, size_t x_br, size_t y_br) const {
+        assert(x_ul <= x_br && x_br <= m_cols);
+        assert(y_ul <= y_br && y_br <= m_rows);
+
+        return self(row_begin(y_ul) + x_ul, x_br - x_ul, y_br - y_ul,
+                    m_stride);
+    }
+
+   private:
+    Type *m_data;
+
+    size_t m_cols;
+    size_t m_rows;
+    size_t m_stride;
+};
+
+typedef Array2DView<float> Array2DViewf;
+typedef Array2DView<const float> Array2DConstViewf;
+
+//! \brief Copy the content of \a from into \a to, which must have the same
+//! size
+template <typename Type>
+void copy(const Array2DView<const Type> &from, const Array2DView<Type> &to) {
+    assert(from.getCols() == to.getCols());
+    assert(from.getRows() == to.getRows());
+
+    if (from.isContiguous() && to.isContiguous()) {
+        std::copy(from.data(), from.data() + from.size(), to.data());
+        return;
+    }
+
+    int rEnd = static_cast<int>(from.getRows());
+#pragma omp parallel for
+    for (int r = 0; r < rEnd; r++) {
+        std::copy(from.row_begin(r), from.row_end(r), to.row_begin(r));
+    }
+}
+
+}  // namespace pfs
+
+#endif  // PFS_ARRAY2DVIEW_H
@@ -31,12 +31,14 @@
 
 #include "colorspace.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
 #include <map>
 
 #include "Libpfs/array2d.h"
+#include "Libpfs/array2dview.h"
 #include "Libpfs/pfs.h"
 #include "Libpfs/utils/msec_timer.h"
 
@@ -44,6 +46,7 @@
 #include "Libpfs/colorspace/xyz.h"
 #include "Libpfs/colorspace/yuv.h"
 #include "Libpfs/utils/transform.h"
+#include "Libpfs/utils/vecmath.h"
 
 #include <boost/assign.hpp>
 
@@ -52,6 +55,31 @@ using namespace boost::assign;
 
 namespace pfs {
 
+namespace {
+//! \brief samples processed at once by a thread
+const int MATRIX_BLOCK_SIZE = 16384;
+
+//! \brief linear conversion by \a matrix, with the vector kernel
+void transformMatrix3(const float matrix[3][3], const Array2Df *inC1,
+                      const Array2Df *inC2, const Array2Df *inC3,
+                      Array2Df *outC1, Array2Df *outC2, Array2Df *outC3) {
+    const float *in1 = inC1->data();
+    const float *in2 = inC2->data();
+    const float *in3 = inC3->data();
+    float *out1 = outC1->data();
+    float *out2 = outC2->data();
+    float *out3 = outC3->data();
+
+    const int size = static_cast<int>(inC1->size());
+#pragma omp parallel for
+    for (int idx = 0; idx < size; idx += MATRIX_BLOCK_SIZE) {
+        const int n = std::min(MATRIX_BLOCK_SIZE, size - idx);
+        utils::vmatrix3(matrix, in1 + idx, in2 + idx, in3 + idx, out1 + idx,
+                        out2 + idx, out3 + idx, n);
+    }
+}
+}
+
 //-----------------------------------------------------------
 // sRGB conversion functions
 //-----------------------------------------------------------
@@ -90,9 +118,8 @@ void transformRGB2XYZ(const Array2Df *inC1, const Array2Df *inC2,
     f_timer.start();
 #endif
 
-    utils::transform(inC1->begin(), inC1->end(), inC2->begin(), inC3->begin(),
-                     outC1->begin(), outC2->begin(), outC3->begin(),
-                     colorspace::ConvertRGB2XYZ());
+    transformMatrix3(colorspace::rgb2xyzD65Mat, inC1, inC2, inC3, outC1, outC2,
+                     outC3);
 
 #ifdef TIMER_PROFILING
     f_timer.stop_and_update();
@@ -153,9 +180,8 @@ void transformXYZ2RGB(const Array2Df *inC1, const Array2Df *inC2,
     f_timer.start();
 #endif
 
-    utils::transform(inC1->begin(), inC1->end(), inC2->begin(), inC3->begin(),
-                     outC1->begin(), outC2->begin(), outC3->begin(),
-                     colorspace::ConvertXYZ2RGB());
+    transformMatrix3(colorspace::xyz2rgbD65Mat, inC1, inC2, inC3, outC1, outC2,
+                     outC3);
 
 #ifdef TIMER_PROFILING
     f_timer.stop_and_update();
@@ -304,4 +330,18 @@ void transformColorSpace(ColorSpace inCS, const Array2Df *inC1,
     // CSTransformFunc func =
     (itTransform->second)(inC1, inC2, inC3, outC1, outC2, outC3);
 }
+
+void transformColorSpace(ColorSpace inCS, const Array2DView<const float> &inC1,
+                         const Array2DView<const float> &inC2,
+                         const Array2DView<const float> &inC3,
+                         ColorSpace outCS, Array2Df *outC1, Array2Df *outC2,
+                         Array2Df *outC3) {
+    // the transforms can work in place: copy the rectangle in the output
+    // channels and convert them
+    copy(inC1, Array2DView<float>(*outC1));
+    copy(inC2, Array2DView<float>(*outC2));
+    copy(inC3, Array2DView<float>(*outC3));
+
+    transformColorSpace(inCS, outC1, outC2, outC3, outCS, outC1, outC2, outC3);
+}
 }  // namespace pfs
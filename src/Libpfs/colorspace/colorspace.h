@@ -116,6 +116,16 @@ void transformColorSpace(ColorSpace inCS, const Array2Df *inC1,
                          const Array2Df *inC2, const Array2Df *inC3,
                          ColorSpace outCS, Array2Df *outC1, Array2Df *outC2,
                          Array2Df *outC3);
+
+//! \brief Transform the color channels of a rectangle (e.g. the channels of
+//! a FrameView) into \a outC1, \a outC2 and \a outC3, which must have the
+//! size of the rectangle. The rectangle is copied straight into the output
+//! channels and converted there, so no intermediate frame is allocated.
+void transformColorSpace(ColorSpace inCS, const Array2DView<const float> &inC1,
+                         const Array2DView<const float> &inC2,
+                         const Array2DView<const float> &inC3,
+                         ColorSpace outCS, Array2Df *outC1, Array2Df *outC2,
+                         Array2Df *outC3);
 }
 
 #endif  // COLORSPACE_H
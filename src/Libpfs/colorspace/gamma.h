@@ -23,6 +23,8 @@
 #define PFS_COLORSPACE_GAMMA_H
 
 #include <Libpfs/colorspace/convert.h>
+#include <Libpfs/utils/vecmath.h>
+#include <Libpfs/utils/vecmath_scalar.h>
 
 #include <cmath>
 
@@ -54,6 +56,34 @@ struct Gamma {
     }
 };
 
+//! \brief gamma correction of linear samples, as pfs::applyGamma(): the
+//! positive samples are raised to 1/gamma, the others set to zero. Both
+//! forms run the element function of utils::vpow(), so the results do not
+//! depend on the path taken.
+struct ChangeGamma {
+    explicit ChangeGamma(float gamma) : exponent(1.0f / gamma) {}
+
+    float operator()(float sample) const {
+        return utils::powKernel(sample, exponent);
+    }
+
+    void operator()(float i1, float i2, float i3, float &o1, float &o2,
+                    float &o3) const {
+        o1 = operator()(i1);
+        o2 = operator()(i2);
+        o3 = operator()(i3);
+    }
+
+    //! \brief block form (see pixelpipeline.h)
+    void operator()(float *c1, float *c2, float *c3, size_t size) const {
+        utils::vpow(c1, c1, size, exponent);
+        utils::vpow(c2, c2, size, exponent);
+        utils::vpow(c3, c3, size, exponent);
+    }
+
+    float exponent;
+};
+
 }  // colorspace
 }  // pfs
 
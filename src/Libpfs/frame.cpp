@@ -32,6 +32,8 @@
 
 #include "channel.h"
 #include "frame.h"
+#include "halfframe.h"
+#include "utils/trace.h"
 
 using namespace std;
 
@@ -39,6 +41,37 @@ namespace pfs {
 Frame::Frame(size_t width, size_t height)
     : m_width(width), m_height(height), m_X(NULL), m_Y(NULL), m_Z(NULL) {}
 
+Frame::Frame(const Frame &other)
+    : m_width(other.m_width),
+      m_height(other.m_height),
+      m_tags(other.m_tags),
+      m_half(other.m_half),
+      m_X(NULL),
+      m_Y(NULL),
+      m_Z(NULL) {
+    m_channels.reserve(other.m_channels.size());
+    for (ChannelContainer::const_iterator it = other.m_channels.begin();
+         it != other.m_channels.end(); ++it) {
+        Channel *ch = new Channel(**it);
+        m_channels.push_back(ch);
+
+        if (ch->getName() == "X") {
+            m_X = ch;
+        } else if (ch->getName() == "Y") {
+            m_Y = ch;
+        } else if (ch->getName() == "Z") {
+            m_Z = ch;
+        }
+    }
+}
+
+Frame &Frame::operator=(const Frame &other) {
+    Frame newState(other);
+    swap(newState);
+
+    return *this;
+}
+
 namespace {
 struct ChannelDeleter {
     template <typename T>
@@ -54,6 +87,7 @@ Frame::~Frame() {
 
 //! \brief Changes the size of the frame
 void Frame::resize(size_t width, size_t height) {
+    inflate();
     for_each(m_channels.begin(), m_channels.end(),
              boost::bind(&Channel::ChannelData::resize, _1, width, height));
 
@@ -77,6 +111,7 @@ struct FindChannel {
 
 void Frame::getXYZChannels(const Channel *&X, const Channel *&Y,
                            const Channel *&Z) const {
+    inflate();
     // find X
     if (m_X == NULL || m_Y == NULL || m_Z == NULL) {
         X = NULL;
@@ -143,6 +178,7 @@ void Frame::createXYZChannels(Channel *&X, Channel *&Y, Channel *&Z) {
 }
 
 const Channel *Frame::getChannel(const string &name) const {
+    inflate();
     ChannelContainer::const_iterator it =
         find_if(m_channels.begin(), m_channels.end(), FindChannel(name));
     if (it == m_channels.end())
@@ -157,6 +193,7 @@ Channel *Frame::getChannel(const string &name) {
 }
 
 Channel *Frame::createChannel(const string &name) {
+    inflate();
     Channel *ch = NULL;
     ChannelContainer::iterator it =
         find_if(m_channels.begin(), m_channels.end(), FindChannel(name));
@@ -180,6 +217,7 @@ Channel *Frame::createChannel(const string &name) {
 }
 
 void Frame::removeChannel(const string &channel) {
+    inflate();
     ChannelContainer::iterator it =
         find_if(m_channels.begin(), m_channels.end(), FindChannel(channel));
     if (it != m_channels.end()) {
@@ -197,9 +235,15 @@ void Frame::removeChannel(const string &channel) {
     }
 }
 
-ChannelContainer &Frame::getChannels() { return this->m_channels; }
+ChannelContainer &Frame::getChannels() {
+    inflate();
+    return this->m_channels;
+}
 
-const ChannelContainer &Frame::getChannels() const { return this->m_channels; }
+const ChannelContainer &Frame::getChannels() const {
+    inflate();
+    return this->m_channels;
+}
 
 TagContainer &Frame::getTags() { return m_tags; }
 
@@ -212,10 +256,33 @@ void Frame::swap(Frame &other) {
     swap(m_height, other.m_height);
     m_channels.swap(other.m_channels);
     m_tags.swap(other.m_tags);
+    m_half.swap(other.m_half);
 
     swap(m_X, other.m_X);
     swap(m_Y, other.m_Y);
     swap(m_Z, other.m_Z);
 }
 
+void Frame::setHalfChannels(const HalfFrame &half) {
+    for_each(m_channels.begin(), m_channels.end(), ChannelDeleter());
+    m_channels.clear();
+    m_X = m_Y = m_Z = NULL;
+
+    m_width = half.getWidth();
+    m_height = half.getHeight();
+    m_half = std::make_shared<const HalfFrame>(half);
+}
+
+void Frame::inflate() const {
+    if (!m_half) return;
+
+    utils::TraceScope trace("inflate_half", "frame");
+    trace.setBytes(size() * m_half->getChannels().size() * sizeof(float));
+
+    std::shared_ptr<const HalfFrame> half;
+    half.swap(m_half);
+    // only the mutable members are written
+    half->decodeRows(0, m_height, const_cast<Frame &>(*this));
+}
+
 }  // namespace pfs
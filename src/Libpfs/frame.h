@@ -38,6 +38,7 @@
 #include <Libpfs/tag.h>
 
 namespace pfs {
+class HalfFrame;
 
 typedef std::vector<Channel *> ChannelContainer;
 
@@ -45,9 +46,20 @@ typedef std::vector<Channel *> ChannelContainer;
 //! or more channels (e.g. color XYZ, depth channel, alpha
 //! channnel). All the channels are of the same size. Frame can
 //! also contain additional information in tags (see getTags).
+//!
+//! The channels can be stored in half precision (see setHalfChannels()), at
+//! half the memory. They are inflated to float by the first call that
+//! accesses them (getChannel(), getChannels(), ...), so that the code
+//! unaware of the half storage keeps working; the consumers that can work on
+//! the half samples (resize(), cut(), the viewers, the OpenEXR writer) test
+//! isHalf() first and read halfChannels() one band of rows at a time.
 class Frame {
    public:
     Frame(size_t width = 0, size_t height = 0);
+    //! \brief copy ctor: the channels share the buffers of \a other until
+    //! either frame writes them (see Array2D), so the copy is O(1)
+    Frame(const Frame &other);
+    Frame &operator=(const Frame &other);
     ~Frame();
 
     bool isValid() const { return (getWidth() > 0 && getHeight() > 0); }
@@ -127,17 +139,35 @@ class Frame {
 
     void swap(Frame &other);
 
+    //! \brief Replaces the channels (and the size) of the frame with the
+    //! half precision channels of \a half, which share their buffers. The
+    //! tags of the frame are kept.
+    void setHalfChannels(const HalfFrame &half);
+
+    //! \return true if the channels are stored in half precision
+    bool isHalf() const { return m_half.get() != NULL; }
+
+    //! \return the half precision channels, NULL unless isHalf()
+    const HalfFrame *halfChannels() const { return m_half.get(); }
+
+    //! \brief Converts the half precision channels to float. Like any other
+    //! access to the channels, it must not run concurrently with the readers
+    //! of the frame.
+    void inflate() const;
+
    private:
     size_t m_width;
     size_t m_height;
 
     TagContainer m_tags;
-    ChannelContainer m_channels;
+    // inflating the half precision channels does not change the frame
+    mutable ChannelContainer m_channels;
+    mutable std::shared_ptr<const HalfFrame> m_half;
 
     // cache for X Y Z
-    Channel *m_X;
-    Channel *m_Y;
-    Channel *m_Z;
+    mutable Channel *m_X;
+    mutable Channel *m_Y;
+    mutable Channel *m_Z;
 };
 
 typedef std::shared_ptr<pfs::Frame> FramePtr;
@@ -0,0 +1,90 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \author agent <agent@local>
+
+#include "frameview.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace pfs {
+
+FrameView::FrameView(const Frame &frame)
+    : m_frame(frame),
+      m_x(0),
+      m_y(0),
+      m_width(frame.getWidth()),
+      m_height(frame.getHeight()) {}
+
+FrameView::FrameView(const Frame &frame, size_t x_ul, size_t y_ul,
+                     size_t x_br, size_t y_br)
+    : m_frame(frame) {
+    // ----  Boundary Check!
+    x_br = std::min(x_br, frame.getWidth());
+    y_br = std::min(y_br, frame.getHeight());
+    x_ul = std::min(x_ul, x_br);
+    y_ul = std::min(y_ul, y_br);
+
+    m_x = x_ul;
+    m_y = y_ul;
+    m_width = x_br - x_ul;
+    m_height = y_br - y_ul;
+}
+
+bool FrameView::isFullFrame() const {
+    return m_x == 0 && m_y == 0 && m_width == m_frame.getWidth() &&
+           m_height == m_frame.getHeight();
+}
+
+FrameView::ChannelView FrameView::getChannel(const Channel &channel) const {
+    assert(channel.getWidth() == m_frame.getWidth());
+    assert(channel.getHeight() == m_frame.getHeight());
+
+    return ChannelView(channel, m_x, m_y, m_x + m_width, m_y + m_height);
+}
+
+FrameView::ChannelView FrameView::getChannel(const std::string &name) const {
+    const Channel *channel = m_frame.getChannel(name);
+    if (channel == NULL) {
+        return ChannelView();
+    }
+    return getChannel(*channel);
+}
+
+bool FrameView::getXYZChannels(ChannelView &X, ChannelView &Y,
+                               ChannelView &Z) const {
+    const Channel *X_;
+    const Channel *Y_;
+    const Channel *Z_;
+    m_frame.getXYZChannels(X_, Y_, Z_);
+    if (X_ == NULL) {
+        X = Y = Z = ChannelView();
+        return false;
+    }
+
+    X = getChannel(*X_);
+    Y = getChannel(*Y_);
+    Z = getChannel(*Z_);
+    return true;
+}
+
+}  // namespace pfs
@@ -0,0 +1,94 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief PFS library - read-only view on a rectangle of a Frame
+//! \author agent <agent@local>
+
+#ifndef PFS_FRAMEVIEW_H
+#define PFS_FRAMEVIEW_H
+
+#include <cstddef>
+#include <string>
+
+#include <Libpfs/array2dview.h>
+#include <Libpfs/frame.h>
+
+namespace pfs {
+
+//! \brief Non-owning, read-only view on a rectangle of a Frame (e.g. the
+//! selection of the user). The channels are read through Array2DView, so
+//! nothing is copied until the view is materialized by pfs::cut() or
+//! resampled by pfs::resize(). The frame must outlive the view.
+class FrameView {
+   public:
+    typedef Array2DView<const float> ChannelView;
+
+    //! \brief view on the whole \a frame
+    explicit FrameView(const Frame &frame);
+
+    //! \brief view on the rectangle [x_ul, x_br) x [y_ul, y_br) of \a frame.
+    //! The rectangle is clipped to the frame.
+    FrameView(const Frame &frame, size_t x_ul, size_t y_ul, size_t x_br,
+              size_t y_br);
+
+    //! \return width of the view (in pixels)
+    size_t getWidth() const { return m_width; }
+    //! \return height of the view (in pixels)
+    size_t getHeight() const { return m_height; }
+    //! \return height * width
+    size_t size() const { return m_height * m_width; }
+    //! \return position of the upper left corner in the frame
+    size_t getX() const { return m_x; }
+    size_t getY() const { return m_y; }
+
+    //! \return true if the view covers the whole frame
+    bool isFullFrame() const;
+
+    const Frame &getFrame() const { return m_frame; }
+    const ChannelContainer &getChannels() const {
+        return m_frame.getChannels();
+    }
+    const TagContainer &getTags() const { return m_frame.getTags(); }
+
+    //! \return view on the rectangle of \a channel, which must belong to the
+    //! frame
+    ChannelView getChannel(const Channel &channel) const;
+
+    //! \return view on the rectangle of the channel \a name, or an empty view
+    //! if the channel does not exist
+    ChannelView getChannel(const std::string &name) const;
+
+    //! \brief Gets the views on the XYZ channels
+    //! \return false (and empty views) if the frame has no XYZ channels
+    bool getXYZChannels(ChannelView &X, ChannelView &Y, ChannelView &Z) const;
+
+   private:
+    const Frame &m_frame;
+
+    size_t m_x;
+    size_t m_y;
+    size_t m_width;
+    size_t m_height;
+};
+
+}  // namespace pfs
+
+#endif  // PFS_FRAMEVIEW_H
@@ -0,0 +1,106 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \author agent <agent@local>
+
+#include "halfframe.h"
+
+#include <cassert>
+
+#include "frame.h"
+
+namespace pfs {
+
+HalfFrame::HalfFrame(size_t width, size_t height)
+    : m_width(width), m_height(height) {}
+
+HalfFrame::HalfFrame(const Frame &frame)
+    : m_width(frame.getWidth()),
+      m_height(frame.getHeight()),
+      m_tags(frame.getTags()) {
+    encodeRows(frame, 0);
+}
+
+const HalfChannel *HalfFrame::getChannel(const std::string &name) const {
+    for (HalfChannelContainer::const_iterator it = m_channels.begin();
+         it != m_channels.end(); ++it) {
+        if (it->getName() == name) {
+            return &(*it);
+        }
+    }
+    return NULL;
+}
+
+HalfChannel *HalfFrame::getChannel(const std::string &name) {
+    return const_cast<HalfChannel *>(
+        static_cast<const HalfFrame &>(*this).getChannel(name));
+}
+
+HalfChannel *HalfFrame::createChannel(const std::string &name) {
+    HalfChannel *ch = getChannel(name);
+    if (ch == NULL) {
+        m_channels.push_back(HalfChannel(m_width, m_height, name));
+        ch = &m_channels.back();
+    }
+    return ch;
+}
+
+void HalfFrame::decode(Frame &frame) const {
+    Frame tempFrame;
+    decodeRows(0, m_height, tempFrame);
+    tempFrame.getTags() = m_tags;
+
+    frame.swap(tempFrame);
+}
+
+void HalfFrame::decodeRows(size_t firstRow, size_t rows, Frame &band) const {
+    assert(firstRow + rows <= m_height);
+
+    if (band.getWidth() != m_width || band.getHeight() != rows) {
+        band.resize(m_width, rows);
+    }
+    for (HalfChannelContainer::const_iterator it = m_channels.begin();
+         it != m_channels.end(); ++it) {
+        Channel *out = band.createChannel(it->getName());
+        out->getTags() = it->getTags();
+
+        utils::halfToFloat(it->data() + firstRow * m_width, out->data(),
+                           rows * m_width);
+    }
+}
+
+void HalfFrame::encodeRows(const Frame &band, size_t firstRow) {
+    assert(band.getWidth() == m_width);
+    assert(firstRow + band.getHeight() <= m_height);
+
+    const ChannelContainer &channels = band.getChannels();
+    for (ChannelContainer::const_iterator it = channels.begin();
+         it != channels.end(); ++it) {
+        const Channel *in = *it;
+        HalfChannel *out = createChannel(in->getName());
+        out->getTags() = in->getTags();
+
+        utils::floatToHalf(in->data(), out->data() + firstRow * m_width,
+                           band.size());
+    }
+}
+
+}  // namespace pfs
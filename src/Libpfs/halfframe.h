@@ -0,0 +1,120 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief PFS library - Frame with half precision (fp16) channels
+//! \author agent <agent@local>
+
+#ifndef PFS_HALFFRAME_H
+#define PFS_HALFFRAME_H
+
+#include <cstddef>
+#include <string>
+#include <deque>
+
+#include <Libpfs/array2d.h>
+#include <Libpfs/tag.h>
+#include <Libpfs/utils/float16.h>
+
+namespace pfs {
+class Frame;
+
+//! \brief rows decoded at a time by the consumers of a HalfFrame
+const size_t HALF_BAND_ROWS = 64;
+
+//! \brief Channel storing half precision samples (the bits of OpenEXR HALF)
+class HalfChannel : public Array2D<utils::float16> {
+   public:
+    typedef Array2D<utils::float16> ChannelData;
+
+    HalfChannel(size_t width, size_t height, const std::string &channelName)
+        : ChannelData(width, height), m_name(channelName), m_tags() {}
+
+    size_t getWidth() const { return getCols(); }
+    size_t getHeight() const { return getRows(); }
+    const std::string &getName() const { return m_name; }
+
+    TagContainer &getTags() { return m_tags; }
+    const TagContainer &getTags() const { return m_tags; }
+
+   private:
+    std::string m_name;
+    TagContainer m_tags;
+};
+
+//! \brief Channels of a Frame at half the memory of the float channels, for
+//! the frames kept in memory but processed rarely (the HDR of a viewer, the
+//! source of a batch). A Frame stores its channels in a HalfFrame when it is
+//! read from an OpenEXR file of HALF samples (see Frame::isHalf()). The 11
+//! bits of mantissa are below the noise of any real HDR, and the range is
+//! clamped to utils::FLOAT16_MAX.
+//!
+//! The channels are converted with F16C (when available) one band of rows
+//! at a time: decodeRows() and encodeRows() let a consumer work on float
+//! bands of HALF_BAND_ROWS rows without inflating the whole frame. The copies
+//! share the buffers (see Array2D).
+class HalfFrame {
+   public:
+    // a deque keeps the channels in place when a channel is added
+    typedef std::deque<HalfChannel> HalfChannelContainer;
+
+    HalfFrame(size_t width = 0, size_t height = 0);
+    //! \brief encode all the channels and tags of \a frame
+    explicit HalfFrame(const Frame &frame);
+
+    bool isValid() const { return (getWidth() > 0 && getHeight() > 0); }
+    size_t getWidth() const { return m_width; }
+    size_t getHeight() const { return m_height; }
+    size_t size() const { return m_height * m_width; }
+
+    //! \return the named channel, NULL if the channel does not exist
+    HalfChannel *getChannel(const std::string &name);
+    const HalfChannel *getChannel(const std::string &name) const;
+    //! \return existing or newly created channel
+    HalfChannel *createChannel(const std::string &name);
+
+    HalfChannelContainer &getChannels() { return m_channels; }
+    const HalfChannelContainer &getChannels() const { return m_channels; }
+
+    TagContainer &getTags() { return m_tags; }
+    const TagContainer &getTags() const { return m_tags; }
+
+    //! \brief inflate all the channels and tags in \a frame
+    void decode(Frame &frame) const;
+
+    //! \brief inflate \a rows rows from \a firstRow in \a band (resized to
+    //! getWidth() x rows), creating the channels of this frame
+    void decodeRows(size_t firstRow, size_t rows, Frame &band) const;
+
+    //! \brief store the channels of \a band, which have getWidth() columns,
+    //! from \a firstRow. The channels are created if they do not exist.
+    void encodeRows(const Frame &band, size_t firstRow);
+
+   private:
+    size_t m_width;
+    size_t m_height;
+
+    TagContainer m_tags;
+    HalfChannelContainer m_channels;
+};
+
+}  // namespace pfs
+
+#endif  // PFS_HALFFRAME_H
@@ -0,0 +1,59 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief Parameters shared by EXRReader and EXRWriter
+//! \author agent <agent@local>
+
+#ifndef PFS_IO_EXRCOMMON_H
+#define PFS_IO_EXRCOMMON_H
+
+#include <ImfThreading.h>
+#include <cstddef>
+
+#include <Libpfs/params.h>
+
+namespace pfs {
+namespace io {
+
+//! \brief rows decoded (or converted to half) at once when the frame
+//! cannot be read (or written) in a single call. Multiple of the 32 rows
+//! of the PIZ, B44 and DWAA blocks.
+static const size_t EXR_BAND_ROWS = 256;
+
+//! \brief set the size of the OpenEXR global thread pool to the value of
+//! the "exr.threads" parameter (0 disables the threading)
+//! \return true if the parameter is set: the files opened before the call
+//! keep their previous number of threads
+inline bool setExrThreads(const Params &params) {
+    int threads;
+    if (!params.get("exr.threads", threads) || threads < 0) {
+        return false;
+    }
+    if (threads != Imf::globalThreadCount()) {
+        Imf::setGlobalThreadCount(threads);
+    }
+    return true;
+}
+
+}  // io
+}  // pfs
+
+#endif  // PFS_IO_EXRCOMMON_H
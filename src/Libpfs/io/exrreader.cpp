@@ -32,12 +32,17 @@
 #include <ImfStandardAttributes.h>
 #include <ImfStringAttribute.h>
 
+#include <algorithm>
+#include <cassert>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include <Libpfs/frame.h>
+#include <Libpfs/halfframe.h>
+#include <Libpfs/io/exrcommon.h>
 #include <Libpfs/io/exrreader.h>
 #include <Libpfs/io/ioexception.h>
 
@@ -57,11 +62,155 @@ static string escapeString(const string &src) {
     }
     return ret;
 }
+
+//! \brief insert into \a frameBuffer the RGB slices writing into \a X, \a Y
+//! and \a Z, whose first row is row \a firstRow of the data window
+void insertRGBSlices(FrameBuffer &frameBuffer, pfs::Channel *X,
+                     pfs::Channel *Y, pfs::Channel *Z, const Box2i &dtw,
+                     int firstRow) {
+    const size_t width = X->getWidth();
+    const char *names[] = {"R", "G", "B"};
+    pfs::Channel *channels[] = {X, Y, Z};
+
+    for (int c = 0; c < 3; ++c) {
+        frameBuffer.insert(
+            names[c],     // name
+            Slice(FLOAT,  // type
+                  (char *)(channels[c]->data() - dtw.min.x - firstRow * width),
+                  sizeof(float),          // xStride
+                  sizeof(float) * width,  // yStride
+                  1, 1,                   // x/y sampling
+                  0.0));                  // fillValue
+    }
+}
+
+//! \brief read into \a X, \a Y and \a Z the window of their size whose top
+//! left corner is (\a x0, \a y0), relative to the data window
+void readWindow(InputFile &file, const Box2i &dtw, size_t x0, size_t y0,
+                pfs::Channel *X, pfs::Channel *Y, pfs::Channel *Z) {
+    const size_t dataWidth = dtw.max.x - dtw.min.x + 1;
+    const size_t width = X->getWidth();
+    const size_t height = X->getHeight();
+
+    if (width == dataWidth) {
+        const int firstRow = dtw.min.y + static_cast<int>(y0);
+        FrameBuffer frameBuffer;
+        insertRGBSlices(frameBuffer, X, Y, Z, dtw, firstRow);
+
+        file.setFrameBuffer(frameBuffer);
+        file.readPixels(firstRow, firstRow + static_cast<int>(height) - 1);
+        return;
+    }
+
+    // OpenEXR decodes whole scanlines: decode the rows of the window one band
+    // at a time, and keep the requested columns
+    const size_t bandRows = std::min(height, pfs::io::EXR_BAND_ROWS);
+    pfs::Frame band(dataWidth, bandRows);
+    pfs::Channel *bandX, *bandY, *bandZ;
+    band.createXYZChannels(bandX, bandY, bandZ);
+
+    const pfs::Channel *in[] = {bandX, bandY, bandZ};
+    pfs::Channel *out[] = {X, Y, Z};
+    for (size_t row = 0; row < height; row += bandRows) {
+        const size_t rows = std::min(bandRows, height - row);
+        const int firstRow = dtw.min.y + static_cast<int>(y0 + row);
+
+        FrameBuffer frameBuffer;
+        insertRGBSlices(frameBuffer, bandX, bandY, bandZ, dtw, firstRow);
+        file.setFrameBuffer(frameBuffer);
+        file.readPixels(firstRow, firstRow + static_cast<int>(rows) - 1);
+
+        for (int c = 0; c < 3; ++c) {
+            for (size_t r = 0; r < rows; ++r) {
+                std::copy(in[c]->row_begin(r) + x0,
+                          in[c]->row_begin(r) + x0 + width,
+                          out[c]->row_begin(row + r));
+            }
+        }
+    }
+}
+
+//! \brief copy the string attributes of \a header to the tags of \a frame
+//! (pfs::Frame or pfs::HalfFrame) and of its channels
+template <typename FrameType>
+void copyAttributesToTags(const Header &header, FrameType &frame) {
+    for (Header::ConstIterator it = header.begin(), itEnd = header.end();
+         it != itEnd; ++it) {
+        const char *attribName = it.name();
+        const StringAttribute *attrib =
+            header.findTypedAttribute<StringAttribute>(attribName);
+
+        if (attrib == NULL) continue;  // Skip if type is not String
+
+        // fprintf( stderr, "Tag: %s = %s\n", attribName,
+        // attrib->value().c_str() );
+
+        const char *colon = strstr(attribName, ":");
+        if (colon == NULL)  // frame tag
+        {
+            frame.getTags().setTag(attribName, escapeString(attrib->value()));
+        } else  // channel tag
+        {
+            std::string channelName = string(attribName, colon - attribName);
+            auto *ch = frame.getChannel(channelName);
+            if (ch == NULL) {
+                std::cerr << " Warning! Can not set tag for " << channelName
+                          << " channel because it does not exist\n";
+            } else {
+                ch->getTags().setTag(colon + 1, escapeString(attrib->value()));
+            }
+        }
+    }
+}
+
+//! \return true if the R, G and B channels of \a header hold HALF samples
+bool hasHalfRGB(const Header &header) {
+    const char *names[] = {"R", "G", "B"};
+    for (int c = 0; c < 3; ++c) {
+        const Imf::Channel *channel = header.channels().findChannel(names[c]);
+        if (channel == NULL || channel->type != HALF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void applyWhiteLuminance(pfs::Frame &frame, float scaleFactor) {
+    pfs::Channel *X, *Y, *Z;
+    frame.getXYZChannels(X, Y, Z);
+
+    int pixelCount = frame.getHeight() * frame.getWidth();
+    for (int i = 0; i < pixelCount; i++) {
+        (*X)(i) *= scaleFactor;
+        (*Y)(i) *= scaleFactor;
+        (*Z)(i) *= scaleFactor;
+    }
+}
 }
 
 namespace pfs {
 namespace io {
 
+//! \brief window of the data window to read: the whole image by default. A
+//! width or height of 0 extends the window to the border of the image
+struct EXRReaderParams {
+    EXRReaderParams() : x_(0), y_(0), width_(0), height_(0), half_(false) {}
+
+    void parse(const Params &params) {
+        params.get("exr.window_x", x_);
+        params.get("exr.window_y", y_);
+        params.get("exr.window_width", width_);
+        params.get("exr.window_height", height_);
+        params.get("exr.half", half_);
+    }
+
+    size_t x_;
+    size_t y_;
+    size_t width_;
+    size_t height_;
+    bool half_;
+};
+
 class EXRReader::EXRReaderData {
    public:
     explicit EXRReaderData(const string &filename)
@@ -128,6 +277,17 @@ void EXRReader::open() {
     setHeight(height);
 }
 
+void EXRReader::probeFormat(FrameInfo &info, const Params &) {
+    const ChannelList &channels = m_data->file_.header().channels();
+    const Imf::Channel *red = channels.findChannel("R");
+    assert(red != NULL);
+
+    info.channels = 3;
+    info.hasAlpha = (channels.findChannel("A") != NULL);
+    info.bitDepth = (red->type == Imf::HALF) ? 16 : 32;
+    info.isFloat = (red->type != Imf::UINT);
+}
+
 void EXRReader::close() {
     m_data.reset();
 
@@ -135,45 +295,44 @@ void EXRReader::close() {
     setHeight(0);
 }
 
-void EXRReader::read(Frame &frame, const Params & /*params*/) {
-    if (!isOpen()) open();
+void EXRReader::read(Frame &frame, const Params &params) {
+    // the number of threads of the file is set when it is opened
+    if (setExrThreads(params) || !isOpen()) open();
+
+    EXRReaderParams p;
+    p.parse(params);
+    if (p.x_ >= width() || p.y_ >= height()) {
+        throw pfs::io::ReadException("EXRReader: the window is outside of " +
+                                     filename());
+    }
+    const size_t W =
+        p.width_ ? std::min(p.width_, width() - p.x_) : width() - p.x_;
+    const size_t H =
+        p.height_ ? std::min(p.height_, height() - p.y_) : height() - p.y_;
 
     // helpers...
     InputFile &file = m_data->file_;
     Box2i &dtw = m_data->dtw_;
 
-    pfs::Frame tempFrame(width(), height());
+    // the HALF samples of the whole image are kept as they are, unless they
+    // have to be scaled
+    if (p.half_ && W == width() && H == height() &&
+        hasHalfRGB(file.header()) && !hasWhiteLuminance(file.header())) {
+        pfs::HalfFrame half;
+        readHalf(half, params);
+
+        pfs::Frame tempFrame;
+        tempFrame.getTags().swap(half.getTags());
+        tempFrame.setHalfChannels(half);
+
+        frame.swap(tempFrame);
+        return;
+    }
+
+    pfs::Frame tempFrame(W, H);
     pfs::Channel *X, *Y, *Z;
     tempFrame.createXYZChannels(X, Y, Z);
 
-    FrameBuffer frameBuffer;
-    frameBuffer.insert(
-        "R",          // name
-        Slice(FLOAT,  // type
-              (char *)(X->data() - dtw.min.x - dtw.min.y * width()),
-              sizeof(float),            // xStride
-              sizeof(float) * width(),  // yStride
-              1, 1,                     // x/y sampling
-              0.0));                    // fillValue
-
-    frameBuffer.insert(
-        "G",          // name
-        Slice(FLOAT,  // type
-              (char *)(Y->data() - dtw.min.x - dtw.min.y * width()),
-              sizeof(float),            // xStride
-              sizeof(float) * width(),  // yStride
-              1, 1,                     // x/y sampling
-              0.0));                    // fillValue
-
-    frameBuffer.insert(
-        "B",          // name
-        Slice(FLOAT,  // type
-              (char *)(Z->data() - dtw.min.x - dtw.min.y * width()),
-              sizeof(float),            // xStride
-              sizeof(float) * width(),  // yStride
-              1, 1,                     // x/y sampling
-              0.0));                    // fillValue
-
     // I know I have the channels I need because I have checked that I have the
     // RGB channels. Hence, I don't load any further that that...
     /*
@@ -203,61 +362,112 @@ void EXRReader::read(Frame &frame, const Params & /*params*/) {
     */
 
     // Copy attributes to tags
-    for (Header::ConstIterator it = file.header().begin(),
-                               itEnd = file.header().end();
-         it != itEnd; ++it) {
-        const char *attribName = it.name();
-        const StringAttribute *attrib =
-            file.header().findTypedAttribute<StringAttribute>(attribName);
+    copyAttributesToTags(file.header(), tempFrame);
 
-        if (attrib == NULL) continue;  // Skip if type is not String
+    readWindow(file, dtw, p.x_, p.y_, X, Y, Z);
 
-        // fprintf( stderr, "Tag: %s = %s\n", attribName,
-        // attrib->value().c_str() );
+    // Rescale values if WhiteLuminance is present
+    if (hasWhiteLuminance(file.header())) {
+        applyWhiteLuminance(tempFrame, whiteLuminance(file.header()));
 
-        const char *colon = strstr(attribName, ":");
-        if (colon == NULL)  // frame tag
-        {
-            tempFrame.getTags().setTag(attribName,
-                                       escapeString(attrib->value()));
-        } else  // channel tag
-        {
-            std::string channelName = string(attribName, colon - attribName);
-            pfs::Channel *ch = tempFrame.getChannel(channelName);
-            if (ch == NULL) {
-                std::cerr << " Warning! Can not set tag for " << channelName
-                          << " channel because it does not exist\n";
-            } else {
-                ch->getTags().setTag(colon + 1, escapeString(attrib->value()));
-            }
+        // const StringAttribute *relativeLum =
+        // file.header().findTypedAttribute<StringAttribute>("RELATIVE_LUMINANCE");
+
+        std::string luminanceTag = tempFrame.getTags().getTag("LUMINANCE");
+        if (luminanceTag.empty()) {
+            tempFrame.getTags().setTag("LUMINANCE", "ABSOLUTE");
         }
     }
 
+    tempFrame.getTags().setTag("FILE_NAME", filename());
+
+    frame.swap(tempFrame);
+}
+
+void EXRReader::readHalf(HalfFrame &frame, const Params &params) {
+    if (setExrThreads(params) || !isOpen()) open();
+
+    InputFile &file = m_data->file_;
+    Box2i &dtw = m_data->dtw_;
+
+    pfs::HalfFrame tempFrame(width(), height());
+    pfs::HalfChannel *channels[] = {tempFrame.createChannel("X"),
+                                    tempFrame.createChannel("Y"),
+                                    tempFrame.createChannel("Z")};
+    copyAttributesToTags(file.header(), tempFrame);
+
+    // OpenEXR converts FLOAT files to HALF
+    const char *names[] = {"R", "G", "B"};
+    FrameBuffer frameBuffer;
+    for (int c = 0; c < 3; ++c) {
+        frameBuffer.insert(
+            names[c],
+            Slice(HALF, (char *)(channels[c]->data() - dtw.min.x -
+                                 dtw.min.y * width()),
+                  sizeof(utils::float16),             // xStride
+                  sizeof(utils::float16) * width(),  // yStride
+                  1, 1,                               // x/y sampling
+                  0.0));                              // fillValue
+    }
     file.setFrameBuffer(frameBuffer);
     file.readPixels(dtw.min.y, dtw.max.y);
 
-    // Rescale values if WhiteLuminance is present
     if (hasWhiteLuminance(file.header())) {
-        float scaleFactor = whiteLuminance(file.header());
-        int pixelCount = tempFrame.getHeight() * tempFrame.getWidth();
-
-        for (int i = 0; i < pixelCount; i++) {
-            (*X)(i) *= scaleFactor;
-            (*Y)(i) *= scaleFactor;
-            (*Z)(i) *= scaleFactor;
+        const float scaleFactor = whiteLuminance(file.header());
+        std::vector<float> row(width());
+        for (int c = 0; c < 3; ++c) {
+            for (size_t y = 0; y < height(); ++y) {
+                utils::float16 *data = channels[c]->data() + y * width();
+                utils::halfToFloat(data, row.data(), width());
+                for (size_t x = 0; x < width(); ++x) {
+                    row[x] *= scaleFactor;
+                }
+                utils::floatToHalf(row.data(), data, width());
+            }
         }
-
-        // const StringAttribute *relativeLum =
-        // file.header().findTypedAttribute<StringAttribute>("RELATIVE_LUMINANCE");
-
-        std::string luminanceTag = tempFrame.getTags().getTag("LUMINANCE");
-        if (luminanceTag.empty()) {
+        if (tempFrame.getTags().getTag("LUMINANCE").empty()) {
             tempFrame.getTags().setTag("LUMINANCE", "ABSOLUTE");
         }
     }
 
     tempFrame.getTags().setTag("FILE_NAME", filename());
 
+    std::swap(frame, tempFrame);
+}
+
+void EXRReader::openBands(const Params &params) {
+    if (setExrThreads(params) || !isOpen()) open();
+}
+
+bool EXRReader::streamsBands() { return true; }
+
+void EXRReader::readBand(Frame &frame, size_t firstRow, size_t rows,
+                         const Params & /*params*/) {
+    if (!isOpen()) open();
+
+    assert(firstRow + rows <= height());
+
+    InputFile &file = m_data->file_;
+    Box2i &dtw = m_data->dtw_;
+
+    pfs::Frame tempFrame(width(), rows);
+    pfs::Channel *X, *Y, *Z;
+    tempFrame.createXYZChannels(X, Y, Z);
+
+    // only the scanlines (or the lines of tiles) of the band are decoded
+    const int y0 = dtw.min.y + static_cast<int>(firstRow);
+    FrameBuffer frameBuffer;
+    insertRGBSlices(frameBuffer, X, Y, Z, dtw, y0);
+
+    file.setFrameBuffer(frameBuffer);
+    file.readPixels(y0, y0 + static_cast<int>(rows) - 1);
+
+    if (hasWhiteLuminance(file.header())) {
+        applyWhiteLuminance(tempFrame, whiteLuminance(file.header()));
+    }
+
+    tempFrame.getTags().setTag("FILE_NAME", filename());
+
     frame.swap(tempFrame);
 }
 
@@ -25,6 +25,8 @@
 #include <Libpfs/io/framereader.h>
 
 namespace pfs {
+class HalfFrame;
+
 namespace io {
 
 class EXRReader : public FrameReader {
@@ -36,9 +38,24 @@ class EXRReader : public FrameReader {
 
     void close();
     void open();
+    //! \brief read the file, or the window set by the "exr.window_x",
+    //! "exr.window_y", "exr.window_width" and "exr.window_height" parameters
+    //! (size_t), decoding only its scanlines. "exr.threads" (int) sets the
+    //! size of the OpenEXR thread pool. With "exr.half" (bool), the HALF
+    //! samples of a whole file are stored in half precision in \a frame
+    //! (see Frame::isHalf()) instead of being inflated to float.
     void read(Frame &frame, const Params &params);
+    //! \brief read the whole file in half precision, without inflating it to
+    //! float. "exr.threads" (int) sets the size of the OpenEXR thread pool.
+    void readHalf(HalfFrame &frame, const Params &params);
+    void openBands(const Params &params);
+    void readBand(Frame &frame, size_t firstRow, size_t rows,
+                  const Params &params);
+    bool streamsBands();
 
    protected:
+    void probeFormat(FrameInfo &info, const Params &params);
+
     class EXRReaderData;
 
     std::unique_ptr<EXRReaderData> m_data;
@@ -26,12 +26,23 @@
 #include <ImfRgbaFile.h>
 #include <ImfStandardAttributes.h>
 #include <ImfStringAttribute.h>
+#include <OpenEXRConfig.h>
+#include <half.h>
 
+#include <algorithm>
 #include <cmath>
+#include <iostream>
+#include <map>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include <Libpfs/frame.h>
+#include <Libpfs/halfframe.h>
+#include <Libpfs/io/exrcommon.h>
 #include <Libpfs/io/exrwriter.h>
+#include <Libpfs/io/ioexception.h>
+#include <Libpfs/utils/string.h>
 
 // #define min(x,y) ( (x)<(y) ? (x) : (y) )
 
@@ -39,22 +50,158 @@ using namespace Imf;
 using namespace Imath;
 using namespace std;
 
+#if defined(OPENEXR_VERSION_MAJOR) && \
+    (OPENEXR_VERSION_MAJOR * 100 + OPENEXR_VERSION_MINOR >= 202)
+#define EXR_HAS_DWA_COMPRESSION
+#endif
+
 namespace pfs {
 namespace io {
 
-EXRWriter::EXRWriter(const string &filename) : FrameWriter(filename) {}
+typedef std::map<std::string, Compression, utils::StringUnsensitiveComp>
+    CompressionMap;
+
+static CompressionMap buildCompressionMap() {
+    CompressionMap compressions;
+    compressions["none"] = NO_COMPRESSION;
+    compressions["rle"] = RLE_COMPRESSION;
+    compressions["zips"] = ZIPS_COMPRESSION;
+    compressions["zip"] = ZIP_COMPRESSION;
+    compressions["piz"] = PIZ_COMPRESSION;
+    compressions["pxr24"] = PXR24_COMPRESSION;
+    compressions["b44"] = B44_COMPRESSION;
+    compressions["b44a"] = B44A_COMPRESSION;
+#ifdef EXR_HAS_DWA_COMPRESSION
+    compressions["dwaa"] = DWAA_COMPRESSION;
+    compressions["dwab"] = DWAB_COMPRESSION;
+#endif
+    return compressions;
+}
+
+struct EXRWriterParams {
+    EXRWriterParams() : compression_(PIZ_COMPRESSION), half_(false) {}
+
+    void parse(const Params &params) {
+        std::string compression;
+        if (params.get("exr.compression", compression)) {
+            static const CompressionMap compressions = buildCompressionMap();
+            CompressionMap::const_iterator it = compressions.find(compression);
+            if (it == compressions.end()) {
+                throw pfs::io::WriteException(
+                    "EXRWriter: unsupported compression " + compression);
+            }
+            compression_ = it->second;
+        }
+        params.get("exr.half", half_);
+    }
+
+    Compression compression_;
+    bool half_;
+};
+
+ostream &operator<<(ostream &out, const EXRWriterParams &params) {
+    stringstream ss;
+    ss << "EXRWriterParams: [";
+    ss << "compression: " << params.compression_ << ", ";
+    ss << "half: " << params.half_ << "]";
+    return (out << ss.str());
+}
+
+//! \brief write \a R, \a G and \a B as HALF samples, converting one band
+//! of rows at a time
+static void writeHalfPixels(OutputFile &file, const pfs::Channel *R,
+                            const pfs::Channel *G, const pfs::Channel *B) {
+    const size_t width = R->getWidth();
+    const size_t height = R->getHeight();
+    const size_t bandRows = std::min(height, EXR_BAND_ROWS);
+
+    const char *names[] = {"R", "G", "B"};
+    const pfs::Channel *channels[] = {R, G, B};
+    std::vector<half> buffer(3 * bandRows * width);
+
+    for (size_t row = 0; row < height; row += bandRows) {
+        const size_t rows = std::min(bandRows, height - row);
+
+        FrameBuffer frameBuffer;
+        for (int c = 0; c < 3; ++c) {
+            half *band = buffer.data() + c * bandRows * width;
+            // values above HALF_MAX would become infinite
+            std::transform(channels[c]->row_begin(row),
+                           channels[c]->row_begin(row) + rows * width, band,
+                           [](float v) {
+                               return half(std::max(std::min(v, HALF_MAX),
+                                                    -HALF_MAX));
+                           });
+
+            // the base address is the one of the first row of the frame
+            frameBuffer.insert(names[c],
+                               Slice(HALF, (char *)(band - row * width),
+                                     sizeof(half),           // xStride
+                                     sizeof(half) * width));  // yStride
+        }
+
+        file.setFrameBuffer(frameBuffer);
+        file.writePixels(static_cast<int>(rows));
+    }
+}
+
+//! \brief write the half precision channels of \a frame, whose tags are
+//! already in \a header, as samples of \a type: the HALF samples are not
+//! copied, and OpenEXR converts them to FLOAT if needed
+static void writeHalfChannels(const std::string &filename, Header &header,
+                              const pfs::HalfFrame &frame, PixelType type) {
+    const pfs::HalfFrame::HalfChannelContainer &channels =
+        frame.getChannels();
+    for (pfs::HalfFrame::HalfChannelContainer::const_iterator ch =
+             channels.begin();
+         ch != channels.end(); ++ch) {
+        for (pfs::TagContainer::const_iterator it = ch->getTags().begin();
+             it != ch->getTags().end(); ++it) {
+            header.insert(string(ch->getName() + ":" + it->first).c_str(),
+                          StringAttribute(it->second));
+        }
+    }
 
-bool EXRWriter::write(const Frame &frame, const Params & /*params*/) {
     // Channels are named (X Y Z) but contain (R G B) data
-    const pfs::Channel *R, *G, *B;
-    frame.getXYZChannels(R, G, B);
+    const pfs::HalfChannel *rgb[] = {frame.getChannel("X"),
+                                     frame.getChannel("Y"),
+                                     frame.getChannel("Z")};
+    if (!rgb[0] || !rgb[1] || !rgb[2]) {
+        throw pfs::io::WriteException("EXRWriter: missing X, Y or Z channel");
+    }
+
+    const char *names[] = {"R", "G", "B"};
+    const size_t xStride = sizeof(utils::float16);
+    const size_t yStride = xStride * frame.getWidth();
+    FrameBuffer frameBuffer;
+    for (int c = 0; c < 3; ++c) {
+        header.channels().insert(names[c], Imf::Channel(type));
+        frameBuffer.insert(names[c], Slice(HALF, (char *)rgb[c]->data(),
+                                           xStride, yStride));
+    }
+
+    OutputFile file(filename.c_str(), header);
+    file.setFrameBuffer(frameBuffer);
+    file.writePixels(static_cast<int>(frame.getHeight()));
+}
+
+EXRWriter::EXRWriter(const string &filename) : FrameWriter(filename) {}
+
+bool EXRWriter::write(const Frame &frame, const Params &params) {
+    EXRWriterParams p;
+    p.parse(params);
+#ifndef NDEBUG
+    std::clog << p << std::endl;
+#endif
+    // the number of threads of the file is set when it is created
+    setExrThreads(params);
 
     Header header(frame.getWidth(), frame.getHeight(),
                   1,                 // aspect ratio
                   Imath::V2f(0, 0),  // screenWindowCenter
                   1,                 // screenWindowWidth
                   INCREASING_Y,      // lineOrder
-                  PIZ_COMPRESSION);
+                  p.compression_);
 
     // Copy tags to attributes
     pfs::TagContainer::const_iterator it = frame.getTags().begin();
@@ -64,6 +211,12 @@ bool EXRWriter::write(const Frame &frame, const Params & /*params*/) {
         header.insert(it->first.c_str(), StringAttribute(it->second));
     }
 
+    if (frame.isHalf()) {
+        writeHalfChannels(filename(), header, *frame.halfChannels(),
+                          p.half_ ? HALF : FLOAT);
+        return true;
+    }
+
     // Copy all channel tags
     const pfs::ChannelContainer &channels = frame.getChannels();
 
@@ -79,6 +232,21 @@ bool EXRWriter::write(const Frame &frame, const Params & /*params*/) {
         }
     }
 
+    // Channels are named (X Y Z) but contain (R G B) data
+    const pfs::Channel *R, *G, *B;
+    frame.getXYZChannels(R, G, B);
+
+    if (p.half_) {
+        header.channels().insert("R", Imf::Channel(HALF));
+        header.channels().insert("G", Imf::Channel(HALF));
+        header.channels().insert("B", Imf::Channel(HALF));
+
+        OutputFile file(filename().c_str(), header);
+        writeHalfPixels(file, R, G, B);
+
+        return true;
+    }
+
     FrameBuffer frameBuffer;
 
     // Define channels in Header
@@ -39,6 +39,15 @@ class EXRWriter : public FrameWriter {
    public:
     EXRWriter(const std::string &filename);
 
+    //! \brief write the RGB channels of \a frame. Parameters:
+    //! - "exr.compression" (string): none, rle, zips, zip, piz (default),
+    //! pxr24, b44, b44a, dwaa or dwab
+    //! - "exr.half" (bool): write 16 bit HALF samples instead of FLOAT
+    //! - "exr.threads" (int): size of the OpenEXR thread pool
+    //!
+    //! The half precision channels of a frame (see Frame::isHalf()) are
+    //! written without inflating them.
+    //! \throw pfs::io::WriteException if the compression is not supported
     bool write(const Frame &frame, const Params &params);
 };
 
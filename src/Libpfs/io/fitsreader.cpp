@@ -21,6 +21,8 @@
 
 #include <Libpfs/io/fitsreader.h>
 
+#include <cstdlib>
+
 #include <boost/algorithm/minmax_element.hpp>
 
 #include <boost/bind.hpp>
@@ -146,6 +148,13 @@ void FitsReader::open() {
 #endif
 }
 
+void FitsReader::probeFormat(FrameInfo &info, const Params &) {
+    // BITPIX is negative for floating point data
+    info.channels = 1;
+    info.bitDepth = std::abs(m_data->m_format);
+    info.isFloat = (m_data->m_format < 0);
+}
+
 void FitsReader::close() {
     setWidth(0);
     setHeight(0);
@@ -51,6 +51,9 @@ class FitsReader : public FrameReader {
     void close();
     void read(Frame &frame, const Params &);
 
+   protected:
+    void probeFormat(FrameInfo &info, const Params &params);
+
    private:
     std::unique_ptr<FitsReaderData> m_data;
 };
@@ -21,6 +21,9 @@
 
 #include <Libpfs/io/framereader.h>
 
+#include <algorithm>
+#include <cassert>
+
 #include <Libpfs/frame.h>
 #include <Libpfs/manip/rotate.h>
 #include <Libpfs/exif/exifdata.hpp>
@@ -29,7 +32,7 @@ namespace pfs {
 namespace io {
 
 FrameReader::FrameReader(const std::string &filename)
-    : m_filename(filename), m_width(0), m_height(0) {}
+    : m_filename(filename), m_width(0), m_height(0), m_rotation(-1) {}
 
 FrameReader::~FrameReader() {}
 
@@ -49,5 +52,86 @@ void FrameReader::read(pfs::Frame &frame, const pfs::Params &params) {
     }
 }
 
+FrameInfo FrameReader::probe(const pfs::Params &params) {
+    if (!isOpen()) {
+        open();
+    }
+
+    FrameInfo info;
+    info.exif.fromFile(m_filename);
+    if (m_rotation < 0) {
+        m_rotation = info.exif.getOrientationDegree();
+    }
+
+    info.width = width();
+    info.height = height();
+    probeFormat(info, params);
+
+    return info;
+}
+
+void FrameReader::readPreview(pfs::Frame &frame, size_t,
+                              const pfs::Params &params) {
+    read(frame, params);
+}
+
+void FrameReader::probeFormat(FrameInfo &info, const pfs::Params &) {
+    info.channels = 3;
+    info.bitDepth = 32;
+    info.isFloat = true;
+}
+
+void FrameReader::openBands(const pfs::Params &params) {
+    m_bandCache.reset(new Frame);
+    read(*m_bandCache, params);
+
+    setWidth(m_bandCache->getWidth());
+    setHeight(m_bandCache->getHeight());
+}
+
+void FrameReader::readBand(pfs::Frame &frame, size_t firstRow, size_t rows,
+                           const pfs::Params &params) {
+    if (!m_bandCache) {
+        FrameReader::openBands(params);
+    }
+    assert(firstRow + rows <= height());
+
+    const Channel *inX, *inY, *inZ;
+    m_bandCache->getXYZChannels(inX, inY, inZ);
+
+    Frame tempFrame(width(), rows);
+    Channel *outX, *outY, *outZ;
+    tempFrame.createXYZChannels(outX, outY, outZ);
+
+    std::copy(inX->row_begin(firstRow), inX->row_begin(firstRow) + width() * rows,
+              outX->begin());
+    std::copy(inY->row_begin(firstRow), inY->row_begin(firstRow) + width() * rows,
+              outY->begin());
+    std::copy(inZ->row_begin(firstRow), inZ->row_begin(firstRow) + width() * rows,
+              outZ->begin());
+    pfs::copyTags(m_bandCache.get(), &tempFrame);
+
+    // another pass over the bands decodes the image again
+    if (firstRow + rows == height()) {
+        m_bandCache.reset();
+    }
+
+    frame.swap(tempFrame);
+}
+
+bool FrameReader::streamsBands() { return false; }
+
+bool FrameReader::isRotated() {
+    if (m_rotation < 0) {
+        pfs::exif::ExifData exifData(m_filename);
+        m_rotation = exifData.getOrientationDegree();
+    }
+    return m_rotation == 90 || m_rotation == 180 || m_rotation == 270;
+}
+
+bool FrameReader::isTransposed() {
+    return isRotated() && m_rotation != 180;
+}
+
 }  // io
 }  // pfs
@@ -28,6 +28,7 @@
 #include <memory>
 #include <string>
 
+#include <Libpfs/exif/exifdata.hpp>
 #include <Libpfs/params.h>
 
 namespace pfs {
@@ -35,6 +36,34 @@ class Frame;
 
 namespace io {
 
+//! \brief description of an image file, read from its header
+struct FrameInfo {
+    FrameInfo()
+        : width(0),
+          height(0),
+          channels(0),
+          hasAlpha(false),
+          bitDepth(0),
+          isFloat(false) {}
+
+    //! \brief size of the frame returned by FrameReader::read()
+    size_t width;
+    size_t height;
+    //! \brief color channels stored in the file: 1 (gray), 3 (RGB/XYZ) or 4
+    //! (CMYK), alpha excluded
+    int channels;
+    bool hasAlpha;
+    //! \brief bits per sample stored in the file
+    int bitDepth;
+    //! \brief true for floating point (HDR) samples
+    bool isFloat;
+    //! \brief exposure data of the file (empty if not available)
+    pfs::exif::ExifData exif;
+
+    //! \brief memory needed by the decoded pfs::Frame (three float channels)
+    size_t frameBytes() const { return width * height * 3 * sizeof(float); }
+};
+
 class FrameReader {
    public:
     FrameReader(const std::string &filename);
@@ -53,14 +82,67 @@ class FrameReader {
     virtual void close() = 0;
     virtual void read(pfs::Frame &frame, const pfs::Params &params);
 
+    //! \brief read size, sample format and EXIF data of the file, without
+    //! decoding its pixels. Opens the reader if needed.
+    //! \param params the parameters that read() would use, as they can
+    //! change the size of the frame (e.g. RAW half size)
+    FrameInfo probe(const pfs::Params &params = pfs::Params());
+
+    //! \brief read a reduced version of the image, for display purposes.
+    //! The longest side of \a frame is at least \a minSize (or the size of
+    //! the image, if smaller), but samples might not match the ones
+    //! returned by read(). The default implementation calls read().
+    virtual void readPreview(pfs::Frame &frame, size_t minSize,
+                             const pfs::Params &params);
+
+    //! \brief prepare the reader for readBand(). After this call, width()
+    //! and height() are the size of the frame returned by read().
+    //!
+    //! The default implementation decodes the whole image, and readBand()
+    //! then serves the bands from memory until the last one is read: only
+    //! the readers whose streamsBands() is true bound the memory needed to
+    //! read a file.
+    virtual void openBands(const pfs::Params &params);
+
+    //! \brief read \a rows rows of the image, starting from \a firstRow, into
+    //! \a frame, which is resized to width() x rows. Must follow openBands().
+    //!
+    //! Bands are meant to be requested from top to bottom: readers that decode
+    //! the file sequentially (e.g. JPEG) restart from the beginning of the
+    //! file when a band above the last one read is requested.
+    virtual void readBand(pfs::Frame &frame, size_t firstRow, size_t rows,
+                          const pfs::Params &params);
+
+    //! \brief true if readBand() decodes only the rows requested, false if
+    //! openBands() decodes the whole image. The default implementation
+    //! returns false.
+    virtual bool streamsBands();
+
    protected:
     void setWidth(size_t width) { m_width = width; }
     void setHeight(size_t height) { m_height = height; }
 
+    //! \brief fill the format fields of \a info, whose size is the one set
+    //! by open(). Called on an open reader by probe(). The default
+    //! implementation describes a float RGB file.
+    virtual void probeFormat(FrameInfo &info, const pfs::Params &params);
+
+    //! \brief true if the image has to be rotated, as specified by its EXIF
+    //! orientation tag
+    bool isRotated();
+    //! \brief true if the EXIF rotation swaps width and height
+    bool isTransposed();
+
    private:
     std::string m_filename;
     size_t m_width;
     size_t m_height;
+
+    //! \brief EXIF orientation in degrees, -1 until read
+    int m_rotation;
+    //! \brief fully decoded image, used by the default readBand() and
+    //! released once its last row is read
+    std::unique_ptr<pfs::Frame> m_bandCache;
 };
 
 typedef std::shared_ptr<FrameReader> FrameReaderPtr;
@@ -32,8 +32,10 @@
 #include <Libpfs/utils/transform.h>
 
 #include <jpeglib.h>
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <utility>
 
 using namespace pfs;
 
@@ -200,6 +202,11 @@ struct JpegReader::JpegReaderData {
 
     utils::ScopedStdIoFile file_;
 
+    //! \brief true between jpeg_start_decompress() and close(), while bands
+    //! are being read
+    bool decompressing_;
+    utils::ScopedCmsTransform xform_;
+
     inline j_decompress_ptr cinfo() { return &cinfo_; }
 
     inline FILE *handle() { return file_.data(); }
@@ -207,6 +214,7 @@ struct JpegReader::JpegReaderData {
 
 JpegReader::JpegReader(const std::string &filename)
     : FrameReader(filename), m_data(new JpegReaderData) {
+    m_data->decompressing_ = false;
     JpegReader::open();
 }
 
@@ -217,6 +225,8 @@ bool JpegReader::isOpen() const { return m_data->file_; }
 void JpegReader::close() {
     // destroy decompress structure
     jpeg_destroy_decompress(m_data->cinfo());
+    m_data->decompressing_ = false;
+    m_data->xform_.reset();
     // close open file
     m_data->file_.reset();
 }
@@ -262,6 +272,19 @@ void JpegReader::open() {
     setHeight(m_data->cinfo()->image_height);
 }
 
+void JpegReader::probeFormat(FrameInfo &info, const Params &) {
+    info.channels = (m_data->cinfo()->jpeg_color_space == JCS_CMYK ||
+                     m_data->cinfo()->jpeg_color_space == JCS_YCCK)
+                        ? 4
+                        : 3;
+    info.bitDepth = m_data->cinfo()->data_precision;
+    info.isFloat = false;
+
+    if (isTransposed()) {
+        std::swap(info.width, info.height);
+    }
+}
+
 static cmsHTRANSFORM getColorSpaceTransform(j_decompress_ptr cinfo) {
     unsigned int cmsProfileLength;
     JOCTET *cmsProfileBuffer;
@@ -319,24 +342,29 @@ static cmsHTRANSFORM getColorSpaceTransform(j_decompress_ptr cinfo) {
 //! \brief read from a 3 components (RGB) input JPEG file
 template <typename Converter>
 static void read3Components(j_decompress_ptr cinfo, Frame &frame,
-                            const Converter &conv) {
+                            JDIMENSION firstRow, const Converter &conv) {
     Channel *red;
     Channel *green;
     Channel *blue;
 
     frame.createXYZChannels(red, green, blue);
 
-    std::vector<JSAMPLE> scanLineBuffer(cinfo->image_width *
+    std::vector<JSAMPLE> scanLineBuffer(cinfo->output_width *
                                         cinfo->num_components);
     JSAMPROW scanLineBufferArray[1] = {scanLineBuffer.data()};
 
-    for (int i = 0; cinfo->output_scanline < cinfo->output_height; ++i) {
+    // skip the scanlines above the requested rows
+    while (cinfo->output_scanline < firstRow) {
+        jpeg_read_scanlines(cinfo, scanLineBufferArray, 1);
+    }
+
+    for (size_t i = 0; i < frame.getHeight(); ++i) {
         jpeg_read_scanlines(cinfo, scanLineBufferArray, 1);
 
         utils::transform(
             FixedStrideIterator<JSAMPLE *, 3>(scanLineBuffer.data()),
             FixedStrideIterator<JSAMPLE *, 3>(scanLineBuffer.data() +
-                                              cinfo->image_width * 3),
+                                              cinfo->output_width * 3),
             FixedStrideIterator<JSAMPLE *, 3>(scanLineBuffer.data() + 1),
             FixedStrideIterator<JSAMPLE *, 3>(scanLineBuffer.data() + 2),
             red->row_begin(i), green->row_begin(i), blue->row_begin(i), conv);
@@ -346,24 +374,29 @@ static void read3Components(j_decompress_ptr cinfo, Frame &frame,
 //! \brief read from a 4 components (CMYK) input JPEG file
 template <typename Converter>
 static void read4Components(j_decompress_ptr cinfo, Frame &frame,
-                            const Converter &conv) {
+                            JDIMENSION firstRow, const Converter &conv) {
     Channel *red;
     Channel *green;
     Channel *blue;
 
     frame.createXYZChannels(red, green, blue);
 
-    std::vector<JSAMPLE> scanLineBuffer(cinfo->image_width *
+    std::vector<JSAMPLE> scanLineBuffer(cinfo->output_width *
                                         cinfo->num_components);
     JSAMPROW scanLineBufferArray[1] = {scanLineBuffer.data()};
 
-    for (int i = 0; cinfo->output_scanline < cinfo->output_height; ++i) {
+    // skip the scanlines above the requested rows
+    while (cinfo->output_scanline < firstRow) {
+        jpeg_read_scanlines(cinfo, scanLineBufferArray, 1);
+    }
+
+    for (size_t i = 0; i < frame.getHeight(); ++i) {
         jpeg_read_scanlines(cinfo, scanLineBufferArray, 1);
 
         utils::transform(
             FixedStrideIterator<JSAMPLE *, 4>(scanLineBuffer.data()),  // C
-            FixedStrideIterator<JSAMPLE *, 4>(scanLineBuffer.data() +
-                                              cinfo->image_width * 4),  // end C
+            FixedStrideIterator<JSAMPLE *, 4>(
+                scanLineBuffer.data() + cinfo->output_width * 4),  // end C
             FixedStrideIterator<JSAMPLE *, 4>(scanLineBuffer.data() + 1),  // M
             FixedStrideIterator<JSAMPLE *, 4>(scanLineBuffer.data() + 2),  // Y
             FixedStrideIterator<JSAMPLE *, 4>(scanLineBuffer.data() + 3),  // K
@@ -373,6 +406,40 @@ static void read4Components(j_decompress_ptr cinfo, Frame &frame,
     }
 }
 
+//! \brief read the rows of \a frame, starting from scanline \a firstRow
+static void readComponents(j_decompress_ptr cinfo, cmsHTRANSFORM xform,
+                           Frame &frame, JDIMENSION firstRow) {
+    assert(firstRow + frame.getHeight() <= cinfo->output_height);
+
+    switch (cinfo->jpeg_color_space) {
+        case JCS_RGB:
+        case JCS_YCbCr: {
+            if (xform) {
+                PRINT_DEBUG("Use LCMS RGB");
+                read3Components(cinfo, frame, firstRow,
+                                colorspace::Convert3LCMS3(xform));
+            } else {
+                read3Components(cinfo, frame, firstRow, colorspace::Copy());
+            }
+        } break;
+        case JCS_CMYK:
+        case JCS_YCCK: {
+            if (xform) {
+                PRINT_DEBUG("Use LCMS CMYK");
+                read4Components(cinfo, frame, firstRow,
+                                colorspace::Convert4LCMS3(xform));
+            } else {
+                read4Components(cinfo, frame, firstRow,
+                                colorspace::ConvertInvertedCMYK2RGB());
+            }
+        } break;
+        default:
+            // This case should never happen, but at least the compiler
+            // stops complaining!
+            break;
+    }
+}
+
 void JpegReader::read(Frame &frame, const Params &params) {
     try {
         Frame tempFrame(width(), height());
@@ -389,34 +456,54 @@ void JpegReader::read(Frame &frame, const Params &params) {
         utils::ScopedCmsTransform xform(
             getColorSpaceTransform(m_data->cinfo()));
 
-        switch (m_data->cinfo()->jpeg_color_space) {
-            case JCS_RGB:
-            case JCS_YCbCr: {
-                if (xform) {
-                    PRINT_DEBUG("Use LCMS RGB");
-                    read3Components(m_data->cinfo(), tempFrame,
-                                    colorspace::Convert3LCMS3(xform.data()));
-                } else {
-                    read3Components(m_data->cinfo(), tempFrame,
-                                    colorspace::Copy());
-                }
-            } break;
-            case JCS_CMYK:
-            case JCS_YCCK: {
-                if (xform) {
-                    PRINT_DEBUG("Use LCMS CMYK");
-                    read4Components(m_data->cinfo(), tempFrame,
-                                    colorspace::Convert4LCMS3(xform.data()));
-                } else {
-                    read4Components(m_data->cinfo(), tempFrame,
-                                    colorspace::ConvertInvertedCMYK2RGB());
-                }
-            } break;
-            default:
-                // This case should never happen, but at least the compiler
-                // stops complaining!
-                break;
-        }
+        readComponents(m_data->cinfo(), xform.data(), tempFrame, 0);
+
+        jpeg_finish_decompress(m_data->cinfo());
+        jpeg_destroy_decompress(m_data->cinfo());
+
+        FrameReader::read(tempFrame, params);
+        frame.swap(tempFrame);
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+//! \brief start decoding \a cinfo at the smallest DCT scaling (1/8, 1/4, 1/2
+//! or 1) whose longest side is at least \a minSize
+static void startPreviewDecompress(j_decompress_ptr cinfo, size_t minSize) {
+    const size_t longest = std::max(cinfo->image_width, cinfo->image_height);
+    unsigned int denom = 8;
+    while (denom > 1 && (longest + denom - 1) / denom < minSize) {
+        denom /= 2;
+    }
+
+    cinfo->scale_num = 1;
+    cinfo->scale_denom = denom;
+    // the preview is only displayed: trade accuracy for speed
+    cinfo->dct_method = JDCT_IFAST;
+    cinfo->do_fancy_upsampling = FALSE;
+
+    jpeg_start_decompress(cinfo);
+
+    PRINT_DEBUG("JPEG preview: 1/" << denom << ", " << cinfo->output_width
+                                   << "x" << cinfo->output_height);
+}
+
+void JpegReader::readPreview(Frame &frame, size_t minSize,
+                             const Params &params) {
+    try {
+        // read() and readBand() leave the decompressor in a state that
+        // cannot be rescaled
+        open();
+
+        startPreviewDecompress(m_data->cinfo(), minSize);
+
+        Frame tempFrame(m_data->cinfo()->output_width,
+                        m_data->cinfo()->output_height);
+        utils::ScopedCmsTransform xform(
+            getColorSpaceTransform(m_data->cinfo()));
+        readComponents(m_data->cinfo(), xform.data(), tempFrame, 0);
 
         jpeg_finish_decompress(m_data->cinfo());
         jpeg_destroy_decompress(m_data->cinfo());
@@ -429,5 +516,86 @@ void JpegReader::read(Frame &frame, const Params &params) {
     }
 }
 
+void readJpegPreview(const unsigned char *buffer, size_t size,
+                     size_t minSize, Frame &frame) {
+#if JPEG_LIB_VERSION >= 80 || defined(MEM_SRCDST_SUPPORTED)
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr err;
+
+    cinfo.err = jpeg_std_error(&err);
+    cinfo.err->error_exit = my_error_handler;
+    cinfo.err->output_message = my_output_message;
+    jpeg_create_decompress(&cinfo);
+
+    try {
+        jpeg_mem_src(&cinfo, const_cast<unsigned char *>(buffer), size);
+        jpeg_read_header(&cinfo, true);
+
+        if (cinfo.jpeg_color_space == JCS_GRAYSCALE) {
+            throw pfs::io::ReadException("Unsupported color space: grayscale");
+        }
+        if (cinfo.jpeg_color_space == JCS_YCCK) {
+            cinfo.out_color_space = JCS_CMYK;
+        }
+
+        startPreviewDecompress(&cinfo, minSize);
+
+        Frame tempFrame(cinfo.output_width, cinfo.output_height);
+        readComponents(&cinfo, NULL, tempFrame, 0);
+
+        jpeg_finish_decompress(&cinfo);
+        jpeg_destroy_decompress(&cinfo);
+
+        frame.swap(tempFrame);
+    } catch (...) {
+        jpeg_destroy_decompress(&cinfo);
+        throw;
+    }
+#else
+    throw pfs::io::ReadException(
+        "JPEG decoding from memory is not supported by this libjpeg");
+#endif
+}
+
+void JpegReader::openBands(const Params &params) {
+    // a rotated image can only be served by the full decode
+    if (isRotated()) {
+        FrameReader::openBands(params);
+    }
+}
+
+bool JpegReader::streamsBands() { return !isRotated(); }
+
+void JpegReader::readBand(Frame &frame, size_t firstRow, size_t rows,
+                          const Params &params) {
+    if (isRotated()) {
+        FrameReader::readBand(frame, firstRow, rows, params);
+        return;
+    }
+
+    try {
+        // JPEG data can only be decoded forward: restart from the beginning
+        // of the file if the band has already been passed
+        if (!isOpen() || (m_data->decompressing_ &&
+                          firstRow < m_data->cinfo()->output_scanline)) {
+            open();
+        }
+        if (!m_data->decompressing_) {
+            jpeg_start_decompress(m_data->cinfo());
+            m_data->xform_.reset(getColorSpaceTransform(m_data->cinfo()));
+            m_data->decompressing_ = true;
+        }
+
+        Frame tempFrame(width(), rows);
+        readComponents(m_data->cinfo(), m_data->xform_.data(), tempFrame,
+                       firstRow);
+
+        frame.swap(tempFrame);
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
 }  // io
 }  // pfs
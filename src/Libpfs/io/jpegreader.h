@@ -44,6 +44,15 @@ class JpegReader : public FrameReader {
     bool isOpen() const;
     void close();
     void read(Frame &frame, const Params &params);
+    //! \brief decode the image with libjpeg DCT scaling (1/2, 1/4 or 1/8)
+    void readPreview(Frame &frame, size_t minSize, const Params &params);
+    void openBands(const Params &params);
+    void readBand(Frame &frame, size_t firstRow, size_t rows,
+                  const Params &params);
+    bool streamsBands();
+
+   protected:
+    void probeFormat(FrameInfo &info, const Params &params);
 
    private:
     struct JpegReaderData;
@@ -51,6 +60,14 @@ class JpegReader : public FrameReader {
     std::unique_ptr<JpegReaderData> m_data;
 };
 
+//! \brief decode the JPEG stream of \a size bytes in \a buffer (e.g. the
+//! thumbnail embedded in a RAW file) with the DCT scaling of
+//! JpegReader::readPreview(). The ICC profile and the EXIF orientation are
+//! ignored.
+//! \throw pfs::io::ReadException if the stream cannot be decoded
+void readJpegPreview(const unsigned char *buffer, size_t size,
+                     size_t minSize, Frame &frame);
+
 }  // io
 }  // pfs
 
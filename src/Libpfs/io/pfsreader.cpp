@@ -103,6 +103,12 @@ void PfsReader::open() {
     m_channelCount = channelCount;
 }
 
+void PfsReader::probeFormat(FrameInfo &info, const Params &) {
+    info.channels = m_channelCount;
+    info.bitDepth = 32;
+    info.isFloat = true;
+}
+
 void PfsReader::close() {
     setWidth(0);
     setHeight(0);
@@ -47,6 +47,9 @@ class PfsReader : public FrameReader {
     void close();
     void read(pfs::Frame &frame, const pfs::Params &);
 
+   protected:
+    void probeFormat(FrameInfo &info, const Params &params);
+
    private:
     utils::ScopedStdIoFile m_file;
     size_t m_channelCount;
@@ -22,15 +22,18 @@
  *
  */
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #include <Libpfs/colorspace/copy.h>
 #include <Libpfs/colorspace/gamma.h>
 #include <Libpfs/fixedstrideiterator.h>
 #include <Libpfs/frame.h>
+#include <Libpfs/io/jpegreader.h>
 #include <Libpfs/io/rawreader.h>
 #include <Libpfs/utils/transform.h>
 
@@ -417,6 +420,36 @@ void RAWReader::open() {
     setHeight(S.height);
 }
 
+void RAWReader::probeFormat(FrameInfo &info, const Params &params) {
+    // size of the image produced by dcraw_process() with the same
+    // parameters; read() opens the file again, so the state left by LibRaw
+    // does not matter
+    RAWReaderParams p;
+    p.parse(params);
+    setParams(m_processor, p);
+    if (m_processor.adjust_sizes_info_only() == LIBRAW_SUCCESS) {
+        info.width = S.iwidth;
+        info.height = S.iheight;
+    }
+    if (isTransposed()) {
+        std::swap(info.width, info.height);
+    }
+
+    info.channels = 3;
+    info.bitDepth = 16;
+    info.isFloat = false;
+
+    // some RAW formats are not understood by Exiv2: use the data decoded by
+    // LibRaw
+    if (!info.exif.isValid() && P2.shutter > 0.f && P2.aperture > 0.f) {
+        info.exif.setExposureTime(P2.shutter);
+        info.exif.setFNumber(P2.aperture);
+        if (P2.iso_speed > 0.f) {
+            info.exif.setIsoSpeed(P2.iso_speed);
+        }
+    }
+}
+
 bool RAWReader::isOpen() const { return true; }
 
 void RAWReader::close() { m_processor.recycle(); }
@@ -429,6 +462,100 @@ void RAWReader::read(Frame &frame, const Params &params) {
 
     open();
 
+    pfs::Frame tempFrame;
+    decode(tempFrame);
+
+    FrameReader::read(tempFrame, params);
+    frame.swap(tempFrame);
+}
+
+void RAWReader::readPreview(Frame &frame, size_t minSize,
+                            const Params &params) {
+    open();
+
+    pfs::Frame tempFrame;
+    if (!readThumbnail(tempFrame, minSize)) {
+        RAWReaderParams p;
+        p.parse(params);
+
+        setParams(m_processor, p);
+        // half size output skips the demosaicing
+        OUT.half_size = 1;
+
+        open();
+        try {
+            decode(tempFrame);
+        } catch (...) {
+            OUT.half_size = 0;
+            throw;
+        }
+        OUT.half_size = 0;
+    }
+    m_processor.recycle();
+
+    FrameReader::read(tempFrame, params);
+    frame.swap(tempFrame);
+}
+
+bool RAWReader::readThumbnail(Frame &frame, size_t minSize) {
+    if (m_processor.unpack_thumb() != LIBRAW_SUCCESS) {
+        return false;
+    }
+
+    const size_t W = T.twidth;
+    const size_t H = T.theight;
+    PRINT_DEBUG("Thumbnail: " << W << "x" << H << ", format " << T.tformat);
+
+    // too small, or cropped to a different aspect ratio
+    if (std::max(W, H) < minSize ||
+        std::fabs(double(W) * S.height - double(H) * S.width) >
+            0.02 * double(W) * S.height) {
+        return false;
+    }
+
+    pfs::Frame tempFrame;
+    try {
+        if (T.tformat == LIBRAW_THUMBNAIL_JPEG) {
+            readJpegPreview(reinterpret_cast<const unsigned char *>(T.thumb),
+                            T.tlength, minSize, tempFrame);
+        } else if (T.tformat == LIBRAW_THUMBNAIL_BITMAP && T.tcolors == 3 &&
+                   T.tlength >= W * H * 3) {
+            pfs::Frame bitmap(W, H);
+            pfs::Channel *Xc, *Yc, *Zc;
+            bitmap.createXYZChannels(Xc, Yc, Zc);
+
+            const uint8_t *data = reinterpret_cast<const uint8_t *>(T.thumb);
+            utils::transform(
+                FixedStrideIterator<const uint8_t *, 3>(data),
+                FixedStrideIterator<const uint8_t *, 3>(data + H * W * 3),
+                FixedStrideIterator<const uint8_t *, 3>(data + 1),
+                FixedStrideIterator<const uint8_t *, 3>(data + 2), Xc->begin(),
+                Yc->begin(), Zc->begin(), colorspace::Copy());
+            tempFrame.swap(bitmap);
+        } else {
+            return false;
+        }
+    } catch (pfs::io::ReadException &e) {
+        PRINT_DEBUG("Cannot decode thumbnail: " << e.what());
+        return false;
+    }
+
+    // the thumbnail is encoded like the output of dcraw_process(): apply the
+    // same curve as decode()
+    pfs::Channel *Ch[3];
+    tempFrame.getXYZChannels(Ch[0], Ch[1], Ch[2]);
+    for (int c = 0; c < 3; ++c) {
+        std::transform(Ch[c]->begin(), Ch[c]->end(), Ch[c]->begin(),
+                       [](float v) {
+                           return std::pow(v, colorspace::Gamma1_8::gamma());
+                       });
+    }
+
+    frame.swap(tempFrame);
+    return true;
+}
+
+void RAWReader::decode(Frame &frame) {
     if (m_processor.unpack() != LIBRAW_SUCCESS) {
         m_processor.recycle();
         throw pfs::io::ReadException("Error Unpacking RAW File");
@@ -485,7 +612,6 @@ void RAWReader::read(Frame &frame, const Params &params) {
     LibRaw::dcraw_clear_mem(image);
     m_processor.recycle();
 
-    FrameReader::read(tempFrame, params);
     frame.swap(tempFrame);
 }
 
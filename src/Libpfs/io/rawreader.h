@@ -52,8 +52,20 @@ class RAWReader : public FrameReader {
     void close();
 
     void read(Frame &frame, const Params &params);
+    //! \brief decode the thumbnail embedded in the file when it is large
+    //! enough, otherwise process the file at half size
+    void readPreview(Frame &frame, size_t minSize, const Params &params);
+
+   protected:
+    void probeFormat(FrameInfo &info, const Params &params);
 
    private:
+    //! \brief unpack and process the open file with the current parameters
+    void decode(Frame &frame);
+    //! \brief decode the embedded thumbnail, if it has the aspect ratio of
+    //! the image and its longest side is at least \a minSize
+    bool readThumbnail(Frame &frame, size_t minSize);
+
     LibRaw m_processor;
 };
 
@@ -251,6 +251,13 @@ void RGBEReader::open() {
     m_exposure = exposure;
 }
 
+void RGBEReader::probeFormat(FrameInfo &info, const Params &) {
+    // 8 bits mantissas with a shared exponent
+    info.channels = 3;
+    info.bitDepth = 8;
+    info.isFloat = true;
+}
+
 void RGBEReader::close() {
     m_file.reset();
     m_exposure = 0.f;
@@ -51,6 +51,9 @@ class RGBEReader : public FrameReader {
     void close();
     void read(pfs::Frame &frame, const pfs::Params &params);
 
+   protected:
+    void probeFormat(FrameInfo &info, const Params &params);
+
    private:
     utils::ScopedStdIoFile m_file;
     float m_exposure;
@@ -147,7 +147,14 @@ static cmsHPROFILE GetTIFFProfile(TIFF *in, uint16 bps) {
 namespace pfs {
 namespace io {
 
-struct TiffReaderParams {};
+//! \brief rows of the image to be read
+struct TiffReaderParams {
+    TiffReaderParams(uint32 firstRow, uint32 rows)
+        : firstRow_(firstRow), rows_(rows) {}
+
+    uint32 firstRow_;
+    uint32 rows_;
+};
 
 struct TiffReaderData {
     // < photometric type, bits per sample >
@@ -186,7 +193,11 @@ struct TiffReaderData {
     inline TIFF *handle() { return file_.data(); }
 
     void read(Frame &frame, const Params & /*params*/) {
-        currentCallback_(this, frame, TiffReaderParams());
+        currentCallback_(this, frame, TiffReaderParams(0, height_));
+    }
+
+    void readBand(Frame &frame, uint32 firstRow, uint32 rows) {
+        currentCallback_(this, frame, TiffReaderParams(firstRow, rows));
     }
 
     void initReader() {
@@ -289,10 +300,11 @@ struct TiffReaderData {
     void doNothing(Frame & /*frame*/, const TiffReaderParams & /*params*/) {}
 
     template <typename InputDataType, typename Converter>
-    void read3Components(Frame &frame, const TiffReaderParams & /*params*/,
+    void read3Components(Frame &frame, const TiffReaderParams &params,
                          const Converter &conv) {
         assert(samplesPerPixel_ >= 3);
-        Frame tempFrame(width_, height_);
+        assert(params.firstRow_ + params.rows_ <= height_);
+        Frame tempFrame(width_, params.rows_);
 
         pfs::Channel *Xc;
         pfs::Channel *Yc;
@@ -300,8 +312,9 @@ struct TiffReaderData {
         tempFrame.createXYZChannels(Xc, Yc, Zc);
 
         std::vector<InputDataType> tempBuffer(width_ * samplesPerPixel_);
-        for (uint32 row = 0; row < height_; row++) {
-            TIFFReadScanline(handle(), tempBuffer.data(), row);
+        for (uint32 row = 0; row < params.rows_; row++) {
+            TIFFReadScanline(handle(), tempBuffer.data(),
+                             params.firstRow_ + row);
 
             utils::transform(StrideIterator<InputDataType *>(tempBuffer.data(),
                                                              samplesPerPixel_),
@@ -320,10 +333,11 @@ struct TiffReaderData {
     }
 
     template <typename InputDataType, typename Converter>
-    void read4Components(Frame &frame, const TiffReaderParams & /*params*/,
+    void read4Components(Frame &frame, const TiffReaderParams &params,
                          const Converter &conv) {
         assert(samplesPerPixel_ >= 4);
-        Frame tempFrame(width_, height_);
+        assert(params.firstRow_ + params.rows_ <= height_);
+        Frame tempFrame(width_, params.rows_);
 
         pfs::Channel *Xc;
         pfs::Channel *Yc;
@@ -331,8 +345,9 @@ struct TiffReaderData {
         tempFrame.createXYZChannels(Xc, Yc, Zc);
 
         std::vector<InputDataType> tempBuffer(width_ * samplesPerPixel_);
-        for (uint32 row = 0; row < height_; row++) {
-            TIFFReadScanline(handle(), tempBuffer.data(), row);
+        for (uint32 row = 0; row < params.rows_; row++) {
+            TIFFReadScanline(handle(), tempBuffer.data(),
+                             params.firstRow_ + row);
 
             utils::transform(StrideIterator<InputDataType *>(tempBuffer.data(),
                                                              samplesPerPixel_),
@@ -526,6 +541,19 @@ void TiffReader::open() {
         GetTIFFProfile(m_data->handle(), m_data->bitsPerSample_));
 }
 
+void TiffReader::probeFormat(FrameInfo &info, const Params &) {
+    info.channels =
+        (m_data->photometricType_ == PHOTOMETRIC_SEPARATED) ? 4 : 3;
+    info.hasAlpha = m_data->hasAlpha_;
+    info.bitDepth = m_data->bitsPerSample_;
+    info.isFloat = (m_data->photometricType_ == PHOTOMETRIC_LOGLUV ||
+                    m_data->bitsPerSample_ == 32);
+
+    if (isTransposed()) {
+        std::swap(info.width, info.height);
+    }
+}
+
 #define CALL_MEMBER_FN(object, ptrToMember) ((object).*(ptrToMember))
 
 void TiffReader::read(Frame &frame, const Params &params) {
@@ -537,5 +565,30 @@ void TiffReader::read(Frame &frame, const Params &params) {
     FrameReader::read(frame, params);
 }
 
+void TiffReader::openBands(const Params &params) {
+    if (!isOpen()) {
+        open();
+    }
+    // a rotated image can only be served by the full decode
+    if (isRotated()) {
+        FrameReader::openBands(params);
+    }
+}
+
+bool TiffReader::streamsBands() { return !isRotated(); }
+
+void TiffReader::readBand(Frame &frame, size_t firstRow, size_t rows,
+                          const Params &params) {
+    if (isRotated()) {
+        FrameReader::readBand(frame, firstRow, rows, params);
+        return;
+    }
+    if (!isOpen()) {
+        open();
+    }
+
+    m_data->readBand(frame, firstRow, rows);
+}
+
 }  // io
 }  // pfs
@@ -44,6 +44,13 @@ class TiffReader : public FrameReader {
     void close();
 
     void read(Frame &frame, const Params &params);
+    void openBands(const Params &params);
+    void readBand(Frame &frame, size_t firstRow, size_t rows,
+                  const Params &params);
+    bool streamsBands();
+
+   protected:
+    void probeFormat(FrameInfo &info, const Params &params);
 
    private:
     std::unique_ptr<TiffReaderData> m_data;
@@ -38,23 +38,8 @@ pfs::Frame *copy(const pfs::Frame *inFrame) {
     f_timer.start();
 #endif
 
-    const int outWidth = inFrame->getWidth();
-    const int outHeight = inFrame->getHeight();
-
-    pfs::Frame *outFrame = new pfs::Frame(outWidth, outHeight);
-
-    const ChannelContainer &channels = inFrame->getChannels();
-
-    for (ChannelContainer::const_iterator it = channels.begin();
-         it != channels.end(); ++it) {
-        const pfs::Channel *inCh = *it;
-
-        pfs::Channel *outCh = outFrame->createChannel(inCh->getName());
-
-        copy(inCh, outCh);
-    }
-
-    pfs::copyTags(inFrame, outFrame);
+    // the channels share the buffers of inFrame until they are written
+    pfs::Frame *outFrame = new pfs::Frame(*inFrame);
 
 #ifdef TIMER_PROFILING
     f_timer.stop_and_update();
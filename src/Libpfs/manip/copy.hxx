@@ -37,7 +37,8 @@ void copy(const Array2D<Type> *from, Array2D<Type> *to) {
     assert(from->getRows() == to->getRows());
     assert(from->getCols() == to->getCols());
 
-    std::copy(from->begin(), from->end(), to->begin());
+    // share the buffer of from (copy-on-write)
+    *to = *from;
 }
 }
 
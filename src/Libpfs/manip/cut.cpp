@@ -36,44 +36,64 @@
 #include <iostream>
 
 #include "Libpfs/frame.h"
+#include "Libpfs/frameview.h"
+#include "Libpfs/halfframe.h"
 #include "Libpfs/utils/msec_timer.h"
 
 namespace pfs {
 
 pfs::Frame *cut(const pfs::Frame *inFrame, size_t x_ul, size_t y_ul,
                 size_t x_br, size_t y_br) {
+    return cut(FrameView(*inFrame, x_ul, y_ul, x_br, y_br));
+}
+
+pfs::Frame *cut(const FrameView &view) {
 #ifdef TIMER_PROFILING
     msec_timer f_timer;
     f_timer.start();
 #endif
 
-    // ----  Boundary Check!
-    // if (x_ul < 0) x_ul = 0;
-    // if (y_ul < 0) y_ul = 0;
-    if (x_br > inFrame->getWidth()) x_br = inFrame->getWidth();
-    if (y_br > inFrame->getHeight()) y_br = inFrame->getHeight();
-    // -----
+    pfs::Frame *outFrame = new pfs::Frame(view.getWidth(), view.getHeight());
 
-    pfs::Frame *outFrame = new pfs::Frame((x_br - x_ul), (y_br - y_ul));
+    if (view.getFrame().isHalf()) {
+        // decode the rows of the rectangle, without inflating the frame
+        const HalfFrame::HalfChannelContainer &channels =
+            view.getFrame().halfChannels()->getChannels();
 
-    const ChannelContainer &channels = inFrame->getChannels();
+        for (HalfFrame::HalfChannelContainer::const_iterator it =
+                 channels.begin();
+             it != channels.end(); ++it) {
+            pfs::Channel *outCh = outFrame->createChannel(it->getName());
+            copyTags(it->getTags(), outCh->getTags());
 
-    for (ChannelContainer::const_iterator it = channels.begin();
-         it != channels.end(); ++it) {
-        const pfs::Channel *inCh = *it;
+            for (size_t row = 0; row < view.getHeight(); ++row) {
+                utils::halfToFloat(&(*it)(view.getX(), view.getY() + row),
+                                   outCh->data() + row * view.getWidth(),
+                                   view.getWidth());
+            }
+        }
+        copyTags(view.getTags(), outFrame->getTags());
+    } else {
+        const ChannelContainer &channels = view.getChannels();
 
-        pfs::Channel *outCh = outFrame->createChannel(inCh->getName());
+        for (ChannelContainer::const_iterator it = channels.begin();
+             it != channels.end(); ++it) {
+            const pfs::Channel *inCh = *it;
 
-        cut(inCh, outCh, x_ul, y_ul, x_br, y_br);
-    }
+            pfs::Channel *outCh = outFrame->createChannel(inCh->getName());
 
-    pfs::copyTags(inFrame, outFrame);
+            copy(view.getChannel(*inCh), Array2DView<float>(*outCh));
+        }
+
+        pfs::copyTags(&view.getFrame(), outFrame);
+    }
 
 #ifdef TIMER_PROFILING
     f_timer.stop_and_update();
     std::cout << "pfscut(";
-    std::cout << "[" << x_ul << ", " << y_ul << "],";
-    std::cout << "[" << x_br << ", " << y_br << "]";
+    std::cout << "[" << view.getX() << ", " << view.getY() << "],";
+    std::cout << "[" << view.getX() + view.getWidth() << ", "
+              << view.getY() + view.getHeight() << "]";
     std::cout << ") = " << f_timer.get_time() << " msec" << std::endl;
 #endif
 
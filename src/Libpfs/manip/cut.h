@@ -33,10 +33,15 @@
 
 namespace pfs {
 class Frame;
+class FrameView;
 
 Frame *cut(const Frame *inFrame, size_t x_ul, size_t y_ul, size_t x_br,
            size_t y_br);
 
+//! \brief Copy the rectangle of \a view in a new frame. The half precision
+//! channels of a frame (see Frame::isHalf()) are decoded row by row.
+Frame *cut(const FrameView &view);
+
 template <typename Type>
 void cut(const Array2D<Type> *from, Array2D<Type> *to, size_t x_ul, size_t y_ul,
          size_t x_br, size_t y_br);
@@ -27,9 +27,10 @@
 
 #include "cut.h"
 
-#include <algorithm>
 #include <cassert>
 
+#include <Libpfs/array2dview.h>
+
 namespace pfs {
 
 template <typename Type>
@@ -49,14 +50,8 @@ void cut(const Array2D<Type> *from, Array2D<Type> *to, size_t x_ul, size_t y_ul,
     if (x_br > from->getCols()) x_br = from->getCols();
     if (y_br > from->getRows()) y_br = from->getRows();
 
-    // update right border
-    x_br = from->getCols() - x_br;
-    int rEnd = (int)to->getRows();
-#pragma omp parallel for shared(rEnd)
-    for (int r = 0; r < rEnd; r++) {
-        std::copy(from->row_begin(r + y_ul) + x_ul,
-                  from->row_end(r + y_ul) - x_br, to->row_begin(r));
-    }
+    copy(Array2DView<const Type>(*from, x_ul, y_ul, x_br, y_br),
+         Array2DView<Type>(*to));
 }
 
 }  // pfs
@@ -26,28 +26,31 @@
 
 #include "gamma.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
 
 #include "Libpfs/array2d.h"
 #include "Libpfs/colorspace/colorspace.h"
+#include "Libpfs/colorspace/gamma.h"
 #include "Libpfs/frame.h"
+#include "Libpfs/manip/pixelpipeline.h"
 #include "Libpfs/utils/msec_timer.h"
+#include "Libpfs/utils/vecmath.h"
 
 namespace pfs {
 
-void applyGamma(pfs::Frame *frame, float gamma) {
-    float multiplier = 1.0f;
+namespace {
+//! \brief samples processed at once by a thread
+const int GAMMA_BLOCK_SIZE = 16384;
+}
 
+void applyGamma(pfs::Frame *frame, float gamma) {
     if (gamma == 1.0f) return;
 
-    pfs::Channel *X, *Y, *Z;
-    frame->getXYZChannels(X, Y, Z);
-
-    applyGamma(X, 1.0f / gamma, multiplier);
-    applyGamma(Y, 1.0f / gamma, multiplier);
-    applyGamma(Z, 1.0f / gamma, multiplier);
+    // the three channels in a single pass
+    transformRGB(*frame, colorspace::ChangeGamma(gamma));
 }
 
 void applyGamma(pfs::Array2Df *array, const float exponent,
@@ -59,14 +62,11 @@ void applyGamma(pfs::Array2Df *array, const float exponent,
 
     float *Vin = array->data();
 
-    int V_ELEMS = array->getRows() * array->getCols();
+    const int V_ELEMS = array->getRows() * array->getCols();
 #pragma omp parallel for
-    for (int idx = 0; idx < V_ELEMS; idx++) {
-        if (Vin[idx] > 0.0f) {
-            Vin[idx] = powf(Vin[idx] * multiplier, exponent);
-        } else {
-            Vin[idx] = 0.0f;
-        }
+    for (int idx = 0; idx < V_ELEMS; idx += GAMMA_BLOCK_SIZE) {
+        const int size = std::min(GAMMA_BLOCK_SIZE, V_ELEMS - idx);
+        utils::vpow(Vin + idx, Vin + idx, size, exponent, multiplier);
     }
 
 #ifdef TIMER_PROFILING
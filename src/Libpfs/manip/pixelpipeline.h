@@ -0,0 +1,69 @@
+/*
+ * This file is a part of LuminanceHDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ */
+
+//! \brief Fused per-pixel processing of the RGB channels of a frame
+//! \author agent <agent@local>
+
+#ifndef PFS_PIXELPIPELINE_H
+#define PFS_PIXELPIPELINE_H
+
+namespace pfs {
+class Frame;
+class FrameView;
+
+//! \brief A stage of the pipeline is any functor of the RGB samples of a
+//! pixel, as accepted by utils::transform():
+//! \code
+//! void operator()(float r, float g, float b,
+//!                 float &o1, float &o2, float &o3) const;
+//! \endcode
+//! (see colorspace::ChangeGamma and colorspace::ChangeSaturation).
+//! Stages are composed with utils::chain(), so that a sequence of
+//! elementwise steps runs in a single sweep over the frame: the pipeline
+//! works on blocks of pixels small enough to stay in the cache, and runs
+//! every stage of the chain on a block before moving to the next one.
+//!
+//! A stage can also provide a block form, applied in place to \a size
+//! contiguous pixels:
+//! \code
+//! void operator()(float *c1, float *c2, float *c3, size_t size) const;
+//! \endcode
+//! which the pipeline calls instead of the per-pixel form, so that the stage
+//! can run the vector kernels of vecmath.h at the width of the CPU
+//! (colorspace::ChangeGamma calls utils::vpow()).
+
+//! \brief Copy the rectangle of \a view in a new frame (as cut()), applying
+//! \a stage to the X, Y and Z (RGB) channels in the same pass. The other
+//! channels and the tags are copied unchanged.
+template <typename Stage>
+Frame *transformRGB(const FrameView &view, const Stage &stage);
+
+//! \brief Apply \a stage in place to the X, Y and Z (RGB) channels of
+//! \a frame, in a single pass
+template <typename Stage>
+void transformRGB(Frame &frame, const Stage &stage);
+
+}  // pfs
+
+#include "pixelpipeline.hxx"
+
+#endif  // PFS_PIXELPIPELINE_H
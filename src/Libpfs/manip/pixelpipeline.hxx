@@ -0,0 +1,158 @@
+/*
+ * This file is a part of LuminanceHDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ */
+
+//! \author agent <agent@local>
+
+#ifndef PFS_PIXELPIPELINE_HXX
+#define PFS_PIXELPIPELINE_HXX
+
+#include "pixelpipeline.h"
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+
+#include <Libpfs/array2dview.h>
+#include <Libpfs/frame.h>
+#include <Libpfs/frameview.h>
+#include <Libpfs/utils/chain.h>
+
+namespace pfs {
+
+namespace detail {
+//! \brief pixels of a block of transformRGB(Frame &): the three channels of
+//! a block stay in the cache while the stages of a chain run on it
+const int PIPELINE_BLOCK_SIZE = 4096;
+
+//! \brief true if \c Stage has the block form of a stage
+template <typename Stage>
+struct HasBlockForm {
+    template <typename S,
+              void (S::*)(float *, float *, float *, size_t) const>
+    struct Check;
+
+    template <typename S>
+    static char test(Check<S, &S::operator()> *);
+    template <typename S>
+    static long test(...);
+
+    static const bool value = (sizeof(test<Stage>(0)) == sizeof(char));
+};
+
+template <typename Stage>
+void runStage(const Stage &stage, float *c1, float *c2, float *c3,
+              size_t size, std::true_type) {
+    stage(c1, c2, c3, size);
+}
+
+template <typename Stage>
+void runStage(const Stage &stage, float *c1, float *c2, float *c3,
+              size_t size, std::false_type) {
+    for (size_t i = 0; i < size; ++i) {
+        stage(c1[i], c2[i], c3[i], c1[i], c2[i], c3[i]);
+    }
+}
+
+//! \brief apply \a stage in place to \a size pixels, through its block
+//! form if it has one
+template <typename Stage>
+void runStage(const Stage &stage, float *c1, float *c2, float *c3,
+              size_t size) {
+    runStage(stage, c1, c2, c3, size,
+             std::integral_constant<bool, HasBlockForm<Stage>::value>());
+}
+
+//! \brief the stages of a chain run one after the other on the block, each
+//! in its own form
+template <typename Func1, typename Func2>
+void runStage(const utils::Chain<Func1, Func2> &stage, float *c1, float *c2,
+              float *c3, size_t size) {
+    runStage(stage.first(), c1, c2, c3, size);
+    runStage(stage.second(), c1, c2, c3, size);
+}
+}  // detail
+
+template <typename Stage>
+Frame *transformRGB(const FrameView &view, const Stage &stage) {
+    Frame *outFrame = new Frame(view.getWidth(), view.getHeight());
+
+    Channel *X, *Y, *Z;
+    outFrame->createXYZChannels(X, Y, Z);
+
+    const ChannelContainer &channels = view.getChannels();
+    for (ChannelContainer::const_iterator it = channels.begin();
+         it != channels.end(); ++it) {
+        const Channel *inCh = *it;
+        Channel *outCh = outFrame->createChannel(inCh->getName());
+        if (outCh != X && outCh != Y && outCh != Z) {
+            copy(view.getChannel(*inCh), Array2DView<float>(*outCh));
+        }
+    }
+
+    FrameView::ChannelView inX, inY, inZ;
+    const bool hasXYZ = view.getXYZChannels(inX, inY, inZ);
+    assert(hasXYZ);
+    (void)hasXYZ;
+
+    const Array2DView<float> outX(*X), outY(*Y), outZ(*Z);
+    const int rows = static_cast<int>(view.getHeight());
+    const size_t cols = view.getWidth();
+#pragma omp parallel for
+    for (int r = 0; r < rows; ++r) {
+        const float *x = inX.row_begin(r);
+        const float *y = inY.row_begin(r);
+        const float *z = inZ.row_begin(r);
+        float *ox = outX.row_begin(r);
+        float *oy = outY.row_begin(r);
+        float *oz = outZ.row_begin(r);
+        std::copy(x, x + cols, ox);
+        std::copy(y, y + cols, oy);
+        std::copy(z, z + cols, oz);
+        // on the row, still in the cache
+        detail::runStage(stage, ox, oy, oz, cols);
+    }
+
+    pfs::copyTags(&view.getFrame(), outFrame);
+
+    return outFrame;
+}
+
+template <typename Stage>
+void transformRGB(Frame &frame, const Stage &stage) {
+    Channel *X, *Y, *Z;
+    frame.getXYZChannels(X, Y, Z);
+    assert(X != NULL && Y != NULL && Z != NULL);
+
+    float *x = X->data();
+    float *y = Y->data();
+    float *z = Z->data();
+    const int size = static_cast<int>(frame.size());
+#pragma omp parallel for
+    for (int idx = 0; idx < size; idx += detail::PIPELINE_BLOCK_SIZE) {
+        const int count = std::min(detail::PIPELINE_BLOCK_SIZE, size - idx);
+        detail::runStage(stage, x + idx, y + idx, z + idx, count);
+    }
+}
+
+}  // pfs
+
+#endif  // PFS_PIXELPIPELINE_HXX
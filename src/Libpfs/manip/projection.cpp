@@ -26,12 +26,15 @@
 
 #include <boost/math/constants/constants.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <cstdio>
 #include <cstring>
-// #include <stdio.h>
-// #include <stdlib.h>
+#include <vector>
 
 #include "Libpfs/array2d.h"
+#include "Libpfs/frame.h"
 #include "arch/math.h"
 
 using namespace std;
@@ -45,86 +48,25 @@ MirrorBallProjection MirrorBallProjection::singleton(true);
 
 const double EPSILON = 1e-7;
 
-class Vector3D {
-   public:
-    double x, y, z;
-
-    Vector3D(double phi, double theta) {
-        x = cos(phi) * sin(theta);
-        y = sin(phi) * sin(theta);
-        z = cos(theta);
-    }
-
-    Vector3D(double x, double y, double z) {
-        this->x = x;
-        this->y = y;
-        this->z = z;
-
-        normalize();
-    }
-
-    double magnitude(void) { return sqrt(x * x + y * y + z * z); }
-
-    void normalize(void) {
-        double len = magnitude();
-
-        x = x / len;
-        y = y / len;
-        z = z / len;
-    }
-
-    double dot(Vector3D *v) { return x * v->x + y * v->y + z * v->z; }
-
-    // TODO: optimize rotations by precomputing sines and cosines
-    void rotateX(double angle) {
-        angle *= boost::math::double_constants::degree;
-
-        double c = cos(angle);
-        double s = sin(angle);
-
-        double y2 = c * y + -s * z;
-        double z2 = s * y + c * z;
-
-        y = y2;
-        z = z2;
-    }
-
-    void rotateY(double angle) {
-        angle *= boost::math::double_constants::degree;
-
-        double c = cos(angle);
-        double s = sin(angle);
-
-        double x2 = c * x + s * z;
-        double z2 = -s * x + c * z;
-
-        x = x2;
-        z = z2;
-    }
-
-    void rotateZ(double angle) {
-        angle *= boost::math::double_constants::degree;
-
-        double c = cos(angle);
-        double s = sin(angle);
+Vector3D::Vector3D(double phi, double theta) {
+    x = cos(phi) * sin(theta);
+    y = sin(phi) * sin(theta);
+    z = cos(theta);
+}
 
-        double x2 = c * x + -s * y;
-        double y2 = s * x + c * y;
+Vector3D::Vector3D(double x, double y, double z) : x(x), y(y), z(z) {
+    normalize();
+}
 
-        x = x2;
-        y = y2;
-    }
-};
+double Vector3D::magnitude() const { return sqrt(x * x + y * y + z * z); }
 
-class Point2D {
-   public:
-    double x, y;
+void Vector3D::normalize() {
+    double len = magnitude();
 
-    Point2D(double x, double y) {
-        this->x = x;
-        this->y = y;
-    }
-};
+    x = x / len;
+    y = y / len;
+    z = z / len;
+}
 
 /// PROJECTIONFACTORY
 ProjectionFactory::ProjectionFactory(bool) {}
@@ -143,8 +85,13 @@ Projection *ProjectionFactory::getProjection(char *name) {
         *opts++ = '\0';
     }
 
-    ProjectionCreator projectionCreator =
-        singleton.projections.find(string(name))->second;
+    map<string, ProjectionCreator>::const_iterator it =
+        singleton.projections.find(string(name));
+    if (it == singleton.projections.end()) {
+        return NULL;
+    }
+
+    ProjectionCreator projectionCreator = it->second;
 
     if (projectionCreator != NULL) {
         projection = projectionCreator();
@@ -183,7 +130,7 @@ const char *MirrorBallProjection::getName(void) { return name; }
 
 double MirrorBallProjection::getSizeRatio(void) { return 1; }
 
-bool MirrorBallProjection::isValidPixel(double u, double v) {
+bool MirrorBallProjection::isValidPixel(double u, double v) const {
     // check if we are not in a boundary region (outside a circle)
     if ((u - 0.5) * (u - 0.5) + (v - 0.5) * (v - 0.5) > 0.25)
         return false;
@@ -191,39 +138,37 @@ bool MirrorBallProjection::isValidPixel(double u, double v) {
         return true;
 }
 
-Vector3D *MirrorBallProjection::uvToDirection(double u, double v) {
+Vector3D MirrorBallProjection::uvToDirection(double u, double v) const {
     u = 2 * u - 1;
     v = 2 * v - 1;
 
     double phi = atan2(v, u);
     double theta = 2 * asin(sqrt(u * u + v * v));
 
-    Vector3D *direction = new Vector3D(phi, theta);
-    //     double t;
+    Vector3D direction(phi, theta);
 
-    direction->y = -direction->y;
+    direction.y = -direction.y;
 
     return direction;
 }
 
-Point2D *MirrorBallProjection::directionToUV(Vector3D *direction) {
+Point2D MirrorBallProjection::directionToUV(const Vector3D &direction) const {
     double u, v;
 
-    direction->y = -direction->y;
+    const double dy = -direction.y;
 
-    if (fabs(direction->x) > 0 || fabs(direction->y) > 0) {
-        double distance =
-            sqrt(direction->x * direction->x + direction->y * direction->y);
+    if (fabs(direction.x) > 0 || fabs(dy) > 0) {
+        double distance = sqrt(direction.x * direction.x + dy * dy);
 
-        double r = 0.5 * (sin(acos(direction->z) / 2)) / distance;
+        double r = 0.5 * (sin(acos(direction.z) / 2)) / distance;
 
-        u = direction->x * r + 0.5;
-        v = direction->y * r + 0.5;
+        u = direction.x * r + 0.5;
+        v = dy * r + 0.5;
     } else {
         u = v = 0.5;
     }
 
-    return new Point2D(u, v);
+    return Point2D(u, v);
 }
 /// END MIRRORBALL
 
@@ -247,13 +192,8 @@ void AngularProjection::setOptions(char *opts) {
     static const char *OPTION_ANGLE = "angle";
 
     while (*opts) {
-        // fprintf(stderr,"option: %s\n", opts);
-        // if(delimiter = strchr(name, '/'))
-        //*delimiter++ = '\0';
-
         if (strncmp(opts, OPTION_ANGLE, strlen(OPTION_ANGLE)) == 0) {
             totalAngle = strtod(opts + strlen(OPTION_ANGLE) + 1, &delimiter);
-            //  fprintf(stderr,"angle: %g\n", totalAngle);
 
             if (0 >= totalAngle || totalAngle > 360) {
                 throw "error: angular projection: angle must be in (0,360] "
@@ -271,7 +211,7 @@ const char *AngularProjection::getName(void) { return name; }
 
 double AngularProjection::getSizeRatio(void) { return 1; }
 
-bool AngularProjection::isValidPixel(double u, double v) {
+bool AngularProjection::isValidPixel(double u, double v) const {
     // check if we are not in a boundary region (outside a circle)
     if ((u - 0.5) * (u - 0.5) + (v - 0.5) * (v - 0.5) > 0.25)
         return false;
@@ -279,7 +219,7 @@ bool AngularProjection::isValidPixel(double u, double v) {
         return true;
 }
 
-Vector3D *AngularProjection::uvToDirection(double u, double v) {
+Vector3D AngularProjection::uvToDirection(double u, double v) const {
     u = 2 * u - 1;
     v = 2 * v - 1;
 
@@ -289,91 +229,78 @@ Vector3D *AngularProjection::uvToDirection(double u, double v) {
     double phi = atan2(v, u);
     double theta = boost::math::double_constants::pi * sqrt(u * u + v * v);
 
-    Vector3D *direction = new Vector3D(phi, theta);
-    //     double t;
+    Vector3D direction(phi, theta);
 
-    direction->y = -direction->y;
+    direction.y = -direction.y;
 
     return direction;
 }
 
-Point2D *AngularProjection::directionToUV(Vector3D *direction) {
+Point2D AngularProjection::directionToUV(const Vector3D &direction) const {
     double u, v;
 
-    direction->y = -direction->y;
+    const double dy = -direction.y;
 
-    if (fabs(direction->x) > 0 || fabs(direction->y) > 0) {
-        double distance =
-            sqrt(direction->x * direction->x + direction->y * direction->y);
+    if (fabs(direction.x) > 0 || fabs(dy) > 0) {
+        double distance = sqrt(direction.x * direction.x + dy * dy);
 
         double r =
-            (boost::math::double_constants::one_div_two_pi)*acos(direction->z) /
+            (boost::math::double_constants::one_div_two_pi)*acos(direction.z) /
             distance;
 
-        u = direction->x * r + 0.5;
-        v = direction->y * r + 0.5;
+        u = direction.x * r + 0.5;
+        v = dy * r + 0.5;
     } else {
         u = v = 0.5;
     }
 
-    return new Point2D(u, v);
+    return Point2D(u, v);
 }
 /// END ANGULAR
 
 /// CYLINDRICAL
-CylindricalProjection::CylindricalProjection(bool initialization) {
+CylindricalProjection::CylindricalProjection(bool initialization)
+    : pole(0, 1, 0), equator(0, 0, -1), cross(1, 0, 0) {
     name = "cylindrical";
 
     if (initialization)
         ProjectionFactory::registerProjection(name, this->create);
-
-    pole = new Vector3D(0, 1, 0);
-    equator = new Vector3D(0, 0, -1);
-    cross = new Vector3D(1, 0, 0);
 }
 
 Projection *CylindricalProjection::create() {
     return new CylindricalProjection(false);
 }
 
-CylindricalProjection::~CylindricalProjection() {
-    delete pole;
-    delete equator;
-    delete cross;
-}
-
 double CylindricalProjection::getSizeRatio(void) { return 2; }
 
-bool CylindricalProjection::isValidPixel(double /*u*/, double /*v*/) {
+bool CylindricalProjection::isValidPixel(double /*u*/, double /*v*/) const {
     return true;
 }
 
-Vector3D *CylindricalProjection::uvToDirection(double u, double v) {
+Vector3D CylindricalProjection::uvToDirection(double u, double v) const {
     u = 0.75 - u;
 
     u *= boost::math::double_constants::two_pi;
 
     v = acos(1 - 2 * v);
 
-    Vector3D *direction = new Vector3D(u, v);
+    Vector3D direction(u, v);
 
-    double temp = direction->z;
-    direction->z = direction->y;
-    direction->y = temp;
+    std::swap(direction.y, direction.z);
 
     return direction;
 }
 
-Point2D *CylindricalProjection::directionToUV(Vector3D *direction) {
+Point2D CylindricalProjection::directionToUV(const Vector3D &direction) const {
     double u, v;
-    double lat = direction->dot(pole);
+    double lat = direction.dot(pole);
 
     v = (1 - lat) / 2;
 
     if (v < EPSILON || fabs(1 - v) < EPSILON)
         u = 0;
     else {
-        double ratio = equator->dot(direction) / sin(acos(lat));
+        double ratio = equator.dot(direction) / sin(acos(lat));
 
         if (ratio < -1)
             ratio = -1;
@@ -382,7 +309,7 @@ Point2D *CylindricalProjection::directionToUV(Vector3D *direction) {
 
         double lon = acos(ratio) / (boost::math::double_constants::two_pi);
 
-        if (cross->dot(direction) < 0)
+        if (cross.dot(direction) < 0)
             u = lon;
         else
             u = 1 - lon;
@@ -392,63 +319,50 @@ Point2D *CylindricalProjection::directionToUV(Vector3D *direction) {
         if (v == 1) v = 0;
     }
 
-    //  if ( 0 > v || v >= 1 ) fprintf(stderr, "u: %f (%f,%f,%f)\n", v,
-    //  direction->x, direction->y, direction->z);
-    //  assert ( -0. <= u && u < 1 );
-    //  assert ( -0. <= v && v < 1 );
-    return new Point2D(u, v);
+    return Point2D(u, v);
 }
 /// END CYLINDRICAL
 
 /// POLAR
-PolarProjection::PolarProjection(bool initialization) {
+PolarProjection::PolarProjection(bool initialization)
+    : pole(0, 1, 0), equator(0, 0, -1), cross(1, 0, 0) {
     name = "polar";
 
     if (initialization)
         ProjectionFactory::registerProjection(name, this->create);
-
-    pole = new Vector3D(0, 1, 0);
-    equator = new Vector3D(0, 0, -1);
-    cross = new Vector3D(1, 0, 0);
 }
 
 Projection *PolarProjection::create() { return new PolarProjection(false); }
 
-PolarProjection::~PolarProjection() {
-    delete pole;
-    delete equator;
-    delete cross;
-}
-
 double PolarProjection::getSizeRatio(void) { return 2; }
 
-bool PolarProjection::isValidPixel(double /*u*/, double /*v*/) { return true; }
+bool PolarProjection::isValidPixel(double /*u*/, double /*v*/) const {
+    return true;
+}
 
-Vector3D *PolarProjection::uvToDirection(double u, double v) {
+Vector3D PolarProjection::uvToDirection(double u, double v) const {
     u = 0.75 - u;
 
     u *= boost::math::double_constants::two_pi;
     v *= boost::math::double_constants::pi;
 
-    Vector3D *direction = new Vector3D(u, v);
+    Vector3D direction(u, v);
 
-    double temp = direction->z;
-    direction->z = direction->y;
-    direction->y = temp;
+    std::swap(direction.y, direction.z);
 
     return direction;
 }
 
-Point2D *PolarProjection::directionToUV(Vector3D *direction) {
+Point2D PolarProjection::directionToUV(const Vector3D &direction) const {
     double u, v;
-    double lat = acos(direction->dot(pole));
+    double lat = acos(direction.dot(pole));
 
     v = lat * (1 / boost::math::double_constants::pi);
 
     if (v < EPSILON || fabs(1 - v) < EPSILON)
         u = 0;
     else {
-        double ratio = equator->dot(direction) / sin(lat);
+        double ratio = equator.dot(direction) / sin(lat);
 
         if (ratio < -1)
             ratio = -1;
@@ -457,7 +371,7 @@ Point2D *PolarProjection::directionToUV(Vector3D *direction) {
 
         double lon = acos(ratio) / (boost::math::double_constants::two_pi);
 
-        if (cross->dot(direction) < 0)
+        if (cross.dot(direction) < 0)
             u = lon;
         else
             u = 1 - lon;
@@ -467,101 +381,194 @@ Point2D *PolarProjection::directionToUV(Vector3D *direction) {
         if (v == 1) v = 0;
     }
 
-    //  if ( 0 > v || v >= 1 ) fprintf(stderr, "u: %f (%f,%f,%f)\n", v,
-    //  direction->x, direction->y, direction->z);
-    //  assert ( -0. <= u && u < 1 );
-    //  assert ( -0. <= v && v < 1 );
-    return new Point2D(u, v);
+    return Point2D(u, v);
 }
 /// END POLAR
 
-void transformArray(const pfs::Array2Df *in, pfs::Array2Df *out,
-                    TransformInfo *transformInfo) {
-    const double delta = 1. / transformInfo->oversampleFactor;
-    const double offset = 0.5 / transformInfo->oversampleFactor;
-    const double scaler = 1. / (transformInfo->oversampleFactor *
-                                transformInfo->oversampleFactor);
+namespace {
 
-    const int outRows = out->getRows();
-    const int outCols = out->getCols();
+//! \brief rotation matrix equivalent to rotateX, rotateY, rotateZ applied in
+//! sequence. Angles are negated, because we want to rotate the environment
+//! around us, not us within the environment.
+class Rotation {
+   public:
+    explicit Rotation(const TransformInfo &info)
+        : m_identity(info.xRotate == 0 && info.yRotate == 0 &&
+                     info.zRotate == 0) {
+        const double deg = boost::math::double_constants::degree;
+        const double cx = cos(-info.xRotate * deg);
+        const double sx = sin(-info.xRotate * deg);
+        const double cy = cos(-info.yRotate * deg);
+        const double sy = sin(-info.yRotate * deg);
+        const double cz = cos(-info.zRotate * deg);
+        const double sz = sin(-info.zRotate * deg);
+
+        // Rz * Ry * Rx
+        m[0][0] = cz * cy;
+        m[0][1] = cz * sy * sx - sz * cx;
+        m[0][2] = cz * sy * cx + sz * sx;
+        m[1][0] = sz * cy;
+        m[1][1] = sz * sy * sx + cz * cx;
+        m[1][2] = sz * sy * cx - cz * sx;
+        m[2][0] = -sy;
+        m[2][1] = cy * sx;
+        m[2][2] = cy * cx;
+    }
 
-    const int inRows = in->getRows();
-    const int inCols = in->getCols();
+    void apply(Vector3D &d) const {
+        if (m_identity) return;
 
-    for (int y = 0; y < outRows; y++)
-        for (int x = 0; x < outCols; x++) {
-            double pixVal = 0;
+        const double x = m[0][0] * d.x + m[0][1] * d.y + m[0][2] * d.z;
+        const double y = m[1][0] * d.x + m[1][1] * d.y + m[1][2] * d.z;
+        const double z = m[2][0] * d.x + m[2][1] * d.y + m[2][2] * d.z;
 
-            if (transformInfo->dstProjection->isValidPixel(
-                    (x + 0.5) / outCols, (y + 0.5) / outCols) == true) {
-                for (double sy = 0, oy = 0;
-                     oy < transformInfo->oversampleFactor; sy += delta, oy++)
-                    for (double sx = 0, ox = 0;
-                         ox < transformInfo->oversampleFactor;
-                         sx += delta, ox++) {
-                        Vector3D *direction =
-                            transformInfo->dstProjection->uvToDirection(
-                                (x + offset + sx) / outCols,
-                                (y + offset + sy) / outRows);
+        d.x = x;
+        d.y = y;
+        d.z = z;
+    }
 
-                        if (direction == NULL) continue;
+   private:
+    bool m_identity;
+    double m[3][3];
+};
 
-                        // angles below are negated, because we want to rotate
-                        // the environment around us, not us within the
-                        // environment.
-                        if (transformInfo->xRotate != 0)
-                            direction->rotateX(-transformInfo->xRotate);
+//! \brief source pixels and weights for one oversample of an output pixel
+struct SourceSample {
+    int x0, y0;
+    int x1, y1;
+    float w00, w10, w01, w11;
+};
 
-                        if (transformInfo->yRotate != 0)
-                            direction->rotateY(-transformInfo->yRotate);
+inline int clampCoord(int v, int size) {
+    return std::max(0, std::min(v, size - 1));
+}
 
-                        if (transformInfo->zRotate != 0)
-                            direction->rotateZ(-transformInfo->zRotate);
+SourceSample computeSample(const Point2D &p, int inCols, int inRows,
+                           bool interpolate) {
+    const double px = p.x * inCols;
+    const double py = p.y * inRows;
 
-                        Point2D *p =
-                            transformInfo->srcProjection->directionToUV(
-                                direction);
+    SourceSample s;
+    if (interpolate) {
+        const int ix = static_cast<int>(floor(px));
+        const int iy = static_cast<int>(floor(py));
 
-                        p->x *= inCols;
-                        p->y *= inRows;
+        const double i = px - ix;
+        const double j = py - iy;
 
-                        if (transformInfo->interpolate == true) {
-                            int ix = (int)floor(p->x);
-                            int iy = (int)floor(p->y);
+        s.x0 = clampCoord(ix, inCols);
+        s.y0 = clampCoord(iy, inRows);
+        s.x1 = clampCoord(ix + 1, inCols);
+        s.y1 = clampCoord(iy + 1, inRows);
 
-                            double i = p->x - ix;
-                            double j = p->y - iy;
+        s.w00 = static_cast<float>((1 - i) * (1 - j));
+        s.w10 = static_cast<float>(i * (1 - j));
+        s.w01 = static_cast<float>((1 - i) * j);
+        s.w11 = static_cast<float>(i * j);
+    } else {
+        s.x0 = s.x1 = clampCoord(static_cast<int>(floor(px + 0.5)), inCols);
+        s.y0 = s.y1 = clampCoord(static_cast<int>(floor(py + 0.5)), inRows);
 
-                            // compute pixel weights for interpolation
-                            double w1 = i * j;
-                            double w2 = (1 - i) * j;
-                            double w3 = (1 - i) * (1 - j);
-                            double w4 = i * (1 - j);
+        s.w00 = 1.f;
+        s.w10 = s.w01 = s.w11 = 0.f;
+    }
+    return s;
+}
 
-                            int dx = ix + 1;
-                            if (dx >= inCols) dx = inCols - 1;
+void transformChannels(const std::vector<const pfs::Array2Df *> &in,
+                       const std::vector<pfs::Array2Df *> &out,
+                       const TransformInfo &transformInfo) {
+    assert(in.size() == out.size());
+    if (in.empty()) return;
 
-                            int dy = iy + 1;
-                            if (dy >= inRows) dy = inRows - 1;
+    const Projection &dstProjection = *transformInfo.dstProjection;
+    const Projection &srcProjection = *transformInfo.srcProjection;
+    const Rotation rotation(transformInfo);
 
-                            pixVal += w3 * (*in)(ix, iy) + w4 * (*in)(dx, iy) +
-                                      w1 * (*in)(dx, dy) + w2 * (*in)(ix, dy);
-                        } else {
-                            int ix = (int)floor(p->x + 0.5);
-                            int iy = (int)floor(p->y + 0.5);
+    const int oversample = std::max(transformInfo.oversampleFactor, 1);
+    const double delta = 1. / oversample;
+    const double offset = 0.5 / oversample;
 
-                            if (ix >= inCols) ix = inCols - 1;
+    const size_t numChannels = in.size();
 
-                            if (iy >= inRows) iy = inRows - 1;
+    const int outRows = out[0]->getRows();
+    const int outCols = out[0]->getCols();
 
-                            pixVal += (*in)(ix, iy);
-                        }
+    const int inRows = in[0]->getRows();
+    const int inCols = in[0]->getCols();
+
+#pragma omp parallel
+    {
+        // per-thread accumulators, allocated once
+        std::vector<float> pixVal(numChannels);
+
+#pragma omp for schedule(dynamic, 16)
+        for (int y = 0; y < outRows; y++) {
+            for (int x = 0; x < outCols; x++) {
+                if (!dstProjection.isValidPixel((x + 0.5) / outCols,
+                                                (y + 0.5) / outRows)) {
+                    continue;
+                }
 
-                        delete direction;
-                        delete p;
+                std::fill(pixVal.begin(), pixVal.end(), 0.f);
+                int numSamples = 0;
 
-                        (*out)(x, y) = pixVal * scaler;
+                for (int oy = 0; oy < oversample; oy++) {
+                    for (int ox = 0; ox < oversample; ox++) {
+                        const double u = (x + offset + ox * delta) / outCols;
+                        const double v = (y + offset + oy * delta) / outRows;
+
+                        // oversamples of border pixels can fall outside the
+                        // domain of the projection
+                        if (!dstProjection.isValidPixel(u, v)) continue;
+
+                        Vector3D direction = dstProjection.uvToDirection(u, v);
+
+                        rotation.apply(direction);
+
+                        const SourceSample s = computeSample(
+                            srcProjection.directionToUV(direction), inCols,
+                            inRows, transformInfo.interpolate);
+
+                        for (size_t c = 0; c < numChannels; ++c) {
+                            const pfs::Array2Df &src = *in[c];
+                            pixVal[c] += s.w00 * src(s.x0, s.y0) +
+                                         s.w10 * src(s.x1, s.y0) +
+                                         s.w01 * src(s.x0, s.y1) +
+                                         s.w11 * src(s.x1, s.y1);
+                        }
+                        ++numSamples;
                     }
+                }
+
+                const float scaler = numSamples ? 1.f / numSamples : 0.f;
+                for (size_t c = 0; c < numChannels; ++c) {
+                    (*out[c])(x, y) = pixVal[c] * scaler;
+                }
             }
         }
+    }
+}
+}  // anonymous namespace
+
+void transformArray(const pfs::Array2Df *in, pfs::Array2Df *out,
+                    TransformInfo *transformInfo) {
+    transformChannels(std::vector<const pfs::Array2Df *>(1, in),
+                      std::vector<pfs::Array2Df *>(1, out), *transformInfo);
+}
+
+void transformFrame(const pfs::Frame &in, pfs::Frame &out,
+                    const TransformInfo &transformInfo) {
+    const pfs::ChannelContainer &channels = in.getChannels();
+
+    std::vector<const pfs::Array2Df *> inChannels;
+    std::vector<pfs::Array2Df *> outChannels;
+
+    for (pfs::ChannelContainer::const_iterator it = channels.begin();
+         it != channels.end(); ++it) {
+        inChannels.push_back(*it);
+        outChannels.push_back(out.createChannel((*it)->getName()));
+    }
+
+    transformChannels(inChannels, outChannels, transformInfo);
 }
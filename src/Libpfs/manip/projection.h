@@ -34,17 +34,47 @@
 
 #include "Libpfs/array2d_fwd.h"
 
-class Vector3D;
-class Point2D;
+namespace pfs {
+class Frame;
+}
 
+//! \brief unit vector on the sphere, stored by value
+class Vector3D {
+   public:
+    double x, y, z;
+
+    Vector3D() : x(0.), y(0.), z(0.) {}
+
+    //! \brief build a direction from spherical coordinates
+    Vector3D(double phi, double theta);
+
+    //! \brief build a direction from cartesian coordinates (normalized)
+    Vector3D(double x, double y, double z);
+
+    double magnitude() const;
+    void normalize();
+
+    double dot(const Vector3D &v) const { return x * v.x + y * v.y + z * v.z; }
+};
+
+class Point2D {
+   public:
+    double x, y;
+
+    Point2D() : x(0.), y(0.) {}
+    Point2D(double x, double y) : x(x), y(y) {}
+};
+
+//! \note all the methods are const and must not touch any state: they are
+//! called concurrently by the worker threads of \c transformFrame
 class Projection {
    protected:
     const char *name;
 
    public:
-    virtual Vector3D *uvToDirection(double u, double v) = 0;
-    virtual Point2D *directionToUV(Vector3D *direction) = 0;
-    virtual bool isValidPixel(double u, double v) = 0;
+    virtual Vector3D uvToDirection(double u, double v) const = 0;
+    virtual Point2D directionToUV(const Vector3D &direction) const = 0;
+    virtual bool isValidPixel(double u, double v) const = 0;
     virtual double getSizeRatio(void) = 0;
     virtual ~Projection() {}
 
@@ -73,9 +103,9 @@ class MirrorBallProjection : public Projection {
     static Projection *create();
     const char *getName(void);
     double getSizeRatio(void);
-    bool isValidPixel(double u, double v);
-    Vector3D *uvToDirection(double u, double v);
-    Point2D *directionToUV(Vector3D *direction);
+    bool isValidPixel(double u, double v) const;
+    Vector3D uvToDirection(double u, double v) const;
+    Point2D directionToUV(const Vector3D &direction) const;
 };
 
 class AngularProjection : public Projection {
@@ -88,42 +118,40 @@ class AngularProjection : public Projection {
     void setOptions(char *opts);
     const char *getName(void);
     double getSizeRatio(void);
-    bool isValidPixel(double u, double v);
-    Vector3D *uvToDirection(double u, double v);
-    Point2D *directionToUV(Vector3D *direction);
+    bool isValidPixel(double u, double v) const;
+    Vector3D uvToDirection(double u, double v) const;
+    Point2D directionToUV(const Vector3D &direction) const;
     void setAngle(double v) { totalAngle = v; }
 };
 
 class CylindricalProjection : public Projection {
-    Vector3D *pole;
-    Vector3D *equator;
-    Vector3D *cross;
+    Vector3D pole;
+    Vector3D equator;
+    Vector3D cross;
     explicit CylindricalProjection(bool initialization);
 
    public:
     static CylindricalProjection singleton;
     static Projection *create();
-    ~CylindricalProjection();
     double getSizeRatio(void);
-    bool isValidPixel(double /*u*/, double /*v*/);
-    Vector3D *uvToDirection(double u, double v);
-    Point2D *directionToUV(Vector3D *direction);
+    bool isValidPixel(double /*u*/, double /*v*/) const;
+    Vector3D uvToDirection(double u, double v) const;
+    Point2D directionToUV(const Vector3D &direction) const;
 };
 
 class PolarProjection : public Projection {
-    Vector3D *pole;
-    Vector3D *equator;
-    Vector3D *cross;
+    Vector3D pole;
+    Vector3D equator;
+    Vector3D cross;
     explicit PolarProjection(bool initialization);
 
    public:
     static PolarProjection singleton;
     static Projection *create();
-    ~PolarProjection();
     double getSizeRatio(void);
-    bool isValidPixel(double /*u*/, double /*v*/);
-    Vector3D *uvToDirection(double u, double v);
-    Point2D *directionToUV(Vector3D *direction);
+    bool isValidPixel(double /*u*/, double /*v*/) const;
+    Vector3D uvToDirection(double u, double v) const;
+    Point2D directionToUV(const Vector3D &direction) const;
 };
 
 class TransformInfo {
@@ -144,7 +172,19 @@ class TransformInfo {
     }
 };
 
+//! \brief Reproject a single array
+//! \note prefer \c transformFrame when more than one channel must be
+//! transformed: the geometry is then computed only once for all of them
 void transformArray(const pfs::Array2Df *in, pfs::Array2Df *out,
                     TransformInfo *transformInfo);
 
+//! \brief Reproject all the channels of \a in into \a out
+//!
+//! For every output pixel the source coordinates are computed once and all
+//! the channels are sampled in the same pass. Output rows are processed in
+//! parallel. Channels missing in \a out are created with the same name of the
+//! source ones; \a out must already have the requested size.
+void transformFrame(const pfs::Frame &in, pfs::Frame &out,
+                    const TransformInfo &transformInfo);
+
 #endif  // PFS_PROJECTION_H
@@ -29,35 +29,101 @@
 #include <cmath>
 #include <iostream>
 #include <numeric>
+#include <vector>
 
 #include "resize.h"
 
 #include "Libpfs/utils/msec_timer.h"
 
 #include "Libpfs/frame.h"
+#include "Libpfs/frameview.h"
+#include "Libpfs/halfframe.h"
 
 namespace pfs {
 
+namespace {
+//! \brief Resample the rectangle of \a view, whose frame stores its channels
+//! in half precision, in \a out: the source rows of a few output rows are
+//! decoded at a time, so that the frame is not inflated
+void resizeHalf(const FrameView &view, Frame &out, InterpolationMethod m) {
+    const HalfFrame &half = *view.getFrame().halfChannels();
+    const size_t w = view.getWidth();
+    const size_t h = view.getHeight();
+    const size_t w2 = out.getWidth();
+    const size_t h2 = out.getHeight();
+
+    // about HALF_BAND_ROWS source rows for each band of output rows
+    const size_t bandRows = std::max<size_t>(1, HALF_BAND_ROWS * h2 / h);
+    std::vector<float> band;
+
+    const HalfFrame::HalfChannelContainer &channels = half.getChannels();
+    for (HalfFrame::HalfChannelContainer::const_iterator it = channels.begin();
+         it != channels.end(); ++it) {
+        Channel *outCh = out.createChannel(it->getName());
+        copyTags(it->getTags(), outCh->getTags());
+
+        for (size_t row0 = 0; row0 < h2; row0 += bandRows) {
+            const size_t row1 = std::min(row0 + bandRows, h2);
+
+            size_t first = row0;
+            size_t last = row1;
+            if (w != w2 || h != h2) {
+                detail::sourceRows(m, w, h, w2, h2, row0, row1, first, last);
+            }
+            band.resize((last - first) * w);
+            for (size_t row = first; row < last; ++row) {
+                utils::halfToFloat(&(*it)(view.getX(), view.getY() + row),
+                                   band.data() + (row - first) * w, w);
+            }
+
+            if (w == w2 && h == h2) {
+                std::copy(band.begin(), band.end(), outCh->row_begin(row0));
+            } else {
+                detail::resampleRows(band.data(), first, w,
+                                     outCh->data() + row0 * w2, w, h, w2, h2,
+                                     row0, row1, m);
+            }
+        }
+    }
+}
+}
+
 Frame *resize(Frame *frame, int xSize, InterpolationMethod m) {
+    return resize(FrameView(*frame), xSize, m);
+}
+
+Frame *resize(const FrameView &view, int xSize, InterpolationMethod m) {
 #ifdef TIMER_PROFILING
     msec_timer f_timer;
     f_timer.start();
 #endif
 
     int new_x = xSize;
-    int new_y = (int)((float)frame->getHeight() * (float)xSize /
-                      (float)frame->getWidth());
+    int new_y = (int)((float)view.getHeight() * (float)xSize /
+                      (float)view.getWidth());
 
     pfs::Frame *resizedFrame = new pfs::Frame(new_x, new_y);
 
-    const ChannelContainer &channels = frame->getChannels();
-    for (ChannelContainer::const_iterator it = channels.begin();
-         it != channels.end(); ++it) {
-        pfs::Channel *newCh = resizedFrame->createChannel((*it)->getName());
+    if (view.getFrame().isHalf()) {
+        // the channels of the frame are not inflated
+        resizeHalf(view, *resizedFrame, m);
+        copyTags(view.getTags(), resizedFrame->getTags());
+    } else {
+        const ChannelContainer &channels = view.getChannels();
+        for (ChannelContainer::const_iterator it = channels.begin();
+             it != channels.end(); ++it) {
+            pfs::Channel *newCh =
+                resizedFrame->createChannel((*it)->getName());
 
-        resize(*it, newCh, m);
+            if (view.isFullFrame()) {
+                // same size: share the buffer of the channel
+                resize(*it, newCh, m);
+            } else {
+                resize(view.getChannel(**it), newCh, m);
+            }
+        }
+        pfs::copyTags(&view.getFrame(), resizedFrame);
     }
-    pfs::copyTags(frame, resizedFrame);
 
 #ifdef TIMER_PROFILING
     f_timer.stop_and_update();
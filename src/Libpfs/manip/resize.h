@@ -34,13 +34,26 @@
 namespace pfs {
 // forward declaration
 class Frame;
+class FrameView;
+template <typename Type>
+class Array2DView;
 
 Frame *resize(Frame *frame, int xSize, InterpolationMethod m);
 
+//! \brief Resample the rectangle of \a view in a new frame, \a xSize pixels
+//! wide, without copying the rectangle first. The half precision channels
+//! of a frame (see Frame::isHalf()) are decoded a band of rows at a time.
+Frame *resize(const FrameView &view, int xSize, InterpolationMethod m);
+
 template <typename Type>
 void resize(const Array2D<Type> *from, Array2D<Type> *to,
             InterpolationMethod m);
 
+//! \brief Resample \a from (e.g. a sub-rectangle of an Array2D) into \a to
+template <typename Type>
+void resize(const Array2DView<const Type> &from, Array2D<Type> *to,
+            InterpolationMethod m);
+
 template <typename Type>
 void resize(const Array2D<Type> &from, Array2D<Type> &to,
             InterpolationMethod m) {
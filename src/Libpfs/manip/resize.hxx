@@ -25,6 +25,7 @@
 #include <boost/math/constants/constants.hpp>
 #include "copy.h"
 #include "resize.h"
+#include "Libpfs/array2dview.h"
 #include "../../sleef.c"
 
 namespace pfs {
@@ -45,8 +46,20 @@ static inline float Lanc(float x, float a) {
     }
 }
 
+//! \brief rows [\a ii0, \a ii1) of the source weighted by the output row
+//! whose center is at \a y0 in the source
+inline void lanczosSupport(float y0, float a, float sc, int H, int &ii0,
+                           int &ii1) {
+    ii0 = std::max(0, static_cast<int>(floorf(y0 - a / sc)) + 1);
+    ii1 = std::min(H, static_cast<int>(floorf(y0 + a / sc)) + 1);
+}
+
+//! \brief rows [\a row0, \a row1) of the resampling of the W x H image
+//! \a src to the width W2, from the rows of \a src starting at \a srcRow0.
+//! The first of the output rows is written at \a dst.
 template <typename Type>
-void Lanczos(const Type *src, Type *dst, int W, int H, int W2, int H2)
+void LanczosRows(const Type *src, int srcRow0, int srcStride, Type *dst,
+                 int W, int H, int W2, int row0, int row1)
 
 {
     const float scale = static_cast<float>(W2) / static_cast<float>(W);
@@ -100,15 +113,15 @@ void Lanczos(const Type *src, Type *dst, int W, int H, int W2, int H2)
         // weights for interpolation in y direction
         float *w = new float[support];
 #pragma omp for
-        for (int i = 0; i < H2; i++) {
+        for (int i = row0; i < row1; i++) {
             // y coord of the center of pixel on src image
             float y0 = (static_cast<float>(i) + 0.5f) * delta - 0.5f;
 
             // sum of weights used for normalization
             float ws = 0.0f;
 
-            int ii0 = std::max(0, static_cast<int>(floorf(y0 - a / sc)) + 1);
-            int ii1 = std::min(H, static_cast<int>(floorf(y0 + a / sc)) + 1);
+            int ii0, ii1;
+            lanczosSupport(y0, a, sc, H, ii0, ii1);
 
             // calculate weights for vertical interpolation
             for (int ii = ii0; ii < ii1; ii++) {
@@ -130,7 +143,8 @@ void Lanczos(const Type *src, Type *dst, int W, int H, int W2, int H2)
                 for (int ii = ii0; ii < ii1; ii++) {
                     int k = ii - ii0;
 
-                    o += w[k] * static_cast<float>(src[ii * W + j]);
+                    o += w[k] * static_cast<float>(
+                                    src[(ii - srcRow0) * srcStride + j]);
                 }
 
                 l[j] = o;
@@ -148,7 +162,7 @@ void Lanczos(const Type *src, Type *dst, int W, int H, int W2, int H2)
                     o += wh[k] * l[jj];
                 }
 
-                dst[i * W2 + j] =
+                dst[(i - row0) * W2 + j] =
                     max(zero, min(static_cast<Type>(o),
                                   boost::numeric::bounds<Type>::highest()));
             }
@@ -162,15 +176,25 @@ void Lanczos(const Type *src, Type *dst, int W, int H, int W2, int H2)
     }
 }
 
+template <typename Type>
+void Lanczos(const Type *src, int srcStride, Type *dst, int W, int H, int W2,
+             int H2) {
+    LanczosRows(src, 0, srcStride, dst, W, H, W2, 0, H2);
+}
+
 const size_t BLOCK_FACTOR = 96;
 
 //! \author Davide Anastasia <davideanastasia@users.sourceforge.net>
 //! \note Code derived from
 //! http://tech-algorithm.com/articles/bilinear-image-scaling/
 //! with added OpenMP support and block based resampling
+//! \brief rows [\a row0, \a row1) of the w2 x h2 resampling of the w x h
+//! image \a pixels, from its rows starting at \a srcRow0. The first of the
+//! output rows is written at \a output.
 template <typename Type>
-void resizeBilinearGray(const Type *pixels, Type *output, size_t w, size_t h,
-                        size_t w2, size_t h2) {
+void resizeBilinearGrayRows(const Type *pixels, size_t srcRow0, size_t stride,
+                            Type *output, size_t w, size_t h, size_t w2,
+                            size_t h2, size_t row0, size_t row1) {
     const float x_ratio = static_cast<float>(w - 1) / w2;
     const float y_ratio = static_cast<float>(h - 1) / h2;
 
@@ -183,13 +207,15 @@ void resizeBilinearGray(const Type *pixels, Type *output, size_t w, size_t h,
     float x_diff = 0.0f;
     float y_diff = 0.0f;
 
-#pragma omp parallel shared(pixels, output, w, h, w2, h2) private( \
-    x_diff, y_diff, x, y, index, outputPixel, A, B, C, D)
+#pragma omp parallel shared(pixels, srcRow0, stride, output, w, h, w2, h2, \
+                           row0, row1) private(x_diff, y_diff, x, y, index, \
+                                               outputPixel, A, B, C, D)
     {
 #pragma omp for schedule(static, 1)
-        for (int iO = 0; iO < static_cast<int>(h2); iO += BLOCK_FACTOR) {
+        for (int iO = static_cast<int>(row0); iO < static_cast<int>(row1);
+             iO += BLOCK_FACTOR) {
             for (int jO = 0; jO < static_cast<int>(w2); jO += BLOCK_FACTOR) {
-                for (size_t i = iO, iEnd = std::min(iO + BLOCK_FACTOR, h2);
+                for (size_t i = iO, iEnd = std::min(iO + BLOCK_FACTOR, row1);
                      i < iEnd; i++) {
                     y = static_cast<size_t>(y_ratio * i);
                     y_diff = (y_ratio * i) - y;
@@ -199,12 +225,12 @@ void resizeBilinearGray(const Type *pixels, Type *output, size_t w, size_t h,
                         x = static_cast<size_t>(x_ratio * j);
                         x_diff = (x_ratio * j) - x;
 
-                        index = y * w + x;
+                        index = (y - srcRow0) * stride + x;
 
                         A = pixels[index];
                         B = pixels[index + 1];
-                        C = pixels[index + w];
-                        D = pixels[index + w + 1];
+                        C = pixels[index + stride];
+                        D = pixels[index + stride + 1];
 
                         // Y = A(1-w)(1-h) + B(w)(1-h) + C(h)(1-w) + D(w)(h)
                         outputPixel =
@@ -213,7 +239,7 @@ void resizeBilinearGray(const Type *pixels, Type *output, size_t w, size_t h,
                                               C * (y_diff) * (1 - x_diff) +
                                               D * (x_diff * y_diff));
 
-                        output[i * w2 + j] = outputPixel;
+                        output[(i - row0) * w2 + j] = outputPixel;
                     }
                 }
             }
@@ -222,16 +248,78 @@ void resizeBilinearGray(const Type *pixels, Type *output, size_t w, size_t h,
 }
 
 template <typename Type>
-void resample(const ::pfs::Array2D<Type> *in, ::pfs::Array2D<Type> *out,
-              InterpolationMethod m) {
+void resizeBilinearGray(const Type *pixels, size_t stride, Type *output,
+                        size_t w, size_t h, size_t w2, size_t h2) {
+    resizeBilinearGrayRows(pixels, 0, stride, output, w, h, w2, h2, 0, h2);
+}
+
+//! \brief rows [\a first, \a last) of the w x h source read by the rows
+//! [\a row0, \a row1) of its w2 x h2 resampling
+inline void sourceRows(InterpolationMethod m, size_t w, size_t h, size_t w2,
+                       size_t h2, size_t row0, size_t row1, size_t &first,
+                       size_t &last) {
+    switch (m) {
+        case LanczosInterp: {
+            // as LanczosRows()
+            const float scale = static_cast<float>(w2) / static_cast<float>(w);
+            const float delta = 1.0f / scale;
+            const float a = 3.0f;
+            const float sc = std::min(scale, 1.0f);
+
+            // one more row on each side, in case the rounding of y0 differs
+            int ii0, ii1;
+            lanczosSupport((static_cast<float>(row0) + 0.5f) * delta - 0.5f,
+                           a, sc, static_cast<int>(h), ii0, ii1);
+            first = static_cast<size_t>(std::max(ii0 - 1, 0));
+            lanczosSupport(
+                (static_cast<float>(row1 - 1) + 0.5f) * delta - 0.5f, a, sc,
+                static_cast<int>(h), ii0, ii1);
+            last = std::min(h, static_cast<size_t>(std::max(ii1 + 1, 0)));
+        } break;
+        case BilinearInterp:
+        default: {
+            // as resizeBilinearGrayRows()
+            const float y_ratio = static_cast<float>(h - 1) / h2;
+            first = static_cast<size_t>(y_ratio * row0);
+            last = std::min(
+                h, static_cast<size_t>(y_ratio * (row1 - 1)) + 2);
+        } break;
+    }
+}
+
+//! \brief rows [\a row0, \a row1) of the resampling of the w x h \a in to
+//! w2 x h2, from the rows of \a in starting at \a srcRow0 (see sourceRows())
+template <typename Type>
+void resampleRows(const Type *in, size_t srcRow0, size_t stride, Type *out,
+                  size_t w, size_t h, size_t w2, size_t h2, size_t row0,
+                  size_t row1, InterpolationMethod m) {
+    switch (m) {
+        case LanczosInterp:
+            LanczosRows(in, static_cast<int>(srcRow0),
+                        static_cast<int>(stride), out, static_cast<int>(w),
+                        static_cast<int>(h), static_cast<int>(w2),
+                        static_cast<int>(row0), static_cast<int>(row1));
+            break;
+        case BilinearInterp:
+            resizeBilinearGrayRows(in, srcRow0, stride, out, w, h, w2, h2,
+                                   row0, row1);
+            break;
+    }
+}
+
+template <typename Type>
+void resample(const ::pfs::Array2DView<const Type> &in,
+              ::pfs::Array2D<Type> *out, InterpolationMethod m) {
     switch (m) {
         case LanczosInterp:
-            Lanczos(in->data(), out->data(), in->getCols(), in->getRows(),
-                    out->getCols(), out->getRows());
+            Lanczos(in.data(), static_cast<int>(in.getStride()), out->data(),
+                    in.getCols(), in.getRows(), out->getCols(),
+                    out->getRows());
             break;
         case BilinearInterp:
-            resizeBilinearGray(in->data(), out->data(), in->getCols(),
-                               in->getRows(), out->getCols(), out->getRows());
+            resizeBilinearGray(in.data(), in.getStride(), out->data(),
+                               in.getCols(), in.getRows(), out->getCols(),
+                               out->getRows());
             break;
     }
 }
@@ -243,6 +331,16 @@ void resize(const Array2D<Type> *in, Array2D<Type> *out,
             InterpolationMethod m) {
     if (in->getCols() == out->getCols() && in->getRows() == out->getRows()) {
         pfs::copy(in, out);
+    } else {
+        detail::resample(Array2DView<const Type>(*in), out, m);
+    }
+}
+
+template <typename Type>
+void resize(const Array2DView<const Type> &in, Array2D<Type> *out,
+            InterpolationMethod m) {
+    if (in.getCols() == out->getCols() && in.getRows() == out->getRows()) {
+        pfs::copy(in, Array2DView<Type>(*out));
     } else {
         detail::resample(in, out, m);
     }
@@ -30,6 +30,7 @@
 #endif
 
 #include "rt_algo.h"
+#include "Libpfs/utils/vecmath.h"
 
 namespace lhdrengine
 {
@@ -68,11 +69,30 @@ void findMinMaxPercentile(const float* data, size_t size, float minPrct, float&
     float minVal = data[0];
     float maxVal = data[0];
 #ifdef _OPENMP
-    #pragma omp parallel for reduction(min:minVal) reduction(max:maxVal) num_threads(numThreads)
+    #pragma omp parallel num_threads(numThreads)
+#endif
+    {
+        // one contiguous block per thread, scanned by the vector kernel
+#ifdef _OPENMP
+        const size_t thread = omp_get_thread_num();
+        const size_t threads = omp_get_num_threads();
+#else
+        const size_t thread = 0;
+        const size_t threads = 1;
 #endif
-    for (size_t i = 1; i < size; ++i) {
-        minVal = std::min(minVal, data[i]);
-        maxVal = std::max(maxVal, data[i]);
+        const size_t begin = size * thread / threads;
+        const size_t end = size * (thread + 1) / threads;
+        if (begin < end) {
+            float minThr, maxThr;
+            pfs::utils::vminmax(data + begin, end - begin, minThr, maxThr);
+#ifdef _OPENMP
+            #pragma omp critical
+#endif
+            {
+                minVal = std::min(minVal, minThr);
+                maxVal = std::max(maxVal, maxThr);
+            }
+        }
     }
 
     if (std::fabs(maxVal - minVal) == 0.f) { // fast exit, also avoids division by zero in calculation of scale factor
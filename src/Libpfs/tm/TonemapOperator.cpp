@@ -65,7 +65,7 @@ class TonemapOperatorMantiuk06
                 opts->operator_options.mantiuk06options.saturationfactor,
                 opts->operator_options.mantiuk06options.detailfactor,
                 opts->operator_options.mantiuk06options.contrastequalization,
-                ph);
+                ph, opts->operator_options.mantiuk06options.warmstart.get());
         } catch (...) {
             throw std::runtime_error("Mantiuk06: Tonemap Failed");
         }
@@ -188,7 +188,9 @@ class TonemapOperatorDurand02
             pfstmo_durand02(workingframe,
                             opts->operator_options.durandoptions.spatial,
                             opts->operator_options.durandoptions.range,
-                            opts->operator_options.durandoptions.base, ph);
+                            opts->operator_options.durandoptions.base,
+                            opts->operator_options.durandoptions.bilateralgrid,
+                            ph);
         } catch (...) {
             throw std::runtime_error("Durand: Tonemap Failed");
         }
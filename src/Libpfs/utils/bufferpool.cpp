@@ -0,0 +1,257 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \author agent <agent@local>
+
+#include "bufferpool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "mappedbuffer.h"
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace pfs {
+namespace utils {
+
+void *alignedMalloc(size_t size, size_t alignment) {
+    assert((alignment & (alignment - 1)) == 0);
+    if (size == 0) {
+        size = alignment;
+    }
+#ifdef _MSC_VER
+    void *ptr = _aligned_malloc(size, alignment);
+    if (ptr == NULL) {
+        throw std::bad_alloc();
+    }
+#else
+    void *ptr = NULL;
+    if (posix_memalign(&ptr, alignment, size) != 0) {
+        throw std::bad_alloc();
+    }
+#endif
+    return ptr;
+}
+
+void alignedFree(void *ptr) {
+#ifdef _MSC_VER
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+const size_t BufferPool::DEFAULT_CAPACITY;
+const size_t BufferPool::MIN_POOLED_SIZE;
+
+BufferPool &BufferPool::instance() {
+    // never destroyed: static Array2D can release their buffers at exit
+    static BufferPool *s_pool = new BufferPool();
+    return *s_pool;
+}
+
+BufferPool::BufferPool(size_t capacity)
+    : m_capacity(capacity), m_fileBackingThreshold(0) {}
+
+BufferPool::~BufferPool() { trim(); }
+
+size_t BufferPool::sizeClass(size_t size) {
+    if (size < MIN_POOLED_SIZE) {
+        return size;
+    }
+    // 8 classes between two consecutive powers of two
+    size_t step = 1;
+    while ((step << 4) <= size) {
+        step <<= 1;
+    }
+    return (size + step - 1) & ~(step - 1);
+}
+
+void *BufferPool::acquire(size_t size) {
+    const size_t bytes = sizeClass(size);
+    if (bytes < MIN_POOLED_SIZE) {
+        return alignedMalloc(bytes);
+    }
+
+    if (void *ptr = acquireMapped(size)) {
+        return ptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (std::vector<CachedBuffer>::reverse_iterator it = m_cache.rbegin();
+             it != m_cache.rend(); ++it) {
+            if (it->first == bytes) {
+                void *ptr = it->second;
+                m_cache.erase(--(it.base()));
+
+                m_stats.hits++;
+                m_stats.cachedBytes -= bytes;
+                m_stats.cachedBuffers--;
+                return ptr;
+            }
+        }
+        m_stats.misses++;
+    }
+
+    try {
+        return alignedMalloc(bytes);
+    } catch (std::bad_alloc &) {
+        // the cached buffers might be what is missing
+        trim();
+        return alignedMalloc(bytes);
+    }
+}
+
+void BufferPool::release(void *ptr, size_t size) {
+    if (ptr == NULL) {
+        return;
+    }
+    const size_t bytes = sizeClass(size);
+    if (bytes < MIN_POOLED_SIZE) {
+        alignedFree(ptr);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (std::vector<CachedBuffer>::iterator it = m_mapped.begin();
+         it != m_mapped.end(); ++it) {
+        if (it->second == ptr) {
+            unmapScratchBuffer(ptr, it->first);
+            m_stats.mappedBytes -= it->first;
+            m_stats.mappedBuffers--;
+            m_mapped.erase(it);
+            return;
+        }
+    }
+
+    m_stats.releases++;
+    if (bytes > m_capacity) {
+        m_stats.evictions++;
+        alignedFree(ptr);
+        return;
+    }
+
+    evict(m_capacity - bytes);
+    m_cache.push_back(CachedBuffer(bytes, ptr));
+    m_stats.cachedBytes += bytes;
+    m_stats.cachedBuffers++;
+}
+
+void *BufferPool::acquireMapped(size_t size) {
+    std::string directory;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fileBackingThreshold == 0 || size < m_fileBackingThreshold) {
+            return NULL;
+        }
+        directory = m_fileBackingDirectory;
+    }
+
+    // creating the file can take a while: not under the lock
+    void *ptr = mapScratchBuffer(directory, size);
+    if (ptr == NULL) {
+        std::cerr << "BufferPool: cannot map " << size
+                  << " bytes in " << directory << ", using memory\n";
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapped.push_back(CachedBuffer(size, ptr));
+    m_stats.mappedBytes += size;
+    m_stats.mappedBuffers++;
+    return ptr;
+}
+
+void BufferPool::evict(size_t capacity) {
+    std::vector<CachedBuffer>::iterator it = m_cache.begin();
+    while (it != m_cache.end() && m_stats.cachedBytes > capacity) {
+        alignedFree(it->second);
+        m_stats.cachedBytes -= it->first;
+        m_stats.cachedBuffers--;
+        m_stats.evictions++;
+        ++it;
+    }
+    m_cache.erase(m_cache.begin(), it);
+}
+
+size_t BufferPool::capacity() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_capacity;
+}
+
+void BufferPool::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_capacity = capacity;
+    evict(m_capacity);
+}
+
+void BufferPool::trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    evict(0);
+}
+
+void BufferPool::setFileBacking(const std::string &directory,
+                                size_t threshold) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fileBackingDirectory = directory;
+    // smaller buffers are not worth a file (and are never looked up in
+    // m_mapped on release)
+    m_fileBackingThreshold =
+        (threshold == 0) ? 0 : std::max(threshold, size_t(MIN_POOLED_SIZE));
+}
+
+std::string BufferPool::fileBackingDirectory() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fileBackingDirectory;
+}
+
+size_t BufferPool::fileBackingThreshold() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fileBackingThreshold;
+}
+
+BufferPoolStats BufferPool::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void BufferPool::resetStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const size_t cachedBytes = m_stats.cachedBytes;
+    const size_t cachedBuffers = m_stats.cachedBuffers;
+    const size_t mappedBytes = m_stats.mappedBytes;
+    const size_t mappedBuffers = m_stats.mappedBuffers;
+    m_stats = BufferPoolStats();
+    m_stats.cachedBytes = cachedBytes;
+    m_stats.cachedBuffers = cachedBuffers;
+    m_stats.mappedBytes = mappedBytes;
+    m_stats.mappedBuffers = mappedBuffers;
+}
+
+}  // utils
+}  // pfs
@@ -0,0 +1,156 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief Pool of aligned memory buffers, bucketed by size
+//! \author agent <agent@local>
+
+#ifndef PFS_UTILS_BUFFERPOOL_H
+#define PFS_UTILS_BUFFERPOOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pfs {
+namespace utils {
+
+//! \brief alignment of the buffers of the pool: a cache line, enough for
+//! aligned SSE, AVX and AVX-512 loads
+static const size_t BUFFER_ALIGNMENT = 64;
+
+//! \brief allocate \a size bytes aligned to \a alignment (a power of two)
+//! \throw std::bad_alloc
+void *alignedMalloc(size_t size, size_t alignment = BUFFER_ALIGNMENT);
+//! \brief free a buffer allocated by alignedMalloc()
+void alignedFree(void *ptr);
+
+struct BufferPoolStats {
+    BufferPoolStats()
+        : hits(0),
+          misses(0),
+          releases(0),
+          evictions(0),
+          cachedBytes(0),
+          cachedBuffers(0),
+          mappedBytes(0),
+          mappedBuffers(0) {}
+
+    //! \brief acquire() served by a cached buffer
+    size_t hits;
+    //! \brief acquire() served by the system allocator
+    size_t misses;
+    //! \brief buffers returned to the pool
+    size_t releases;
+    //! \brief buffers given back to the system to stay within the capacity
+    size_t evictions;
+    //! \brief bytes and number of buffers currently cached
+    size_t cachedBytes;
+    size_t cachedBuffers;
+    //! \brief bytes and number of buffers currently backed by scratch files
+    size_t mappedBytes;
+    size_t mappedBuffers;
+};
+
+//! \brief Process-wide cache of large aligned buffers.
+//!
+//! The sizes are rounded up to size classes (8 classes per power of two, so
+//! at most 12.5% is wasted), and a released buffer is kept for the next
+//! request of the same class. The full-frame temporaries of the tonemapping
+//! operators are then recycled from one run to the next, instead of going
+//! through the system allocator and page-faulting fresh memory every time.
+//! Requests below minPooledSize() are not cached. The cached memory never
+//! exceeds capacity(): the oldest buffers are freed first.
+//!
+//! Once a file backing is set, requests of at least fileBackingThreshold()
+//! bytes are mapped on scratch files (see mapScratchBuffer()) instead, so
+//! that the channels of a gigapixel frame are paged to a disk chosen by the
+//! user rather than exhausting the RAM and the swap. These buffers are not
+//! cached, and fall back to memory if the scratch file cannot be created.
+class BufferPool {
+   public:
+    //! \brief the pool used by Array2D
+    static BufferPool &instance();
+
+    BufferPool(size_t capacity = DEFAULT_CAPACITY);
+    ~BufferPool();
+
+    //! \brief aligned buffer of at least \a size bytes
+    //! \throw std::bad_alloc
+    void *acquire(size_t size);
+    //! \brief give back a buffer returned by acquire(\a size)
+    void release(void *ptr, size_t size);
+
+    //! \brief maximum number of bytes kept in the pool
+    size_t capacity() const;
+    void setCapacity(size_t capacity);
+
+    //! \brief free all the cached buffers
+    void trim();
+
+    //! \brief map the requests of at least \a threshold bytes on scratch
+    //! files created in \a directory. A threshold of 0 disables the file
+    //! backing. The buffers already allocated are not affected.
+    void setFileBacking(const std::string &directory, size_t threshold);
+    std::string fileBackingDirectory() const;
+    size_t fileBackingThreshold() const;
+
+    BufferPoolStats stats() const;
+    void resetStats();
+
+    static size_t minPooledSize() { return MIN_POOLED_SIZE; }
+    //! \brief size actually allocated for a request of \a size bytes
+    static size_t sizeClass(size_t size);
+
+    static const size_t DEFAULT_CAPACITY = size_t(1) << 30;  // 1 GiB
+    static const size_t MIN_POOLED_SIZE = size_t(1) << 16;   // 64 KiB
+
+   private:
+    BufferPool(const BufferPool &);
+    BufferPool &operator=(const BufferPool &);
+
+    //! \brief free the oldest buffers until \a capacity bytes are cached
+    void evict(size_t capacity);
+    //! \brief buffer backed by a scratch file, NULL if \a size is below the
+    //! threshold or the file cannot be mapped
+    void *acquireMapped(size_t size);
+
+    //! \brief size class and address of a cached buffer
+    typedef std::pair<size_t, void *> CachedBuffer;
+
+    mutable std::mutex m_mutex;
+    size_t m_capacity;
+    //! \brief cached buffers, in release order: the oldest are evicted
+    //! first, the newest (most likely still in cache) are reused first
+    std::vector<CachedBuffer> m_cache;
+    BufferPoolStats m_stats;
+
+    std::string m_fileBackingDirectory;
+    size_t m_fileBackingThreshold;
+    //! \brief live buffers backed by scratch files, with their size
+    std::vector<CachedBuffer> m_mapped;
+};
+
+}  // utils
+}  // pfs
+
+#endif  // PFS_UTILS_BUFFERPOOL_H
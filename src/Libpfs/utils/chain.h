@@ -45,6 +45,9 @@ struct Chain {
         return func2_(func1_(v1));
     }
 
+    const Func1 &first() const { return func1_; }
+    const Func2 &second() const { return func2_; }
+
    private:
     Func1 func1_;
     Func2 func2_;
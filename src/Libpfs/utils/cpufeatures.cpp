@@ -0,0 +1,126 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \author agent <agent@local>
+
+#include "cpufeatures.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if PFS_SIMD_DISPATCH
+#include <cpuid.h>
+#endif
+
+namespace pfs {
+namespace utils {
+
+namespace {
+
+SimdLevel detect() {
+#if PFS_SIMD_DISPATCH
+    // __builtin_cpu_supports() also checks that the OS saves the AVX state
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") &&
+        __builtin_cpu_supports("fma")) {
+        return SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SIMD_SSE2;
+    }
+    return SIMD_NONE;
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    return SIMD_SSE2;
+#else
+    return SIMD_NONE;
+#endif
+}
+
+SimdLevel parseSimdLevel(const char *name, SimdLevel fallback) {
+    for (int level = SIMD_NONE; level <= SIMD_AVX512; ++level) {
+        if (std::strcmp(name, simdLevelName(SimdLevel(level))) == 0) {
+            return SimdLevel(level);
+        }
+    }
+    return fallback;
+}
+
+std::atomic<int> &currentLevel() {
+    static std::atomic<int> s_level([] {
+        SimdLevel level = detectedSimdLevel();
+        const char *env = std::getenv("LUMINANCE_HDR_SIMD");
+        if (env != NULL) {
+            level = std::min(level, parseSimdLevel(env, level));
+        }
+        return int(level);
+    }());
+    return s_level;
+}
+}
+
+SimdLevel detectedSimdLevel() {
+    static const SimdLevel s_detected = detect();
+    return s_detected;
+}
+
+SimdLevel simdLevel() { return SimdLevel(currentLevel().load()); }
+
+void setSimdLevel(SimdLevel level) {
+    currentLevel().store(std::min(level, detectedSimdLevel()));
+}
+
+bool hasF16C() {
+#if PFS_SIMD_DISPATCH
+    static const bool s_f16c = [] {
+        unsigned int eax, ebx, ecx, edx;
+        return __get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0 &&
+               (ecx & bit_F16C) != 0;
+    }();
+    // the instructions use the AVX registers: simdLevel() has checked that
+    // the OS saves them
+    return s_f16c && simdLevel() >= SIMD_AVX2;
+#else
+    return false;
+#endif
+}
+
+const char *simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SIMD_SSE2:
+            return "sse2";
+        case SIMD_AVX2:
+            return "avx2";
+        case SIMD_AVX512:
+            return "avx512";
+        case SIMD_NONE:
+        default:
+            return "none";
+    }
+}
+
+}  // utils
+}  // pfs
@@ -0,0 +1,71 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief Runtime detection of the vector instruction sets of the CPU
+//! \author agent <agent@local>
+
+#ifndef PFS_UTILS_CPUFEATURES_H
+#define PFS_UTILS_CPUFEATURES_H
+
+//! \brief 1 when the compiler can build kernels for instruction sets above
+//! the ones enabled on the command line (GCC and Clang on x86), so that a
+//! generic build still runs AVX2 or AVX-512 code on the CPUs supporting it
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define PFS_SIMD_DISPATCH 1
+#else
+#define PFS_SIMD_DISPATCH 0
+#endif
+
+namespace pfs {
+namespace utils {
+
+//! \brief vector instruction sets, from the narrowest to the widest
+enum SimdLevel {
+    SIMD_NONE = 0,
+    SIMD_SSE2,    //!< 128 bits
+    SIMD_AVX2,    //!< 256 bits, with FMA
+    SIMD_AVX512,  //!< 512 bits (AVX-512F)
+};
+
+//! \brief widest instruction set supported by the CPU and the OS
+SimdLevel detectedSimdLevel();
+
+//! \brief instruction set used by the dispatched kernels (see vecmath.h).
+//! It is detectedSimdLevel(), unless it is lowered by setSimdLevel() or by
+//! the environment variable LUMINANCE_HDR_SIMD (none, sse2, avx2, avx512)
+SimdLevel simdLevel();
+
+//! \brief use at most \a level in the dispatched kernels: the level actually
+//! set never exceeds detectedSimdLevel()
+void setSimdLevel(SimdLevel level);
+
+//! \brief true if the CPU converts between half and single precision
+//! (F16C) and simdLevel() allows 256 bit code (SIMD_AVX2 or above)
+bool hasF16C();
+
+//! \brief "none", "sse2", "avx2" or "avx512"
+const char *simdLevelName(SimdLevel level);
+
+}  // utils
+}  // pfs
+
+#endif  // PFS_UTILS_CPUFEATURES_H
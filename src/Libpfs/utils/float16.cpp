@@ -0,0 +1,119 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \author agent <agent@local>
+
+#include "float16.h"
+
+#include "cpufeatures.h"
+
+#if PFS_SIMD_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace pfs {
+namespace utils {
+
+namespace {
+
+inline float clampHalf(float v) {
+    return v > FLOAT16_MAX ? FLOAT16_MAX
+                           : (v < -FLOAT16_MAX ? -FLOAT16_MAX : v);
+}
+
+void floatToHalfScalar(const float *in, float16 *out, size_t size) {
+    for (size_t idx = 0; idx < size; ++idx) {
+        out[idx] = floatToHalf(clampHalf(in[idx]));
+    }
+}
+
+void halfToFloatScalar(const float16 *in, float *out, size_t size) {
+    for (size_t idx = 0; idx < size; ++idx) {
+        out[idx] = halfToFloat(in[idx]);
+    }
+}
+
+#if PFS_SIMD_DISPATCH
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx,f16c"))), \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx,f16c")
+#endif
+
+void floatToHalfF16C(const float *in, float16 *out, size_t size) {
+    const __m256 maxV = _mm256_set1_ps(FLOAT16_MAX);
+    const __m256 minV = _mm256_set1_ps(-FLOAT16_MAX);
+
+    size_t idx = 0;
+    for (; idx + 8 <= size; idx += 8) {
+        // min/max return the second operand (the input) for NaN
+        __m256 v = _mm256_loadu_ps(in + idx);
+        v = _mm256_max_ps(minV, _mm256_min_ps(maxV, v));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + idx),
+                         _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+    }
+    floatToHalfScalar(in + idx, out + idx, size - idx);
+}
+
+void halfToFloatF16C(const float16 *in, float *out, size_t size) {
+    size_t idx = 0;
+    for (; idx + 8 <= size; idx += 8) {
+        _mm256_storeu_ps(out + idx,
+                         _mm256_cvtph_ps(_mm_loadu_si128(
+                             reinterpret_cast<const __m128i *>(in + idx))));
+    }
+    halfToFloatScalar(in + idx, out + idx, size - idx);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif  // PFS_SIMD_DISPATCH
+}
+
+void floatToHalf(const float *in, float16 *out, size_t size) {
+#if PFS_SIMD_DISPATCH
+    if (hasF16C()) {
+        floatToHalfF16C(in, out, size);
+        return;
+    }
+#endif
+    floatToHalfScalar(in, out, size);
+}
+
+void halfToFloat(const float16 *in, float *out, size_t size) {
+#if PFS_SIMD_DISPATCH
+    if (hasF16C()) {
+        halfToFloatF16C(in, out, size);
+        return;
+    }
+#endif
+    halfToFloatScalar(in, out, size);
+}
+
+}  // utils
+}  // pfs
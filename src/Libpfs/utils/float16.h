@@ -0,0 +1,117 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief IEEE 754 half precision (binary16) conversions, bit compatible
+//! with the OpenEXR HALF type
+//! \author agent <agent@local>
+
+#ifndef PFS_UTILS_FLOAT16_H
+#define PFS_UTILS_FLOAT16_H
+
+#include <cstddef>
+#include <cstring>
+#include <stdint.h>
+
+namespace pfs {
+namespace utils {
+
+//! \brief bits of a half precision number
+typedef uint16_t float16;
+
+//! \brief largest finite half precision number
+static const float FLOAT16_MAX = 65504.f;
+
+//! \brief convert \a f to half precision, rounding to the nearest even.
+//! Values above FLOAT16_MAX become infinite.
+inline float16 floatToHalf(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+
+    const uint32_t sign = u & 0x80000000u;
+    u ^= sign;
+
+    uint32_t h;
+    if (u >= (uint32_t(127 + 16) << 23)) {
+        // Inf or NaN (quiet)
+        h = (u > (uint32_t(255) << 23)) ? 0x7e00 : 0x7c00;
+    } else if (u < (uint32_t(113) << 23)) {
+        // subnormal or zero: let the FPU round the mantissa
+        const uint32_t magicBits = uint32_t((127 - 15) + (23 - 10) + 1) << 23;
+        float magic;
+        std::memcpy(&magic, &magicBits, sizeof(magic));
+
+        float v;
+        std::memcpy(&v, &u, sizeof(v));
+        v += magic;
+        std::memcpy(&u, &v, sizeof(u));
+        h = u - magicBits;
+    } else {
+        const uint32_t mantOdd = (u >> 13) & 1;
+        // rebias the exponent and round
+        u += (uint32_t(15 - 127) << 23) + 0xfff;
+        u += mantOdd;
+        h = u >> 13;
+    }
+    return static_cast<float16>(h | (sign >> 16));
+}
+
+//! \brief convert the half precision number \a h to float (exact)
+inline float halfToFloat(float16 h) {
+    const uint32_t shiftedExp = uint32_t(0x7c00) << 13;
+
+    uint32_t u = uint32_t(h & 0x7fff) << 13;
+    const uint32_t exp = shiftedExp & u;
+    u += uint32_t(127 - 15) << 23;
+    if (exp == shiftedExp) {
+        // Inf or NaN
+        u += uint32_t(128 - 16) << 23;
+    } else if (exp == 0) {
+        // subnormal or zero: renormalize
+        const uint32_t magicBits = uint32_t(113) << 23;
+        float magic;
+        std::memcpy(&magic, &magicBits, sizeof(magic));
+
+        u += uint32_t(1) << 23;
+        float v;
+        std::memcpy(&v, &u, sizeof(v));
+        v -= magic;
+        std::memcpy(&u, &v, sizeof(u));
+    }
+    u |= uint32_t(h & 0x8000) << 16;
+
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+//! \brief convert \a size values to half precision. Values are clamped to
+//! +/- FLOAT16_MAX, so that large radiances do not become infinite (NaN are
+//! kept). Uses the F16C instructions when the CPU has them (see
+//! hasF16C() in cpufeatures.h).
+void floatToHalf(const float *in, float16 *out, size_t size);
+
+//! \brief convert \a size half precision values to float
+void halfToFloat(const float16 *in, float *out, size_t size);
+
+}  // utils
+}  // pfs
+
+#endif  // PFS_UTILS_FLOAT16_H
@@ -0,0 +1,131 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+
+//! \author agent <agent@local>
+
+#include "mappedbuffer.h"
+
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdlib>
+#endif
+
+namespace pfs {
+namespace utils {
+
+#ifdef _WIN32
+
+void *mapScratchBuffer(const std::string &directory, size_t size) {
+    char fileName[MAX_PATH];
+    if (GetTempFileNameA(directory.c_str(), "pfs", 0, fileName) == 0) {
+        return NULL;
+    }
+    HANDLE file = CreateFileA(
+        fileName, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        DeleteFileA(fileName);
+        return NULL;
+    }
+
+    // the mapping extends the file, the view keeps both alive
+    const unsigned long long bytes = size;
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE,
+                                        DWORD(bytes >> 32), DWORD(bytes), NULL);
+    void *ptr = NULL;
+    if (mapping != NULL) {
+        ptr = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    return ptr;
+}
+
+void unmapScratchBuffer(void *ptr, size_t /*size*/) {
+    if (ptr != NULL) {
+        UnmapViewOfFile(ptr);
+    }
+}
+
+#else
+
+//! \brief allocate the blocks of the first \a size bytes of \a fd: a write
+//! to a page of a sparse file on a full disk would kill the process with
+//! SIGBUS
+static bool reserve(int fd, size_t size) {
+#ifdef __APPLE__
+    fstore_t store = {F_ALLOCATEALL, F_PEOFPOSMODE, 0, off_t(size), 0};
+    if (fcntl(fd, F_PREALLOCATE, &store) == -1) {
+        return false;
+    }
+    return ftruncate(fd, off_t(size)) == 0;
+#else
+    return posix_fallocate(fd, 0, off_t(size)) == 0;
+#endif
+}
+
+void *mapScratchBuffer(const std::string &directory, size_t size) {
+    std::string pattern = directory;
+    if (pattern.empty()) {
+        return NULL;
+    }
+    if (pattern[pattern.size() - 1] != '/') {
+        pattern += '/';
+    }
+    pattern += "pfs-XXXXXX";
+
+    std::vector<char> fileName(pattern.begin(), pattern.end());
+    fileName.push_back('\0');
+
+    const int fd = mkstemp(fileName.data());
+    if (fd < 0) {
+        return NULL;
+    }
+    unlink(fileName.data());
+
+    void *ptr = NULL;
+    if (reserve(fd, size)) {
+        ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED) {
+            ptr = NULL;
+        }
+    }
+    close(fd);
+    return ptr;
+}
+
+void unmapScratchBuffer(void *ptr, size_t size) {
+    if (ptr != NULL) {
+        munmap(ptr, size);
+    }
+}
+
+#endif
+
+}  // utils
+}  // pfs
@@ -0,0 +1,51 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+
+//! \brief Buffers backed by a scratch file instead of the swap
+//! \author agent <agent@local>
+
+#ifndef PFS_UTILS_MAPPEDBUFFER_H
+#define PFS_UTILS_MAPPEDBUFFER_H
+
+#include <cstddef>
+#include <string>
+
+namespace pfs {
+namespace utils {
+
+//! \brief map \a size bytes of a new scratch file created in \a directory.
+//! The file is deleted as soon as it is mapped (or, on Windows, when it is
+//! unmapped), so nothing is left behind on a crash. The kernel writes the
+//! pages back to the file and evicts them under memory pressure, so a
+//! buffer larger than the RAM can be processed row by row. The buffer is
+//! page aligned and filled with zeros.
+//! \return NULL if the file cannot be created or \a size bytes of disk
+//! space cannot be reserved
+void *mapScratchBuffer(const std::string &directory, size_t size);
+
+//! \brief unmap a buffer returned by mapScratchBuffer(\a size)
+void unmapScratchBuffer(void *ptr, size_t size);
+
+}  // utils
+}  // pfs
+
+#endif  // PFS_UTILS_MAPPEDBUFFER_H
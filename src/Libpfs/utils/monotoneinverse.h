@@ -0,0 +1,91 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief Table driven inverse of an increasing function
+//! \author agent <agent@local>
+
+#ifndef PFS_UTILS_MONOTONEINVERSE_H
+#define PFS_UTILS_MONOTONEINVERSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pfs {
+namespace utils {
+
+//! \brief Solves f(x) = y for the samples y of a frame, when f is strictly
+//! increasing on [0, +inf) and f(0) <= y.
+//!
+//! The exact roots are computed once, on a table with NODES_PER_OCTAVE nodes
+//! per octave of y between yMin() and yMax(). The node of a sample is read
+//! from the bits of its float representation, without a logarithm. The root
+//! interpolated between two nodes is then refined by Newton steps in double
+//! precision. For smooth functions, such as polynomials, a single step brings
+//! the relative error below 1e-6, the precision of the float result.
+//!
+//! \a Function provides double operator()(double x) and
+//! double derivative(double x).
+template <typename Function>
+class MonotoneInverse {
+   public:
+    static const int NODES_PER_OCTAVE = 64;
+
+    //! \brief table of the inverse of \a function for the y in [\a yMin,
+    //! \a yMax]. \a yMin is raised to the smallest normal float if needed.
+    MonotoneInverse(const Function &function, float yMin, float yMax,
+                    int refinementSteps = 1);
+
+    float yMin() const { return m_yMin; }
+    float yMax() const { return m_yMax; }
+    size_t tableSize() const { return m_x.size(); }
+
+    //! \brief x such that f(x) = \a y, once \a y is clamped to [yMin(),
+    //! yMax()]. NaN gives a value in the range as well.
+    float operator()(float y) const;
+    //! \brief inverse of \a size samples, \a out can be \a in
+    void operator()(const float *in, float *out, size_t size) const;
+
+    //! \brief root of f(x) = \a y computed by bisection, to the double
+    //! precision
+    double solve(double y) const;
+
+   private:
+    //! \brief the lowest bits of the mantissa address a sample inside a node
+    static const int NODE_SHIFT = 23 - 6;  // 2^6 == NODES_PER_OCTAVE
+
+    Function m_function;
+    float m_yMin;
+    float m_yMax;
+    int m_refinementSteps;
+    //! \brief bits of the first node
+    int32_t m_base;
+    //! \brief position, root and slope of the inverse at each node
+    std::vector<float> m_y;
+    std::vector<float> m_x;
+    std::vector<float> m_slope;
+};
+
+}  // utils
+}  // pfs
+
+#include <Libpfs/utils/monotoneinverse.hxx>
+#endif  // PFS_UTILS_MONOTONEINVERSE_H
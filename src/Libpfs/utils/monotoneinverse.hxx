@@ -0,0 +1,130 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#ifndef PFS_UTILS_MONOTONEINVERSE_HXX
+#define PFS_UTILS_MONOTONEINVERSE_HXX
+
+#include <Libpfs/utils/monotoneinverse.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace pfs {
+namespace utils {
+
+namespace monotoneinverse {
+inline int32_t asInt(float f) {
+    int32_t i;
+    std::memcpy(&i, &f, sizeof(i));
+    return i;
+}
+
+inline float asFloat(int32_t i) {
+    float f;
+    std::memcpy(&f, &i, sizeof(f));
+    return f;
+}
+}
+
+template <typename Function>
+MonotoneInverse<Function>::MonotoneInverse(const Function &function,
+                                           float yMin, float yMax,
+                                           int refinementSteps)
+    : m_function(function),
+      m_yMin(std::max(yMin, std::numeric_limits<float>::min())),
+      m_yMax(std::min(std::max(m_yMin, yMax),
+                      std::numeric_limits<float>::max())),
+      m_refinementSteps(refinementSteps),
+      m_base(monotoneinverse::asInt(m_yMin) & ~((1 << NODE_SHIFT) - 1)) {
+    using namespace monotoneinverse;
+
+    // one node after the one of yMax, for the interpolation
+    const size_t nodes = ((asInt(m_yMax) - m_base) >> NODE_SHIFT) + 2;
+    m_y.resize(nodes);
+    m_x.resize(nodes);
+    m_slope.resize(nodes);
+    for (size_t k = 0; k < nodes; ++k) {
+        m_y[k] = asFloat(m_base + int32_t(k << NODE_SHIFT));
+        m_x[k] = static_cast<float>(solve(m_y[k]));
+    }
+    for (size_t k = 0; k + 1 < nodes; ++k) {
+        m_slope[k] = (m_x[k + 1] - m_x[k]) / (m_y[k + 1] - m_y[k]);
+    }
+    m_slope[nodes - 1] = 0.f;
+}
+
+template <typename Function>
+double MonotoneInverse<Function>::solve(double y) const {
+    double lo = 0.;
+    double hi = 1.;
+    while (m_function(hi) < y && hi < std::numeric_limits<double>::max()) {
+        lo = hi;
+        hi *= 2.;
+    }
+    for (;;) {
+        const double mid = 0.5 * (lo + hi);
+        if (mid <= lo || mid >= hi) {
+            return hi;
+        }
+        if (m_function(mid) < y) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+}
+
+template <typename Function>
+inline float MonotoneInverse<Function>::operator()(float y) const {
+    using namespace monotoneinverse;
+
+    // clamped on the bits, that order the positive floats as the integers:
+    // the negative samples go below yMin, +inf and NaN above yMax. This also
+    // holds with -ffast-math.
+    const int32_t minBits = asInt(m_yMin);
+    const int32_t maxBits = asInt(m_yMax);
+    const int32_t bits = asInt(y);
+    const int32_t clamped =
+        bits < minBits ? minBits : (bits > maxBits ? maxBits : bits);
+    const float v = asFloat(clamped);
+    const size_t k = (clamped - m_base) >> NODE_SHIFT;
+
+    double x = m_x[k] + (v - m_y[k]) * m_slope[k];
+    for (int step = 0; step < m_refinementSteps; ++step) {
+        x -= (m_function(x) - v) / m_function.derivative(x);
+    }
+    return static_cast<float>(x);
+}
+
+template <typename Function>
+void MonotoneInverse<Function>::operator()(const float *in, float *out,
+                                           size_t size) const {
+#pragma omp simd
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = (*this)(in[i]);
+    }
+}
+
+}  // utils
+}  // pfs
+
+#endif  // PFS_UTILS_MONOTONEINVERSE_HXX
@@ -105,6 +105,22 @@ double msec_timer::get_time() {
 #endif
 }
 
+double msec_timer::elapsed() const {
+#ifdef WIN_TIMER
+    LARGE_INTEGER now_t;
+    QueryPerformanceCounter(&now_t);
+    return ((double)(now_t.QuadPart - start_t.QuadPart) * 1000.0 /
+            freq.QuadPart);
+#elif __APPLE__
+    return (conversion * (double)(mach_absolute_time() - start_t) * 1000.0);
+#else
+    timeval now_t;
+    gettimeofday(&now_t, NULL);
+    return (((now_t.tv_sec - start_t.tv_sec) * 1000.0) +
+            (now_t.tv_usec - start_t.tv_usec) / 1000.0);
+#endif
+}
+
 void msec_timer::get_timer_type() {
 #ifdef WIN_TIMER
     printf("<windows.h> QueryPerformanceCounter()\n");
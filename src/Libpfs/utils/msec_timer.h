@@ -80,6 +80,8 @@ class msec_timer {
     void stop_and_update();
     void reset();
     double get_time();
+    //! \brief milliseconds since start(), without stopping the timer
+    double elapsed() const;
 
     void get_timer_type();
 };
@@ -24,104 +24,69 @@
 
 #include <Libpfs/utils/numeric.h>
 
-#include <algorithm>
-#include <functional>
-#include <numeric>
+#include <Libpfs/array2dexpr.h>
 
 namespace pfs {
 namespace utils {
 
-namespace detail {
-
-template <typename _Type, typename _Op>
-inline void op(const _Type *A, const _Type *B, _Type *C, size_t size,
-               const _Op &currOp) {
-#pragma omp parallel for
-    for (int idx = 0; idx < static_cast<int>(size); idx++) {
-        C[idx] = currOp(A[idx], B[idx]);
-    }
-}
-
-}  // detail
+// every helper is a single expression (see array2dexpr.h), evaluated in one
+// parallel loop
 
 template <typename _Type>
 void vmul(const _Type *A, const _Type *B, _Type *C, size_t size) {
-// detail::op(A, B, C, size, std::multiplies<_Type>());
-#pragma omp parallel for
-    for (int idx = 0; idx < static_cast<int>(size); idx++) {
-        (*C)(idx) = (*A)(idx) * (*B)(idx);
-    }
+    assign(C, size, arrayExpr(A, size) * arrayExpr(B, size));
 }
 
 template <typename _Type>
 void vdiv(const _Type *A, const _Type *B, _Type *C, size_t size) {
-    detail::op(A, B, C, size, std::divides<_Type>());
+    assign(C, size, arrayExpr(A, size) / arrayExpr(B, size));
 }
 
 template <typename _Type>
 void vadd(const _Type *A, const _Type *B, _Type *C, size_t size) {
-// detail::op(A, B, C, size, std::plus<_Type>());
-#pragma omp parallel for
-    for (int idx = 0; idx < static_cast<int>(size); idx++) {
-        (*C)(idx) = (*A)(idx) + (*B)(idx);
-    }
+    assign(C, size, arrayExpr(A, size) + arrayExpr(B, size));
 }
 
 template <typename _Type>
 void vsadd(const _Type *A, const float s, _Type *B, size_t size) {
-#pragma omp parallel for
-    for (int idx = 0; idx < static_cast<int>(size); idx++) {
-        B[idx] = A[idx] + s;
-    }
+    assign(B, size, arrayExpr(A, size) + s);
 }
 
 template <typename _Type>
 void vadds(const _Type *A, const _Type &s, const _Type *B, _Type *C,
            size_t size) {
-    detail::op(A, B, C, size, numeric::vadds<_Type>(s));
+    assign(C, size, arrayExpr(A, size) + s * arrayExpr(B, size));
 }
 
 template <typename _Type>
 void vsub(const _Type *A, const _Type *B, _Type *C, size_t size) {
-    detail::op(A, B, C, size, std::minus<_Type>());
+    assign(C, size, arrayExpr(A, size) - arrayExpr(B, size));
 }
 
 template <typename _Type>
 void vsubs(const _Type *A, const _Type &s, const _Type *B, _Type *C,
            size_t size) {
-    detail::op(A, B, C, size, numeric::vsubs<_Type>(s));
+    assign(C, size, arrayExpr(A, size) - s * arrayExpr(B, size));
 }
 
 template <typename _Type>
 void vsmul(const _Type *I, const float c, _Type *O, size_t size) {
-#pragma omp parallel for
-    for (int idx = 0; idx < static_cast<int>(size); idx++) {
-        O[idx] = c * I[idx];
-    }
+    assign(O, size, c * arrayExpr(I, size));
 }
 
 template <typename _Type>
 void vsum_scalar(const _Type *I, const float c, _Type *O, size_t size) {
-#pragma omp parallel for
-    for (int idx = 0; idx < static_cast<int>(size); idx++) {
-        (*O)(idx) = c + (*I)(idx);
-    }
+    assign(O, size, c + arrayExpr(I, size));
 }
 
 template <typename _Type>
 void vmul_scalar(const _Type *I, const float c, _Type *O, size_t size) {
-#pragma omp parallel for
-    for (int idx = 0; idx < static_cast<int>(size); idx++) {
-        (*O)(idx) = c * (*I)(idx);
-    }
+    assign(O, size, c * arrayExpr(I, size));
 }
 
 template <typename _Type>
 void vdiv_scalar(const _Type *I, const float c, _Type *O, size_t size) {
-#pragma omp parallel for
-    for (int idx = 0; idx < static_cast<int>(size); idx++) {
-        (*O)(idx) = c / (*I)(idx);
-    }
+    assign(O, size, c / arrayExpr(I, size));
 }
 
 }  // utils
@@ -0,0 +1,88 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief STL allocator drawing aligned buffers from the BufferPool
+//! \author agent <agent@local>
+
+#ifndef PFS_UTILS_POOLEDALLOCATOR_H
+#define PFS_UTILS_POOLEDALLOCATOR_H
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+#include <Libpfs/utils/bufferpool.h>
+
+namespace pfs {
+namespace utils {
+
+//! \brief Stateless allocator returning BUFFER_ALIGNMENT aligned memory from
+//! BufferPool::instance()
+template <typename Type>
+class PooledAllocator {
+   public:
+    typedef Type value_type;
+    typedef Type *pointer;
+    typedef const Type *const_pointer;
+    typedef Type &reference;
+    typedef const Type &const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename Other>
+    struct rebind {
+        typedef PooledAllocator<Other> other;
+    };
+
+    PooledAllocator() {}
+    template <typename Other>
+    PooledAllocator(const PooledAllocator<Other> &) {}
+
+    pointer allocate(size_type n, const void * = 0) {
+        if (n > max_size()) {
+            throw std::bad_alloc();
+        }
+        return static_cast<pointer>(
+            BufferPool::instance().acquire(n * sizeof(Type)));
+    }
+
+    void deallocate(pointer p, size_type n) {
+        BufferPool::instance().release(p, n * sizeof(Type));
+    }
+
+    size_type max_size() const {
+        return std::numeric_limits<size_type>::max() / sizeof(Type);
+    }
+
+    template <typename Other>
+    bool operator==(const PooledAllocator<Other> &) const {
+        return true;
+    }
+    template <typename Other>
+    bool operator!=(const PooledAllocator<Other> &) const {
+        return false;
+    }
+};
+
+}  // utils
+}  // pfs
+
+#endif  // PFS_UTILS_POOLEDALLOCATOR_H
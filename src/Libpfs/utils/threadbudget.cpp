@@ -0,0 +1,127 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \author agent <agent@local>
+
+#include "threadbudget.h"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace pfs {
+namespace utils {
+
+namespace {
+//! \brief innermost lease of the calling thread
+thread_local const ThreadLease *t_lease = NULL;
+}
+
+ThreadBudget &ThreadBudget::instance() {
+    static ThreadBudget s_budget;
+#ifdef _OPENMP
+    // the leases size the outermost parallel regions: no nested teams
+    static const bool s_init = (omp_set_max_active_levels(1), true);
+    (void)s_init;
+#endif
+    return s_budget;
+}
+
+ThreadBudget::ThreadBudget(size_t size)
+    : m_size(size ? size : hardwareThreads()), m_leased(0) {}
+
+size_t ThreadBudget::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_size;
+}
+
+void ThreadBudget::setSize(size_t size) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_size = size ? size : hardwareThreads();
+}
+
+size_t ThreadBudget::available() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_leased < m_size ? m_size - m_leased : 0;
+}
+
+size_t ThreadBudget::share(size_t jobs) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::max<size_t>(1, m_size / std::max<size_t>(1, jobs));
+}
+
+size_t ThreadBudget::hardwareThreads() {
+    const size_t cores = std::thread::hardware_concurrency();
+    return cores ? cores : 1;
+}
+
+size_t ThreadBudget::acquire(size_t wanted) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const size_t available = m_leased < m_size ? m_size - m_leased : 0;
+    // the thread of the job is always granted, even above the budget
+    const size_t count = std::max<size_t>(
+        1, std::min(wanted ? wanted : available, available));
+    m_leased += count;
+    return count;
+}
+
+void ThreadBudget::release(size_t count) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_leased -= std::min(count, m_leased);
+}
+
+ThreadLease::ThreadLease(size_t wanted, ThreadBudget &budget)
+    : m_budget(NULL), m_count(1), m_previousThreads(0), m_outer(t_lease) {
+    if (m_outer != NULL) {
+        m_count = std::max<size_t>(
+            1, wanted ? std::min(wanted, m_outer->count()) : m_outer->count());
+    } else {
+        m_budget = &budget;
+        m_count = budget.acquire(wanted);
+    }
+    t_lease = this;
+
+#ifdef _OPENMP
+    m_previousThreads = omp_get_max_threads();
+    omp_set_num_threads(static_cast<int>(m_count));
+#endif
+}
+
+ThreadLease::~ThreadLease() {
+#ifdef _OPENMP
+    omp_set_num_threads(m_previousThreads);
+#endif
+    t_lease = m_outer;
+    if (m_budget != NULL) {
+        m_budget->release(m_count);
+    }
+}
+
+size_t ThreadLease::current() {
+    return t_lease != NULL ? t_lease->count()
+                           : ThreadBudget::instance().size();
+}
+
+}  // utils
+}  // pfs
@@ -0,0 +1,116 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief Process-wide budget of worker threads, shared by the concurrent
+//! jobs (batch threads, thread pools) and by their OpenMP and FFTW teams
+//! \author agent <agent@local>
+
+#ifndef PFS_UTILS_THREADBUDGET_H
+#define PFS_UTILS_THREADBUDGET_H
+
+#include <cstddef>
+#include <mutex>
+
+namespace pfs {
+namespace utils {
+
+//! \brief Number of threads the process is allowed to keep busy.
+//!
+//! Every job running concurrently with others takes a ThreadLease out of the
+//! budget, and its parallel regions are limited to the leased threads. N
+//! batch jobs then share the cores, instead of starting N teams as large
+//! as the machine each. Nested parallel regions run serially.
+class ThreadBudget {
+   public:
+    //! \brief the budget of the process
+    static ThreadBudget &instance();
+
+    //! \brief budget of \a size threads, the cores of the machine if 0
+    explicit ThreadBudget(size_t size = 0);
+
+    //! \brief total number of threads
+    size_t size() const;
+    //! \brief set the total number of threads, all the cores if \a size is
+    //! 0. The leases already taken are not affected.
+    void setSize(size_t size);
+
+    //! \brief threads not leased
+    size_t available() const;
+
+    //! \brief threads of each of \a jobs jobs sharing the budget fairly
+    size_t share(size_t jobs) const;
+
+    //! \brief number of cores of the machine
+    static size_t hardwareThreads();
+
+   private:
+    ThreadBudget(const ThreadBudget &);
+    ThreadBudget &operator=(const ThreadBudget &);
+
+    friend class ThreadLease;
+
+    //! \brief take between 1 and \a wanted threads
+    size_t acquire(size_t wanted);
+    void release(size_t count);
+
+    mutable std::mutex m_mutex;
+    size_t m_size;
+    size_t m_leased;
+};
+
+//! \brief Threads taken out of a ThreadBudget for the lifetime of the
+//! object, by the thread that creates it.
+//!
+//! The lease is never refused and never blocks: when the budget is exhausted
+//! the job gets a single thread, its own, and runs serially. The OpenMP
+//! parallel regions started by the leasing thread use at most count()
+//! threads, as do the FFTW plans created by it (see init_fftw()). A lease
+//! taken by a thread that already holds one is carved out of the outer
+//! lease and does not touch the budget.
+class ThreadLease {
+   public:
+    //! \brief lease up to \a wanted threads (0: as many as available) from
+    //! \a budget
+    explicit ThreadLease(size_t wanted = 0,
+                         ThreadBudget &budget = ThreadBudget::instance());
+    ~ThreadLease();
+
+    //! \brief threads leased, at least 1
+    size_t count() const { return m_count; }
+
+    //! \brief threads available to the calling thread: the count() of its
+    //! innermost lease, or the size of the budget without a lease
+    static size_t current();
+
+   private:
+    ThreadLease(const ThreadLease &);
+    ThreadLease &operator=(const ThreadLease &);
+
+    ThreadBudget *m_budget;  //!< NULL for nested leases
+    size_t m_count;
+    int m_previousThreads;
+    const ThreadLease *m_outer;
+};
+
+}  // utils
+}  // pfs
+
+#endif  // PFS_UTILS_THREADBUDGET_H
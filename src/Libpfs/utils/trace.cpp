@@ -0,0 +1,208 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \author agent <agent@local>
+
+#include "trace.h"
+
+#include <cstdlib>
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+#define _WINSOCKAPI_  // stops windows.h including winsock.h
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <Libpfs/utils/bufferpool.h>
+#include <Libpfs/utils/msec_timer.h>
+
+namespace pfs {
+namespace utils {
+
+namespace {
+const char TRACE_ENVIRONMENT[] = "LUMINANCE_HDR_TRACE";
+
+long processId() {
+#if defined(_WIN32) || defined(__CYGWIN__)
+    return static_cast<long>(GetCurrentProcessId());
+#else
+    return static_cast<long>(getpid());
+#endif
+}
+
+//! \brief \a text as the content of a JSON string
+std::string escapeJson(const std::string &text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        const unsigned char c = text[i];
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c < 0x20) {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+}
+
+Trace &Trace::instance() {
+    static Trace s_trace;
+    return s_trace;
+}
+
+Trace::Trace() : m_enabled(false), m_file(NULL), m_clock(new msec_timer) {}
+
+Trace::~Trace() { stop(); }
+
+bool Trace::start(const std::string &filename) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stopLocked();
+
+    m_file = fopen(filename.c_str(), "w");
+    if (m_file == NULL) {
+        return false;
+    }
+    // JSON array format: the viewers accept it without the closing bracket,
+    // should the process not reach stop()
+    fprintf(m_file,
+            "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%ld,"
+            "\"args\":{\"name\":\"Luminance HDR\"}}",
+            processId());
+    fflush(m_file);
+    m_clock->start();
+    m_enabled.store(true);
+    return true;
+}
+
+bool Trace::startFromEnvironment() {
+    const char *filename = getenv(TRACE_ENVIRONMENT);
+    if (filename == NULL || *filename == '\0') {
+        return false;
+    }
+    return start(filename);
+}
+
+void Trace::stop() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stopLocked();
+}
+
+void Trace::stopLocked() {
+    m_enabled.store(false);
+    if (m_file != NULL) {
+        fprintf(m_file, "\n]\n");
+        fclose(m_file);
+        m_file = NULL;
+    }
+}
+
+double Trace::now() const { return m_clock->elapsed(); }
+
+void Trace::complete(const char *name, const char *category, double begin,
+                     double end, size_t bytes, const std::string &detail) {
+    // sampled before taking the lock
+    const size_t peak = peakMemory();
+    const BufferPoolStats pool = BufferPool::instance().stats();
+    const size_t tid = threadId();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file == NULL) {
+        return;
+    }
+    const long pid = processId();
+    // the timestamps are in microseconds
+    fprintf(m_file,
+            ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+            "\"dur\":%.3f,\"pid\":%ld,\"tid\":%zu,\"args\":{\"bytes\":%zu",
+            name, category, begin * 1000.0, (end - begin) * 1000.0, pid, tid,
+            bytes);
+    if (!detail.empty()) {
+        fprintf(m_file, ",\"detail\":\"%s\"", escapeJson(detail).c_str());
+    }
+    fprintf(m_file,
+            "}},\n{\"name\":\"memory\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":%ld,"
+            "\"args\":{\"peak\":%zu,\"pool\":%zu,\"mapped\":%zu}}",
+            end * 1000.0, pid, peak, pool.cachedBytes, pool.mappedBytes);
+    fflush(m_file);
+}
+
+size_t Trace::threadId() {
+    static std::atomic<size_t> s_threads(0);
+    thread_local const size_t t_id = ++s_threads;
+    return t_id;
+}
+
+size_t Trace::peakMemory() {
+#if defined(_WIN32) || defined(__CYGWIN__)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                             sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    // kilobytes
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+TraceScope::TraceScope(const char *name, const char *category, Trace &trace)
+    : m_trace(trace.isEnabled() ? &trace : NULL),
+      m_name(name),
+      m_category(category),
+      m_begin(m_trace != NULL ? trace.now() : 0.0),
+      m_bytes(0) {}
+
+TraceScope::~TraceScope() {
+    if (m_trace != NULL) {
+        m_trace->complete(m_name, m_category, m_begin, m_trace->now(), m_bytes,
+                          m_detail);
+    }
+}
+
+void TraceScope::setDetail(const std::string &detail) {
+    if (m_trace != NULL) {
+        m_detail = detail;
+    }
+}
+
+}  // utils
+}  // pfs
@@ -0,0 +1,130 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief Runtime tracing of the processing stages, written as a Chrome
+//! trace (chrome://tracing, Perfetto)
+//! \author agent <agent@local>
+
+#ifndef PFS_UTILS_TRACE_H
+#define PFS_UTILS_TRACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class msec_timer;
+
+namespace pfs {
+namespace utils {
+
+//! \brief Sink of the trace events of the process.
+//!
+//! Disabled by default: a TraceScope then costs a relaxed atomic load. Once
+//! started, every scope is written to the file as a complete event ("X")
+//! with its thread, its duration and the bytes it processed, followed by a
+//! counter event ("C") with the peak resident memory of the process and the
+//! memory held by the BufferPool. The events are written as they complete,
+//! so that the trace of a batch run that crashes is still readable.
+class Trace {
+   public:
+    //! \brief the trace of the process
+    static Trace &instance();
+
+    Trace();
+    ~Trace();
+
+    //! \brief start writing the events to \a filename, replacing the trace
+    //! already running
+    //! \return false if the file cannot be created
+    bool start(const std::string &filename);
+    //! \brief start the trace named by the environment variable
+    //! LUMINANCE_HDR_TRACE, if set
+    bool startFromEnvironment();
+    //! \brief close the file
+    void stop();
+
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    //! \brief milliseconds since start()
+    double now() const;
+
+    //! \brief write a scope of \a category that ran from \a begin to \a end
+    //! (see now()) on the calling thread. \a detail (e.g. a file name) and
+    //! \a bytes are optional.
+    void complete(const char *name, const char *category, double begin,
+                  double end, size_t bytes = 0,
+                  const std::string &detail = std::string());
+
+    //! \brief small identifier of the calling thread, stable for its life
+    static size_t threadId();
+    //! \brief peak resident memory of the process, in bytes (0 if unknown)
+    static size_t peakMemory();
+
+   private:
+    Trace(const Trace &);
+    Trace &operator=(const Trace &);
+
+    void stopLocked();
+
+    mutable std::mutex m_mutex;
+    std::atomic<bool> m_enabled;
+    FILE *m_file;
+    std::unique_ptr<msec_timer> m_clock;
+};
+
+//! \brief Traces the lifetime of the object as a stage of the processing.
+//!
+//! \a name and \a category must outlive the scope (string literals). The
+//! scopes opened by a thread nest in the trace viewer.
+class TraceScope {
+   public:
+    explicit TraceScope(const char *name, const char *category = "",
+                        Trace &trace = Trace::instance());
+    ~TraceScope();
+
+    //! \brief the scope is written to the trace: the details that are
+    //! expensive to build are only needed in this case
+    bool isEnabled() const { return m_trace != NULL; }
+
+    //! \brief bytes read, written or processed by the stage
+    void setBytes(size_t bytes) { m_bytes = bytes; }
+    //! \brief free text shown with the scope, e.g. the file processed
+    void setDetail(const std::string &detail);
+
+   private:
+    TraceScope(const TraceScope &);
+    TraceScope &operator=(const TraceScope &);
+
+    Trace *m_trace;  //!< NULL if the trace was disabled at construction
+    const char *m_name;
+    const char *m_category;
+    double m_begin;
+    size_t m_bytes;
+    std::string m_detail;
+};
+
+}  // utils
+}  // pfs
+
+#endif  // PFS_UTILS_TRACE_H
@@ -0,0 +1,168 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \author agent <agent@local>
+
+#include "vecmath.h"
+
+#include <cstring>
+#include <limits>
+#include <stdint.h>
+
+#include "cpufeatures.h"
+#include "vecmath_scalar.h"
+
+namespace pfs {
+namespace utils {
+
+namespace {
+
+//! \brief instruction set of the command line: SSE2 on x86-64
+namespace generic {
+#include "vecmath_kernels.hxx"
+}
+
+#if PFS_SIMD_DISPATCH
+
+#if !defined(__SSE2__)
+// 32 bit x86 builds
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+namespace sse2 {
+#include "vecmath_kernels.hxx"
+}
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+#else
+namespace sse2 = generic;
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+namespace avx2 {
+#include "vecmath_kernels.hxx"
+}
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f,avx2,fma"))), \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+#endif
+namespace avx512 {
+#include "vecmath_kernels.hxx"
+}
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#else
+namespace sse2 = generic;
+namespace avx2 = generic;
+namespace avx512 = generic;
+#endif  // PFS_SIMD_DISPATCH
+
+struct Kernels {
+    void (*exp)(const float *, float *, size_t);
+    void (*log)(const float *, float *, size_t);
+    void (*pow)(const float *, float *, size_t, float, float);
+    void (*expDiv)(const float *, const float *, float *, size_t);
+    void (*logAccumulate)(const float *, const float *, float, float *,
+                          size_t);
+    void (*matrix3)(const float[3][3], const float *, const float *,
+                    const float *, float *, float *, float *, size_t);
+    void (*minmax)(const float *, size_t, float &, float &);
+};
+
+#define PFS_VECMATH_KERNELS(ns)                                        \
+    {                                                                  \
+        &ns::vexp, &ns::vlog, &ns::vpow, &ns::vexpDiv,                 \
+            &ns::vlogAccumulate, &ns::vmatrix3, &ns::vminmax           \
+    }
+
+//! \brief kernels of the current simdLevel()
+const Kernels &kernels() {
+    // indexed by SimdLevel
+    static const Kernels s_kernels[] = {
+        PFS_VECMATH_KERNELS(generic), PFS_VECMATH_KERNELS(sse2),
+        PFS_VECMATH_KERNELS(avx2), PFS_VECMATH_KERNELS(avx512)};
+
+    return s_kernels[simdLevel()];
+}
+
+#undef PFS_VECMATH_KERNELS
+}
+
+void vexp(const float *in, float *out, size_t size) {
+    kernels().exp(in, out, size);
+}
+
+void vlog(const float *in, float *out, size_t size) {
+    kernels().log(in, out, size);
+}
+
+void vpow(const float *in, float *out, size_t size, float exponent,
+          float multiplier) {
+    kernels().pow(in, out, size, exponent, multiplier);
+}
+
+void vexpDiv(const float *num, const float *den, float *out, size_t size) {
+    kernels().expDiv(num, den, out, size);
+}
+
+void vlogAccumulate(const float *in, const float *weight, float offset,
+                    float *acc, size_t size) {
+    kernels().logAccumulate(in, weight, offset, acc, size);
+}
+
+void vmatrix3(const float matrix[3][3], const float *in1, const float *in2,
+              const float *in3, float *out1, float *out2, float *out3,
+              size_t size) {
+    kernels().matrix3(matrix, in1, in2, in3, out1, out2, out3, size);
+}
+
+void vminmax(const float *in, size_t size, float &minValue, float &maxValue) {
+    kernels().minmax(in, size, minValue, maxValue);
+}
+
+}  // utils
+}  // pfs
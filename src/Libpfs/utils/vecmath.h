@@ -0,0 +1,74 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief Vector math kernels dispatched at runtime on the widest
+//! instruction set of the CPU (see cpufeatures.h)
+//! \author agent <agent@local>
+//!
+//! Every kernel is compiled once per instruction set (SSE2, AVX2 + FMA,
+//! AVX-512F) and the version matching simdLevel() is called, so a binary
+//! built for a generic x86-64 target runs 256 or 512 bit vectors where
+//! available. The kernels are serial and process \a size contiguous
+//! elements: the callers split the work among the threads. The output may
+//! alias the input, element by element.
+//!
+//! exp and log are computed with the polynomials of sleef.c (xexpf and
+//! xlogf), whose relative error is within a few ulps.
+
+#ifndef PFS_UTILS_VECMATH_H
+#define PFS_UTILS_VECMATH_H
+
+#include <cstddef>
+
+namespace pfs {
+namespace utils {
+
+//! \brief out[i] = exp(in[i])
+void vexp(const float *in, float *out, size_t size);
+
+//! \brief out[i] = log(in[i])
+void vlog(const float *in, float *out, size_t size);
+
+//! \brief out[i] = pow(in[i] * multiplier, exponent) for the positive
+//! samples, 0 for the others (gamma correction)
+void vpow(const float *in, float *out, size_t size, float exponent,
+          float multiplier = 1.f);
+
+//! \brief out[i] = exp(num[i] / den[i])
+void vexpDiv(const float *num, const float *den, float *out, size_t size);
+
+//! \brief acc[i] += (log(in[i]) + offset) * weight[i], the accumulation of
+//! the log radiances in the merge of the exposures
+void vlogAccumulate(const float *in, const float *weight, float offset,
+                    float *acc, size_t size);
+
+//! \brief 3x3 color matrix: out_r[i] = sum_c matrix[r][c] * in_c[i]
+void vmatrix3(const float matrix[3][3], const float *in1, const float *in2,
+              const float *in3, float *out1, float *out2, float *out3,
+              size_t size);
+
+//! \brief minimum and maximum of \a size > 0 samples
+void vminmax(const float *in, size_t size, float &minValue, float &maxValue);
+
+}  // utils
+}  // pfs
+
+#endif  // PFS_UTILS_VECMATH_H
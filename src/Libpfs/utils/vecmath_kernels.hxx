@@ -0,0 +1,96 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief Bodies of the kernels of vecmath.h
+//! \author agent <agent@local>
+//!
+//! This file has no include guard: vecmath.cpp includes it once per
+//! instruction set, each time in its own namespace and under its own target
+//! options. The loops are written without branches or calls and marked as
+//! simd loops (the elements are independent, also when the output aliases
+//! the input), so that the compiler vectorizes them at the width of the
+//! target. The element functions are in vecmath_scalar.h.
+
+void vexp(const float *in, float *out, size_t size) {
+#pragma omp simd
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = expKernel(in[i]);
+    }
+}
+
+void vlog(const float *in, float *out, size_t size) {
+#pragma omp simd
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = logKernel(in[i]);
+    }
+}
+
+void vpow(const float *in, float *out, size_t size, float exponent,
+          float multiplier) {
+#pragma omp simd
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = powKernel(in[i] * multiplier, exponent);
+    }
+}
+
+void vexpDiv(const float *num, const float *den, float *out, size_t size) {
+#pragma omp simd
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = expKernel(num[i] / den[i]);
+    }
+}
+
+void vlogAccumulate(const float *in, const float *weight, float offset,
+                    float *acc, size_t size) {
+#pragma omp simd
+    for (size_t i = 0; i < size; ++i) {
+        acc[i] += (logKernel(in[i]) + offset) * weight[i];
+    }
+}
+
+void vmatrix3(const float matrix[3][3], const float *in1, const float *in2,
+              const float *in3, float *out1, float *out2, float *out3,
+              size_t size) {
+    const float m00 = matrix[0][0], m01 = matrix[0][1], m02 = matrix[0][2];
+    const float m10 = matrix[1][0], m11 = matrix[1][1], m12 = matrix[1][2];
+    const float m20 = matrix[2][0], m21 = matrix[2][1], m22 = matrix[2][2];
+#pragma omp simd
+    for (size_t i = 0; i < size; ++i) {
+        const float i1 = in1[i];
+        const float i2 = in2[i];
+        const float i3 = in3[i];
+        out1[i] = m00 * i1 + m01 * i2 + m02 * i3;
+        out2[i] = m10 * i1 + m11 * i2 + m12 * i3;
+        out3[i] = m20 * i1 + m21 * i2 + m22 * i3;
+    }
+}
+
+void vminmax(const float *in, size_t size, float &minValue, float &maxValue) {
+    float minV = in[0];
+    float maxV = in[0];
+#pragma omp simd reduction(min : minV) reduction(max : maxV)
+    for (size_t i = 1; i < size; ++i) {
+        minV = in[i] < minV ? in[i] : minV;
+        maxV = in[i] > maxV ? in[i] : maxV;
+    }
+    minValue = minV;
+    maxValue = maxV;
+}
@@ -0,0 +1,129 @@
+/*
+ * This file is a part of Luminance HDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+//! \brief Element functions of the kernels of vecmath.h
+//! \author agent <agent@local>
+//!
+//! They are inline and branch-free, so that the loops of vecmath.cpp
+//! vectorize, and they are also the scalar version of the same math: a
+//! per-pixel stage (e.g. colorspace::ChangeGamma) calling powKernel() gets
+//! the results of vpow().
+
+#ifndef PFS_UTILS_VECMATH_SCALAR_H
+#define PFS_UTILS_VECMATH_SCALAR_H
+
+#include <cstring>
+#include <limits>
+#include <stdint.h>
+
+namespace pfs {
+namespace utils {
+
+// Copy of the constants of sleef.c (renamed: sleef.c defines them as
+// macros)
+const float VM_R_LN2 =
+    1.442695040888963407359924681001892137426645954152985934f;
+const float VM_L2U = 0.693145751953125f;
+const float VM_L2L = 1.428606765330187045e-06f;
+const float VM_LN2 = 0.693147180559945286226764f;
+
+inline float asFloat(int32_t i) {
+    float f;
+    std::memcpy(&f, &i, sizeof(f));
+    return f;
+}
+
+inline int32_t asInt(float f) {
+    int32_t i;
+    std::memcpy(&i, &f, sizeof(i));
+    return i;
+}
+
+//! \brief xexpf of sleef.c, with a branchless range reduction
+inline float expKernel(float d) {
+    // exp(88.72) is about FLT_MAX, exp(-87.33) about FLT_MIN
+    const float c = d < -87.33f ? -87.33f : (d > 88.72f ? 88.72f : d);
+    const float t = c * VM_R_LN2;
+    const int32_t q = int32_t(t < 0.f ? t - 0.5f : t + 0.5f);
+
+    float s = c - q * VM_L2U;
+    s = s - q * VM_L2L;
+
+    float u = 0.00136324646882712841033936f;
+    u = u * s + 0.00836596917361021041870117f;
+    u = u * s + 0.0416710823774337768554688f;
+    u = u * s + 0.166665524244308471679688f;
+    u = u * s + 0.499999850988388061523438f;
+    u = s * (s * u + 1.f) + 1.f;
+
+    // 2^q in two factors, because q is in [-126, 128]
+    const int32_t q1 = q >> 1;
+    const float r = u * asFloat((q1 + 127) << 23) *
+                    asFloat((q - q1 + 127) << 23);
+
+    return d < -87.33f ? 0.f
+                       : (d > 88.72f ? std::numeric_limits<float>::infinity()
+                                     : r);
+}
+
+//! \brief xlogf of sleef.c, with the exponent and the mantissa read from the
+//! bits of the sample
+inline float logKernel(float d) {
+    // scale the denormals up to normal numbers
+    const bool tiny = d < std::numeric_limits<float>::min();
+    const int32_t i = asInt(tiny ? d * 8388608.f : d);
+
+    int32_t e = ((i >> 23) & 0xff) - (tiny ? 127 + 23 : 127);
+    float m = asFloat((i & 0x007fffff) | 0x3f800000);
+    // m in [sqrt(2)/2, sqrt(2))
+    const bool high = m > 1.41421356f;
+    m = high ? m * 0.5f : m;
+    e = high ? e + 1 : e;
+
+    float x = (m - 1.f) / (m + 1.f);
+    const float x2 = x * x;
+
+    float t = 0.2371599674224853515625f;
+    t = t * x2 + 0.285279005765914916992188f;
+    t = t * x2 + 0.400005519390106201171875f;
+    t = t * x2 + 0.666666567325592041015625f;
+    t = t * x2 + 2.0f;
+
+    x = x * t + VM_LN2 * e;
+
+    return d > 0.f
+               ? (i >= 0x7f800000 ? std::numeric_limits<float>::infinity()
+                                  : x)
+               : (d == 0.f ? -std::numeric_limits<float>::infinity()
+                           : std::numeric_limits<float>::quiet_NaN());
+}
+
+//! \brief pow(v, exponent) for v > 0, 0 for the others (gamma correction)
+inline float powKernel(float v, float exponent) {
+    // the argument of logKernel is kept positive for the zeros
+    const float p = expKernel(exponent * logKernel(v > 0.f ? v : 1.f));
+    return v > 0.f ? p : 0.f;
+}
+
+}  // utils
+}  // pfs
+
+#endif  // PFS_UTILS_VECMATH_SCALAR_H
@@ -41,6 +41,9 @@
 #include <HdrHTML/pfsouthdrhtml.h>
 #include <Libpfs/manip/gamma_levels.h>
 #include <Libpfs/tm/TonemapOperator.h>
+#include <Libpfs/utils/cpufeatures.h>
+#include <Libpfs/utils/trace.h>
+#include <TonemappingOperators/pfstmo.h>
 #include "commandline.h"
 
 #if defined(_MSC_VER)
@@ -94,6 +97,7 @@ CommandLineInterfaceManager::CommandLineInterfaceManager(const int argc,
       started(false),
       threshold(0.0f),
       isAutolevels(false),
+      isStreaming(false),
       isHtml(false),
       isHtmlDone(false),
       htmlQuality(2),
@@ -137,7 +141,9 @@ int CommandLineInterfaceManager::execCommandLineParams() {
         ("version,V", tr("Display program version.").toUtf8().constData())
         ("verbose,v", tr("Print more messages during execution.").toUtf8().constData())
         ("cameras,c", tr("Print a list of all supported cameras.").toUtf8().constData())
-        ("align,a", po::value<std::string>(), tr("[AIS|MTB]   Align Engine to use during HDR creation (default: no "
+        ("trace", po::value<std::string>(), tr("TRACE_FILE  Write the duration and the memory usage of the processing "
+            "stages to TRACE_FILE, in Chrome trace format.").toUtf8().constData())
+        ("align,a", po::value<std::string>(), tr("[AIS|MTB|FEATURES]   Align Engine to use during HDR creation (default: no "
            "alignment).").toUtf8().constData())
         ("ev,e", po::value<std::string>(), tr("EV1,EV2,... Specify numerical EV values (as many as INPUTFILES).")
             .toUtf8().constData())
@@ -189,7 +195,12 @@ int CommandLineInterfaceManager::execCommandLineParams() {
             .toUtf8()
             .constData())(
         "hdrCurveFilename", po::value<std::string>(),
-        tr("curve filename = your_file_here.m").toUtf8().constData());
+        tr("curve filename = your_file_here.m").toUtf8().constData())(
+        "stream",
+        tr("Merge the input files reading them band by band, with low memory "
+           "usage (not compatible with alignment and anti-ghosting)")
+            .toUtf8()
+            .constData());
 
     po::options_description ldr_desc(
         tr("LDR output parameters").toUtf8().constData());
@@ -261,9 +272,10 @@ directory must exist.  Useful to avoid clutter in the current directory. \
         "tmoFatNoise",
         po::value<float>(&tmopts->operator_options.fattaloptions.noiseredux),
         tr("noise FLOAT").toUtf8().constData())(
-        "tmoFatNew",
-        po::value<bool>(&tmopts->operator_options.fattaloptions.fftsolver),
-        tr("new true|false").toUtf8().constData());
+        "tmoFatNew", po::value<bool>(),
+        tr("new true|false").toUtf8().constData())(
+        "tmoFatSolver", po::value<std::string>(),
+        tr("solver multigrid|fft|redblack").toUtf8().constData());
     po::options_description tmo_ferradans(
         tr(" Ferradans").toUtf8().constData());
     tmo_ferradans.add_options()(
@@ -342,7 +354,11 @@ directory must exist.  Useful to avoid clutter in the current directory. \
         tr("range kernel sigma FLOAT").toUtf8().constData())(
         "tmoDurBase",
         po::value<float>(&tmopts->operator_options.durandoptions.base),
-        tr("base contrast FLOAT").toUtf8().constData());
+        tr("base contrast FLOAT").toUtf8().constData())(
+        "tmoDurGrid",
+        po::value<bool>(
+            &tmopts->operator_options.durandoptions.bilateralgrid),
+        tr("bilateral grid filter true|false").toUtf8().constData());
     po::options_description tmo_drago(tr(" Drago").toUtf8().constData());
     tmo_drago.add_options()(
         "tmoDrgBias",
@@ -476,6 +492,12 @@ directory must exist.  Useful to avoid clutter in the current directory. \
         if (vm.count("verbose")) {
             verbose = true;
         }
+        if (vm.count("trace")) {
+            const std::string traceFile = vm["trace"].as<std::string>();
+            if (!pfs::utils::Trace::instance().start(traceFile))
+                printErrorAndExit(tr("Error: Cannot write the trace to %1.")
+                                      .arg(QString::fromStdString(traceFile)));
+        }
         if (vm.count("cameras")) {
             cout << tr("With LibRaw version ").toStdString()
                  << LibRaw::version() << endl;
@@ -492,6 +514,9 @@ directory must exist.  Useful to avoid clutter in the current directory. \
         if (vm.count("createwebpage")) {
             isHtml = true;
         }
+        if (vm.count("stream")) {
+            isStreaming = true;
+        }
         if (vm.count("proposedldrname")) {
             isProposedLdrName = true;
             if (!validLdrExtensions.contains(
@@ -522,6 +547,8 @@ directory must exist.  Useful to avoid clutter in the current directory. \
                 alignMode = AIS_ALIGN;
             else if (strcmp(value, "MTB") == 0)
                 alignMode = MTB_ALIGN;
+            else if (strcmp(value, "FEATURES") == 0)
+                alignMode = FEATURE_ALIGN;
             else
                 printErrorAndExit(
                     tr("Error: Alignment engine not recognized."));
@@ -614,6 +641,26 @@ directory must exist.  Useful to avoid clutter in the current directory. \
                 printErrorAndExit(
                     tr("Error: Unknown tone mapping operator specified."));
         }
+        if (vm.count("tmoFatNew")) {
+            tmopts->operator_options.fattaloptions.fftsolver =
+                vm["tmoFatNew"].as<bool>() ? FATTAL02_SOLVER_FFT
+                                           : FATTAL02_SOLVER_MULTIGRID;
+        }
+        if (vm.count("tmoFatSolver")) {
+            const std::string value = vm["tmoFatSolver"].as<std::string>();
+            if (value == "multigrid")
+                tmopts->operator_options.fattaloptions.fftsolver =
+                    FATTAL02_SOLVER_MULTIGRID;
+            else if (value == "fft")
+                tmopts->operator_options.fattaloptions.fftsolver =
+                    FATTAL02_SOLVER_FFT;
+            else if (value == "redblack")
+                tmopts->operator_options.fattaloptions.fftsolver =
+                    FATTAL02_SOLVER_REDBLACK;
+            else
+                printErrorAndExit(
+                    tr("Error: Unknown Fattal solver specified."));
+        }
         if (vm.count("tmofile")) {
             QString settingFile =
                 QString::fromStdString(vm["tmofile"].as<std::string>());
@@ -696,6 +743,9 @@ directory must exist.  Useful to avoid clutter in the current directory. \
         if (threshold < 0.0f || threshold > 1.0f)
             printErrorAndExit(
                 tr("Error: Threshold must be in the range [0..1]."));
+        if (isStreaming && (alignMode != NO_ALIGN || threshold > 0.0f))
+            printErrorAndExit(tr("Error: Alignment and anti-ghosting are not "
+                                 "available in streaming mode."));
 
     } catch (boost::program_options::required_option &e) {
         std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
@@ -755,6 +805,10 @@ void CommandLineInterfaceManager::execCommandLineParamsSlot() {
             printIfVerbose(QObject::tr("Using %n threads.", "",
                                        luminance_options.getNumThreads()),
                            verbose);
+            printIfVerbose(
+                QObject::tr("Vector instructions: %1")
+                    .arg(pfs::utils::simdLevelName(pfs::utils::simdLevel())),
+                verbose);
         }
         hdrCreationManager.reset(new HdrCreationManager(true));
         connect(hdrCreationManager.data(),
@@ -771,6 +825,22 @@ void CommandLineInterfaceManager::execCommandLineParamsSlot() {
         connect(hdrCreationManager.data(), &HdrCreationManager::aisDataReady,
                 this, &CommandLineInterfaceManager::readData);
 
+        if (isStreaming) {
+            printIfVerbose(tr("Creating (streaming) the HDR."), verbose);
+            try {
+                hdrCreationManager->setConfig(hdrcreationconfig);
+                HDR.reset(
+                    hdrCreationManager->createHdrStreaming(inputFiles, ev));
+            } catch (std::exception &e) {
+                printErrorAndExit(e.what());
+            } catch (...) {
+                printErrorAndExit(
+                    QStringLiteral("Catched unhandled exception"));
+            }
+            saveHDR();
+            return;
+        }
+
         try {
             hdrCreationManager->setConfig(hdrcreationconfig);
             hdrCreationManager->loadFiles(inputFiles);
@@ -820,6 +890,9 @@ void CommandLineInterfaceManager::finishedLoadingInputFiles() {
     } else if (alignMode == MTB_ALIGN) {
         printIfVerbose(tr("Starting aligning..."), verbose);
         hdrCreationManager->align_with_mtb();
+    } else if (alignMode == FEATURE_ALIGN) {
+        printIfVerbose(tr("Starting aligning..."), verbose);
+        hdrCreationManager->align_with_features();
     } else if (alignMode == NO_ALIGN) {
         createHDR(0);
     }
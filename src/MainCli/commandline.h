@@ -56,7 +56,12 @@ class CommandLineInterfaceManager : public QObject {
         UNKNOWN_MODE
     } operationMode;
 
-    enum align_mode { AIS_ALIGN, MTB_ALIGN, NO_ALIGN } alignMode;
+    enum align_mode {
+        AIS_ALIGN,
+        MTB_ALIGN,
+        FEATURE_ALIGN,
+        NO_ALIGN
+    } alignMode;
 
     QList<float> ev;
     QScopedPointer<HdrCreationManager> hdrCreationManager;
@@ -77,6 +82,7 @@ class CommandLineInterfaceManager : public QObject {
     bool started;
     float threshold;
     bool isAutolevels;
+    bool isStreaming;
     bool isHtml;
     bool isHtmlDone;
     int htmlQuality;
@@ -27,6 +27,7 @@
 #include "Common/TranslatorManager.h"
 #include "Common/config.h"
 
+#include "Libpfs/utils/trace.h"
 #include "MainCli/commandline.h"
 
 int main(int argc, char **argv) {
@@ -36,6 +37,9 @@ int main(int argc, char **argv) {
     LuminanceOptions lumOpts;
 
     TranslatorManager::setLanguage(lumOpts.getGuiLang(), false);
+    lumOpts.applyFileBackedStorage();
+    lumOpts.applyThreadBudget();
+    pfs::utils::Trace::instance().startFromEnvironment();
 
     CommandLineInterfaceManager cli(argc, argv);
 
@@ -38,6 +38,7 @@
 #include "Common/TranslatorManager.h"
 #include "Common/config.h"
 #include "Common/global.h"
+#include "Libpfs/utils/trace.h"
 #include "MainWindow/DonationDialog.h"
 #include "MainWindow/MainWindow.h"
 
@@ -156,6 +157,9 @@ int main(int argc, char **argv) {
     TranslatorManager::setLanguage(LuminanceOptions().getGuiLang());
 
     LuminanceOptions().applyTheme(true);
+    LuminanceOptions().applyFileBackedStorage();
+    LuminanceOptions().applyThreadBudget();
+    pfs::utils::Trace::instance().startFromEnvironment();
 
     QStringList arguments = application.arguments();
 
@@ -105,6 +105,7 @@
 #include <Resize/ResizeDialog.h>
 #include <TonemappingPanel/TMOProgressIndicator.h>
 #include <TonemappingPanel/TonemappingPanel.h>
+#include <TonemappingOperators/pfstmo.h>
 
 namespace {
 QString getLdrFileNameFromSaveDialog(const QString &suggestedFileName,
@@ -1651,7 +1652,8 @@ void MainWindow::tonemapImage(TonemappingOptions *opts) {
 
     // Warning when using size dependent TMOs with smaller sizes
     if ((opts->tmoperator == fattal) &&
-        (opts->operator_options.fattaloptions.fftsolver == false) &&
+        (opts->operator_options.fattaloptions.fftsolver ==
+         FATTAL02_SOLVER_MULTIGRID) &&
         (opts->xsize != opts->origxsize) &&
         (LuminanceOptions().isShowFattalWarning())) {
         UMessageBox warningDialog(this);
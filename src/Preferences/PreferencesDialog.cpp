@@ -194,6 +194,9 @@ void PreferencesDialog::on_okButton_clicked() {
     }
 
     luminance_options.setTempDir(m_Ui->lineEditTempPath->text());
+    luminance_options.setFileBackedThreshold(
+        m_Ui->fileBackedThresholdSpinBox->value());
+    luminance_options.applyFileBackedStorage();
 
     luminance_options.setPreviewWidth(m_Ui->previewsWidthSpinBox->value());
     luminance_options.setPreviewPanelActive(
@@ -207,6 +210,8 @@ void PreferencesDialog::on_okButton_clicked() {
 
     // --- Batch TM
     luminance_options.setBatchTmNumThreads(m_Ui->numThreadspinBox->value());
+    luminance_options.setThreadBudget(m_Ui->threadBudgetSpinBox->value());
+    luminance_options.applyThreadBudget();
 
     // --- Other Parameters
 
@@ -576,8 +581,11 @@ void PreferencesDialog::from_options_to_gui() {
 
     // Temp directory
     m_Ui->lineEditTempPath->setText(luminance_options.getTempDir());
+    m_Ui->fileBackedThresholdSpinBox->setValue(
+        luminance_options.getFileBackedThreshold());
 
     m_Ui->numThreadspinBox->setValue(luminance_options.getBatchTmNumThreads());
+    m_Ui->threadBudgetSpinBox->setValue(luminance_options.getThreadBudget());
 
     m_Ui->aisParamsLineEdit->setText(
         luminance_options.getAlignImageStackOptions().join(
@@ -30,16 +30,9 @@
 #include "Libpfs/frame.h"
 #include "Libpfs/manip/projection.h"
 
-static void worker(pfs::Frame *original, pfs::Frame *transformed, int xSize,
-                   int ySize, TransformInfo *transforminfo) {
-    const pfs::ChannelContainer &channels = original->getChannels();
-
-    for (pfs::ChannelContainer::const_iterator it = channels.begin();
-         it != channels.end(); ++it) {
-        pfs::Channel *newCh = transformed->createChannel((*it)->getName());
-
-        transformArray(*it, newCh, transforminfo);
-    }
+static void worker(pfs::Frame *original, pfs::Frame *transformed,
+                   TransformInfo *transforminfo) {
+    transformFrame(*original, *transformed, *transforminfo);
 
     pfs::copyTags(original, transformed);
 }
@@ -132,8 +125,8 @@ void ProjectionsDialog::okClicked() {
         static_cast<int>(xSize / transforminfo->dstProjection->getSizeRatio());
     transformed = new pfs::Frame(xSize, ySize);
 
-    m_future = QtConcurrent::run(boost::bind(&worker, original, transformed,
-                                             xSize, ySize, transforminfo));
+    m_future = QtConcurrent::run(
+        boost::bind(&worker, original, transformed, transforminfo));
 
     m_futureWatcher.setFuture(m_future);
 }
@@ -0,0 +1,219 @@
+/**
+ * @file bilateralgrid.cpp
+ * @brief Bilateral filtering on a bilateral grid
+ *
+ *
+ * This file is a part of LuminanceHDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ * @author agent <agent@local>
+ */
+
+#include "bilateralgrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <Libpfs/array2d.h>
+#include <Libpfs/progress.h>
+#include "fastbilateral.h"
+
+namespace {
+//! \brief empty cells around the samples, for the support of the blur
+const int PAD = 2;
+
+//! \brief size of a grid cell along the range axis: the range kernel is
+//! exp(-d^2 / sigma_r^2), a Gaussian of standard deviation sigma_r / sqrt(2)
+inline float rangeCell(float sigma_r) { return sigma_r * 0.70710678f; }
+
+//! \brief number of cells covering \a extent samples, one every \a cell
+inline size_t gridSize(float extent, float cell) {
+    return static_cast<size_t>(extent / cell) + 1 + 2 * PAD;
+}
+
+//! \brief Gaussian of one cell (the binomial [1 4 6 4 1] / 16, variance 1)
+//! along the axis of length \a count of the [outer][count][inner] array
+//! \a in, zero outside of it
+void blur(const float *in, float *out, int outer, int count, int inner) {
+#ifdef _OPENMP
+#pragma omp parallel for collapse(2)
+#endif
+    for (int o = 0; o < outer; ++o) {
+        for (int i = 0; i < count; ++i) {
+            const float *src = in + (size_t(o) * count + i) * inner;
+            float *dst = out + (size_t(o) * count + i) * inner;
+
+            // the taps falling outside of the axis are skipped
+            const float *m2 = i >= 2 ? src - 2 * inner : NULL;
+            const float *m1 = i >= 1 ? src - inner : NULL;
+            const float *p1 = i + 1 < count ? src + inner : NULL;
+            const float *p2 = i + 2 < count ? src + 2 * inner : NULL;
+
+#pragma omp simd
+            for (int k = 0; k < inner; ++k) {
+                dst[k] = 0.375f * src[k];
+            }
+            if (m2 && p2) {
+#pragma omp simd
+                for (int k = 0; k < inner; ++k) {
+                    dst[k] += 0.25f * (m1[k] + p1[k]) +
+                              0.0625f * (m2[k] + p2[k]);
+                }
+                continue;
+            }
+            const float *taps[4] = {m2, m1, p1, p2};
+            const float weights[4] = {0.0625f, 0.25f, 0.25f, 0.0625f};
+            for (int t = 0; t < 4; ++t) {
+                if (taps[t] == NULL) continue;
+                for (int k = 0; k < inner; ++k) {
+                    dst[k] += weights[t] * taps[t][k];
+                }
+            }
+        }
+    }
+}
+}
+
+bool bilateralGridFits(size_t width, size_t height, float range,
+                       float sigma_s, float sigma_r) {
+    if (sigma_s < 1.f || !(sigma_r > 0.f)) return false;
+
+    const double cells = double(gridSize(width - 1, sigma_s)) *
+                         gridSize(height - 1, sigma_s) *
+                         gridSize(range, rangeCell(sigma_r));
+    // two grids of two floats per cell: up to 4 frames
+    return cells <= double(width) * height;
+}
+
+void bilateralGridFilter(const pfs::Array2Df &I, pfs::Array2Df &J,
+                         float sigma_s, float sigma_r, pfs::Progress &ph) {
+    const int w = I.getCols();
+    const int h = I.getRows();
+    const int size = w * h;
+
+    // find range of values in the input array
+    float maxI = I(0);
+    float minI = I(0);
+#ifdef _OPENMP
+#pragma omp parallel for reduction(min : minI) reduction(max : maxI)
+#endif
+    for (int i = 0; i < size; i++) {
+        maxI = std::max(maxI, I(i));
+        minI = std::min(minI, I(i));
+    }
+
+    if (!bilateralGridFits(w, h, maxI - minI, sigma_s, sigma_r)) {
+        fastBilateralFilter(I, J, sigma_s, sigma_r, 1, ph);
+        return;
+    }
+
+    const float invCellS = 1.f / sigma_s;
+    const float invCellR = 1.f / rangeCell(sigma_r);
+    const int gw = gridSize(w - 1, sigma_s);
+    const int gh = gridSize(h - 1, sigma_s);
+    const int gd = gridSize(maxI - minI, rangeCell(sigma_r));
+    // [gy][gx][gz][2]: sum of the samples, number of samples
+    const size_t gridRow = size_t(gw) * gd * 2;
+
+    std::vector<float> grid(gridRow * gh, 0.f);
+    std::vector<float> buffer(grid.size());
+
+    // splat every sample into its nearest cell. The rows of the frame are
+    // grouped by grid row, so that each thread owns the cells it writes.
+    std::vector<int> rowStart(gh + 1, h);
+    for (int y = h - 1; y >= 0; --y) {
+        rowStart[int(y * invCellS + 0.5f) + PAD] = y;
+    }
+    for (int gy = gh - 1; gy > 0; --gy) {
+        rowStart[gy - 1] = std::min(rowStart[gy - 1], rowStart[gy]);
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int gy = 0; gy < gh; ++gy) {
+        float *cells = grid.data() + gy * gridRow;
+        for (int y = rowStart[gy]; y < rowStart[gy + 1]; ++y) {
+            for (int x = 0; x < w; ++x) {
+                const float v = I(x, y);
+                const int gx = int(x * invCellS + 0.5f) + PAD;
+                const int gz = int((v - minI) * invCellR + 0.5f) + PAD;
+                float *cell = cells + (size_t(gx) * gd + gz) * 2;
+                cell[0] += v;
+                cell[1] += 1.f;
+            }
+        }
+    }
+
+    ph.setValue(25);
+    if (ph.canceled()) return;
+
+    // separable blur, range axis first
+    blur(grid.data(), buffer.data(), gh * gw, gd, 2);
+    blur(buffer.data(), grid.data(), gh, gw, gd * 2);
+    ph.setValue(50);
+    if (ph.canceled()) return;
+    blur(grid.data(), buffer.data(), 1, gh, gw * gd * 2);
+
+    ph.setValue(75);
+    if (ph.canceled()) return;
+
+    // slice: trilinear interpolation of the blurred grid at each sample
+    const float *blurred = buffer.data();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int y = 0; y < h; ++y) {
+        const float fy = y * invCellS + PAD;
+        const int y0 = int(fy);
+        const float wy = fy - y0;
+
+        for (int x = 0; x < w; ++x) {
+            const float v = I(x, y);
+            const float fx = x * invCellS + PAD;
+            const float fz = (v - minI) * invCellR + PAD;
+            const int x0 = int(fx);
+            const int z0 = int(fz);
+            const float wx = fx - x0;
+            const float wz = fz - z0;
+
+            float sum = 0.f;
+            float count = 0.f;
+            for (int dy = 0; dy < 2; ++dy) {
+                const float ky = dy ? wy : 1.f - wy;
+                for (int dx = 0; dx < 2; ++dx) {
+                    const float kxy = ky * (dx ? wx : 1.f - wx);
+                    const float *cell =
+                        blurred + (y0 + dy) * gridRow +
+                        (size_t(x0 + dx) * gd + z0) * 2;
+                    const float k0 = kxy * (1.f - wz);
+                    const float k1 = kxy * wz;
+                    sum += k0 * cell[0] + k1 * cell[2];
+                    count += k0 * cell[1] + k1 * cell[3];
+                }
+            }
+            // the cell of the sample always holds it: count is 0 only in
+            // the far tails of the kernel
+            J(x, y) = count > 1e-10f ? sum / count : v;
+        }
+    }
+
+    ph.setValue(100);
+}
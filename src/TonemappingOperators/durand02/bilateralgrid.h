@@ -0,0 +1,67 @@
+/**
+ * @file bilateralgrid.h
+ * @brief Bilateral filtering on a bilateral grid
+ *
+ *
+ * This file is a part of LuminanceHDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ * @author agent <agent@local>
+ */
+
+#ifndef BILATERALGRID_H
+#define BILATERALGRID_H
+
+#include <cstddef>
+
+#include <Libpfs/array2d_fwd.h>
+
+namespace pfs {
+class Progress;
+}
+
+//!
+//! @brief Bilateral filtering on a bilateral grid
+//!
+//! Paris and Durand, "A Fast Approximation of the Bilateral Filter using a
+//! Signal Processing Approach", ECCV 2006. The samples are accumulated in a
+//! 3D grid with a cell every sigma_s pixels and every sigma_r / sqrt(2)
+//! intensity units (the range kernel of fastBilateralFilter() is
+//! exp(-d^2 / sigma_r^2)). The grid is blurred by a Gaussian of one cell and
+//! sampled back by trilinear interpolation. The grid shrinks as sigma_s
+//! grows, so the run time is about 2 passes over the frame for the large
+//! kernels.
+//!
+//! When the grid would not be smaller than the frame (small sigma_s, see
+//! bilateralGridFits()), the frame is filtered by fastBilateralFilter().
+//!
+//! \param I [in] input array
+//! \param J [out] filtered array
+//! \param sigma_s sigma value for spatial kernel
+//! \param sigma_r sigma value for range kernel
+//!
+void bilateralGridFilter(const pfs::Array2Df &I, pfs::Array2Df &J,
+                         float sigma_s, float sigma_r, pfs::Progress &ph);
+
+//! \brief the bilateral grid of a \a width x \a height frame with values
+//! spread over \a range is smaller than the frame
+bool bilateralGridFits(size_t width, size_t height, float range,
+                       float sigma_s, float sigma_r);
+
+#endif /* #ifndef BILATERALGRID_H */
@@ -56,7 +56,8 @@ const bool original_algorithm = false;
 // float baseContrast = 5.0f;
 
 void pfstmo_durand02(pfs::Frame &frame, float sigma_s, float sigma_r,
-                     float baseContrast, pfs::Progress &ph) {
+                     float baseContrast, bool bilateralgrid,
+                     pfs::Progress &ph) {
 #ifndef NDEBUG
     std::stringstream ss;
 
@@ -68,7 +69,8 @@ void pfstmo_durand02(pfs::Frame &frame, float sigma_s, float sigma_r,
 #endif
     ss << ", sigma_s: " << sigma_s;
     ss << ", sigma_r: " << sigma_r;
-    ss << ", base contrast: " << baseContrast << ")";
+    ss << ", base contrast: " << baseContrast;
+    ss << ", bilateral grid: " << bilateralgrid << ")";
 
     std::cout << ss.str() << std::endl;
 #endif
@@ -85,7 +87,7 @@ void pfstmo_durand02(pfs::Frame &frame, float sigma_s, float sigma_r,
 
     try {
         tmo_durand02(*X, *Y, *Z, sigma_s, sigma_r, baseContrast, downsample,
-                     !original_algorithm, ph);
+                     !original_algorithm, bilateralgrid, ph);
     } catch (...) {
         throw pfs::Exception("Tonemapping Failed!");
     }
@@ -37,12 +37,13 @@
 #include <iostream>
 #include <vector>
 
-#include "Libpfs/utils/msec_timer.h"
 #include "Libpfs/array2d.h"
 #include "Libpfs/rt_algo.h"
 #include "Libpfs/progress.h"
+#include "Libpfs/utils/trace.h"
 #include "TonemappingOperators/pfstmo.h"
 
+#include "bilateralgrid.h"
 #include "fastbilateral.h"
 
 #include "../../sleef.c"
@@ -99,15 +100,14 @@ R output = r*exp(log(output intensity)), etc.
 
 void tmo_durand02(pfs::Array2Df &R, pfs::Array2Df &G, pfs::Array2Df &B,
                   float sigma_s, float sigma_r, float baseContrast,
-                  int downsample, bool color_correction, pfs::Progress &ph) {
-#ifdef TIMER_PROFILING
-    msec_timer stop_watch;
-    stop_watch.start();
-#endif
+                  int downsample, bool color_correction, bool bilateral_grid,
+                  pfs::Progress &ph) {
+    pfs::utils::TraceScope trace("tmo_durand02", "tonemap");
 
     int w = R.getCols();
     int h = R.getRows();
     int size = w * h;
+    trace.setBytes(size_t(size) * 3 * sizeof(float));
 
     pfs::Array2Df I(w, h);       // intensities
     pfs::Array2Df BASE(w, h);    // base layer
@@ -202,7 +202,11 @@ void tmo_durand02(pfs::Array2Df &R, pfs::Array2Df &G, pfs::Array2Df &B,
     }
 }
 
-    fastBilateralFilter(I, BASE, sigma_s, sigma_r, downsample, ph);
+    if (bilateral_grid) {
+        bilateralGridFilter(I, BASE, sigma_s, sigma_r, ph);
+    } else {
+        fastBilateralFilter(I, BASE, sigma_s, sigma_r, downsample, ph);
+    }
 
     //!! FIX: find minimum and maximum luminance, but skip 1% of outliers
     float maxB;
@@ -295,11 +299,4 @@ void tmo_durand02(pfs::Array2Df &R, pfs::Array2Df &G, pfs::Array2Df &B,
     if (!ph.canceled()) {
         ph.setValue(100);
     }
-
-#ifdef TIMER_PROFILING
-    stop_watch.stop_and_update();
-    cout << endl;
-    cout << "tmo_durand02 = " << stop_watch.get_time() << " msec" << endl;
-#endif
-
 }
@@ -55,10 +55,12 @@ class Progress;
 //! \param color_correction enable automatic color correction
 //! \param downsample down sampling factor for speeding up fast-bilateral
 //! (1..20)
+//! \param bilateral_grid filter the base layer on a bilateral grid (see
+//! bilateralGridFilter()) rather than with the piecewise linear filter
 //!
 void tmo_durand02(pfs::Array2Df &R, pfs::Array2Df &G, pfs::Array2Df &B,
                   float sigma_s, float sigma_r, float baseContrast,
                   int downsample, bool color_correction /*= true*/,
-                  pfs::Progress &ph);
+                  bool bilateral_grid, pfs::Progress &ph);
 
 #endif  // TMO_DURAND02_H
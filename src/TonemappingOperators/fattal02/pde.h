@@ -56,6 +56,31 @@ void solve_pde_multigrid(pfs::Array2Df *F, pfs::Array2Df *U, pfs::Progress &ph);
 void solve_pde_fft(pfs::Array2Df &F, pfs::Array2Df &U, pfs::Array2Df &F_tr, pfs::Progress &ph,
                    bool adjust_bound = false);
 
+//! \brief cycles of solve_pde_redblack()
+enum MultigridCycle {
+    MULTIGRID_V_CYCLE,
+    MULTIGRID_W_CYCLE,
+    MULTIGRID_F_CYCLE
+};
+
+/**
+ * @brief solve poisson pde (Laplace U = F) using red-black Gauss-Seidel
+ * multigrid, with the boundary conditions of solve_pde_fft()
+ *
+ * Unlike the fft solver, any size is solved at the same cost per pixel.
+ *
+ * @param F array of the right hand side
+ * @param U [out] solution
+ * @param cycle multigrid cycle run until convergence
+ * @param tolerance reduction of the norm of the residual
+ * @param max_cycles number of cycles run at most
+ * @return number of cycles run
+ */
+int solve_pde_redblack(const pfs::Array2Df &F, pfs::Array2Df &U,
+                       pfs::Progress &ph,
+                       MultigridCycle cycle = MULTIGRID_F_CYCLE,
+                       float tolerance = 1e-4f, int max_cycles = 30);
+
 /**
  * @brief returns the residual error of the solution U, ie norm(Laplace U - F)
  *
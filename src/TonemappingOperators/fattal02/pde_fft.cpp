@@ -78,7 +78,7 @@
 #include <fftw3.h>
 #include <vector>
 
-#include <Common/init_fftw.h>
+#include <Common/fftwplans.h>
 #include <Libpfs/array2d.h>
 #include <Libpfs/progress.h>
 #include "pde.h"
@@ -120,17 +120,10 @@ void transform_ev2normal(pfs::Array2Df &A, pfs::Array2Df &T) {
     // fftwf_free(in);
 
     // executes 2d discrete cosine transform
-    fftwf_plan p;
-    FFTW_MUTEX::fftw_mutex_plan.lock();
-    p = fftwf_plan_r2r_2d(height, width, A.data(), T.data(), FFTW_REDFT00,
-                          FFTW_REDFT00, FFTW_ESTIMATE);
-    FFTW_MUTEX::fftw_mutex_plan.unlock();
-
-    fftwf_execute(p);
-
-    FFTW_MUTEX::fftw_mutex_destroy_plan.lock();
-    fftwf_destroy_plan(p);
-    FFTW_MUTEX::fftw_mutex_destroy_plan.unlock();
+    FftwPlans::Plan p = FftwPlans::instance().r2r2d(
+        height, width, A.data(), T.data(), FFTW_REDFT00, FFTW_REDFT00,
+        FFTW_ESTIMATE);
+    fftwf_execute_r2r(p.get(), A.data(), T.data());
 }
 
 // returns T = EVy^-1 * A * (EVx^-1)^tr
@@ -140,17 +133,10 @@ void transform_normal2ev(pfs::Array2Df &A, pfs::Array2Df &T) {
     assert((int)T.getCols() == width && (int)T.getRows() == height);
 
     // executes 2d discrete cosine transform
-    fftwf_plan p;
-    FFTW_MUTEX::fftw_mutex_plan.lock();
-    p = fftwf_plan_r2r_2d(height, width, A.data(), T.data(), FFTW_REDFT00,
-                          FFTW_REDFT00, FFTW_ESTIMATE);
-    FFTW_MUTEX::fftw_mutex_plan.unlock();
-
-    fftwf_execute(p);
-
-    FFTW_MUTEX::fftw_mutex_destroy_plan.lock();
-    fftwf_destroy_plan(p);
-    FFTW_MUTEX::fftw_mutex_destroy_plan.unlock();
+    FftwPlans::Plan p = FftwPlans::instance().r2r2d(
+        height, width, A.data(), T.data(), FFTW_REDFT00, FFTW_REDFT00,
+        FFTW_ESTIMATE);
+    fftwf_execute_r2r(p.get(), A.data(), T.data());
 
     // need to scale the output matrix to get the right transform
     for (int y = 0; y < height; y++)
@@ -229,9 +215,6 @@ void solve_pde_fft(pfs::Array2Df &F, pfs::Array2Df &U, pfs::Array2Df &F_tr, pfs:
     int height = F.getRows();
     assert((int)U.getCols() == width && (int)U.getRows() == height);
 
-    // activate parallel execution of fft routines
-    init_fftw();
-
     // in general there might not be a solution to the Poisson pde
     // with Neumann boundary conditions unless the boundary satisfies
     // an integral condition, this function modifies the boundary so that
@@ -0,0 +1,541 @@
+/**
+ * @file pde_redblack.cpp
+ * @brief Red-black Gauss-Seidel multigrid solver of the Poisson pde
+ *
+ *
+ * This file is a part of LuminanceHDR package
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ *
+ * @author agent <agent@local>
+ */
+
+// The pde is the one of solve_pde_fft(): 5-point Laplacian, with the
+// boundary conditions U(-1) = U(1) and U(N) = U(N-2), which is the finite
+// volume discretization of the Laplacian with zero flux at the border.
+//
+// Level l+1 keeps every second node of level l along each axis, and the
+// last one: a grid of any size is coarsened without changing its domain,
+// so the spacing is uniform but for the last interval of the coarse axes
+// of even length. The coarse operators are the same finite volume
+// Laplacian on the coarse nodes, and the residual is restricted by the
+// transpose of the (bilinear) interpolation, weighted by the dual cells.
+//
+// The operator is singular, constant functions being in its kernel: each
+// level removes from its right hand side the component that has no
+// solution (the DC term that solve_pde_fft() zeroes). The coarsest level,
+// a few nodes across, is solved exactly by banded LU decomposition.
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include <Libpfs/array2d.h>
+#include <Libpfs/progress.h>
+#include <Libpfs/utils/trace.h>
+#include "pde.h"
+
+namespace {
+//! \brief the levels are coarsened while both sides are longer than this
+const int COARSEST_SIZE = 4;
+//! \brief smoothing sweeps before and after the coarse grid correction
+const int PRE_SMOOTH = 2;
+const int POST_SMOOTH = 2;
+
+//! \brief nodes of a level along one axis
+struct Axis {
+    //! \brief \a n nodes, unit spacing
+    explicit Axis(int n) : position(n) {
+        for (int i = 0; i < n; ++i) position[i] = float(i);
+        setStencil();
+    }
+
+    //! \brief every second node of \a fine, and its last one. Sets the
+    //! transfer weights of \a fine.
+    explicit Axis(Axis &fine) {
+        const int n = fine.size();
+        for (int i = 0; i < n; i += 2) fine.node.push_back(i);
+        if (n % 2 == 0) fine.node.push_back(n - 1);
+        for (int i : fine.node) position.push_back(fine.position[i]);
+        setStencil();
+        fine.setTransfer(*this);
+    }
+
+    int size() const { return position.size(); }
+
+    std::vector<float> position;
+    //! \brief weights of the previous and next node in the Laplacian
+    std::vector<float> lower;
+    std::vector<float> upper;
+    //! \brief length of the cell of each node (the trapezoidal rule)
+    std::vector<float> cell;
+
+    //! \brief node of the coarse axis: fine node of each coarse node
+    std::vector<int> node;
+    //! \brief interpolation: node i lies between the coarse nodes below[i]
+    //! and below[i] + 1, the latter weighted by above[i]
+    std::vector<int> below;
+    std::vector<float> above;
+    //! \brief restriction: weights of the fine nodes node[I] - 1, node[I]
+    //! and node[I] + 1 to coarse node I
+    std::vector<float> restriction;
+
+   private:
+    void setStencil() {
+        const int n = size();
+        lower.assign(n, 0.f);
+        upper.assign(n, 0.f);
+        cell.assign(n, 0.f);
+        for (int i = 0; i < n; ++i) {
+            const float left = i > 0 ? position[i] - position[i - 1] : 0.f;
+            const float right =
+                i + 1 < n ? position[i + 1] - position[i] : 0.f;
+            cell[i] = 0.5f * (left + right);
+            if (i > 0) lower[i] = 1.f / (left * cell[i]);
+            if (i + 1 < n) upper[i] = 1.f / (right * cell[i]);
+        }
+    }
+
+    void setTransfer(const Axis &coarse) {
+        const int n = size();
+        const int nc = coarse.size();
+        below.resize(n);
+        above.resize(n);
+        for (int I = 0, i = 0; i < n; ++i) {
+            while (I + 2 < nc && node[I + 1] <= i) ++I;
+            below[i] = I;
+            above[i] = (position[i] - position[node[I]]) /
+                       (position[node[I + 1]] - position[node[I]]);
+        }
+
+        restriction.assign(3 * nc, 0.f);
+        for (int I = 0; I < nc; ++I) {
+            for (int k = 0; k < 3; ++k) {
+                const int i = node[I] + k - 1;
+                if (i < 0 || i >= n) continue;
+                const float weight = below[i] == I
+                                         ? 1.f - above[i]
+                                         : (below[i] + 1 == I ? above[i] : 0.f);
+                restriction[3 * I + k] = weight * cell[i] / coarse.cell[I];
+            }
+        }
+    }
+};
+
+struct Level {
+    Level(int width, int height)
+        : x(width), y(height), u(width, height), f(width, height),
+          r(width, height) {}
+    explicit Level(Level &fine)
+        : x(fine.x), y(fine.y), u(x.size(), y.size()), f(x.size(), y.size()),
+          r(x.size(), y.size()) {}
+
+    int width() const { return x.size(); }
+    int height() const { return y.size(); }
+
+    Axis x;
+    Axis y;
+    pfs::Array2Df u;  //!< solution (correction, on the coarse levels)
+    pfs::Array2Df f;  //!< right hand side
+    pfs::Array2Df r;  //!< residual
+
+    //! \brief LU decomposition of the operator (coarsest level only)
+    std::vector<double> lu;
+};
+
+typedef std::vector<std::unique_ptr<Level>> Levels;
+
+//! \brief remove from the right hand side the component out of the range
+//! of the operator
+void makeCompatible(Level &l) {
+    const int w = l.width();
+    const int h = l.height();
+    float *F = l.f.data();
+
+    double sum = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+ : sum)
+#endif
+    for (int y = 0; y < h; ++y) {
+        double row = 0.0;
+        for (int x = 0; x < w; ++x) {
+            row += l.x.cell[x] * F[y * w + x];
+        }
+        sum += l.y.cell[y] * row;
+    }
+    // the cells cover the domain
+    const double area = double(l.x.position.back()) * l.y.position.back();
+    const float mean = static_cast<float>(sum / area);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int y = 0; y < h; ++y) {
+        float *f = F + y * w;
+#pragma omp simd
+        for (int x = 0; x < w; ++x) {
+            f[x] -= mean;
+        }
+    }
+}
+
+//! \brief one red-black Gauss-Seidel sweep. Nodes of the same color do not
+//! depend on each other: the rows of a color run in parallel, and the nodes
+//! of a row as a strided SIMD loop.
+void smooth(Level &l) {
+    const int w = l.width();
+    const int h = l.height();
+    float *U = l.u.data();
+    const float *F = l.f.data();
+    const float *lx = l.x.lower.data();
+    const float *ux = l.x.upper.data();
+
+    for (int color = 0; color < 2; ++color) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int y = 0; y < h; ++y) {
+            // the weight of the node out of the grid is 0
+            const float ly = l.y.lower[y];
+            const float uy = l.y.upper[y];
+            float *u = U + y * w;
+            const float *up = U + (y > 0 ? y - 1 : y + 1) * w;
+            const float *down = U + (y + 1 < h ? y + 1 : y - 1) * w;
+            const float *f = F + y * w;
+
+            int x = (y + color) & 1;
+            if (x == 0) {
+                u[0] = (ux[0] * u[1] + ly * up[0] + uy * down[0] - f[0]) /
+                       (ux[0] + ly + uy);
+                x = 2;
+            }
+#pragma omp simd
+            for (int i = x; i < w - 1; i += 2) {
+                u[i] = (lx[i] * u[i - 1] + ux[i] * u[i + 1] + ly * up[i] +
+                        uy * down[i] - f[i]) /
+                       (lx[i] + ux[i] + ly + uy);
+            }
+            const int last = w - 1;
+            if (((last + y) & 1) == color) {
+                u[last] = (lx[last] * u[last - 1] + ly * up[last] +
+                           uy * down[last] - f[last]) /
+                          (lx[last] + ly + uy);
+            }
+        }
+    }
+}
+
+//! \brief r = f - Laplace u
+//! \return the L2 norm of the residual
+double residual(Level &l) {
+    const int w = l.width();
+    const int h = l.height();
+    const float *U = l.u.data();
+    const float *F = l.f.data();
+    float *R = l.r.data();
+    const float *lx = l.x.lower.data();
+    const float *ux = l.x.upper.data();
+
+    double norm = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+ : norm)
+#endif
+    for (int y = 0; y < h; ++y) {
+        const float ly = l.y.lower[y];
+        const float uy = l.y.upper[y];
+        const float *u = U + y * w;
+        const float *up = U + (y > 0 ? y - 1 : y + 1) * w;
+        const float *down = U + (y + 1 < h ? y + 1 : y - 1) * w;
+        const float *f = F + y * w;
+        float *r = R + y * w;
+
+        const int last = w - 1;
+        r[0] = f[0] - (ux[0] * (u[1] - u[0]) + ly * (up[0] - u[0]) +
+                       uy * (down[0] - u[0]));
+        r[last] = f[last] - (lx[last] * (u[last - 1] - u[last]) +
+                             ly * (up[last] - u[last]) +
+                             uy * (down[last] - u[last]));
+        float rowNorm = r[0] * r[0] + r[last] * r[last];
+#pragma omp simd reduction(+ : rowNorm)
+        for (int i = 1; i < last; ++i) {
+            r[i] = f[i] - (lx[i] * (u[i - 1] - u[i]) + ux[i] * (u[i + 1] - u[i]) +
+                           ly * (up[i] - u[i]) + uy * (down[i] - u[i]));
+            rowNorm += r[i] * r[i];
+        }
+        norm += rowNorm;
+    }
+    return std::sqrt(norm);
+}
+
+//! \brief right hand side of \a coarse: the residual of \a fine, restricted
+void restrictResidual(const Level &fine, Level &coarse) {
+    const int fw = fine.width();
+    const int cw = coarse.width();
+    const int ch = coarse.height();
+    const float *R = fine.r.data();
+    float *F = coarse.f.data();
+    const std::vector<int> &nodeX = fine.x.node;
+    const std::vector<float> &weightX = fine.x.restriction;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        // the rows are weighted first, for each column of the fine level
+        std::vector<float> row(fw);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int y = 0; y < ch; ++y) {
+            std::fill(row.begin(), row.end(), 0.f);
+            for (int k = 0; k < 3; ++k) {
+                const int j = fine.y.node[y] + k - 1;
+                const float weight = fine.y.restriction[3 * y + k];
+                if (weight == 0.f) continue;
+                const float *r = R + j * fw;
+#pragma omp simd
+                for (int i = 0; i < fw; ++i) {
+                    row[i] += weight * r[i];
+                }
+            }
+
+            float *f = F + y * cw;
+            for (int x = 0; x < cw; ++x) {
+                const int i = nodeX[x];
+                const float *w = &weightX[3 * x];
+                f[x] = w[1] * row[i];
+                if (w[0] != 0.f) f[x] += w[0] * row[i - 1];
+                if (w[2] != 0.f) f[x] += w[2] * row[i + 1];
+            }
+        }
+    }
+    makeCompatible(coarse);
+}
+
+//! \brief add the correction of \a coarse to \a fine, bilinearly
+//! interpolated
+void prolongate(const Level &coarse, Level &fine) {
+    const int fw = fine.width();
+    const int fh = fine.height();
+    const int cw = coarse.width();
+    const float *E = coarse.u.data();
+    float *U = fine.u.data();
+    const int *belowX = fine.x.below.data();
+    const float *aboveX = fine.x.above.data();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<float> row(cw);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int y = 0; y < fh; ++y) {
+            const float t = fine.y.above[y];
+            const float *e0 = E + fine.y.below[y] * cw;
+            const float *e1 = e0 + cw;
+#pragma omp simd
+            for (int x = 0; x < cw; ++x) {
+                row[x] = e0[x] + t * (e1[x] - e0[x]);
+            }
+
+            float *u = U + y * fw;
+            for (int x = 0; x < fw; ++x) {
+                const float *e = &row[belowX[x]];
+                u[x] += e[0] + aboveX[x] * (e[1] - e[0]);
+            }
+        }
+    }
+}
+
+//! \brief index of node (\a x, \a y) of \a l in its linear system. The
+//! nodes are numbered along the shorter side first, so that the half width
+//! of the band of the operator is the length of that side.
+int bandIndex(const Level &l, int x, int y) {
+    return l.width() >= l.height() ? x * l.height() + y : y * l.width() + x;
+}
+
+//! \brief factorize the operator of the coarsest level \a l. The equation of
+//! the first node is replaced by u = 0: the others determine the solution,
+//! the right hand side being compatible.
+void factorize(Level &l) {
+    const int w = l.width();
+    const int h = l.height();
+    const int n = w * h;
+    const int band = std::min(w, h);
+    const int stride = 2 * band + 1;
+    std::vector<double> &a = l.lu;
+    a.assign(size_t(n) * stride, 0.0);
+
+    // a[i * stride + band + j - i] holds the element (i, j)
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const int i = bandIndex(l, x, y);
+            double *row = &a[size_t(i) * stride + band - i];
+            if (i == 0) {
+                row[i] = 1.0;
+                continue;
+            }
+            const double lx = l.x.lower[x], ux = l.x.upper[x];
+            const double ly = l.y.lower[y], uy = l.y.upper[y];
+            row[i] = -(lx + ux + ly + uy);
+            if (x > 0) row[bandIndex(l, x - 1, y)] = lx;
+            if (x + 1 < w) row[bandIndex(l, x + 1, y)] = ux;
+            if (y > 0) row[bandIndex(l, x, y - 1)] = ly;
+            if (y + 1 < h) row[bandIndex(l, x, y + 1)] = uy;
+        }
+    }
+
+    // diagonally dominant: no pivoting
+    for (int k = 0; k < n; ++k) {
+        const double *pivot = &a[size_t(k) * stride + band - k];
+        const int end = std::min(n, k + band + 1);
+        for (int i = k + 1; i < end; ++i) {
+            double *row = &a[size_t(i) * stride + band - i];
+            if (row[k] == 0.0) continue;
+            row[k] /= pivot[k];
+            for (int j = k + 1; j < end; ++j) {
+                row[j] -= row[k] * pivot[j];
+            }
+        }
+    }
+}
+
+//! \brief exact solution of the coarsest level
+void solveCoarsest(Level &l) {
+    const int w = l.width();
+    const int h = l.height();
+    const int n = w * h;
+    const int band = std::min(w, h);
+    const int stride = 2 * band + 1;
+    const std::vector<double> &a = l.lu;
+
+    std::vector<double> b(n);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            b[bandIndex(l, x, y)] = l.f(x, y);
+        }
+    }
+    b[0] = 0.0;
+
+    for (int i = 0; i < n; ++i) {
+        const double *row = &a[size_t(i) * stride + band - i];
+        for (int j = std::max(0, i - band); j < i; ++j) b[i] -= row[j] * b[j];
+    }
+    for (int i = n - 1; i >= 0; --i) {
+        const double *row = &a[size_t(i) * stride + band - i];
+        const int end = std::min(n, i + band + 1);
+        for (int j = i + 1; j < end; ++j) b[i] -= row[j] * b[j];
+        b[i] /= row[i];
+    }
+
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            l.u(x, y) = static_cast<float>(b[bandIndex(l, x, y)]);
+        }
+    }
+}
+
+//! \brief one cycle on \a level, which starts from the current solution
+void cycle(Levels &levels, size_t level, MultigridCycle type) {
+    Level &fine = *levels[level];
+    if (level + 1 == levels.size()) {
+        solveCoarsest(fine);
+        return;
+    }
+
+    for (int k = 0; k < PRE_SMOOTH; ++k) smooth(fine);
+    residual(fine);
+
+    Level &coarse = *levels[level + 1];
+    restrictResidual(fine, coarse);
+    coarse.u.fill(0.f);
+    switch (type) {
+        case MULTIGRID_V_CYCLE:
+            cycle(levels, level + 1, MULTIGRID_V_CYCLE);
+            break;
+        case MULTIGRID_W_CYCLE:
+            cycle(levels, level + 1, MULTIGRID_W_CYCLE);
+            cycle(levels, level + 1, MULTIGRID_W_CYCLE);
+            break;
+        case MULTIGRID_F_CYCLE:
+            cycle(levels, level + 1, MULTIGRID_F_CYCLE);
+            cycle(levels, level + 1, MULTIGRID_V_CYCLE);
+            break;
+    }
+    prolongate(coarse, fine);
+
+    for (int k = 0; k < POST_SMOOTH; ++k) smooth(fine);
+}
+}
+
+int solve_pde_redblack(const pfs::Array2Df &F, pfs::Array2Df &U,
+                       pfs::Progress &ph, MultigridCycle type,
+                       float tolerance, int max_cycles) {
+    pfs::utils::TraceScope trace("solve_pde_redblack", "tonemap");
+
+    const int width = F.getCols();
+    const int height = F.getRows();
+    assert((int)U.getCols() == width && (int)U.getRows() == height);
+    assert(width > 1 && height > 1);
+
+    Levels levels;
+    levels.emplace_back(new Level(width, height));
+    while (std::min(levels.back()->width(), levels.back()->height()) >
+           COARSEST_SIZE) {
+        levels.emplace_back(new Level(*levels.back()));
+    }
+    factorize(*levels.back());
+
+    Level &finest = *levels.front();
+    std::copy(F.begin(), F.end(), finest.f.begin());
+    makeCompatible(finest);
+    finest.u.fill(0.f);
+
+    ph.setValue(20);
+    const double target = tolerance * residual(finest);
+    double norm = target;
+    int cycles = 0;
+    while (cycles < max_cycles) {
+        cycle(levels, 0, type);
+        ++cycles;
+        norm = residual(finest);
+
+        ph.setValue(20 + 65 * cycles / max_cycles);
+        if (norm <= target || ph.canceled()) break;
+    }
+
+    if (trace.isEnabled()) {
+        std::ostringstream detail;
+        detail << width << "x" << height << ", " << levels.size()
+               << " levels, " << cycles << " cycles, residual " << norm;
+        trace.setDetail(detail.str());
+    }
+
+    // as solve_pde_fft(): the solution has no positive values
+    const float max = *std::max_element(finest.u.begin(), finest.u.end());
+    std::transform(finest.u.begin(), finest.u.end(), U.begin(),
+                   [max](float u) { return u - max; });
+
+    ph.setValue(90);
+    return cycles;
+}
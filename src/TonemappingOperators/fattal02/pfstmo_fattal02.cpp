@@ -42,6 +42,7 @@
 #include "Libpfs/exception.h"
 #include "Libpfs/frame.h"
 #include "Libpfs/progress.h"
+#include "TonemappingOperators/pfstmo.h"
 #include "../../opthelper.h"
 #include "../../sleef.c"
 #define pow_F(a,b) (xexpf(b*xlogf(a)))
@@ -52,9 +53,9 @@ const float epsilon = 1e-4f;
 
 void pfstmo_fattal02(pfs::Frame &frame, float opt_alpha, float opt_beta,
                      float opt_saturation, float opt_noise, bool newfattal,
-                     bool fftsolver, int detail_level, pfs::Progress &ph) {
+                     int fftsolver, int detail_level, pfs::Progress &ph) {
 
-    if (fftsolver) {
+    if (fftsolver != FATTAL02_SOLVER_MULTIGRID) {
         // opt_alpha = 1.f;
         newfattal = true;  // let's make sure, prudence is never enough!
     }
@@ -284,7 +284,7 @@ void calculateFiMatrix(pfs::Array2Df &FI, pfs::Array2Df *gradients[],
 
 void tmo_fattal02(size_t width, size_t height, const pfs::Array2Df &Y,
                   pfs::Array2Df &L, float alfa, float beta, float noise,
-                  bool newfattal, bool fftsolver, int detail_level,
+                  bool newfattal, int fftsolver, int detail_level,
                   pfs::Progress &ph) {
 #ifdef TIMER_PROFILING
     msec_timer stop_watch;
@@ -305,7 +305,9 @@ void tmo_fattal02(size_t width, size_t height, const pfs::Array2Df &Y,
     // quality but I'm only applying this if the newly implemented fft solver
     // is used in order not to change behaviour of the old version
     // TODO: best let the user decide this value
-    if (fftsolver) {
+    // The red-black multigrid solves the same pde as the fft solver.
+    const bool fftpde = (fftsolver != FATTAL02_SOLVER_MULTIGRID);
+    if (fftpde) {
         MSIZE = 8;
     }
 
@@ -393,7 +395,7 @@ void tmo_fattal02(size_t width, size_t height, const pfs::Array2Df &Y,
     // side accordingly (basically fft solver assumes U(-1) = U(1), whereas zero
     // Neumann conditions assume U(-1)=U(0)), see also divergence calculation
 
-    if (fftsolver)
+    if (fftpde)
         #pragma omp parallel for
         for (size_t y = 0; y < height; y++)
             for (size_t x = 0; x < width; x++) {
@@ -431,7 +433,7 @@ void tmo_fattal02(size_t width, size_t height, const pfs::Array2Df &Y,
             if (x > 0) DivG(x, y) -= Gx(x - 1, y);
             if (y > 0) DivG(x, y) -= Gy(x, y - 1);
 
-            if (fftsolver) {
+            if (fftpde) {
                 if (x == 0) DivG(x, y) += Gx(x, y);
                 if (y == 0) DivG(x, y) += Gy(x, y);
             }
@@ -446,10 +448,16 @@ void tmo_fattal02(size_t width, size_t height, const pfs::Array2Df &Y,
     // solve pde and exponentiate (ie recover compressed image)
     {
         pfs::Array2Df U(width, height);
-        if (fftsolver) {
-            solve_pde_fft(DivG, U, Gx, ph);
-        } else {
-            solve_pde_multigrid(&DivG, &U, ph);
+        switch (fftsolver) {
+            case FATTAL02_SOLVER_FFT:
+                solve_pde_fft(DivG, U, Gx, ph);
+                break;
+            case FATTAL02_SOLVER_REDBLACK:
+                solve_pde_redblack(DivG, U, ph);
+                break;
+            default:
+                solve_pde_multigrid(&DivG, &U, ph);
+                break;
         }
 #ifndef NDEBUG
         printf("\npde residual error: %f\n", residual_pde(U, DivG));
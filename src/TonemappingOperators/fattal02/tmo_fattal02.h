@@ -52,11 +52,12 @@ class Progress;
 //! \param alfa parameter alfa (refer to the paper)
 //! \param beta parameter beta (refer to the paper)
 //! \param noise gradient level of noise (extra parameter)
+//! \param fftsolver Poisson solver (see Fattal02Solver)
 //!
 void tmo_fattal02(size_t width, size_t height,
                   // const float* Y, float* L,
                   const pfs::Array2Df &Y, pfs::Array2Df &L, float alfa,
-                  float beta, float noise, bool newfattal, bool fftsolver,
+                  float beta, float noise, bool newfattal, int fftsolver,
                   int detail_level, pfs::Progress &ph);
 
 #endif
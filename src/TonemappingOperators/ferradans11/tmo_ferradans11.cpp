@@ -50,13 +50,13 @@
 #include <boost/math/constants/constants.hpp>
 #include <boost/thread/mutex.hpp>
 
+#include <Common/fftwplans.h>
 #include <Common/init_fftw.h>
 #include <Libpfs/array2d.h>
 #include <Libpfs/progress.h>
 #include <Libpfs/utils/msec_timer.h>
 #include <Libpfs/utils/numeric.h>
 #include <TonemappingOperators/pfstmo.h>
-#include "Common/LuminanceOptions.h"
 #include "tmo_ferradans11.h"
 #include "../../sleef.c"
 #define pow_F(a,b) (xexpf(b*xlogf(a)))
@@ -285,8 +285,6 @@ void tmo_ferradans11(pfs::Array2Df &imR, pfs::Array2Df &imG, pfs::Array2Df &imB,
     stop_watch.start();
 #endif
 
-    init_fftw();
-
     ph.setValue(0);
 
     int fil = imR.getRows();
@@ -389,11 +387,12 @@ void tmo_ferradans11(pfs::Array2Df &imR, pfs::Array2Df &imG, pfs::Array2Df &imB,
             }
         }
 
-        float minmez = *min_element(RGB[k], RGB[k] + length);
-        vsadd(RGB[k], -minmez, RGB[k], length);
-
-        float escalamez = 1.f / (*max_element(RGB[k], RGB[k] + length) + 1e-12);
-        vsmul(RGB[k], escalamez, RGB[k], length);
+        // shift to zero and scale to one in a single pass
+        pair<float *, float *> minmax = minmax_element(RGB[k], RGB[k] + length);
+        float minmez = *minmax.first;
+        float escalamez = 1.f / (*minmax.second - minmez + 1e-12);
+        assign(RGB[k], length,
+               (arrayExpr(RGB[k], length) - minmez) * escalamez);
     }
 
     ph.setValue(20);
@@ -424,68 +423,21 @@ void tmo_ferradans11(pfs::Array2Df &imR, pfs::Array2Df &imG, pfs::Array2Df &imB,
     float *u7 = fftwf_alloc_real(length);
     FFTW_MUTEX::fftw_mutex_alloc.unlock();
 
-    FFTW_MUTEX::fftw_mutex_plan.lock();
     fftwf_complex *U = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
-
-    // test for available wisdom
-    fftwf_plan pU = fftwf_plan_dft_r2c_2d(fil, col, u0, U, FFTW_WISDOM_ONLY);
-    if(!pU) {
-        // no wisdom available, load wisdom from file
-        fftwf_import_wisdom_from_filename(LuminanceOptions().getFftwWisdomFileName().toStdString().c_str());
-        // test again for wisdom
-        pU = fftwf_plan_dft_r2c_2d(fil, col, u0, U, FFTW_WISDOM_ONLY);
-        if(!pU) {
-            // build plan with FFTW_MEASURE
-            pU = fftwf_plan_dft_r2c_2d(fil, col, u0, U, FFTW_MEASURE);
-            // save the wisdom
-            fftwf_export_wisdom_to_filename(LuminanceOptions().getFftwWisdomFileName().toStdString().c_str());
-        }
-    }
-
     fftwf_complex *U2 = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
-    fftwf_plan pU2 = fftwf_plan_dft_r2c_2d(fil, col, u2, U2, FFTW_WISDOM_ONLY);
-
     fftwf_complex *U3 = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
-    fftwf_plan pU3 = fftwf_plan_dft_r2c_2d(fil, col, u3, U3, FFTW_WISDOM_ONLY);
-
     fftwf_complex *U4 = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
-    fftwf_plan pU4 = fftwf_plan_dft_r2c_2d(fil, col, u4, U4, FFTW_WISDOM_ONLY);
-
     fftwf_complex *U5 = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
-    fftwf_plan pU5 = fftwf_plan_dft_r2c_2d(fil, col, u5, U5, FFTW_WISDOM_ONLY);
-
     fftwf_complex *U6 = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
-    fftwf_plan pU6 = fftwf_plan_dft_r2c_2d(fil, col, u6, U6, FFTW_WISDOM_ONLY);
-
     fftwf_complex *U7 = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
-    fftwf_plan pU7 = fftwf_plan_dft_r2c_2d(fil, col, u7, U7, FFTW_WISDOM_ONLY);
-
-
     float *iu = fftwf_alloc_real(length);
-    fftwf_plan pinvU = fftwf_plan_dft_c2r_2d(fil, col, U, iu, FFTW_WISDOM_ONLY);
-    if(!pinvU) {
-        // no wisdom available. Makes no sense to load wisdom from file because we just did that a few lines above.
-        // build plan with FFTW_MEASURE
-        pinvU = fftwf_plan_dft_c2r_2d(fil, col, U, iu, FFTW_MEASURE);
-        // save the wisdom
-        fftwf_export_wisdom_to_filename(LuminanceOptions().getFftwWisdomFileName().toStdString().c_str());
-    }
-
-    fftwf_plan pinvU2 = fftwf_plan_dft_c2r_2d(fil, col, U2, u2, FFTW_WISDOM_ONLY);
-
-    fftwf_plan pinvU3 = fftwf_plan_dft_c2r_2d(fil, col, U3, u3, FFTW_WISDOM_ONLY);
-
-    fftwf_plan pinvU4 = fftwf_plan_dft_c2r_2d(fil, col, U4, u4, FFTW_WISDOM_ONLY);
 
-    fftwf_plan pinvU5 = fftwf_plan_dft_c2r_2d(fil, col, U5, u5, FFTW_WISDOM_ONLY);
-
-    fftwf_plan pinvU6 = fftwf_plan_dft_c2r_2d(fil, col, U6, u6, FFTW_WISDOM_ONLY);
-
-    fftwf_plan pinvU7 = fftwf_plan_dft_c2r_2d(fil, col, U7, u7, FFTW_WISDOM_ONLY);
+    // all the powers of u share the same pair of plans, run on their arrays
+    FftwPlans::Plan pU = FftwPlans::instance().r2c2d(fil, col, u0, U, FFTW_MEASURE);
+    FftwPlans::Plan pinvU = FftwPlans::instance().c2r2d(fil, col, U, iu, FFTW_MEASURE);
 
     float alpha = min(col, fil) / invalpha;
     float *g = fftwf_alloc_real(length);
-    FFTW_MUTEX::fftw_mutex_plan.unlock();
 
     nucleo_gaussiano(g, fil, col, alpha);
     escala(g, length, 1.f, 0.f);
@@ -497,17 +449,10 @@ void tmo_ferradans11(pfs::Array2Df &imR, pfs::Array2Df &imG, pfs::Array2Df &imB,
     float w = (1.0f / suma);
     vsmul(g, w, g, length);
 
-    FFTW_MUTEX::fftw_mutex_plan.lock();
     fftwf_complex *G =
         (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * length);
-    fftwf_plan pG = fftwf_plan_dft_r2c_2d(fil, col, g, G, FFTW_WISDOM_ONLY);
-    FFTW_MUTEX::fftw_mutex_plan.unlock();
-    fftwf_execute(pG);
-    FFTW_MUTEX::fftw_mutex_destroy_plan.lock();
-    fftwf_destroy_plan(pG);
-
+    fftwf_execute_dft_r2c(pU.get(), g, G);
     fftwf_free(g);
-    FFTW_MUTEX::fftw_mutex_destroy_plan.unlock();
 
     ph.setValue(30);
     if (ph.canceled()) {
@@ -517,23 +462,6 @@ void tmo_ferradans11(pfs::Array2Df &imR, pfs::Array2Df &imG, pfs::Array2Df &imB,
         delete[] RGB[0];
         delete[] RGB[1];
         delete[] RGB[2];
-        FFTW_MUTEX::fftw_mutex_destroy_plan.lock();
-        fftwf_destroy_plan(pU);
-        fftwf_destroy_plan(pU2);
-        fftwf_destroy_plan(pU3);
-        fftwf_destroy_plan(pU4);
-        fftwf_destroy_plan(pU5);
-        fftwf_destroy_plan(pU6);
-        fftwf_destroy_plan(pU7);
-
-        fftwf_destroy_plan(pinvU);
-        fftwf_destroy_plan(pinvU2);
-        fftwf_destroy_plan(pinvU3);
-        fftwf_destroy_plan(pinvU4);
-        fftwf_destroy_plan(pinvU5);
-        fftwf_destroy_plan(pinvU6);
-        fftwf_destroy_plan(pinvU7);
-
         fftwf_free(RGB0);
         fftwf_free(u0);
         fftwf_free(u2);
@@ -553,7 +481,6 @@ void tmo_ferradans11(pfs::Array2Df &imR, pfs::Array2Df &imG, pfs::Array2Df &imB,
         fftwf_free(U6);
         fftwf_free(U7);
 
-        FFTW_MUTEX::fftw_mutex_destroy_plan.unlock();
         return;
     }
     float delta = 0.f, oldDifference = 0.f;
@@ -578,33 +505,33 @@ void tmo_ferradans11(pfs::Array2Df &imR, pfs::Array2Df &imG, pfs::Array2Df &imB,
             transform(u5, u5 + length, u0, u6, multiplies<float>());
             transform(u6, u6 + length, u0, u7, multiplies<float>());
 
-            fftwf_execute(pU);
+            fftwf_execute_dft_r2c(pU.get(), u0, U);
             producto(U, G, fil, col);
-            fftwf_execute(pinvU);
+            fftwf_execute_dft_c2r(pinvU.get(), U, iu);
 
-            fftwf_execute(pU2);
+            fftwf_execute_dft_r2c(pU.get(), u2, U2);
             producto(U2, G, fil, col);
-            fftwf_execute(pinvU2);
+            fftwf_execute_dft_c2r(pinvU.get(), U2, u2);
 
-            fftwf_execute(pU3);
+            fftwf_execute_dft_r2c(pU.get(), u3, U3);
             producto(U3, G, fil, col);
-            fftwf_execute(pinvU3);
+            fftwf_execute_dft_c2r(pinvU.get(), U3, u3);
 
-            fftwf_execute(pU4);
+            fftwf_execute_dft_r2c(pU.get(), u4, U4);
             producto(U4, G, fil, col);
-            fftwf_execute(pinvU4);
+            fftwf_execute_dft_c2r(pinvU.get(), U4, u4);
 
-            fftwf_execute(pU5);
+            fftwf_execute_dft_r2c(pU.get(), u5, U5);
             producto(U5, G, fil, col);
-            fftwf_execute(pinvU5);
+            fftwf_execute_dft_c2r(pinvU.get(), U5, u5);
 
-            fftwf_execute(pU6);
+            fftwf_execute_dft_r2c(pU.get(), u6, U6);
             producto(U6, G, fil, col);
-            fftwf_execute(pinvU6);
+            fftwf_execute_dft_c2r(pinvU.get(), U6, u6);
 
-            fftwf_execute(pU7);
+            fftwf_execute_dft_r2c(pU.get(), u7, U7);
             producto(U7, G, fil, col);
-            fftwf_execute(pinvU7);
+            fftwf_execute_dft_c2r(pinvU.get(), U7, u7);
 
 #pragma omp parallel for
             for (int i = 0; i < length; i++) {
@@ -640,23 +567,6 @@ void tmo_ferradans11(pfs::Array2Df &imR, pfs::Array2Df &imG, pfs::Array2Df &imB,
         if (iteration > 1) ph.setValue(30 + 69 / (steps + 1));
     }
 
-    FFTW_MUTEX::fftw_mutex_destroy_plan.lock();
-    fftwf_destroy_plan(pU);
-    fftwf_destroy_plan(pU2);
-    fftwf_destroy_plan(pU3);
-    fftwf_destroy_plan(pU4);
-    fftwf_destroy_plan(pU5);
-    fftwf_destroy_plan(pU6);
-    fftwf_destroy_plan(pU7);
-
-    fftwf_destroy_plan(pinvU);
-    fftwf_destroy_plan(pinvU2);
-    fftwf_destroy_plan(pinvU3);
-    fftwf_destroy_plan(pinvU4);
-    fftwf_destroy_plan(pinvU5);
-    fftwf_destroy_plan(pinvU6);
-    fftwf_destroy_plan(pinvU7);
-
     fftwf_free(RGB0);
     fftwf_free(u0);
     fftwf_free(u2);
@@ -676,7 +586,6 @@ void tmo_ferradans11(pfs::Array2Df &imR, pfs::Array2Df &imG, pfs::Array2Df &imB,
     fftwf_free(U6);
     fftwf_free(U7);
 
-    FFTW_MUTEX::fftw_mutex_destroy_plan.unlock();
 
     ph.setValue(90);
 
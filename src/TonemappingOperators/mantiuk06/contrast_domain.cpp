@@ -62,10 +62,13 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 #include <vector>
 
 #ifdef _OPENMP
@@ -88,6 +91,7 @@
 #include "Libpfs/utils/msec_timer.h"
 #include "Libpfs/utils/numeric.h"
 #include "Libpfs/utils/sse.h"
+#include "Libpfs/utils/trace.h"
 #include "Libpfs/rt_algo.h"
 
 using namespace pfs;
@@ -104,7 +108,7 @@ void multiplyA(PyramidT &px, const PyramidT &pC, const Array2Df &x,
     px.computeSumOfDivergence(sumOfDivG);
 }
 
-// conjugate linear equation solver overwrites pyramid!
+// conjugate linear equation solver
 //
 // This version is a slightly modified version by
 // Davide Anastasia <davideanastasia@users.sourceforge.net>
@@ -114,8 +118,21 @@ namespace {
 const int NUM_BACKWARDS_CEILING = 3;
 }
 
-void lincg(PyramidT &pyramid, PyramidT &pC, const Array2Df &b, Array2Df &x,
-           const int itmax, const float tol, Progress &ph) {
+//! \brief outcome of a run of lincg()
+struct LincgResult {
+    int iterations;
+    //! \brief ||b - Ax|| / ||b|| of the solution returned
+    float residual;
+};
+
+//! \brief solve Ax = b on the levels of \a pC from \a level to the coarsest
+//! one, starting from \a x
+//! \note only the first level of the pyramid drives the progress bar, the
+//! coarser ones just stop when the user cancels
+LincgResult lincg(const PyramidT &pC, const Array2Df &b, Array2Df &x,
+                  const size_t level, const int itmax, const float tol,
+                  Progress &ph) {
+    utils::TraceScope trace("lincg", "tonemap");
 
     float rdotr_curr;
     float rdotr_prev;
@@ -123,10 +140,11 @@ void lincg(PyramidT &pyramid, PyramidT &pC, const Array2Df &b, Array2Df &x,
     float alpha;
     float beta;
 
-    const size_t rows = pyramid.getRows();
-    const size_t cols = pyramid.getCols();
+    const size_t rows = x.getRows();
+    const size_t cols = x.getCols();
     const size_t n = rows * cols;
     const float tol2 = tol * tol;
+    const bool showProgress = (level == 0);
 
     Array2Df x_best(cols, rows);
     Array2Df r(cols, rows);
@@ -137,7 +155,7 @@ void lincg(PyramidT &pyramid, PyramidT &pC, const Array2Df &b, Array2Df &x,
     const float bnrm2 = utils::dotProduct(b.data(), n);
 
     // r = b - Ax
-    multiplyA(pyramid, pC, x, r);                  // r = A x
+    pC.computeScaledSumOfDivergence(x, r, level);  // r = A x
     utils::vsub(b.data(), r.data(), r.data(), n);  // r = b - r
 
     // rdotr = r.r
@@ -148,22 +166,30 @@ void lincg(PyramidT &pyramid, PyramidT &pC, const Array2Df &b, Array2Df &x,
     std::copy(x.begin(), x.end(), x_best.begin());  // x_best = x
 
     const float irdotr = rdotr_curr;
-    int phvalue = ph.value() + 8;
+    int phvalue = ph.value();
     const float percent_sf = (100.0f - phvalue) / std::log(tol2 * bnrm2 / irdotr);
 
+    // a warm start can be a solution already
+    const bool converged = (rdotr_curr / bnrm2 < tol2);
+
     int iter = 0;
+    int iterations = 0;
     int num_backwards = 0;
-    for (; iter < itmax; ++iter) {
+    for (; iter < itmax && !converged; ++iter) {
         // TEST
-        ph.setValue(
-            static_cast<int>(phvalue + std::max(std::log(rdotr_curr / irdotr) * percent_sf, 0.f)));
+        if (showProgress) {
+            ph.setValue(static_cast<int>(
+                phvalue +
+                std::max(std::log(rdotr_curr / irdotr) * percent_sf, 0.f)));
+        }
         // User requested abort
         if (ph.canceled() && iter > 0) {
             break;
         }
 
         // Ap = A p
-        multiplyA(pyramid, pC, p, Ap);
+        pC.computeScaledSumOfDivergence(p, Ap, level);
+        ++iterations;
 
         // alpha = r.r / (p . Ap)
         alpha = rdotr_curr / utils::dotProduct(p.data(), Ap.data(), n);
@@ -201,7 +227,7 @@ void lincg(PyramidT &pyramid, PyramidT &pC, const Array2Df &b, Array2Df &x,
             std::copy(x_best.begin(), x_best.end(), x.begin());
 
             // r = Ax
-            multiplyA(pyramid, pC, x, r);
+            pC.computeScaledSumOfDivergence(x, r, level);
 
             // r = b - r
             utils::vsub(b.data(), r.data(), r.data(), n);
@@ -224,7 +250,16 @@ void lincg(PyramidT &pyramid, PyramidT &pC, const Array2Df &b, Array2Df &x,
         std::copy(x_best.begin(), x_best.end(), x.begin());
     }
 
-    if (rdotr_curr / bnrm2 > tol2) {
+    const LincgResult result = {iterations, std::sqrt(rdotr_curr / bnrm2)};
+    if (trace.isEnabled()) {
+        std::ostringstream detail;
+        detail << cols << "x" << rows << ", level " << level << ", "
+               << result.iterations << " iterations, residual "
+               << result.residual;
+        trace.setDetail(detail.str());
+    }
+
+    if (showProgress && rdotr_curr / bnrm2 > tol2) {
         // Not converged
         ph.setValue(
             static_cast<int>(std::log(rdotr_curr / irdotr) * percent_sf));
@@ -232,20 +267,96 @@ void lincg(PyramidT &pyramid, PyramidT &pC, const Array2Df &b, Array2Df &x,
             std::cerr << std::endl
                       << "pfstmo_mantiuk06: Warning: Not "
                          "converged (hit maximum iterations), error = "
-                      << std::sqrt(rdotr_curr / bnrm2) << " (should be below "
-                      << tol << ")" << std::endl;
+                      << result.residual << " (should be below " << tol
+                      << ")" << std::endl;
         } else {
             std::cerr << std::endl
                       << "pfstmo_mantiuk06: Warning: Not converged "
                          "(going unstable), error = "
-                      << std::sqrt(rdotr_curr / bnrm2) << " (should be below "
-                      << tol << ")" << std::endl;
+                      << result.residual << " (should be below " << tol
+                      << ")" << std::endl;
         }
     }
+    return result;
+}
+
+namespace {
+//! \brief fingerprint of the log luminance of a frame (FNV-1a on the words
+//! of its samples)
+uint64_t fingerprint(const Array2Df &Y) {
+    uint64_t hash = 14695981039346656037ULL;
+    const uint64_t prime = 1099511628211ULL;
+
+    hash = (hash ^ Y.getCols()) * prime;
+    hash = (hash ^ Y.getRows()) * prime;
+    for (Array2Df::const_iterator it = Y.begin(); it != Y.end(); ++it) {
+        uint32_t word;
+        std::memcpy(&word, &*it, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    return hash;
+}
+
+//! \brief add to \a x, the starting point of a level, what the coarser level
+//! solved: \a coarser (overwritten) minus \a coarserStart, upsampled
+void addCoarseCorrection(const Array2Df &coarserStart, Array2Df &coarser,
+                         Array2Df &x) {
+    utils::vsub(coarser.data(), coarserStart.data(), coarser.data(),
+                coarser.size());
+
+    Array2Df correction(x.getCols(), x.getRows());
+    matrixUpsample(x.getCols(), x.getRows(), coarser.data(),
+                   correction.data());
+    utils::vadd(x.data(), correction.data(), x.data(), x.size());
+}
+
+//! \brief ||b - Ax|| / ||b|| on the first level of \a pC
+float residual(const PyramidT &pC, const Array2Df &b, const Array2Df &x) {
+    Array2Df r(x.getCols(), x.getRows());
+    pC.computeScaledSumOfDivergence(x, r);
+    utils::vsub(b.data(), r.data(), r.data(), r.size());
+    return std::sqrt(utils::dotProduct(r.data(), r.size()) /
+                     utils::dotProduct(b.data(), b.size()));
+}
+}
+
+Mantiuk06WarmStart::Mantiuk06WarmStart() : m_key(0) {}
+
+bool Mantiuk06WarmStart::restore(uint64_t key, Array2Df &x) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_solution.size() == 0 || m_key != key ||
+        m_solution.getCols() != x.getCols() ||
+        m_solution.getRows() != x.getRows()) {
+        return false;
+    }
+    std::copy(m_solution.begin(), m_solution.end(), x.begin());
+    return true;
 }
 
+void Mantiuk06WarmStart::store(uint64_t key, const Array2Df &x) {
+    Array2Df solution(x.getCols(), x.getRows());
+    std::copy(x.begin(), x.end(), solution.begin());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_key = key;
+    m_solution.swap(solution);
+}
+
+//! \brief solve the system of each level of the pyramid, from the coarsest
+//! one to the first one.
+//!
+//! The system of a level takes into account the gradients of the level and
+//! of the coarser ones: its solution is the coarse part of the solution of
+//! the finer level, which only has to add the gradients of its own level.
+//! Each level starts from \a Y downsampled, corrected by what the coarser
+//! level solved, or from the solution in \a warmStart (if any) of the
+//! previous run on the same frame. The gradients of the pyramid are scaled
+//! by \a pC, the target gradients (\a pp) are already scaled.
 void transformToLuminance(PyramidT &pp, Array2Df &Y, const int itmax,
-                          const float tol, Progress &ph) {
+                          const float tol, Mantiuk06WarmStart *warmStart,
+                          Progress &ph) {
+    utils::TraceScope trace("transformToLuminance", "tonemap");
+
     PyramidT pC = pp;  // copy ctor
 
     pp.computeScaleFactors(pC);
@@ -253,14 +364,70 @@ void transformToLuminance(PyramidT &pp, Array2Df &Y, const int itmax,
     // pyramidScaleGradient(pp, pC);
     pp.multiply(pC);
 
+    const size_t numLevels = pp.numLevels();
+    if (numLevels == 0) return;
+
+    // start from the solution of the previous run on the same frame
+    const uint64_t key = warmStart ? fingerprint(Y) : 0;
+    const bool warm = warmStart && warmStart->restore(key, Y);
+
     // size of the first level of the pyramid
     Array2Df b(pp.getCols(), pp.getRows());
 
     // calculate the sum of divergences (equal to b)
-    pp.computeSumOfDivergence(b);
+    pp.computeSumOfDivergence(b, 0);
+
+    // the coarse levels would move a solution that is already good enough
+    if (warm && residual(pC, b, Y) < tol) {
+        if (trace.isEnabled()) trace.setDetail("warm start, converged");
+        return;
+    }
+
+    // starting point of each level: Y downsampled
+    std::vector<Array2Df> start(numLevels);
+    PyramidT::const_iterator level = pp.begin();
+    for (size_t idx = 1; idx < numLevels; ++idx) {
+        const Array2Df &finer = (idx == 1) ? Y : start[idx - 1];
+        start[idx].resize((level + idx)->getCols(), (level + idx)->getRows());
+        matrixDownsample(finer.getCols(), finer.getRows(), finer.data(),
+                         start[idx].data());
+    }
+
+    const int phvalue = ph.value();
+    int coarseIterations = 0;
+    Array2Df coarser;  // solution of the coarser level
+    for (size_t idx = numLevels - 1; idx > 0; --idx) {
+        Array2Df x(start[idx].getCols(), start[idx].getRows());
+        std::copy(start[idx].begin(), start[idx].end(), x.begin());
+        if (idx + 1 < numLevels) {
+            addCoarseCorrection(start[idx + 1], coarser, x);
+        }
+
+        Array2Df bLevel(x.getCols(), x.getRows());
+        pp.computeSumOfDivergence(bLevel, idx);
+        coarseIterations +=
+            lincg(pC, bLevel, x, idx, itmax, tol, ph).iterations;
+        if (ph.canceled()) return;
+
+        coarser.swap(x);
+        ph.setValue(phvalue + 8 * (numLevels - idx) / numLevels);
+    }
+    if (numLevels > 1) {
+        addCoarseCorrection(start[1], coarser, Y);
+    }
+    const LincgResult result = lincg(pC, b, Y, 0, itmax, tol, ph);
+
+    if (trace.isEnabled()) {
+        std::ostringstream detail;
+        detail << (warm ? "warm" : "cold") << " start, " << numLevels
+               << " levels, " << coarseIterations
+               << " iterations on the coarse levels, " << result.iterations
+               << " iterations, residual " << result.residual;
+        trace.setDetail(detail.str());
+    }
 
-    // calculate luminances from gradients
-    lincg(pp, pC, b, Y, itmax, tol, ph);
+    // a canceled solve is not a solution to start from
+    if (warmStart && !ph.canceled()) warmStart->store(key, Y);
 }
 
 struct HistData {
@@ -439,7 +606,8 @@ void denormalizeRGB(Array2Df &R, Array2Df &G, Array2Df &B, const Array2Df &Y,
 int tmo_mantiuk06_contmap(Array2Df &R, Array2Df &G, Array2Df &B, Array2Df &Y,
                           const float contrastFactor,
                           const float saturationFactor, float detailfactor,
-                          const int itmax, const float tol, Progress &ph) {
+                          const int itmax, const float tol, Progress &ph,
+                          Mantiuk06WarmStart *warmStart) {
 #ifdef TIMER_PROFILING
     msec_timer stop_watch;
     stop_watch.start();
@@ -483,7 +651,7 @@ int tmo_mantiuk06_contmap(Array2Df &R, Array2Df &G, Array2Df &B, Array2Df &Y,
     ph.setValue(40);
 
     // transform gradients to luminance Y (pp -> Y)
-    transformToLuminance(pp, Y, itmax, tol, ph);
+    transformToLuminance(pp, Y, itmax, tol, warmStart, ph);
     denormalizeLuminance(Y);
     denormalizeRGB(R, G, B, Y, saturationFactor);
 
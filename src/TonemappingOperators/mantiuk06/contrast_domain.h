@@ -34,12 +34,43 @@
  * $Id: contrast_domain.h,v 1.7 2008/06/16 22:17:47 rafm Exp $
  */
 
-#ifndef CONTRAST_DOMAIN_H
-#define CONTRAST_DOMAIN_H
+#ifndef MANTIUK06_CONTRAST_DOMAIN_H
+#define MANTIUK06_CONTRAST_DOMAIN_H
 
-#include <Libpfs/array2d_fwd.h>
+#include <cstdint>
+#include <mutex>
+
+#include <Libpfs/array2d.h>
 #include "TonemappingOperators/pfstmo.h"
 
+//! \brief Solution of the last frame tone mapped in a session.
+//!
+//! Moving a slider of the operator tone maps the same frame again with new
+//! parameters: the previous solution is much closer to the new one than the
+//! log luminance of the frame, and the solver starts from there. When only
+//! the saturation changes, the solution is the same and the solver has
+//! nothing left to do.
+//!
+//! The caller owns it and keeps it for as long as the session lasts (the
+//! tone mapping panel): independent runs (batch, command line) do not share
+//! one, or their result would depend on the order they run in.
+class Mantiuk06WarmStart {
+   public:
+    Mantiuk06WarmStart();
+
+    //! \brief copy into \a x the solution of the frame \a key
+    //! \return false if the last frame tone mapped is not \a key
+    bool restore(uint64_t key, pfs::Array2Df &x) const;
+
+    //! \brief keep a copy of \a x, the solution of the frame \a key
+    void store(uint64_t key, const pfs::Array2Df &x);
+
+   private:
+    mutable std::mutex m_mutex;
+    uint64_t m_key;
+    pfs::Array2Df m_solution;
+};
+
 //! \brief: Tone mapping algorithm [Mantiuk2006]
 //!
 //! \param R red channel
@@ -51,6 +82,8 @@
 //! \param itmax maximum number of iterations for convergence (typically 50)
 //! \param tol tolerence to get within for convergence (typically 1e-3)
 //! \param ph callback class that reports progress
+//! \param warmStart solution of the previous run of the session (updated),
+//! NULL to solve from scratch
 //! \return PFSTMO_OK if tone-mapping was sucessful, PFSTMO_ABORTED if
 //! it was stopped from a callback function and PFSTMO_ERROR if an
 //! error was encountered.
@@ -59,6 +92,7 @@ int tmo_mantiuk06_contmap(pfs::Array2Df &R, pfs::Array2Df &G, pfs::Array2Df &B,
                           pfs::Array2Df &Y, float contrastFactor,
                           float saturationFactor, float detailFactor,
                           int itmax /*= 200*/, float tol /*= 1e-3*/,
-                          pfs::Progress &ph);
+                          pfs::Progress &ph,
+                          Mantiuk06WarmStart *warmStart = 0);
 
 #endif
@@ -60,7 +60,7 @@ const float tol = 5e-3f;
 
 void pfstmo_mantiuk06(pfs::Frame &frame, float scaleFactor,
                       float saturationFactor, float detailFactor, bool cont_eq,
-                      pfs::Progress &ph) {
+                      pfs::Progress &ph, Mantiuk06WarmStart *warmStart) {
 
 #ifndef NDEBUG
     std::stringstream ss;
@@ -98,7 +98,8 @@ void pfstmo_mantiuk06(pfs::Frame &frame, float scaleFactor,
 
     try {
         tmo_mantiuk06_contmap(*inRed, *inGreen, *inBlue, inY, scaleFactor,
-                              saturationFactor, detailFactor, itmax, tol, ph);
+                              saturationFactor, detailFactor, itmax, tol, ph,
+                              warmStart);
     } catch (...) {
         throw pfs::Exception("Tonemapping Failed!");
     }
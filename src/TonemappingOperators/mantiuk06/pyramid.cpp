@@ -40,7 +40,6 @@
 #endif
 
 #include "Libpfs/array2d.h"
-#include "Libpfs/utils/numeric.h"
 #include "Libpfs/utils/sse.h"
 #include "../../sleef.c"
 #define pow_F(a,b) (xexpf(b*xlogf(a)))
@@ -119,7 +118,7 @@ float transformToRn(float currG, float detailFactor){
     return mult * lookup_table(LOOKUP_W_TO_R, W_table, R_table, currG);
 }
 
-// transform gradient R to G
+// transform gradient R to G, \a detailFactor being 1 / (ln(10) * detail)
 float transformToGn(float currR, float detailFactor){
     const float mult = copysign(1.f, currR);
     // RESP to W
@@ -209,6 +208,69 @@ void PyramidT::computeSumOfDivergence(pfs::Array2Df &sumOfdivG) {
     }
 }
 
+void PyramidT::computeSumOfDivergence(pfs::Array2Df &sumOfDivG,
+                                      size_t level) const {
+    assert(level < numLevels());
+    assert(sumOfDivG.getCols() == m_pyramid[level].getCols());
+    assert(sumOfDivG.getRows() == m_pyramid[level].getRows());
+
+    pfs::Array2Df coarser;
+    for (size_t idx = numLevels(); idx-- > level;) {
+        const PyramidS &G = m_pyramid[idx];
+        pfs::Array2Df current(G.getCols(), G.getRows());
+        if (idx + 1 == numLevels()) {
+            current.fill(0.0f);
+        } else {
+            matrixUpsample(G.getCols(), G.getRows(), coarser.data(),
+                           current.data());
+        }
+        calculateAndAddDivergence(G, current.data());
+        coarser.swap(current);
+    }
+    sumOfDivG.swap(coarser);
+}
+
+void PyramidT::computeScaledSumOfDivergence(const pfs::Array2Df &inputData,
+                                            pfs::Array2Df &sumOfDivG,
+                                            size_t level) const {
+    assert(level < numLevels());
+    assert(inputData.getCols() == m_pyramid[level].getCols());
+    assert(inputData.getRows() == m_pyramid[level].getRows());
+    assert(sumOfDivG.getCols() == m_pyramid[level].getCols());
+    assert(sumOfDivG.getRows() == m_pyramid[level].getRows());
+
+    // input data downsampled to the size of the following levels
+    std::vector<pfs::Array2Df> downsampled;
+    downsampled.reserve(numLevels() - level - 1);
+    const float *source = inputData.data();
+    for (size_t idx = level + 1; idx < numLevels(); ++idx) {
+        downsampled.emplace_back(m_pyramid[idx].getCols(),
+                                 m_pyramid[idx].getRows());
+        matrixDownsample(m_pyramid[idx - 1].getCols(),
+                         m_pyramid[idx - 1].getRows(), source,
+                         downsampled.back().data());
+        source = downsampled.back().data();
+    }
+
+    pfs::Array2Df coarser;
+    for (size_t idx = numLevels(); idx-- > level;) {
+        const PyramidS &C = m_pyramid[idx];
+        pfs::Array2Df current(C.getCols(), C.getRows());
+        if (idx + 1 == numLevels()) {
+            current.fill(0.0f);
+        } else {
+            matrixUpsample(C.getCols(), C.getRows(), coarser.data(),
+                           current.data());
+        }
+        const float *input = (idx == level)
+                                 ? inputData.data()
+                                 : downsampled[idx - level - 1].data();
+        calculateAndAddScaledDivergence(input, C, current.data());
+        coarser.swap(current);
+    }
+    sumOfDivG.swap(coarser);
+}
+
 void PyramidT::computeScaleFactors(PyramidT &result) const {
     PyramidContainer::const_iterator inCurr = m_pyramid.begin();
     PyramidContainer::const_iterator inEnd = m_pyramid.end();
@@ -258,6 +320,9 @@ void PyramidT::transformToG(float detailFactor) {
     PyramidContainer::iterator itCurr = m_pyramid.begin();
     PyramidContainer::iterator itEnd = m_pyramid.end();
 
+    // here we are actually changing the base of logarithm
+    const float invLog10 = 1.f / (LOG10FACTOR * detailFactor);
+
     while (itCurr != itEnd) {
         #pragma omp parallel for
         for(size_t i = 0; i < itCurr->getRows(); i++) {
@@ -265,8 +330,8 @@ void PyramidT::transformToG(float detailFactor) {
             PyramidS::iterator endGxy = itCurr->row_end(i);
 
             while (currGxy != endGxy) {
-                currGxy->gX() = transformToGn(currGxy->gX(), detailFactor);
-                currGxy->gY() = transformToGn(currGxy->gY(), detailFactor);
+                currGxy->gX() = transformToGn(currGxy->gX(), invLog10);
+                currGxy->gY() = transformToGn(currGxy->gY(), invLog10);
                 ++currGxy;
             }
         }
@@ -274,20 +339,11 @@ void PyramidT::transformToG(float detailFactor) {
     }
 }
 
-struct ScalePyramidS {
-    ScalePyramidS(float multiplier) : multiplier_(multiplier) {}
-
-    void operator()(PyramidS &multiply) {
-        pfs::utils::vsmul(multiply.data(), multiplier_, multiply.data(),
-                          multiply.size());
-    }
-
-   private:
-    float multiplier_;
-};
-
 void PyramidT::scale(float multiplier) {
-    for_each(m_pyramid.begin(), m_pyramid.end(), ScalePyramidS(multiplier));
+    for (PyramidContainer::iterator it = m_pyramid.begin();
+         it != m_pyramid.end(); ++it) {
+        *it *= multiplier;
+    }
 }
 
 // scale gradients for the whole one pyramid with the use of (Cx,Cy)
@@ -304,17 +360,7 @@ void PyramidT::multiply(const PyramidT &other) {
     PyramidContainer::iterator outCurr = m_pyramid.begin();
 
     for (; inCurr != inEnd; ++outCurr, ++inCurr) {
-        PyramidContainer::value_type::const_iterator innerItOther =
-            inCurr->begin();
-        PyramidContainer::value_type::iterator innerIt = outCurr->begin();
-        PyramidContainer::value_type::iterator innerItEnd = outCurr->end();
-
-        while (innerIt != innerItEnd) {
-            *innerIt *= *innerItOther;
-
-            innerIt++;
-            innerItOther++;
-        }
+        *outCurr *= *inCurr;
     }
 }
 
@@ -578,3 +624,39 @@ void calculateAndAddDivergence(const PyramidS &G, float *divG) {
         }
     }
 }
+
+void calculateAndAddScaledDivergence(const float *inputData,
+                                     const PyramidS &C, float *divG) {
+    const int ROWS = C.getRows();
+    const int COLS = C.getCols();
+
+#pragma omp parallel for
+    for (int ky = 0; ky < ROWS; ky++) {
+        const float *currLum = inputData + ky * COLS;
+        const XYGradient *currC = C.data() + ky * COLS;
+        float *currDivG = divG + ky * COLS;
+
+        // the gradients of the last column and of the last row are zero, as
+        // in calculateGradients()
+        const bool hasLower = ky < ROWS - 1;
+        const bool hasUpper = ky > 0;
+
+        float prevGx = 0.0f;
+        for (int kx = 0; kx < COLS; kx++) {
+            const float gX =
+                (kx < COLS - 1)
+                    ? (currLum[kx + 1] - currLum[kx]) * currC[kx].gX()
+                    : 0.0f;
+            const float gY =
+                hasLower ? (currLum[kx + COLS] - currLum[kx]) * currC[kx].gY()
+                         : 0.0f;
+            const float upperGy =
+                hasUpper ? (currLum[kx] - currLum[kx - COLS]) *
+                               currC[kx - COLS].gY()
+                         : 0.0f;
+
+            currDivG[kx] += (gX - prevGx) + (gY - upperGy);
+            prevGx = gX;
+        }
+    }
+}
@@ -106,6 +106,22 @@ class PyramidT {
     //! \param[out] data input vector of data
     void computeSumOfDivergence(pfs::Array2Df &sumOfDivG);
 
+    //! \brief sum of the divergences of the levels from \a level to the
+    //! coarsest one, upsampled to the size of \a level
+    //! \note with \a level equal to 0, same as computeSumOfDivergence()
+    void computeSumOfDivergence(pfs::Array2Df &sumOfDivG, size_t level) const;
+
+    //! \brief sum of the divergences of the gradients of \a inputData scaled
+    //! by this pyramid, as computeGradients(), multiply() and
+    //! computeSumOfDivergence() would do on a pyramid of \a inputData, but in
+    //! a single pass on each level, without storing the gradients
+    //! \param[in] inputData vector of the size of \a level
+    //! \param[out] sumOfDivG vector of the size of \a level
+    //! \param[in] level first level of the pyramid taken into account
+    void computeScaledSumOfDivergence(const pfs::Array2Df &inputData,
+                                      pfs::Array2Df &sumOfDivG,
+                                      size_t level = 0) const;
+
     //! \param[out] result PyramidT structure that contains the scaling factors!
     void computeScaleFactors(PyramidT &result) const;
 
@@ -144,5 +160,10 @@ void matrixUpsample(size_t outCols, size_t outRows, const float *inputData,
 void calculateGradients(const float *inputData, PyramidS &gradient);
 //
 void calculateAndAddDivergence(const PyramidS &G, float *divG);
+//! \brief add to \a divG the divergence of the gradients of \a inputData
+//! scaled by \a C (same as calculateGradients(), a multiplication by \a C
+//! and calculateAndAddDivergence())
+void calculateAndAddScaledDivergence(const float *inputData,
+                                     const PyramidS &C, float *divG);
 
 #endif  // MANTIUK06_PYRAMID_H
@@ -33,6 +33,7 @@ namespace pfs {
 class Frame;
 class Progress;
 }
+class Mantiuk06WarmStart;
 
 #ifdef BRANCH_PREDICTION
 #define likely(x) __builtin_expect((x), 1)
@@ -51,10 +52,19 @@ void pfstmo_ashikhmin02(pfs::Frame &frame, bool simple_flag, float lc_value,
                         int eq, pfs::Progress &ph);
 void pfstmo_drago03(pfs::Frame &frame, float biasValue, pfs::Progress &ph);
 void pfstmo_durand02(pfs::Frame &frame, float sigma_s, float sigma_r,
-                     float baseContrast, pfs::Progress &ph);
+                     float baseContrast, bool bilateralgrid,
+                     pfs::Progress &ph);
+//! \brief Poisson solvers of pfstmo_fattal02(). The first two values are
+//! those of the former fftsolver flag.
+enum Fattal02Solver {
+    FATTAL02_SOLVER_MULTIGRID = 0,  //!< multigrid of the versions before 2.3.0
+    FATTAL02_SOLVER_FFT = 1,
+    FATTAL02_SOLVER_REDBLACK = 2  //!< red-black multigrid, pde of the fft
+};
+
 void pfstmo_fattal02(pfs::Frame &frame, float opt_alpha, float opt_beta,
                      float opt_saturation, float opt_noise, bool newfattal,
-                     bool fftsolver, int detail_level, pfs::Progress &ph);
+                     int fftsolver, int detail_level, pfs::Progress &ph);
 void pfstmo_ferradans11(pfs::Frame &frame, float opt_rho, float opt_inv_alpha,
                         pfs::Progress &ph);
 void pfstmo_ferwerda96(pfs::Frame &frame, float Ld_Max, float L_da,
@@ -64,7 +74,7 @@ void pfstmo_kimkautz08(pfs::Frame &frame, float KK_c1, float KK_c2,
 void pfstmo_mai11(pfs::Frame &frame, pfs::Progress &ph);
 void pfstmo_mantiuk06(pfs::Frame &frame, float scaleFactor,
                       float saturationFactor, float detailFactor, bool cont_eq,
-                      pfs::Progress &ph);
+                      pfs::Progress &ph, Mantiuk06WarmStart *warmStart = 0);
 void pfstmo_mantiuk08(pfs::Frame &frame, float saturation_factor,
                       float contrast_enhance_factor, float white_y,
                       bool setluminance, pfs::Progress &ph);
@@ -45,13 +45,13 @@
 
 #include "tmo_reinhard02.h"
 
+#include <Common/fftwplans.h>
 #include <Common/init_fftw.h>
 #include <Libpfs/array2d.h>
 #include <Libpfs/array2d_fwd.h>
 #include <Libpfs/progress.h>
 #include <Libpfs/utils/msec_timer.h>
 #include <TonemappingOperators/pfstmo.h>
-#include "Common/LuminanceOptions.h"
 #include "../../sleef.c"
 #include "../../opthelper.h"
 #ifdef TIMER_PROFILING
@@ -165,31 +165,13 @@ void Reinhard02::build_gaussian_fft() {
 #endif
 
         m_ph.setValue(30 + 40 * scale / m_range);
-        fftwf_plan p;
-        FFTW_MUTEX::fftw_mutex_plan.lock();
-        // test for available wisdom
-        p = fftwf_plan_dft_2d(m_cvts.ymax, m_cvts.xmax, m_filter_fft[scale], m_filter_fft[scale], -1, FFTW_WISDOM_ONLY);
-        if(!p) {
-            // no wisdom available, load wisdom from file
-            fftwf_import_wisdom_from_filename(LuminanceOptions().getFftwWisdomFileName().toStdString().c_str());
-            // test again for wisdom
-            p = fftwf_plan_dft_2d(m_cvts.ymax, m_cvts.xmax, m_filter_fft[scale], m_filter_fft[scale], -1, FFTW_WISDOM_ONLY);
-            if(!p) {
-                // build plan with FFTW_MEASURE
-                p = fftwf_plan_dft_2d(m_cvts.ymax, m_cvts.xmax, m_filter_fft[scale], m_filter_fft[scale], -1, FFTW_MEASURE);
-                // save the wisdom
-                fftwf_export_wisdom_to_filename(LuminanceOptions().getFftwWisdomFileName().toStdString().c_str());
-            }
-        }
-        FFTW_MUTEX::fftw_mutex_plan.unlock();
+        FftwPlans::Plan p = FftwPlans::instance().dft2d(
+            m_cvts.ymax, m_cvts.xmax, m_filter_fft[scale], m_filter_fft[scale],
+            FFTW_FORWARD, FFTW_MEASURE);
 
         gaussian_filter(m_filter_fft[scale], S_I(scale), m_k);
 
-        fftwf_execute(p);
-
-        FFTW_MUTEX::fftw_mutex_destroy_plan.lock();
-        fftwf_destroy_plan(p);
-        FFTW_MUTEX::fftw_mutex_destroy_plan.unlock();
+        fftwf_execute_dft(p.get(), m_filter_fft[scale], m_filter_fft[scale]);
 
     }
 #ifndef NDEBUG
@@ -202,53 +184,25 @@ void Reinhard02::build_image_fft() {
 #ifndef NDEBUG
     fprintf(stderr, "Computing image FFT\n");
 #endif
-    fftwf_plan p;
-    FFTW_MUTEX::fftw_mutex_plan.lock();
-    p = fftwf_plan_dft_2d(m_cvts.ymax, m_cvts.xmax, m_image_fft, m_image_fft, -1, FFTW_WISDOM_ONLY);
-    if(!p) {
-        // no wisdom available, load wisdom from file
-        fftwf_import_wisdom_from_filename(LuminanceOptions().getFftwWisdomFileName().toStdString().c_str());
-        // test again for wisdom
-        p = fftwf_plan_dft_2d(m_cvts.ymax, m_cvts.xmax, m_image_fft, m_image_fft, -1, FFTW_WISDOM_ONLY);
-        if(!p) {
-            // build plan with FFTW_MEASURE
-            p = fftwf_plan_dft_2d(m_cvts.ymax, m_cvts.xmax, m_image_fft, m_image_fft, -1, FFTW_MEASURE);
-            // save the wisdom
-            fftwf_export_wisdom_to_filename(LuminanceOptions().getFftwWisdomFileName().toStdString().c_str());
-        }
-    }
-    FFTW_MUTEX::fftw_mutex_plan.unlock();
+    FftwPlans::Plan p = FftwPlans::instance().dft2d(
+        m_cvts.ymax, m_cvts.xmax, m_image_fft, m_image_fft, FFTW_FORWARD,
+        FFTW_MEASURE);
 
     #pragma omp parallel for
     for (int y = 0; y < m_cvts.ymax; y++)
-        for (int x = 0; x < m_cvts.xmax; x++)
+        for (int x = 0; x < m_cvts.xmax; x++) {
             m_image_fft[y * m_cvts.xmax + x][0] = m_image[y][x];
+            m_image_fft[y * m_cvts.xmax + x][1] = 0.f;
+        }
 
-    fftwf_execute(p);
-
-    FFTW_MUTEX::fftw_mutex_destroy_plan.lock();
-    fftwf_destroy_plan(p);
-    FFTW_MUTEX::fftw_mutex_destroy_plan.unlock();
+    fftwf_execute_dft(p.get(), m_image_fft, m_image_fft);
 }
 
 void Reinhard02::convolve_filter(int scale, fftwf_complex *convolution_fft) {
 
-    fftwf_plan p;
-    FFTW_MUTEX::fftw_mutex_plan.lock();
-    p = fftwf_plan_dft_2d(m_cvts.ymax, m_cvts.xmax, convolution_fft, convolution_fft, 1, FFTW_WISDOM_ONLY);
-    if(!p) {
-        // no wisdom available, load wisdom from file
-        fftwf_import_wisdom_from_filename(LuminanceOptions().getFftwWisdomFileName().toStdString().c_str());
-        // test again for wisdom
-        p = fftwf_plan_dft_2d(m_cvts.ymax, m_cvts.xmax, convolution_fft, convolution_fft, 1, FFTW_WISDOM_ONLY);
-        if(!p) {
-            // build plan with FFTW_MEASURE
-            p = fftwf_plan_dft_2d(m_cvts.ymax, m_cvts.xmax, convolution_fft, convolution_fft, 1, FFTW_MEASURE);
-            // save the wisdom
-            fftwf_export_wisdom_to_filename(LuminanceOptions().getFftwWisdomFileName().toStdString().c_str());
-        }
-    }
-    FFTW_MUTEX::fftw_mutex_plan.unlock();
+    FftwPlans::Plan p = FftwPlans::instance().dft2d(
+        m_cvts.ymax, m_cvts.xmax, convolution_fft, convolution_fft,
+        FFTW_BACKWARD, FFTW_MEASURE);
 
     int length = m_cvts.xmax * m_cvts.ymax;
     float fft_scale = 1.f / (float)length;
@@ -261,11 +215,7 @@ void Reinhard02::convolve_filter(int scale, fftwf_complex *convolution_fft) {
                                              m_image_fft[i][1] * m_filter_fft[scale][i][0]);
     }
 
-    fftwf_execute(p);
-
-    FFTW_MUTEX::fftw_mutex_destroy_plan.lock();
-    fftwf_destroy_plan(p);
-    FFTW_MUTEX::fftw_mutex_destroy_plan.unlock();
+    fftwf_execute_dft(p.get(), convolution_fft, convolution_fft);
 
 #pragma omp parallel for
     for (int y = 0; y < m_cvts.ymax; y++)
@@ -275,8 +225,6 @@ void Reinhard02::convolve_filter(int scale, fftwf_complex *convolution_fft) {
 
 void Reinhard02::compute_fourier_convolution() {
 
-    // activate parallel execution of fft routines
-    init_fftw();
     //initialise_fft(m_cvts.xmax, m_cvts.ymax);
     build_image_fft();
 
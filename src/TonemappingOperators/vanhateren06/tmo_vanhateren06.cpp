@@ -29,13 +29,15 @@
 
 #include <assert.h>
 #include <math.h>
+#include <algorithm>
 #include <iostream>
-#include <gsl/gsl_poly.h>
+#include <limits>
 
 #include "Libpfs/array2d.h"
 #include "Libpfs/frame.h"
 #include "Libpfs/progress.h"
-#include "Libpfs/utils/msec_timer.h"
+#include "Libpfs/utils/monotoneinverse.h"
+#include "Libpfs/utils/trace.h"
 #include "Libpfs/utils/clamp.h"
 #include <Libpfs/colorspace/normalizer.h>
 #include "tmo_vanhateren06.h"
@@ -45,11 +47,26 @@ using namespace pfs;
 using namespace pfs::colorspace;
 using namespace std;
 
+namespace {
+//! \brief Left side of the steady state equation of the cone model:
+//! a_C * I_os^5 + I_os^4 = 1 / (C_beta + k_beta * I), increasing for I_os > 0
+struct ConeResponse {
+    explicit ConeResponse(double a_C) : m_a_C(a_C) {}
+
+    double operator()(double x) const {
+        const double x2 = x * x;
+        return x2 * x2 * (1.0 + m_a_C * x);
+    }
+    double derivative(double x) const {
+        return x * x * x * (4.0 + 5.0 * m_a_C * x);
+    }
+
+    double m_a_C;
+};
+}
+
 int tmo_vanhateren06(Array2Df &L, float pupil_area, Progress &ph) {
-#ifdef TIMER_PROFILING
-    msec_timer stop_watch;
-    stop_watch.start();
-#endif
+    pfs::utils::TraceScope trace("tmo_vanhateren06", "tonemap");
 
     if(pupil_area <= 0.0f)
         pupil_area = 10.f; //fixed pupil area 10 mm^2
@@ -62,69 +79,60 @@ int tmo_vanhateren06(Array2Df &L, float pupil_area, Progress &ph) {
     float a_C = 9e-2;
     float C_beta = 2.8e-3; // 1/ms
 
-    //Calculate Ios,max
-    double polIosMax[] = {-1.0/C_beta, 0.0, 0.0, 0.0, 1.0, a_C};
-    gsl_poly_complex_workspace * ws = gsl_poly_complex_workspace_alloc(6);
-    double roots[10];
-    double real_roots[5];
-    gsl_poly_complex_solve (polIosMax, 6, ws, roots);
-    gsl_poly_complex_workspace_free (ws);
-
-    for (int i = 0; i < 10 ; i += 2) {
-        real_roots[i>>1] = roots[i];
-    }
+    if (size == 0 || ph.canceled())
+        return 0;
 
-    float maxIos = (float) *max_element(real_roots, real_roots + 5);
-
-    //conversion from cd/m^2 to trolands (tr)
-    transform(L.begin(), L.end(), L.begin(),
-            [pupil_area](float lori) { return lori * pupil_area; } );
-
-    //Range reduction
-    Array2Df tmpI(w, h);
-    transform(L.begin(), L.end(), tmpI.begin(),
-            [C_beta, k_beta](float l) { return -1.0f / (C_beta + k_beta * l); } );
-
-    double base[] = {0.0, 0.0, 0.0, 0.0, 1.0, a_C};
-
-    gsl_poly_complex_workspace * wsp;
-    #pragma omp parallel for private(base, roots, real_roots, wsp) schedule(dynamic,16)
-    //#pragma omp parallel for private(base, roots, real_roots, wsp) schedule(static)
-    for (size_t i = 0; i < size; i++) {
-        base[0] = 0.0;
-        base[1] = 0.0;
-        base[2] = 0.0;
-        base[3] = 0.0;
-        base[4] = 1.0;
-        base[5] = a_C;
-        wsp = gsl_poly_complex_workspace_alloc(6);
-        base[0] = tmpI(i);
-        gsl_poly_complex_solve (base, 6, wsp, roots);
-        gsl_poly_complex_workspace_free (wsp);
-        for (int k = 0; k < 10; k += 2)
-            real_roots[k>>1] = roots[k];
-
-        L(i) = (float) *max_element(real_roots, real_roots + 5);
-
-        if (i % w == 0)
-            ph.setValue(i*100/size);
-        if (ph.canceled())
-            i = size;
+    // The steady state I_os is the largest real root of the polynomial,
+    // which is its only positive root: it depends on the retinal
+    // illuminance only, and is read from a table of the inverse of the cone
+    // response built on the range of the frame (no root finding per pixel)
+    const float maxL = *max_element(L.begin(), L.end()) * pupil_area;
+    const float minRhs =
+        maxL < numeric_limits<float>::max()
+            ? 1.0f / (C_beta + k_beta * max(maxL, 0.0f))
+            : numeric_limits<float>::min();
+    const pfs::utils::MonotoneInverse<ConeResponse> cone(
+        ConeResponse(a_C), minRhs, 1.0f / C_beta);
+
+    //Calculate Ios,max (I == 0)
+    const float maxIos = (float) cone.solve(1.0 / C_beta);
+
+    ph.setValue(10);
+
+    // progress and cancellation are checked once per block of rows
+    const int blockRows = 32;
+    const int blocks = (int(h) + blockRows - 1) / blockRows;
+    float *data = L.data();
+    int doneBlocks = 0;
+    #pragma omp parallel for schedule(dynamic)
+    for (int b = 0; b < blocks; ++b) {
+        if (ph.canceled()) continue;
+
+        const size_t yEnd = min(size_t(b + 1) * blockRows, h);
+        for (size_t y = size_t(b) * blockRows; y < yEnd; ++y) {
+            float *row = data + y * w;
+            //conversion from cd/m^2 to trolands (tr) and range reduction
+            for (size_t x = 0; x < w; ++x) {
+                row[x] = 1.0f / (C_beta + k_beta * (row[x] * pupil_area));
+            }
+            cone(row, row, w);
+            for (size_t x = 0; x < w; ++x) {
+                row[x] = 1.0f - row[x] / maxIos;
+            }
+        }
+
+        #pragma omp critical
+        {
+            ++doneBlocks;
+            ph.setValue(10 + 90 * doneBlocks / blocks);
+        }
     }
 
     if (ph.canceled())
         return 0;
 
-    transform(L.begin(), L.end(), L.begin(),
-            [maxIos](float i_os) { return (1.0f - i_os/maxIos); } );
-
     ph.setValue(100);
-
-#ifdef TIMER_PROFILING
-    stop_watch.stop_and_update();
-    cout << endl;
-    cout << "tmo_vanhateren06 = " << stop_watch.get_time() << " msec" << endl;
-#endif
+    trace.setBytes(size * sizeof(float));
 
     return 0;
 }
@@ -46,6 +46,8 @@
 #include <Common/config.h>
 #include <PreviewPanel/PreviewLabel.h>
 #include <TonemappingOperators/pfstmdefaultparams.h>
+#include <TonemappingOperators/mantiuk06/contrast_domain.h>
+#include <TonemappingOperators/pfstmo.h>
 #include <TonemappingPanel/SavingParametersDialog.h>
 #include <TonemappingPanel/TonemappingPanel.h>
 #include <TonemappingPanel/TonemappingSettings.h>
@@ -80,6 +82,7 @@ TonemappingPanel::TonemappingPanel(int mainWinNumber, PreviewPanel *panel,
         m_Ui->loadButton->setIcon(QIcon(":/program-icons/cloud-upload"));
 
     m_currentTmoOperator = mantiuk06;  // from Qt Designer
+    m_mantiuk06WarmStart = std::make_shared<Mantiuk06WarmStart>();
 
     // mantiuk06
     contrastfactorGang =
@@ -135,6 +138,7 @@ TonemappingPanel::TonemappingPanel(int mainWinNumber, PreviewPanel *panel,
                          NULL, 0, 1.f, FATTAL02_NOISE_REDUX);
     // oldFattalGang = new Gang(NULL,NULL, m_Ui->oldFattalCheckBox);
     fftSolverGang = new Gang(NULL, NULL, m_Ui->fftVersionCheckBox);
+    multigridGang = new Gang(NULL, NULL, m_Ui->multigridCheckBox);
 
     // ferradans11
     rhoGang = new Gang(m_Ui->rhoSlider, m_Ui->rhodsb, NULL, NULL, NULL, NULL,
@@ -182,6 +186,7 @@ TonemappingPanel::TonemappingPanel(int mainWinNumber, PreviewPanel *panel,
                          NULL, 0.01f, 10.f, DURAND02_RANGE);
     baseGang = new Gang(m_Ui->baseSlider, m_Ui->basedsb, NULL, NULL, NULL, NULL,
                         0.f, 10.f, DURAND02_BASE);
+    bilateralGridGang = new Gang(NULL, NULL, m_Ui->bilateralGridCheckBox);
 
     // pattanaik00
     multiplierGang =
@@ -458,7 +463,8 @@ void TonemappingPanel::createDatabase() {
     // Durand
     res = query.exec(QStringLiteral(
         " CREATE TABLE IF NOT EXISTS durand (spatial real, range \
-        real, base real, pregamma real, comment varchar(150), postsaturation real, postgamma real);"));
+        real, base real, pregamma real, comment varchar(150), postsaturation real, postgamma real, \
+        bilateralgrid boolean NOT NULL DEFAULT 0);"));
     if (res == false) qDebug() << query.lastError();
 
     res = query.exec(QStringLiteral(
@@ -469,12 +475,19 @@ void TonemappingPanel::createDatabase() {
         res = query.exec(QStringLiteral(
                 " ALTER TABLE durand ADD COLUMN postgamma real NOT NULL DEFAULT 1;"));
     }
+    res = query.exec(QStringLiteral(
+                " SELECT bilateralgrid FROM durand; "));
+    if (res == false) {
+        res = query.exec(QStringLiteral(
+                " ALTER TABLE durand ADD COLUMN bilateralgrid boolean NOT NULL DEFAULT 0;"));
+    }
     // Fattal
     res = query.exec(QStringLiteral(
         " CREATE TABLE IF NOT EXISTS fattal (alpha real, beta real, \
         colorSaturation real, noiseReduction real, oldFattal boolean NOT \
         NULL, \
-        pregamma real, comment varchar(150), postsaturation real, postgamma real);"));
+        pregamma real, comment varchar(150), postsaturation real, postgamma real, \
+        multigrid boolean NOT NULL DEFAULT 0);"));
     if (res == false) qDebug() << query.lastError();
 
     res = query.exec(QStringLiteral(
@@ -485,6 +498,12 @@ void TonemappingPanel::createDatabase() {
         res = query.exec(QStringLiteral(
                 " ALTER TABLE fattal ADD COLUMN postgamma real NOT NULL DEFAULT 1;"));
     }
+    res = query.exec(QStringLiteral(
+                " SELECT multigrid FROM fattal; "));
+    if (res == false) {
+        res = query.exec(QStringLiteral(
+                " ALTER TABLE fattal ADD COLUMN multigrid boolean NOT NULL DEFAULT 0;"));
+    }
     // Ferradans
     res = query.exec(QStringLiteral(
         " CREATE TABLE IF NOT EXISTS ferradans (rho real, \
@@ -621,6 +640,8 @@ void TonemappingPanel::on_defaultButton_clicked() {
             spatialGang->setDefault();
             rangeGang->setDefault();
             baseGang->setDefault();
+            bilateralGridGang->setDefault();
+            m_Ui->bilateralGridCheckBox->setChecked(false);
             break;
         case fattal:
             alphaGang->setDefault();
@@ -629,6 +650,8 @@ void TonemappingPanel::on_defaultButton_clicked() {
             noiseGang->setDefault();
             fftSolverGang->setDefault();
             m_Ui->fftVersionCheckBox->setChecked(true);
+            multigridGang->setDefault();
+            m_Ui->multigridCheckBox->setChecked(false);
             break;
         case ferradans:
             rhoGang->setDefault();
@@ -801,6 +824,8 @@ void TonemappingPanel::fillToneMappingOptions(bool exportMode) {
                 rangeGang->v();
             m_toneMappingOptions->operator_options.durandoptions.base =
                 baseGang->v();
+            m_toneMappingOptions->operator_options.durandoptions.bilateralgrid =
+                bilateralGridGang->isCheckBox1Checked();
             break;
         case fattal:
             m_toneMappingOptions->tmoperator = fattal;
@@ -814,7 +839,7 @@ void TonemappingPanel::fillToneMappingOptions(bool exportMode) {
                 noiseGang->v();
             //        m_toneMappingOptions->operator_options.fattaloptions.newfattal=!oldFattalGang->isCheckBox1Checked();
             m_toneMappingOptions->operator_options.fattaloptions.fftsolver =
-                fftSolverGang->isCheckBox1Checked();
+                fattalSolver();
             break;
         case ferradans:
             m_toneMappingOptions->tmoperator = ferradans;
@@ -837,6 +862,10 @@ void TonemappingPanel::fillToneMappingOptions(bool exportMode) {
             m_toneMappingOptions->operator_options.mantiuk06options
                 .contrastequalization =
                 contrastfactorGang->isCheckBox1Checked();
+            if (!exportMode) {
+                m_toneMappingOptions->operator_options.mantiuk06options
+                    .warmstart = m_mantiuk06WarmStart;
+            }
             break;
         case mantiuk08:
             m_toneMappingOptions->tmoperator = mantiuk08;
@@ -922,6 +951,7 @@ void TonemappingPanel::setupUndo() {
             spatialGang->setupUndo();
             rangeGang->setupUndo();
             baseGang->setupUndo();
+            bilateralGridGang->setupUndo();
             break;
         case fattal:
             alphaGang->setupUndo();
@@ -930,6 +960,7 @@ void TonemappingPanel::setupUndo() {
             noiseGang->setupUndo();
             //        oldFattalGang->setupUndo();
             fftSolverGang->setupUndo();
+            multigridGang->setupUndo();
             break;
         case ferradans:
             rhoGang->setupUndo();
@@ -985,6 +1016,14 @@ void TonemappingPanel::on_undoButton_clicked() { onUndoRedo(true); }
 
 void TonemappingPanel::on_redoButton_clicked() { onUndoRedo(false); }
 
+int TonemappingPanel::fattalSolver() const {
+    if (!m_Ui->fftVersionCheckBox->isChecked()) {
+        return FATTAL02_SOLVER_MULTIGRID;
+    }
+    return m_Ui->multigridCheckBox->isChecked() ? FATTAL02_SOLVER_REDBLACK
+                                                : FATTAL02_SOLVER_FFT;
+}
+
 void TonemappingPanel::onUndoRedo(bool undo) {
     typedef void (Gang::*REDO_UNDO)();
     REDO_UNDO redoUndo = undo ? &Gang::undo : &Gang::redo;
@@ -1001,6 +1040,7 @@ void TonemappingPanel::onUndoRedo(bool undo) {
             (spatialGang->*redoUndo)();
             (rangeGang->*redoUndo)();
             (baseGang->*redoUndo)();
+            (bilateralGridGang->*redoUndo)();
             break;
         case fattal:
             (alphaGang->*redoUndo)();
@@ -1009,6 +1049,7 @@ void TonemappingPanel::onUndoRedo(bool undo) {
             (noiseGang->*redoUndo)();
             //      (oldFattalGang->*redoUndo)();
             (fftSolverGang->*redoUndo)();
+            (multigridGang->*redoUndo)();
             break;
         case ferradans:
             (rhoGang->*redoUndo)();
@@ -1161,6 +1202,8 @@ void TonemappingPanel::fromGui2Txt(QString destination) {
         out << "NOISE=" << noiseGang->v() << endl;
         out << "OLDFATTAL="
             << (m_Ui->fftVersionCheckBox->isChecked() ? "NO" : "YES") << endl;
+        out << "MULTIGRID="
+            << (m_Ui->multigridCheckBox->isChecked() ? "YES" : "NO") << endl;
     } else if (current_page == m_Ui->page_ferradans) {
         out << "TMO="
             << "Ferradans11" << endl;
@@ -1193,6 +1236,9 @@ void TonemappingPanel::fromGui2Txt(QString destination) {
         out << "SPATIAL=" << spatialGang->v() << endl;
         out << "RANGE=" << rangeGang->v() << endl;
         out << "BASE=" << baseGang->v() << endl;
+        out << "BILATERALGRID="
+            << (m_Ui->bilateralGridCheckBox->isChecked() ? "YES" : "NO")
+            << endl;
     } else if (current_page == m_Ui->page_drago) {
         out << "TMO="
             << "Drago03" << endl;
@@ -1381,6 +1427,9 @@ void TonemappingPanel::fromTxt2Gui() {
                 m_Ui->range2Slider->setValue(range2Gang->v2p(value.toFloat()));
         } else if (field == QLatin1String("BASE")) {
             m_Ui->baseSlider->setValue(baseGang->v2p(value.toFloat()));
+        } else if (field == QLatin1String("BILATERALGRID")) {
+            m_Ui->bilateralGridCheckBox->setChecked(value ==
+                                                    QLatin1String("YES"));
         } else if (field == QLatin1String("ALPHA")) {
             m_Ui->alphaSlider->setValue(alphaGang->v2p(value.toFloat()));
         } else if (field == QLatin1String("BETA")) {
@@ -1392,6 +1441,8 @@ void TonemappingPanel::fromTxt2Gui() {
             m_Ui->noiseSlider->setValue(noiseGang->v2p(value.toFloat()));
         } else if (field == QLatin1String("OLDFATTAL")) {
             m_Ui->fftVersionCheckBox->setChecked(value != QLatin1String("YES"));
+        } else if (field == QLatin1String("MULTIGRID")) {
+            m_Ui->multigridCheckBox->setChecked(value == QLatin1String("YES"));
         } else if (field == QLatin1String("RHO")) {
             m_Ui->rhoSlider->setValue(rhoGang->v2p(value.toFloat()));
         } else if (field == QLatin1String("INV_ALPHA")) {
@@ -1533,7 +1584,9 @@ void TonemappingPanel::saveParameters() {
                     float spatial = spatialGang->v();
                     float range = rangeGang->v();
                     float base = baseGang->v();
-                    execDurandQuery(spatial, range, base, comment);
+                    bool bilateralGrid = bilateralGridGang->isCheckBox1Checked();
+                    execDurandQuery(spatial, range, base, bilateralGrid,
+                                    comment);
                 }
                 break;
             case fattal:
@@ -1543,8 +1596,9 @@ void TonemappingPanel::saveParameters() {
                     float colorSat = saturation2Gang->v();
                     bool  noiseReduction = noiseGang->v();
                     bool  oldFattal = !fftSolverGang->isCheckBox1Checked();
+                    bool  multigrid = multigridGang->isCheckBox1Checked();
                     execFattalQuery(alpha, beta, colorSat, noiseReduction,
-                                    oldFattal, comment);
+                                    oldFattal, multigrid, comment);
                 }
                 break;
             case ferradans:
@@ -1647,9 +1701,10 @@ void TonemappingPanel::loadParameters() {
         float bias;
         // Durand
         float spatial, range, base;
+        bool bilateralGrid;
         // Fattal
         float alpha, beta, colorSat, noiseReduction;
-        bool fftsolver;
+        int fftsolver;
         // Ferradans
         float rho, inv_alpha;
         // Mantiuk 06
@@ -1724,6 +1779,8 @@ void TonemappingPanel::loadParameters() {
                 spatial = tmopts->operator_options.durandoptions.spatial;
                 range = tmopts->operator_options.durandoptions.range;
                 base = tmopts->operator_options.durandoptions.base;
+                bilateralGrid =
+                    tmopts->operator_options.durandoptions.bilateralgrid;
                 pregamma = tmopts->pregamma;
                 postsaturation = tmopts->postsaturation;
                 postgamma = tmopts->postgamma;
@@ -1733,6 +1790,7 @@ void TonemappingPanel::loadParameters() {
                 m_Ui->rangedsb->setValue(range);
                 m_Ui->baseSlider->setValue(base);
                 m_Ui->basedsb->setValue(base);
+                m_Ui->bilateralGridCheckBox->setChecked(bilateralGrid);
                 m_Ui->pregammaSlider->setValue(pregamma);
                 m_Ui->pregammadsb->setValue(pregamma);
                 m_Ui->postsaturationSlider->setValue(postsaturation);
@@ -1759,7 +1817,10 @@ void TonemappingPanel::loadParameters() {
                 m_Ui->saturation2dsb->setValue(colorSat);
                 m_Ui->noiseSlider->setValue(noiseReduction);
                 m_Ui->noisedsb->setValue(noiseReduction);
-                m_Ui->fftVersionCheckBox->setChecked(fftsolver);
+                m_Ui->fftVersionCheckBox->setChecked(
+                    fftsolver != FATTAL02_SOLVER_MULTIGRID);
+                m_Ui->multigridCheckBox->setChecked(
+                    fftsolver == FATTAL02_SOLVER_REDBLACK);
                 m_Ui->pregammaSlider->setValue(pregamma);
                 m_Ui->pregammadsb->setValue(pregamma);
                 m_Ui->postsaturationSlider->setValue(postsaturation);
@@ -2101,7 +2162,7 @@ void TonemappingPanel::execDragoQuery(float bias, QString comment) {
 }
 
 void TonemappingPanel::execDurandQuery(float spatial, float range, float base,
-                                       QString comment) {
+                                       bool bilateralGrid, QString comment) {
     qDebug() << "TonemappingPanel::execDurandQuery";
     QSqlDatabase db = QSqlDatabase::database(m_databaseconnection);
     QSqlQuery query(db);
@@ -2109,8 +2170,8 @@ void TonemappingPanel::execDurandQuery(float spatial, float range, float base,
     float postsaturation = m_Ui->postsaturationdsb->value();
     float postgamma = m_Ui->postgammadsb->value();
     query.prepare(
-        "INSERT INTO durand (spatial, range, base, pregamma, comment, postsaturation, postgamma) \
-        VALUES (:spatial, :range, :base, :pregamma, :comment, :postsaturation, :postgamma)");
+        "INSERT INTO durand (spatial, range, base, pregamma, comment, postsaturation, postgamma, bilateralgrid) \
+        VALUES (:spatial, :range, :base, :pregamma, :comment, :postsaturation, :postgamma, :bilateralgrid)");
     query.bindValue(QStringLiteral(":spatial"), spatial);
     query.bindValue(QStringLiteral(":base"), base);
     query.bindValue(QStringLiteral(":range"), range);
@@ -2118,6 +2179,7 @@ void TonemappingPanel::execDurandQuery(float spatial, float range, float base,
     query.bindValue(QStringLiteral(":comment"), comment);
     query.bindValue(QStringLiteral(":postsaturation"), postsaturation);
     query.bindValue(QStringLiteral(":postgamma"), postgamma);
+    query.bindValue(QStringLiteral(":bilateralgrid"), bilateralGrid);
     bool res = query.exec();
     if (res == false) qDebug() << query.lastError();
 }
@@ -2125,7 +2187,7 @@ void TonemappingPanel::execDurandQuery(float spatial, float range, float base,
 void TonemappingPanel::execFattalQuery(float alpha, float beta,
                                        float colorSaturation,
                                        float noiseReduction, bool oldFattal,
-                                       QString comment) {
+                                       bool multigrid, QString comment) {
     qDebug() << "TonemappingPanel::execFattalQuery";
     QSqlDatabase db = QSqlDatabase::database(m_databaseconnection);
     QSqlQuery query(db);
@@ -2134,9 +2196,9 @@ void TonemappingPanel::execFattalQuery(float alpha, float beta,
     float postgamma = m_Ui->postgammadsb->value();
     query.prepare(
         "INSERT INTO fattal (alpha, beta, colorSaturation, noiseReduction, \
-        oldFattal, pregamma, comment, postsaturation, postgamma) \
+        oldFattal, pregamma, comment, postsaturation, postgamma, multigrid) \
         VALUES (:alpha, :beta, :colorSaturation, :noiseReduction, :oldFattal, \
-        :pregamma, :comment, :postsaturation, :postgamma)");
+        :pregamma, :comment, :postsaturation, :postgamma, :multigrid)");
     query.bindValue(QStringLiteral(":alpha"), alpha);
     query.bindValue(QStringLiteral(":beta"), beta);
     query.bindValue(QStringLiteral(":colorSaturation"), colorSaturation);
@@ -2146,6 +2208,7 @@ void TonemappingPanel::execFattalQuery(float alpha, float beta,
     query.bindValue(QStringLiteral(":comment"), comment);
     query.bindValue(QStringLiteral(":postsaturation"), postsaturation);
     query.bindValue(QStringLiteral(":postgamma"), postgamma);
+    query.bindValue(QStringLiteral(":multigrid"), multigrid);
     bool res = query.exec();
     if (res == false) qDebug() << query.lastError();
 }
@@ -2475,9 +2538,13 @@ void TonemappingPanel::updatePreviewsCB(bool state) {
     // Mantiuk08
     else if (eventSender == m_Ui->luminanceLevelCheckBox)
         tmopts->operator_options.mantiuk08options.luminancelevel = state;
+    // Durand
+    else if (eventSender == m_Ui->bilateralGridCheckBox)
+        tmopts->operator_options.durandoptions.bilateralgrid = state;
     // Fattal
-    else if (eventSender == m_Ui->fftVersionCheckBox)
-        tmopts->operator_options.fattaloptions.fftsolver = state;
+    else if (eventSender == m_Ui->fftVersionCheckBox ||
+             eventSender == m_Ui->multigridCheckBox)
+        tmopts->operator_options.fattaloptions.fftsolver = fattalSolver();
     // Reinhard02
     else if (eventSender == m_Ui->usescalescheckbox)
         tmopts->operator_options.reinhard02options.scales = state;
@@ -2548,6 +2615,8 @@ void TonemappingPanel::setRealtimePreviews(bool toggled) {
                 SLOT(updatePreviews(double)));
         connect(m_Ui->fftVersionCheckBox, &QCheckBox::stateChanged, this,
                 &TonemappingPanel::updatePreviewsCB);
+        connect(m_Ui->multigridCheckBox, &QCheckBox::stateChanged, this,
+                &TonemappingPanel::updatePreviewsCB);
 
         // Ferradans
         connect(m_Ui->rhodsb, SIGNAL(valueChanged(double)), this,
@@ -2578,6 +2647,8 @@ void TonemappingPanel::setRealtimePreviews(bool toggled) {
                 SLOT(updatePreviews(double)));
         connect(m_Ui->rangedsb, SIGNAL(valueChanged(double)), this,
                 SLOT(updatePreviews(double)));
+        connect(m_Ui->bilateralGridCheckBox, &QCheckBox::stateChanged, this,
+                &TonemappingPanel::updatePreviewsCB);
 
         // Reinhard02
         connect(m_Ui->keydsb, SIGNAL(valueChanged(double)), this,
@@ -2664,6 +2735,8 @@ void TonemappingPanel::setRealtimePreviews(bool toggled) {
                 SLOT(updatePreviews(double)));
         disconnect(m_Ui->fftVersionCheckBox, &QCheckBox::stateChanged, this,
                 &TonemappingPanel::updatePreviewsCB);
+        disconnect(m_Ui->multigridCheckBox, &QCheckBox::stateChanged, this,
+                &TonemappingPanel::updatePreviewsCB);
 
         // Ferradans
         disconnect(m_Ui->rhodsb, SIGNAL(valueChanged(double)), this,
@@ -2694,6 +2767,8 @@ void TonemappingPanel::setRealtimePreviews(bool toggled) {
                 SLOT(updatePreviews(double)));
         disconnect(m_Ui->rangedsb, SIGNAL(valueChanged(double)), this,
                 SLOT(updatePreviews(double)));
+        disconnect(m_Ui->bilateralGridCheckBox, &QCheckBox::stateChanged, this,
+                &TonemappingPanel::updatePreviewsCB);
 
         // Reinhard02
         disconnect(m_Ui->keydsb, SIGNAL(valueChanged(double)), this,
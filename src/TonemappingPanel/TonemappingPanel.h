@@ -55,7 +55,7 @@ class TonemappingPanel : public QWidget {
         // fattal02
         *alphaGang, *betaGang, *saturation2Gang, *noiseGang,
         // *oldFattalGang,
-        *fftSolverGang,
+        *fftSolverGang, *multigridGang,
         // ferrands11
         *rhoGang, *inv_alphaGang,
         // ashikhmin02
@@ -63,7 +63,7 @@ class TonemappingPanel : public QWidget {
         // drago03
         *biasGang,
         // durand02
-        *spatialGang, *rangeGang, *baseGang,
+        *spatialGang, *rangeGang, *baseGang, *bilateralGridGang,
         // pattanaik00
         *multiplierGang, *coneGang, *rodGang, *autoYGang, *pattalocalGang,
         // reinhard02
@@ -87,6 +87,8 @@ class TonemappingPanel : public QWidget {
     TMOperator m_currentTmoOperator;
     TonemappingOptions *m_toneMappingOptions;
     QList<TonemappingOptions *> m_toneMappingOptionsToDelete;
+    //! solution of the last Mantiuk06 run of this panel
+    std::shared_ptr<Mantiuk06WarmStart> m_mantiuk06WarmStart;
     QVector<int> sizes;
     void fillToneMappingOptions(bool exportMode);
     void setupUndo();
@@ -135,8 +137,8 @@ class TonemappingPanel : public QWidget {
     void execMantiuk08Query(float, float, float, bool, QString);
     void execAshikhminQuery(bool, bool, float, QString);
     void execDragoQuery(float, QString);
-    void execDurandQuery(float, float, float, QString);
-    void execFattalQuery(float, float, float, float, bool, QString);
+    void execDurandQuery(float, float, float, bool, QString);
+    void execFattalQuery(float, float, float, float, bool, bool, QString);
     void execFerradansQuery(float, float, QString);
     void execFerwerdaQuery(float, float, QString);
     void execKimKautzQuery(float, float, QString);
@@ -178,6 +180,8 @@ class TonemappingPanel : public QWidget {
 
    private:
     void onUndoRedo(bool undo);
+    //! \brief Fattal02Solver of the fft and multigrid checkboxes
+    int fattalSolver() const;
 
     QtWaitingSpinner *m_spinner;
     static int sm_counter;
@@ -29,6 +29,7 @@
 
 #include <Core/TonemappingOptions.h>
 #include <PreviewPanel/PreviewLabel.h>
+#include <TonemappingOperators/pfstmo.h>
 #include <TonemappingPanel/TonemappingSettings.h>
 #include <TonemappingPanel/ui_TonemappingSettings.h>
 
@@ -158,6 +159,7 @@ void TonemappingSettings::fillPreviews() {
     m_modelPreviews->setQuery(sqlQuery, db);
 
     float spatial, range, base;
+    bool bilateralGrid;
 
     for (int selectedRow = 0; selectedRow < m_modelPreviews->rowCount();
          selectedRow++) {
@@ -171,6 +173,9 @@ void TonemappingSettings::fillPreviews() {
         base = m_modelPreviews->record(selectedRow)
                    .value(QStringLiteral("base"))
                    .toFloat();
+        bilateralGrid = m_modelPreviews->record(selectedRow)
+                            .value(QStringLiteral("bilateralgrid"))
+                            .toBool();
 
         fillCommonValues(tmoDurand, origxsize, PREVIEW_WIDTH, durand,
                          m_modelPreviews->record(selectedRow));
@@ -178,6 +183,8 @@ void TonemappingSettings::fillPreviews() {
         tmoDurand->operator_options.durandoptions.spatial = spatial;
         tmoDurand->operator_options.durandoptions.range = range;
         tmoDurand->operator_options.durandoptions.base = base;
+        tmoDurand->operator_options.durandoptions.bilateralgrid =
+            bilateralGrid;
 
         addPreview(new PreviewLabel(0, tmoDurand, index++),
                    m_modelPreviews->record(selectedRow));
@@ -187,7 +194,7 @@ void TonemappingSettings::fillPreviews() {
     m_modelPreviews->setQuery(sqlQuery, db);
 
     float alpha, beta, colorSat, noiseReduction;
-    bool fftsolver;
+    int fftsolver;
 
     for (int selectedRow = 0; selectedRow < m_modelPreviews->rowCount();
          selectedRow++) {
@@ -204,9 +211,15 @@ void TonemappingSettings::fillPreviews() {
         noiseReduction = m_modelPreviews->record(selectedRow)
                              .value(QStringLiteral("noiseReduction"))
                              .toFloat();
-        fftsolver = !m_modelPreviews->record(selectedRow)
-                         .value(QStringLiteral("oldFattal"))
-                         .toBool();
+        fftsolver = FATTAL02_SOLVER_FFT;
+        if (m_modelPreviews->record(selectedRow)
+                .value(QStringLiteral("oldFattal"))
+                .toBool())
+            fftsolver = FATTAL02_SOLVER_MULTIGRID;
+        else if (m_modelPreviews->record(selectedRow)
+                     .value(QStringLiteral("multigrid"))
+                     .toBool())
+            fftsolver = FATTAL02_SOLVER_REDBLACK;
 
         fillCommonValues(tmoFattal, origxsize, PREVIEW_WIDTH, fattal,
                          m_modelPreviews->record(selectedRow));
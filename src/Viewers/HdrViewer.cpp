@@ -43,6 +43,7 @@
 #include "Libpfs/array2d.h"
 #include "Libpfs/channel.h"
 #include "Libpfs/frame.h"
+#include "Libpfs/halfframe.h"
 #include "Libpfs/utils/msec_timer.h"
 #include "Libpfs/utils/sse.h"
 
@@ -53,8 +54,18 @@ namespace  // anonymous namespace
 // the code,
 // because it will only used inside this compilation unit
 
-const pfs::Array2Df *getPrimaryChannel(const pfs::Frame &frame) {
-    return frame.getChannel("Y");
+void setPrimaryChannel(LuminanceRangeWidget &lumRange,
+                       const pfs::Frame &frame) {
+    if (frame.isHalf()) {
+        // the histogram reads the half precision samples, without inflating
+        // the frame
+        const pfs::HalfChannel *Y = frame.halfChannels()->getChannel("Y");
+        if (Y != NULL) {
+            lumRange.setHistogramImage(*Y);
+            return;
+        }
+    }
+    lumRange.setHistogramImage(frame.getChannel("Y"));
 }
 
 }  // end anonymous namespace
@@ -71,7 +82,7 @@ HdrViewer::HdrViewer(pfs::Frame *frame, QWidget *parent, bool ns)
     // I prefer to do everything by hand, so the flow of the calls is clear
     m_lumRange->blockSignals(true);
 
-    m_lumRange->setHistogramImage(getPrimaryChannel(*getFrame()));
+    setPrimaryChannel(*m_lumRange, *getFrame());
     m_lumRange->fitToDynamicRange();
 
     m_mappingMethod =
@@ -153,7 +164,7 @@ void HdrViewer::updatePixmap() {
     refreshPixmap();
 
     // I need to set the histogram again during the setFrame function
-    m_lumRange->setHistogramImage(getPrimaryChannel(*getFrame()));
+    setPrimaryChannel(*m_lumRange, *getFrame());
     m_lumRange->fitToDynamicRange();
     m_lumRange->blockSignals(false);
 }
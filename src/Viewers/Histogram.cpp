@@ -31,33 +31,37 @@
 #include <math.h>
 
 #include <Libpfs/array2d.h>
+#include <Libpfs/utils/float16.h>
 
-Histogram::Histogram(int bins, int accuracy)
-    : bins(bins), accuracy(accuracy), P(new float[bins]) {}
+namespace {
+inline float sample(float v) { return v; }
+inline float sample(pfs::utils::float16 v) {
+    return pfs::utils::halfToFloat(v);
+}
 
-Histogram::~Histogram() { delete[] P; }
+template <typename Type>
+void findMinMax(const pfs::Array2D<Type> &image, int accuracy, float &min,
+                float &max) {
+    const int size = image.getRows() * image.getCols();
 
-void Histogram::computeLog(const pfs::Array2Df *image) {
-    const int size = image->getRows() * image->getCols();
+    min = 999999999.0f;
+    max = -999999999.0f;
 
-    float max, min;  // Find min, max
-    {
-        min = 999999999.0f;
-        max = -999999999.0f;
-
-        for (int i = 0; i < size; i += accuracy) {
-            float v = (*image)(i);
-            if (v > max)
-                max = v;
-            else if (v < min)
-                min = v;
-        }
+    for (int i = 0; i < size; i += accuracy) {
+        float v = sample(image(i));
+        if (v > max)
+            max = v;
+        else if (v < min)
+            min = v;
     }
-    computeLog(image, min, max);
 }
 
-void Histogram::computeLog(const pfs::Array2Df *image, float min, float max) {
-    const int size = image->getRows() * image->getCols();
+//! \brief fill the \a bins bins \a P with the probability of the log10 of
+//! the samples of \a image in [min, max]
+template <typename Type>
+void computeLogBins(const pfs::Array2D<Type> &image, int accuracy, float min,
+                    float max, float *P, int bins) {
+    const int size = image.getRows() * image.getCols();
 
     // Empty all bins
     for (int i = 0; i < bins; i++) P[i] = 0;
@@ -65,7 +69,7 @@ void Histogram::computeLog(const pfs::Array2Df *image, float min, float max) {
     float count = 0;
     float binWidth = (max - min) / (float)bins;
     for (int i = 0; i < size; i += accuracy) {
-        float v = (*image)(i);
+        float v = sample(image(i));
         if (v <= 0) continue;
         v = log10(v);
         int bin = (int)((v - min) / binWidth);
@@ -78,6 +82,33 @@ void Histogram::computeLog(const pfs::Array2Df *image, float min, float max) {
     // Normalize, to get probability
     for (int i = 0; i < bins; i++) P[i] /= (float)(count / accuracy);
 }
+}
+
+Histogram::Histogram(int bins, int accuracy)
+    : bins(bins), accuracy(accuracy), P(new float[bins]) {}
+
+Histogram::~Histogram() { delete[] P; }
+
+void Histogram::computeLog(const pfs::Array2Df *image) {
+    float max, min;  // Find min, max
+    findMinMax(*image, accuracy, min, max);
+    computeLog(image, min, max);
+}
+
+void Histogram::computeLog(const pfs::Array2Df *image, float min, float max) {
+    computeLogBins(*image, accuracy, min, max, P, bins);
+}
+
+void Histogram::computeLog(const pfs::Array2D<pfs::utils::float16> *image) {
+    float max, min;
+    findMinMax(*image, accuracy, min, max);
+    computeLog(image, min, max);
+}
+
+void Histogram::computeLog(const pfs::Array2D<pfs::utils::float16> *image,
+                           float min, float max) {
+    computeLogBins(*image, accuracy, min, max, P, bins);
+}
 
 float Histogram::getMaxP() const {
     float maxP = -1;
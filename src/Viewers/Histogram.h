@@ -29,6 +29,7 @@
 
 #include <assert.h>
 #include "Libpfs/array2d_fwd.h"
+#include "Libpfs/utils/float16.h"
 
 class Histogram {
     int bins;
@@ -42,6 +43,10 @@ class Histogram {
 
     void computeLog(const pfs::Array2Df *image);
     void computeLog(const pfs::Array2Df *image, float min, float max);
+    //! \brief histogram of the half precision samples of \a image
+    void computeLog(const pfs::Array2D<pfs::utils::float16> *image);
+    void computeLog(const pfs::Array2D<pfs::utils::float16> *image, float min,
+                    float max);
 
     int getBins() const { return bins; }
 
@@ -39,6 +39,7 @@
 #include <cassert>
 
 #include <Libpfs/array2d.h>
+#include <Libpfs/utils/float16.h>
 
 #include "Histogram.h"
 
@@ -52,6 +53,39 @@ static const int dragZoneMargin = 5;  // How many pizels from the range window
 #define min(x, y) ((x) < (y) ? (x) : (y))
 #define max(x, y) ((x) > (y) ? (x) : (y))
 
+namespace {
+inline float sample(float v) { return v; }
+inline float sample(pfs::utils::float16 v) {
+    return pfs::utils::halfToFloat(v);
+}
+
+template <typename Type>
+Histogram *buildHistogram(const pfs::Array2D<Type> &image, int bins,
+                          float minValue, float maxValue) {
+    // Build histogram from at least 5000 pixels
+    int accuracy = image.getRows() * image.getCols() / 5000;
+    if (accuracy < 1) accuracy = 1;
+    Histogram *histogram = new Histogram(bins, accuracy);
+    histogram->computeLog(&image, minValue, maxValue);
+    return histogram;
+}
+
+template <typename Type>
+void findRange(const pfs::Array2D<Type> &image, float &minV, float &maxV) {
+    minV = 99999999.0f;
+    maxV = -99999999.0f;
+
+    int size = image.getRows() * image.getCols();
+    for (int i = 0; i < size; i++) {
+        float v = sample(image(i));
+        if (v > maxV)
+            maxV = v;
+        else if (v < minV)
+            minV = v;
+    }
+}
+}
+
 LuminanceRangeWidget::LuminanceRangeWidget(QWidget *parent)
     : QFrame(parent),
       dragMode(DRAG_NO),
@@ -102,16 +136,14 @@ void LuminanceRangeWidget::paintEvent(QPaintEvent * /*pe */) {
     }
 
     // Paint histogram
-    if (histogramImage != NULL) {
+    if (histogramImage != NULL || histogramHalfImage.size() > 0) {
         if (histogram == NULL || histogram->getBins() != fRect.width()) {
             delete histogram;
-            // Build histogram from at least 5000 pixels
-            int accuracy =
-                histogramImage->getRows() * histogramImage->getCols() / 5000;
-            //       int accuracy =1;
-            if (accuracy < 1) accuracy = 1;
-            histogram = new Histogram(fRect.width(), accuracy);
-            histogram->computeLog(histogramImage, minValue, maxValue);
+            histogram = (histogramImage != NULL)
+                            ? buildHistogram(*histogramImage, fRect.width(),
+                                             minValue, maxValue)
+                            : buildHistogram(histogramHalfImage, fRect.width(),
+                                             minValue, maxValue);
         }
 
         float maxP = histogram->getMaxP();
@@ -256,23 +288,28 @@ void LuminanceRangeWidget::shrinkRange() {
 
 void LuminanceRangeWidget::setHistogramImage(const pfs::Array2Df *image) {
     histogramImage = image;
+    histogramHalfImage = pfs::Array2D<pfs::utils::float16>();
+    delete histogram;
+    histogram = NULL;
+    update();
+}
+
+void LuminanceRangeWidget::setHistogramImage(
+    const pfs::Array2D<pfs::utils::float16> &image) {
+    histogramImage = NULL;
+    histogramHalfImage = image;
     delete histogram;
     histogram = NULL;
     update();
 }
 
 void LuminanceRangeWidget::fitToDynamicRange() {
-    if (histogramImage != NULL) {
-        float min = 99999999.0f;
-        float max = -99999999.0f;
-
-        int size = histogramImage->getRows() * histogramImage->getCols();
-        for (int i = 0; i < size; i++) {
-            float v = (*histogramImage)(i);
-            if (v > max)
-                max = v;
-            else if (v < min)
-                min = v;
+    if (histogramImage != NULL || histogramHalfImage.size() > 0) {
+        float min, max;
+        if (histogramImage != NULL) {
+            findRange(*histogramImage, min, max);
+        } else {
+            findRange(histogramHalfImage, min, max);
         }
 
         if (min <= 0.000001f)
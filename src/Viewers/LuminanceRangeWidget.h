@@ -28,7 +28,8 @@
 #define LUMINANCERANGE_WIDGET_H
 
 #include <QFrame>
-#include "Libpfs/array2d_fwd.h"
+#include "Libpfs/array2d.h"
+#include "Libpfs/utils/float16.h"
 #include "Viewers/Histogram.h"
 
 class LuminanceRangeWidget : public QFrame {
@@ -76,6 +77,9 @@ class LuminanceRangeWidget : public QFrame {
 
     Histogram *histogram;
     const pfs::Array2Df *histogramImage;
+    // Y channel of a frame stored in half precision (the copy shares the
+    // buffer, and keeps it alive if the frame is inflated)
+    pfs::Array2D<pfs::utils::float16> histogramHalfImage;
 
     QRect getPaintRect() const;
 
@@ -86,6 +90,7 @@ class LuminanceRangeWidget : public QFrame {
     void setRangeWindowMinMax(float min, float max);
 
     void setHistogramImage(const pfs::Array2Df *image);
+    void setHistogramImage(const pfs::Array2D<pfs::utils::float16> &image);
 
     void showValuePointer(float value);
     void hideValuePointer();
@@ -0,0 +1,145 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <Libpfs/array2d.h>
+#include <Libpfs/channel.h>
+
+using namespace pfs;
+
+namespace {
+const size_t COLS = 37;
+const size_t ROWS = 23;
+
+Array2Df makeArray(float offset) {
+    Array2Df array(COLS, ROWS);
+    for (size_t i = 0; i < array.size(); ++i) {
+        array(i) = offset + 0.25f * i;
+    }
+    return array;
+}
+}
+
+TEST(TestArray2DExpr, Arithmetic) {
+    const Array2Df B = makeArray(1.f);
+    const Array2Df C = makeArray(2.f);
+    const Array2Df D = makeArray(-3.f);
+    const float s = 0.5f;
+
+    Array2Df A(COLS, ROWS);
+    A = B * C + s * D;
+    for (size_t i = 0; i < A.size(); ++i) {
+        ASSERT_FLOAT_EQ(B(i) * C(i) + s * D(i), A(i)) << i;
+    }
+
+    A = (B - C) / 2.f - (-D) + 1;
+    for (size_t i = 0; i < A.size(); ++i) {
+        ASSERT_FLOAT_EQ((B(i) - C(i)) / 2.f + D(i) + 1.f, A(i)) << i;
+    }
+
+    A = 1.f / C;
+    for (size_t i = 0; i < A.size(); ++i) {
+        ASSERT_FLOAT_EQ(1.f / C(i), A(i)) << i;
+    }
+}
+
+TEST(TestArray2DExpr, Empty) {
+    const Array2Df B = makeArray(1.f);
+
+    // takes the size of the expression
+    Array2Df A;
+    A = 2.f * B;
+    ASSERT_EQ(COLS, A.getCols());
+    ASSERT_EQ(ROWS, A.getRows());
+    EXPECT_FLOAT_EQ(2.f * B(COLS - 1, ROWS - 1), A(COLS - 1, ROWS - 1));
+}
+
+TEST(TestArray2DExpr, Aliasing) {
+    Array2Df A = makeArray(1.f);
+    const Array2Df B = makeArray(4.f);
+
+    A = A * B + A;
+    for (size_t i = 0; i < A.size(); ++i) {
+        const float a = 1.f + 0.25f * i;
+        ASSERT_FLOAT_EQ(a * B(i) + a, A(i)) << i;
+    }
+
+    A *= 2.f;
+    A -= B;
+    const Array2Df ref = makeArray(1.f);
+    for (size_t i = 0; i < A.size(); ++i) {
+        ASSERT_FLOAT_EQ(2.f * (ref(i) * B(i) + ref(i)) - B(i), A(i)) << i;
+    }
+}
+
+TEST(TestArray2DExpr, CopyOnWrite) {
+    Array2Df A = makeArray(1.f);
+    Array2Df copy(A);
+    ASSERT_TRUE(A.isShared());
+
+    // the copy keeps the original values
+    A += 1.f;
+    for (size_t i = 0; i < A.size(); ++i) {
+        ASSERT_FLOAT_EQ(copy(i) + 1.f, A(i)) << i;
+    }
+    EXPECT_FLOAT_EQ(1.f, copy(0));
+
+    // not reading the shared buffer: nothing to copy, just a new buffer
+    Array2Df other(A);
+    const Array2Df B = makeArray(2.f);
+    A = B * 3.f;
+    EXPECT_FALSE(A.isShared());
+    EXPECT_FLOAT_EQ(2.f, other(0));
+    EXPECT_FLOAT_EQ(6.f, A(0));
+}
+
+TEST(TestArray2DExpr, Channel) {
+    Channel X(COLS, ROWS, "X");
+    Channel Y(COLS, ROWS, "Y");
+    X.fill(2.f);
+    Y.fill(3.f);
+
+    Array2Df Z(COLS, ROWS);
+    Z = X * Y - X;
+    EXPECT_FLOAT_EQ(4.f, Z(5, 5));
+
+    X *= Y;
+    EXPECT_FLOAT_EQ(6.f, X(5, 5));
+}
+
+TEST(TestArray2DExpr, RawBuffers) {
+    std::vector<float> a(1000), b(1000), c(1000);
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = 0.5f * i;
+        b[i] = 1.f + i;
+    }
+
+    assign(c.data(), c.size(),
+           arrayExpr(a.data(), a.size()) * 2.f -
+               arrayExpr(b.data(), b.size()) / arrayExpr(b.data(), b.size()));
+    for (size_t i = 0; i < c.size(); ++i) {
+        ASSERT_FLOAT_EQ(a[i] * 2.f - 1.f, c[i]) << i;
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <Libpfs/array2d.h>
+#include <Libpfs/progress.h>
+#include <TonemappingOperators/durand02/bilateralgrid.h>
+
+namespace {
+//! \brief log luminance of a shaded frame with a step edge across it
+void makeFrame(pfs::Array2Df &I) {
+    for (size_t y = 0; y < I.getRows(); ++y) {
+        for (size_t x = 0; x < I.getCols(); ++x) {
+            const float shade = 2.f * std::sin(0.05f * x) * std::cos(0.03f * y);
+            I(x, y) = shade + (x + y > I.getCols() ? 8.f : 0.f);
+        }
+    }
+}
+
+//! \brief bilateral filter with the kernels of fastBilateralFilter(), in
+//! a window of 3 sigma_s
+float bruteForce(const pfs::Array2Df &I, int x, int y, float sigma_s,
+                 float sigma_r) {
+    const int radius = int(3.f * sigma_s);
+    const int w = I.getCols();
+    const int h = I.getRows();
+    double sum = 0.;
+    double count = 0.;
+    for (int j = std::max(0, y - radius); j <= std::min(h - 1, y + radius);
+         ++j) {
+        for (int i = std::max(0, x - radius);
+             i <= std::min(w - 1, x + radius); ++i) {
+            const float dI = I(i, j) - I(x, y);
+            const double k =
+                std::exp(-((i - x) * (i - x) + (j - y) * (j - y)) /
+                             (2. * sigma_s * sigma_s) -
+                         dI * dI / (sigma_r * sigma_r));
+            sum += k * I(i, j);
+            count += k;
+        }
+    }
+    return sum / count;
+}
+}
+
+TEST(TestBilateralGrid, Fits) {
+    // the grid is smaller than the frame only for the large kernels
+    EXPECT_FALSE(bilateralGridFits(4000, 3000, 12.f, 2.f, 2.f));
+    EXPECT_TRUE(bilateralGridFits(4000, 3000, 12.f, 16.f, 2.f));
+    EXPECT_FALSE(bilateralGridFits(4000, 3000, 12.f, 0.5f, 2.f));
+}
+
+TEST(TestBilateralGrid, BruteForce) {
+    const float sigma_s = 8.f;
+    const float sigma_r = 1.f;
+
+    pfs::Array2Df I(200, 150);
+    makeFrame(I);
+    pfs::Array2Df J(I.getCols(), I.getRows());
+    pfs::Progress ph;
+    bilateralGridFilter(I, J, sigma_s, sigma_r, ph);
+
+    double error = 0.;
+    size_t samples = 0;
+    for (size_t y = 0; y < I.getRows(); y += 7) {
+        for (size_t x = 0; x < I.getCols(); x += 5) {
+            const float expected = bruteForce(I, x, y, sigma_s, sigma_r);
+            // the step edge is preserved
+            ASSERT_NEAR(expected, J(x, y), 0.25f) << x << " " << y;
+            error += std::fabs(expected - J(x, y));
+            ++samples;
+        }
+    }
+    EXPECT_LT(error / samples, 0.05);
+}
+
+TEST(TestBilateralGrid, Constant) {
+    pfs::Array2Df I(64, 48);
+    I.fill(3.f);
+    pfs::Array2Df J(I.getCols(), I.getRows());
+    pfs::Progress ph;
+    bilateralGridFilter(I, J, 4.f, 0.5f, ph);
+    for (size_t i = 0; i < I.size(); ++i) {
+        ASSERT_NEAR(3.f, J(i), 1e-5f);
+    }
+}
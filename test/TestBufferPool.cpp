@@ -0,0 +1,208 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+
+#include <Libpfs/array2d.h>
+#include <Libpfs/utils/bufferpool.h>
+
+using namespace pfs;
+using namespace pfs::utils;
+
+namespace {
+bool isAligned(const void *ptr) {
+    return (reinterpret_cast<uintptr_t>(ptr) % BUFFER_ALIGNMENT) == 0;
+}
+}
+
+TEST(TestBufferPool, SizeClass) {
+    // small requests are not rounded
+    EXPECT_EQ(BufferPool::sizeClass(100), 100u);
+
+    const size_t M = size_t(1) << 20;
+    EXPECT_EQ(BufferPool::sizeClass(M), M);
+    EXPECT_EQ(BufferPool::sizeClass(M + 1), M + M / 8);
+    EXPECT_EQ(BufferPool::sizeClass(2 * M - 1), 2 * M);
+
+    for (size_t size = BufferPool::minPooledSize(); size < 64 * M;
+         size = size * 3 / 2 + 7) {
+        const size_t bytes = BufferPool::sizeClass(size);
+        EXPECT_GE(bytes, size);
+        EXPECT_LE(bytes, size + size / 8);
+    }
+}
+
+TEST(TestBufferPool, Recycle) {
+    const size_t size = 3 * BufferPool::minPooledSize();
+    BufferPool pool;
+
+    void *ptr = pool.acquire(size);
+    EXPECT_TRUE(isAligned(ptr));
+    pool.release(ptr, size);
+
+    BufferPoolStats stats = pool.stats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.releases, 1u);
+    EXPECT_EQ(stats.cachedBuffers, 1u);
+    EXPECT_EQ(stats.cachedBytes, BufferPool::sizeClass(size));
+
+    // same size class
+    void *ptr2 = pool.acquire(size - 10);
+    EXPECT_EQ(ptr, ptr2);
+    // the buffer is not available anymore
+    void *ptr3 = pool.acquire(size);
+    EXPECT_NE(ptr2, ptr3);
+
+    stats = pool.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.cachedBuffers, 0u);
+
+    pool.release(ptr2, size);
+    pool.release(ptr3, size);
+    pool.trim();
+    stats = pool.stats();
+    EXPECT_EQ(stats.cachedBuffers, 0u);
+    EXPECT_EQ(stats.cachedBytes, 0u);
+    EXPECT_EQ(stats.evictions, 2u);
+}
+
+TEST(TestBufferPool, Capacity) {
+    const size_t size = BufferPool::minPooledSize();
+    BufferPool pool(2 * size);
+
+    void *ptr[3];
+    for (int i = 0; i < 3; ++i) {
+        ptr[i] = pool.acquire(size);
+    }
+    for (int i = 0; i < 3; ++i) {
+        pool.release(ptr[i], size);
+    }
+
+    // the oldest buffer has been freed
+    BufferPoolStats stats = pool.stats();
+    EXPECT_EQ(stats.cachedBuffers, 2u);
+    EXPECT_EQ(stats.cachedBytes, 2 * size);
+    EXPECT_EQ(stats.evictions, 1u);
+
+    // the newest buffer is reused first
+    void *p = pool.acquire(size);
+    EXPECT_EQ(p, ptr[2]);
+    pool.release(p, size);
+
+    // larger than the capacity: never cached
+    p = pool.acquire(4 * size);
+    pool.release(p, 4 * size);
+    EXPECT_EQ(pool.stats().cachedBuffers, 2u);
+
+    pool.setCapacity(0);
+    EXPECT_EQ(pool.stats().cachedBytes, 0u);
+}
+
+TEST(TestBufferPool, Array2D) {
+    BufferPool &pool = BufferPool::instance();
+    pool.trim();
+    pool.resetStats();
+
+    const float *data;
+    {
+        Array2Df array(512, 256);
+        EXPECT_TRUE(isAligned(array.data()));
+        data = array.data();
+    }
+    EXPECT_EQ(pool.stats().cachedBuffers, 1u);
+
+    // the next temporary of the same size reuses the buffer
+    Array2Df array(256, 512);
+    EXPECT_EQ(array.data(), data);
+    EXPECT_EQ(pool.stats().hits, 1u);
+    // std::vector value-initializes its elements
+    EXPECT_EQ(array(10, 10), 0.f);
+}
+
+TEST(TestBufferPool, FileBacking) {
+    const size_t size = 4 * BufferPool::minPooledSize();
+    BufferPool pool;
+    pool.setFileBacking(".", 2 * BufferPool::minPooledSize());
+    EXPECT_EQ(pool.fileBackingDirectory(), ".");
+
+    // below the threshold: in memory
+    void *small = pool.acquire(BufferPool::minPooledSize());
+    EXPECT_EQ(pool.stats().mappedBuffers, 0u);
+
+    float *ptr = static_cast<float *>(pool.acquire(size));
+    EXPECT_TRUE(isAligned(ptr));
+    BufferPoolStats stats = pool.stats();
+    EXPECT_EQ(stats.mappedBuffers, 1u);
+    EXPECT_EQ(stats.mappedBytes, size);
+    EXPECT_EQ(stats.misses, 1u);
+    // zero filled and writable
+    EXPECT_EQ(ptr[size / sizeof(float) - 1], 0.f);
+    for (size_t i = 0; i < size / sizeof(float); ++i) {
+        ptr[i] = static_cast<float>(i);
+    }
+    EXPECT_EQ(ptr[size / sizeof(float) - 1],
+              static_cast<float>(size / sizeof(float) - 1));
+
+    // mapped buffers are never cached
+    pool.release(ptr, size);
+    stats = pool.stats();
+    EXPECT_EQ(stats.mappedBuffers, 0u);
+    EXPECT_EQ(stats.mappedBytes, 0u);
+    EXPECT_EQ(stats.cachedBuffers, 0u);
+
+    // falls back to memory
+    pool.setFileBacking("./no/such/directory", size);
+    void *p = pool.acquire(size);
+    EXPECT_EQ(pool.stats().mappedBuffers, 0u);
+    pool.release(p, size);
+    EXPECT_EQ(pool.stats().cachedBuffers, 1u);
+
+    pool.setFileBacking("", 0);
+    EXPECT_EQ(pool.fileBackingThreshold(), 0u);
+    pool.release(small, BufferPool::minPooledSize());
+}
+
+TEST(TestBufferPool, FileBackedArray2D) {
+    BufferPool &pool = BufferPool::instance();
+    pool.setFileBacking(".", size_t(1) << 20);
+    pool.resetStats();
+
+    {
+        Array2Df array(1024, 512);
+        EXPECT_EQ(pool.stats().mappedBuffers, 1u);
+        array(1023, 511) = 1.f;
+        // the copy on write gets its own scratch file
+        Array2Df copy(array);
+        copy(0, 0) = 2.f;
+        EXPECT_EQ(pool.stats().mappedBuffers, 2u);
+        EXPECT_EQ(copy(1023, 511), 1.f);
+        EXPECT_EQ(array(0, 0), 0.f);
+
+        Array2Df small(16, 16);
+        EXPECT_EQ(pool.stats().mappedBuffers, 2u);
+    }
+    EXPECT_EQ(pool.stats().mappedBuffers, 0u);
+
+    pool.setFileBacking("", 0);
+}
@@ -0,0 +1,237 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+#include <HdrCreation/compactframe.h>
+#include <HdrCreation/fusionoperator.h>
+#include <Libpfs/colorspace/convert.h>
+#include <Libpfs/colorspace/gamma.h>
+#include <Libpfs/frame.h>
+
+using namespace pfs;
+using namespace libhdr::fusion;
+
+namespace {
+
+const size_t W = 41;
+const size_t H = 19;
+
+//! \brief code of pixel \a k of \a channel of exposure \a exposure, as
+//! written by an 8 or 16 bits camera
+unsigned testCode(size_t exposure, int channel, size_t k, unsigned maxCode) {
+    const float times[] = {0.25f, 1.f, 4.f};
+    const float radiance = 0.02f + float((k * 7 + channel * 13) % 97) / 97.f;
+    return unsigned(std::min(radiance * times[exposure], 1.f) * maxCode);
+}
+
+//! \brief frame as produced by a reader decoding \a T samples with
+//! \a Converter
+template <typename T, typename Converter>
+FramePtr buildFrame(size_t exposure, const Converter &conv) {
+    FramePtr frame(new Frame(W, H));
+    Channel *Ch[3];
+    frame->createXYZChannels(Ch[0], Ch[1], Ch[2]);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t k = 0; k < W * H; ++k) {
+            const T code = T(testCode(exposure, c, k,
+                                      std::numeric_limits<T>::max()));
+            (*Ch[c])(k) = conv(code);
+        }
+    }
+    return frame;
+}
+
+struct Linear8 {
+    float operator()(uint8_t v) const {
+        return colorspace::convertSample<float>(v);
+    }
+};
+
+struct Linear16 {
+    float operator()(uint16_t v) const {
+        return colorspace::convertSample<float>(v);
+    }
+};
+
+struct Gamma16 {
+    float operator()(uint16_t v) const {
+        return colorspace::Gamma<colorspace::Gamma1_8>()
+            .operator()<uint16_t, float>(v);
+    }
+};
+
+void compareFrames(const Frame &expected, const Frame &actual) {
+    ASSERT_EQ(expected.getWidth(), actual.getWidth());
+    ASSERT_EQ(expected.getHeight(), actual.getHeight());
+
+    const Channel *e[3];
+    expected.getXYZChannels(e[0], e[1], e[2]);
+    const Channel *a[3];
+    actual.getXYZChannels(a[0], a[1], a[2]);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t k = 0; k < expected.getWidth() * expected.getHeight();
+             ++k) {
+            ASSERT_EQ((*e[c])(k), (*a[c])(k)) << "channel " << c << " pixel "
+                                              << k;
+        }
+    }
+}
+
+void compareFusion(FusionOperator type, float tolerance) {
+    const float times[] = {0.25f, 1.f, 4.f};
+
+    std::vector<FrameEnhanced> floatImages;
+    std::vector<FrameEnhanced> compactImages;
+    for (size_t i = 0; i < 3; ++i) {
+        FramePtr frame = buildFrame<uint16_t>(i, Gamma16());
+        floatImages.push_back(FrameEnhanced(frame, times[i]));
+
+        CompactFramePtr compact(CompactFrame::encode(
+            *frame, 16, colorspace::Gamma1_8::gamma()));
+        ASSERT_TRUE(compact.get() != NULL);
+        compactImages.push_back(FrameEnhanced(compact, times[i]));
+    }
+
+    ResponseCurve floatResponse(RESPONSE_GAMMA);
+    ResponseCurve compactResponse(RESPONSE_GAMMA);
+    WeightFunction weight(WEIGHT_TRIANGULAR);
+    std::unique_ptr<Frame> expected(IFusionOperator::build(type)->computeFusion(
+        floatResponse, weight, floatImages));
+    std::unique_ptr<Frame> actual(IFusionOperator::build(type)->computeFusion(
+        compactResponse, weight, compactImages));
+
+    const Channel *e[3];
+    expected->getXYZChannels(e[0], e[1], e[2]);
+    const Channel *a[3];
+    actual->getXYZChannels(a[0], a[1], a[2]);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t k = 0; k < W * H; ++k) {
+            ASSERT_NEAR((*e[c])(k), (*a[c])(k), tolerance * (*e[c])(k))
+                << "channel " << c << " pixel " << k;
+        }
+    }
+}
+}
+
+TEST(TestCompactFrame, Linear8Bits) {
+    FramePtr frame = buildFrame<uint8_t>(1, Linear8());
+    std::unique_ptr<CompactFrame> compact(CompactFrame::encode(*frame));
+    ASSERT_TRUE(compact.get() != NULL);
+    EXPECT_EQ(8, compact->getBitDepth());
+
+    std::unique_ptr<Frame> decoded(compact->toFrame());
+    compareFrames(*frame, *decoded);
+}
+
+TEST(TestCompactFrame, Linear16Bits) {
+    FramePtr frame = buildFrame<uint16_t>(1, Linear16());
+    std::unique_ptr<CompactFrame> compact(CompactFrame::encode(*frame));
+    ASSERT_TRUE(compact.get() != NULL);
+    EXPECT_EQ(16, compact->getBitDepth());
+
+    std::unique_ptr<Frame> decoded(compact->toFrame());
+    compareFrames(*frame, *decoded);
+}
+
+TEST(TestCompactFrame, Gamma16Bits) {
+    FramePtr frame = buildFrame<uint16_t>(2, Gamma16());
+    EXPECT_TRUE(CompactFrame::encode(*frame) == NULL);
+
+    std::unique_ptr<CompactFrame> compact(
+        CompactFrame::encode(*frame, 16, colorspace::Gamma1_8::gamma()));
+    ASSERT_TRUE(compact.get() != NULL);
+
+    std::unique_ptr<Frame> decoded(compact->toFrame());
+    compareFrames(*frame, *decoded);
+}
+
+TEST(TestCompactFrame, NotRepresentable) {
+    FramePtr frame = buildFrame<uint16_t>(0, Linear16());
+    Channel *X, *Y, *Z;
+    frame->getXYZChannels(X, Y, Z);
+    (*Y)(W * H / 2) = 0.3f / 7.f;
+
+    EXPECT_TRUE(CompactFrame::encode(*frame) == NULL);
+}
+
+TEST(TestCompactFrame, Decimated) {
+    FramePtr frame = buildFrame<uint8_t>(0, Linear8());
+    std::unique_ptr<CompactFrame> compact(CompactFrame::encode(*frame));
+    ASSERT_TRUE(compact.get() != NULL);
+
+    const size_t step = 4;
+    std::unique_ptr<Frame> decimated(compact->toFrame(step));
+    ASSERT_EQ((W + step - 1) / step, decimated->getWidth());
+    ASSERT_EQ((H + step - 1) / step, decimated->getHeight());
+
+    const Channel *in[3];
+    frame->getXYZChannels(in[0], in[1], in[2]);
+    const Channel *out[3];
+    decimated->getXYZChannels(out[0], out[1], out[2]);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t y = 0; y < decimated->getHeight(); ++y) {
+            for (size_t x = 0; x < decimated->getWidth(); ++x) {
+                ASSERT_EQ((*in[c])(x * step, y * step), (*out[c])(x, y));
+            }
+        }
+    }
+}
+
+TEST(TestCompactFrame, Bands) {
+    FramePtr frame = buildFrame<uint16_t>(2, Gamma16());
+    const Channel *in[3];
+    frame->getXYZChannels(in[0], in[1], in[2]);
+
+    CompactFrame compact(W, H, 16, colorspace::Gamma1_8::gamma());
+    const size_t bandHeight = 4;
+    for (size_t y0 = 0; y0 < H; y0 += bandHeight) {
+        const size_t rows = std::min(bandHeight, H - y0);
+        Frame band(W, rows);
+        Channel *out[3];
+        band.createXYZChannels(out[0], out[1], out[2]);
+        for (int c = 0; c < 3; ++c) {
+            std::copy(in[c]->row_begin(y0), in[c]->row_begin(y0) + W * rows,
+                      out[c]->begin());
+        }
+        ASSERT_TRUE(compact.encodeBand(band, y0));
+    }
+
+    std::unique_ptr<Frame> decoded(compact.toFrame());
+    compareFrames(*frame, *decoded);
+
+    // 16 bits samples are not 8 bits codes
+    FramePtr other = buildFrame<uint16_t>(0, Linear16());
+    CompactFrame linear(W, H, 8);
+    EXPECT_FALSE(linear.encodeBand(*other, 0));
+}
+
+TEST(TestCompactFrame, Debevec) { compareFusion(DEBEVEC, 1e-5f); }
+
+TEST(TestCompactFrame, Robertson) { compareFusion(ROBERTSON, 0.f); }
+
+TEST(TestCompactFrame, RobertsonAuto) { compareFusion(ROBERTSON_AUTO, 0.f); }
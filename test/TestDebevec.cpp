@@ -0,0 +1,122 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <HdrCreation/debevec.h>
+#include <Libpfs/frame.h>
+
+using namespace pfs;
+using namespace libhdr::fusion;
+
+namespace {
+
+std::vector<FrameEnhanced> buildExposures(size_t W, size_t H) {
+    const float times[] = {0.25f, 1.f, 4.f};
+
+    std::vector<FrameEnhanced> images;
+    for (size_t i = 0; i < 3; ++i) {
+        FramePtr frame(new Frame(W, H));
+        Channel *Ch[3];
+        frame->createXYZChannels(Ch[0], Ch[1], Ch[2]);
+        for (size_t c = 0; c < 3; ++c) {
+            for (size_t k = 0; k < W * H; ++k) {
+                const float radiance = 0.05f + float((k * 7 + c * 13) % 97) /
+                                                   97.f;
+                (*Ch[c])(k) = std::min(radiance * times[i], 1.f);
+            }
+        }
+        images.push_back(FrameEnhanced(frame, times[i]));
+    }
+    return images;
+}
+
+// straight per-pixel implementation of the Debevec merge
+std::vector<float> referenceFusion(const ResponseCurve &response,
+                                   const WeightFunction &weight,
+                                   const std::vector<FrameEnhanced> &images,
+                                   size_t c) {
+    const size_t size =
+        images[0].frame()->getWidth() * images[0].frame()->getHeight();
+
+    std::vector<float> sum(size, 0.f);
+    std::vector<float> wsum(size, 0.f);
+    for (size_t i = 0; i < images.size(); ++i) {
+        const Channel *Ch[3];
+        images[i].frame()->getXYZChannels(Ch[0], Ch[1], Ch[2]);
+
+        float Min = std::numeric_limits<float>::max();
+        float Max = std::numeric_limits<float>::min();
+        for (size_t j = 0; j < 3; ++j) {
+            Min = std::min(Min, *std::min_element(Ch[j]->begin(), Ch[j]->end()));
+            Max = std::max(Max, *std::max_element(Ch[j]->begin(), Ch[j]->end()));
+        }
+
+        for (size_t k = 0; k < size; ++k) {
+            float w = 0.f;
+            for (size_t j = 0; j < 3; ++j) {
+                w += weight(((*Ch[j])(k) - Min) / (Max - Min)) / 3.f;
+            }
+            const float v = ((*Ch[c])(k) - Min) / (Max - Min);
+            sum[k] += (std::log(response(v)) -
+                       std::log(images[i].averageLuminance())) * w;
+            wsum[k] += w;
+        }
+    }
+    for (size_t k = 0; k < size; ++k) {
+        sum[k] = 0.1f * std::exp(sum[k] / wsum[k]);
+    }
+    return sum;
+}
+}
+
+TEST(TestDebevec, MatchesReference) {
+    // width not multiple of the tile width, nor of the SIMD width
+    const size_t W = 1031;
+    const size_t H = 7;
+
+    std::vector<FrameEnhanced> images = buildExposures(W, H);
+    const float firstSample = (*images[1].frame()->getChannel("X"))(10);
+
+    ResponseCurve response(RESPONSE_LINEAR);
+    WeightFunction weight(WEIGHT_GAUSSIAN);
+
+    FusionOperatorPtr op = IFusionOperator::build(DEBEVEC);
+    std::unique_ptr<Frame> hdr(op->computeFusion(response, weight, images));
+
+    // inputs are left untouched
+    EXPECT_EQ(firstSample, (*images[1].frame()->getChannel("X"))(10));
+
+    Channel *Ch[3];
+    hdr->getXYZChannels(Ch[0], Ch[1], Ch[2]);
+    for (size_t c = 0; c < 3; ++c) {
+        std::vector<float> ref = referenceFusion(response, weight, images, c);
+        for (size_t k = 0; k < W * H; ++k) {
+            ASSERT_NEAR(ref[k], (*Ch[c])(k), 1e-4f * ref[k] + 1e-6f)
+                << "channel " << c << " pixel " << k;
+        }
+    }
+}
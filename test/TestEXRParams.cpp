@@ -0,0 +1,197 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include <Libpfs/frame.h>
+#include <Libpfs/halfframe.h>
+#include <Libpfs/io/exrreader.h>
+#include <Libpfs/io/exrwriter.h>
+#include <Libpfs/io/ioexception.h>
+
+using namespace pfs;
+using namespace pfs::io;
+
+namespace {
+
+// taller than a band of EXRReader, to read windows in several bands
+const size_t W = 67;
+const size_t H = 301;
+
+float sample(int c, size_t x, size_t y) {
+    return 0.01f * (c + 1) + 0.37f * x + 1.13f * y;
+}
+
+void writeTestFile(const std::string &filename, const Params &params) {
+    Frame frame(W, H);
+    Channel *Ch[3];
+    frame.createXYZChannels(Ch[0], Ch[1], Ch[2]);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t y = 0; y < H; ++y) {
+            for (size_t x = 0; x < W; ++x) {
+                (*Ch[c])(x, y) = sample(c, x, y);
+            }
+        }
+    }
+
+    EXRWriter writer(filename);
+    ASSERT_TRUE(writer.write(frame, params));
+}
+
+void checkFrame(const Frame &frame, size_t x0, size_t y0, float tolerance) {
+    const Channel *Ch[3];
+    frame.getXYZChannels(Ch[0], Ch[1], Ch[2]);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t y = 0; y < frame.getHeight(); ++y) {
+            for (size_t x = 0; x < frame.getWidth(); ++x) {
+                const float expected = sample(c, x0 + x, y0 + y);
+                ASSERT_NEAR(expected, (*Ch[c])(x, y), tolerance * expected)
+                    << "channel " << c << " pixel " << x << ", " << y;
+            }
+        }
+    }
+}
+}
+
+TEST(TestEXRParams, Compression) {
+    const std::string filename("TestEXRParams.exr");
+    const char *compressions[] = {"none", "zip", "PIZ"};
+    for (size_t i = 0; i < sizeof(compressions) / sizeof(compressions[0]);
+         ++i) {
+        writeTestFile(filename, Params("exr.compression",
+                                       std::string(compressions[i]))(
+                                    "exr.threads", 2));
+
+        Frame frame;
+        EXRReader(filename).read(frame, Params("exr.threads", 2));
+        ASSERT_EQ(W, frame.getWidth());
+        ASSERT_EQ(H, frame.getHeight());
+        checkFrame(frame, 0, 0, 0.f);
+    }
+
+    EXRWriter writer(filename);
+    EXPECT_THROW(writer.write(Frame(W, H), Params("exr.compression",
+                                                  std::string("lzw"))),
+                 pfs::io::WriteException);
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestEXRParams, Half) {
+    const std::string filename("TestEXRParams_half.exr");
+    writeTestFile(filename, Params("exr.half", true));
+
+    EXRReader reader(filename);
+    EXPECT_EQ(16, reader.probe().bitDepth);
+
+    Frame frame;
+    reader.read(frame, Params());
+    ASSERT_EQ(W, frame.getWidth());
+    ASSERT_EQ(H, frame.getHeight());
+    // 11 bits of mantissa
+    checkFrame(frame, 0, 0, 1e-3f);
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestEXRParams, HalfStorage) {
+    const std::string filename("TestEXRParams_storage.exr");
+    const std::string copyName("TestEXRParams_storage_float.exr");
+    writeTestFile(filename, Params("exr.half", true));
+
+    Frame frame;
+    EXRReader(filename).read(frame, Params("exr.half", true));
+    ASSERT_TRUE(frame.isHalf());
+    ASSERT_EQ(W, frame.getWidth());
+    ASSERT_EQ(H, frame.getHeight());
+    EXPECT_EQ(3u, frame.halfChannels()->getChannels().size());
+    EXPECT_EQ(filename, frame.getTags().getTag("FILE_NAME"));
+
+    // written as FLOAT from the half samples, without inflating the frame
+    EXRWriter writer(copyName);
+    ASSERT_TRUE(writer.write(frame, Params()));
+    EXPECT_TRUE(frame.isHalf());
+
+    EXRReader copyReader(copyName);
+    EXPECT_EQ(32, copyReader.probe().bitDepth);
+    Frame copy;
+    copyReader.read(copy, Params("exr.half", true));
+    // FLOAT samples are read in float
+    EXPECT_FALSE(copy.isHalf());
+
+    frame.inflate();
+    EXPECT_FALSE(frame.isHalf());
+    checkFrame(frame, 0, 0, 1e-3f);
+
+    const Channel *in[3];
+    const Channel *out[3];
+    frame.getXYZChannels(in[0], in[1], in[2]);
+    copy.getXYZChannels(out[0], out[1], out[2]);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t i = 0; i < frame.size(); ++i) {
+            ASSERT_EQ((*in[c])(i), (*out[c])(i));
+        }
+    }
+
+    // a window is read in float
+    Frame window;
+    EXRReader(filename).read(
+        window, Params("exr.half", true)("exr.window_height", size_t(10)));
+    EXPECT_FALSE(window.isHalf());
+    checkFrame(window, 0, 0, 1e-3f);
+
+    std::remove(filename.c_str());
+    std::remove(copyName.c_str());
+}
+
+TEST(TestEXRParams, Window) {
+    const std::string filename("TestEXRParams_window.exr");
+    writeTestFile(filename, Params());
+
+    EXRReader reader(filename);
+
+    // full rows
+    Frame rows;
+    reader.read(rows, Params("exr.window_y", size_t(13))("exr.window_height",
+                                                          size_t(40)));
+    ASSERT_EQ(W, rows.getWidth());
+    ASSERT_EQ(40u, rows.getHeight());
+    checkFrame(rows, 0, 13, 0.f);
+
+    // columns and rows, over more than one band, clipped to the image
+    Frame window;
+    reader.read(window, Params("exr.window_x", size_t(5))(
+                            "exr.window_y", size_t(7))(
+                            "exr.window_width", size_t(20))(
+                            "exr.window_height", size_t(1000)));
+    ASSERT_EQ(20u, window.getWidth());
+    ASSERT_EQ(H - 7, window.getHeight());
+    checkFrame(window, 5, 7, 0.f);
+
+    Frame outside;
+    EXPECT_THROW(reader.read(outside, Params("exr.window_x", W)),
+                 pfs::io::ReadException);
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,118 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <HdrCreation/feature_alignment.h>
+
+#include <Libpfs/frame.h>
+
+using namespace pfs;
+using namespace libhdr;
+
+namespace {
+
+float pattern(double x, double y) {
+    return static_cast<float>(
+        0.5 + 0.2 * std::sin(x / 9.) * std::cos(y / 13.) +
+        0.15 * std::sin((x - 2. * y) / 17.) +
+        0.1 * std::cos((3. * x + y) / 29.) * std::sin(y / 7.));
+}
+
+// frame content at pixel p is pattern(A p), A being a rotation of angle
+// (degrees) followed by a translation, scaled by exposure
+FramePtr buildFrame(size_t width, size_t height, double angle, double dx,
+                    double dy, float exposure) {
+    FramePtr frame = std::make_shared<Frame>(width, height);
+    Channel *X;
+    Channel *Y;
+    Channel *Z;
+    frame->createXYZChannels(X, Y, Z);
+
+    const double a = angle * M_PI / 180.;
+    for (size_t r = 0; r < height; ++r) {
+        for (size_t c = 0; c < width; ++c) {
+            double x = std::cos(a) * c - std::sin(a) * r + dx;
+            double y = std::sin(a) * c + std::cos(a) * r + dy;
+
+            float v = exposure * pattern(x, y);
+            (*X)(c, r) = v;
+            (*Y)(c, r) = v;
+            (*Z)(c, r) = v;
+        }
+    }
+    return frame;
+}
+}
+
+TEST(TestFeatureAlignment, TransformCompose)
+{
+    AlignmentTransform t1 = AlignmentTransform::translation(3., -2.);
+    AlignmentTransform t2;
+    t2(0, 0) = 2.;
+    t2(1, 1) = 2.;
+
+    double x, y;
+    (t2 * t1).apply(1., 1., x, y);
+    EXPECT_DOUBLE_EQ(8., x);
+    EXPECT_DOUBLE_EQ(-2., y);
+}
+
+TEST(TestFeatureAlignment, EstimateRigidMotion)
+{
+    const size_t width = 640;
+    const size_t height = 480;
+
+    std::vector<FramePtr> frames;
+    frames.push_back(buildFrame(width, height, 0.8, 7., -4., 0.25f));
+    frames.push_back(buildFrame(width, height, 0., 0., 0., 1.f));
+    frames.push_back(buildFrame(width, height, -0.5, -12., 5., 4.f));
+
+    FeatureAlignmentParams params;
+    params.model = FEATURE_ALIGN_AFFINE;
+
+    std::vector<AlignmentTransform> transforms =
+        feature_alignment_estimate(frames, params);
+    ASSERT_EQ(frames.size(), transforms.size());
+
+    // frame i at q shows the reference at p when A_i q = p
+    const double angles[] = {0.8, 0., -0.5};
+    const double dxs[] = {7., 0., -12.};
+    const double dys[] = {-4., 0., 5.};
+
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const double a = angles[i] * M_PI / 180.;
+        for (double py = 100.; py < height - 100.; py += 70.) {
+            for (double px = 100.; px < width - 100.; px += 70.) {
+                double qx, qy;
+                transforms[i].apply(px, py, qx, qy);
+
+                double rx = std::cos(a) * qx - std::sin(a) * qy + dxs[i];
+                double ry = std::sin(a) * qx + std::cos(a) * qy + dys[i];
+
+                EXPECT_NEAR(px, rx, 0.5) << "frame " << i;
+                EXPECT_NEAR(py, ry, 0.5) << "frame " << i;
+            }
+        }
+    }
+}
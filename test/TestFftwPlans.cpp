@@ -0,0 +1,109 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include <Common/fftwplans.h>
+
+namespace {
+//! \brief a small cache, with its wisdom in a temporary file
+class TestFftwPlans : public ::testing::Test {
+   protected:
+    TestFftwPlans() : plans(4), wisdom(std::tmpnam(NULL)) {}
+
+    void SetUp() {
+        plans.setWisdomFile(wisdom);
+        in = fftwf_alloc_real(64);
+        out = fftwf_alloc_real(64);
+    }
+
+    void TearDown() {
+        fftwf_free(out);
+        fftwf_free(in);
+        std::remove(wisdom.c_str());
+    }
+
+    FftwPlans plans;
+    std::string wisdom;
+    float *in;
+    float *out;
+};
+}
+
+TEST_F(TestFftwPlans, Hits) {
+    FftwPlans::Plan p =
+        plans.r2r1d(64, in, out, FFTW_REDFT00, FFTW_ESTIMATE);
+    ASSERT_TRUE(p != NULL);
+
+    // any array with the same properties gets the same plan
+    float *other = fftwf_alloc_real(64);
+    EXPECT_EQ(p, plans.r2r1d(64, other, out, FFTW_REDFT00, FFTW_ESTIMATE));
+    EXPECT_EQ(1u, plans.size());
+
+    // but the in-place or unaligned transforms are planned on their own
+    EXPECT_NE(p, plans.r2r1d(64, in, in, FFTW_REDFT00, FFTW_ESTIMATE));
+    EXPECT_NE(p, plans.r2r1d(64, in + 1, out, FFTW_REDFT00, FFTW_ESTIMATE));
+    EXPECT_NE(p, plans.r2r1d(32, in, out, FFTW_REDFT00, FFTW_ESTIMATE));
+    EXPECT_EQ(4u, plans.size());
+    fftwf_free(other);
+}
+
+TEST_F(TestFftwPlans, Eviction) {
+    FftwPlans::Plan kept =
+        plans.r2r1d(64, in, out, FFTW_REDFT00, FFTW_ESTIMATE);
+    for (int n = 2; n < 12; ++n) {
+        plans.r2r1d(n, in, out, FFTW_REDFT00, FFTW_ESTIMATE);
+    }
+    EXPECT_EQ(4u, plans.size());
+    // the plan in use is never evicted
+    EXPECT_EQ(kept, plans.r2r1d(64, in, out, FFTW_REDFT00, FFTW_ESTIMATE));
+
+    plans.clear();
+    EXPECT_EQ(0u, plans.size());
+}
+
+TEST_F(TestFftwPlans, NewArray) {
+    // planned on a scratch array: the data of the caller are not touched
+    for (int i = 0; i < 8; ++i) in[i] = 1.f;
+    FftwPlans::Plan p = plans.r2r1d(8, in, out, FFTW_REDFT00, FFTW_MEASURE);
+    ASSERT_TRUE(p != NULL);
+    for (int i = 0; i < 8; ++i) ASSERT_EQ(1.f, in[i]);
+
+    // DCT-I of a constant: 2 (n - 1) at the DC term, nothing elsewhere
+    fftwf_execute_r2r(p.get(), in, out);
+    EXPECT_NEAR(14.f, out[0], 1e-4f);
+    for (int i = 1; i < 8; ++i) EXPECT_NEAR(0.f, out[i], 1e-4f);
+}
+
+TEST_F(TestFftwPlans, EstimateOnCallerArrays) {
+    // FFTW_ESTIMATE is planned on the arrays of the caller, unchanged
+    for (int i = 0; i < 8; ++i) in[i] = 1.f;
+    FftwPlans::Plan p = plans.r2r1d(8, in, out, FFTW_REDFT00, FFTW_ESTIMATE);
+    ASSERT_TRUE(p != NULL);
+    for (int i = 0; i < 8; ++i) ASSERT_EQ(1.f, in[i]);
+
+    fftwf_execute_r2r(p.get(), in, out);
+    EXPECT_NEAR(14.f, out[0], 1e-4f);
+    for (int i = 1; i < 8; ++i) EXPECT_NEAR(0.f, out[i], 1e-4f);
+}
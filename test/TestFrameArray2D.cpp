@@ -126,3 +126,104 @@ TEST(TestArray2D, Ctor)
         compareVectors(array2d_v2.data(), array2d_2.data(), array2d.size());
     }
 }
+
+TEST(TestArray2D, CopyOnWrite)
+{
+    typedef pfs::Array2D<int> array2d_int_t;
+
+    array2d_int_t array2d(5, 5);
+    std::generate(array2d.begin(), array2d.end(), SeqInt());
+
+    array2d_int_t array2d_v2(array2d);
+    const array2d_int_t& c_array2d = array2d;
+    const array2d_int_t& c_array2d_v2 = array2d_v2;
+
+    // the copy shares the buffer...
+    EXPECT_TRUE(array2d.isShared());
+    EXPECT_EQ(c_array2d.data(), c_array2d_v2.data());
+
+    // ... until it is written
+    array2d_v2(2, 2) = -1;
+    EXPECT_FALSE(array2d_v2.isShared());
+    EXPECT_FALSE(array2d.isShared());
+    EXPECT_NE(c_array2d.data(), c_array2d_v2.data());
+    EXPECT_EQ(array2d(2, 2), 12);
+    EXPECT_EQ(array2d_v2(2, 2), -1);
+    EXPECT_EQ(array2d_v2(2, 3), 17);
+
+    // the source can be written after the copy has been destroyed, without
+    // any copy
+    const int* d1 = c_array2d.data();
+    {
+        array2d_int_t array2d_v3 = array2d;
+    }
+    array2d(0, 0) = -1;
+    EXPECT_EQ(d1, c_array2d.data());
+}
+
+TEST(TestArray2D, CopyOnWriteParallel)
+{
+    pfs::Array2Df array2d(256, 256);
+    array2d.fill(1.f);
+
+    pfs::Array2Df array2d_v2(array2d);
+
+    // the first writes from different threads detach the buffer once
+#pragma omp parallel for
+    for (int i = 0; i < (int)array2d_v2.size(); ++i) {
+        array2d_v2(i) = 2.f * i;
+    }
+
+    const pfs::Array2Df& c_array2d = array2d;
+    for (size_t i = 0; i < array2d.size(); ++i) {
+        ASSERT_EQ(c_array2d(i), 1.f);
+        ASSERT_EQ(array2d_v2(i), 2.f * i);
+    }
+}
+
+TEST(TestFrame, CopyOnWrite)
+{
+    Frame frame(10, 20);
+    Channel *X, *Y, *Z;
+    frame.createXYZChannels(X, Y, Z);
+    X->fill(1.f);
+    Y->fill(2.f);
+    Z->fill(3.f);
+    frame.getTags().setTag("TAG", "value");
+    X->getTags().setTag("CHTAG", "chvalue");
+
+    Frame copy(frame);
+    EXPECT_EQ(copy.getWidth(), frame.getWidth());
+    EXPECT_EQ(copy.getHeight(), frame.getHeight());
+    EXPECT_EQ(copy.getTags().getTag("TAG"), "value");
+
+    Channel *cX, *cY, *cZ;
+    copy.getXYZChannels(cX, cY, cZ);
+    ASSERT_TRUE(cX != NULL);
+    EXPECT_NE(cX, X);
+    EXPECT_EQ(cX->getName(), "X");
+    EXPECT_EQ(cX->getTags().getTag("CHTAG"), "chvalue");
+    EXPECT_TRUE(Y->isShared());
+
+    // replacing a channel does not touch the source
+    cY->fill(-2.f);
+    copy.removeChannel("Z");
+    EXPECT_FALSE(Y->isShared());
+    EXPECT_EQ((*Y)(5, 5), 2.f);
+    EXPECT_EQ((*cY)(5, 5), -2.f);
+    EXPECT_EQ((*Z)(5, 5), 3.f);
+
+    // assignment
+    copy = frame;
+    copy.getXYZChannels(cX, cY, cZ);
+    ASSERT_TRUE(cZ != NULL);
+    EXPECT_EQ((*cY)(5, 5), 2.f);
+    EXPECT_TRUE(Z->isShared());
+
+    // an element write detaches the channel written only
+    EXPECT_TRUE(X->isShared());
+    (*cX)(5, 5) = -1.f;
+    EXPECT_FALSE(X->isShared());
+    EXPECT_TRUE(Z->isShared());
+    EXPECT_EQ((*X)(5, 5), 1.f);
+}
@@ -0,0 +1,99 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include <Libpfs/frame.h>
+#include <Libpfs/io/pfsreader.h>
+#include <Libpfs/io/pfswriter.h>
+#include <Libpfs/io/rgbereader.h>
+#include <Libpfs/io/rgbewriter.h>
+
+using namespace pfs;
+using namespace pfs::io;
+
+namespace {
+
+const size_t W = 37;
+const size_t H = 23;
+
+void writeFrame(FrameWriter &writer) {
+    Frame frame(W, H);
+    Channel *X, *Y, *Z;
+    frame.createXYZChannels(X, Y, Z);
+    for (size_t k = 0; k < W * H; ++k) {
+        (*X)(k) = (*Y)(k) = (*Z)(k) = 0.5f;
+    }
+    ASSERT_TRUE(writer.write(frame, Params()));
+}
+}
+
+TEST(TestFrameReaderProbe, Pfs) {
+    const std::string filename("TestFrameReaderProbe.pfs");
+    {
+        PfsWriter writer(filename);
+        writeFrame(writer);
+    }
+
+    PfsReader reader(filename);
+    FrameInfo info = reader.probe();
+    EXPECT_EQ(W, info.width);
+    EXPECT_EQ(H, info.height);
+    EXPECT_EQ(3, info.channels);
+    EXPECT_EQ(32, info.bitDepth);
+    EXPECT_TRUE(info.isFloat);
+    EXPECT_FALSE(info.exif.isValid());
+    EXPECT_EQ(W * H * 3 * sizeof(float), info.frameBytes());
+
+    // the reader can still decode the file
+    Frame frame;
+    reader.read(frame, Params());
+    EXPECT_EQ(W, frame.getWidth());
+    EXPECT_EQ(H, frame.getHeight());
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestFrameReaderProbe, Rgbe) {
+    const std::string filename("TestFrameReaderProbe.hdr");
+    {
+        RGBEWriter writer(filename);
+        writeFrame(writer);
+    }
+
+    RGBEReader reader(filename);
+    FrameInfo info = reader.probe();
+    EXPECT_EQ(W, info.width);
+    EXPECT_EQ(H, info.height);
+    EXPECT_EQ(3, info.channels);
+    EXPECT_EQ(8, info.bitDepth);
+    EXPECT_TRUE(info.isFloat);
+
+    Frame frame;
+    reader.read(frame, Params());
+    EXPECT_EQ(W, frame.getWidth());
+    EXPECT_EQ(H, frame.getHeight());
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,185 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+
+#include <Libpfs/array2dview.h>
+#include <Libpfs/colorspace/colorspace.h>
+#include <Libpfs/frame.h>
+#include <Libpfs/frameview.h>
+#include <Libpfs/manip/cut.h>
+#include <Libpfs/manip/resize.h>
+
+#include "SeqInt.h"
+
+using namespace pfs;
+
+TEST(TestArray2DView, SubView)
+{
+    Array2Df array(6, 5);
+    std::generate(array.begin(), array.end(), SeqInt());
+
+    Array2DConstViewf view(array, 1, 1, 5, 4);
+    EXPECT_EQ(view.getCols(), 4u);
+    EXPECT_EQ(view.getRows(), 3u);
+    EXPECT_EQ(view.getStride(), 6u);
+    EXPECT_FALSE(view.isContiguous());
+    EXPECT_EQ(view(0, 0), 7.f);
+    EXPECT_EQ(view(3, 2), 22.f);
+    EXPECT_EQ(view[1][2], 15.f);
+
+    Array2DConstViewf sub = view.subView(1, 1, 3, 3);
+    EXPECT_EQ(sub.getCols(), 2u);
+    EXPECT_EQ(sub.getRows(), 2u);
+    EXPECT_EQ(sub(0, 0), 14.f);
+    EXPECT_EQ(sub(1, 1), 21.f);
+
+    // the view does not own the data
+    array(2, 1) = -1.f;
+    EXPECT_EQ(view(1, 0), -1.f);
+}
+
+TEST(TestArray2DView, Copy)
+{
+    Array2Df array(6, 5);
+    std::generate(array.begin(), array.end(), SeqInt());
+
+    Array2Df output(6, 5);
+    output.fill(0.f);
+
+    // write a rectangle of output through a view
+    copy(Array2DConstViewf(array, 0, 0, 2, 2),
+         Array2DViewf(output, 3, 2, 5, 4));
+    EXPECT_EQ(output(3, 2), 0.f);
+    EXPECT_EQ(output(4, 2), 1.f);
+    EXPECT_EQ(output(3, 3), 6.f);
+    EXPECT_EQ(output(4, 3), 7.f);
+    EXPECT_EQ(output(2, 2), 0.f);
+    EXPECT_EQ(output(5, 3), 0.f);
+}
+
+namespace {
+Frame *createFrame(size_t width, size_t height)
+{
+    Frame *frame = new Frame(width, height);
+    Channel *X, *Y, *Z;
+    frame->createXYZChannels(X, Y, Z);
+    std::generate(X->begin(), X->end(), SeqInt());
+    for (size_t i = 0; i < frame->size(); ++i) {
+        (*Y)(i) = 1.f + (*X)(i) * 0.5f;
+        (*Z)(i) = 2.f + (*X)(i) * 0.25f;
+    }
+    frame->getTags().setTag("TAG", "value");
+    return frame;
+}
+}
+
+TEST(TestFrameView, Clip)
+{
+    std::unique_ptr<Frame> frame(createFrame(20, 10));
+
+    FrameView full(*frame);
+    EXPECT_TRUE(full.isFullFrame());
+
+    FrameView view(*frame, 15, 4, 100, 100);
+    EXPECT_FALSE(view.isFullFrame());
+    EXPECT_EQ(view.getX(), 15u);
+    EXPECT_EQ(view.getY(), 4u);
+    EXPECT_EQ(view.getWidth(), 5u);
+    EXPECT_EQ(view.getHeight(), 6u);
+
+    FrameView::ChannelView X, Y, Z;
+    ASSERT_TRUE(view.getXYZChannels(X, Y, Z));
+    EXPECT_EQ(X(0, 0), 4.f * 20 + 15);
+    EXPECT_TRUE(view.getChannel("A").empty());
+}
+
+TEST(TestFrameView, Cut)
+{
+    std::unique_ptr<Frame> frame(createFrame(20, 10));
+
+    std::unique_ptr<Frame> cutFrame(cut(FrameView(*frame, 3, 2, 11, 9)));
+    ASSERT_EQ(cutFrame->getWidth(), 8u);
+    ASSERT_EQ(cutFrame->getHeight(), 7u);
+    EXPECT_EQ(cutFrame->getTags().getTag("TAG"), "value");
+
+    const Channel *inY = frame->getChannel("Y");
+    const Channel *outY = cutFrame->getChannel("Y");
+    ASSERT_TRUE(outY != NULL);
+    for (size_t y = 0; y < cutFrame->getHeight(); ++y) {
+        for (size_t x = 0; x < cutFrame->getWidth(); ++x) {
+            ASSERT_EQ((*outY)(x, y), (*inY)(x + 3, y + 2));
+        }
+    }
+}
+
+TEST(TestFrameView, Resize)
+{
+    std::unique_ptr<Frame> frame(createFrame(200, 100));
+    FrameView view(*frame, 20, 10, 140, 70);
+
+    // resampling the view is the same as resampling its copy
+    std::unique_ptr<Frame> cutFrame(cut(view));
+
+    const InterpolationMethod methods[] = {BilinearInterp, LanczosInterp};
+    for (size_t m = 0; m < 2; ++m) {
+        std::unique_ptr<Frame> expected(
+            resize(cutFrame.get(), 50, methods[m]));
+        std::unique_ptr<Frame> resized(resize(view, 50, methods[m]));
+
+        ASSERT_EQ(resized->getWidth(), expected->getWidth());
+        ASSERT_EQ(resized->getHeight(), expected->getHeight());
+
+        const Channel *e = expected->getChannel("Z");
+        const Channel *r = resized->getChannel("Z");
+        for (size_t i = 0; i < r->size(); ++i) {
+            ASSERT_EQ((*e)(i), (*r)(i));
+        }
+    }
+}
+
+TEST(TestFrameView, TransformColorSpace)
+{
+    std::unique_ptr<Frame> frame(createFrame(20, 10));
+    FrameView view(*frame, 5, 5, 15, 10);
+
+    FrameView::ChannelView X, Y, Z;
+    ASSERT_TRUE(view.getXYZChannels(X, Y, Z));
+
+    Array2Df R(view.getWidth(), view.getHeight());
+    Array2Df G(view.getWidth(), view.getHeight());
+    Array2Df B(view.getWidth(), view.getHeight());
+    transformColorSpace(CS_XYZ, X, Y, Z, CS_RGB, &R, &G, &B);
+
+    std::unique_ptr<Frame> cutFrame(cut(view));
+    Channel *cX, *cY, *cZ;
+    cutFrame->getXYZChannels(cX, cY, cZ);
+    transformColorSpace(CS_XYZ, cX, cY, cZ, CS_RGB, cX, cY, cZ);
+
+    for (size_t i = 0; i < R.size(); ++i) {
+        ASSERT_EQ((*cX)(i), R(i));
+        ASSERT_EQ((*cY)(i), G(i));
+        ASSERT_EQ((*cZ)(i), B(i));
+    }
+}
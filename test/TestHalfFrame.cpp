@@ -0,0 +1,319 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <Libpfs/frame.h>
+#include <Libpfs/frameview.h>
+#include <Libpfs/halfframe.h>
+#include <Libpfs/manip/cut.h>
+#include <Libpfs/manip/resize.h>
+#include <Libpfs/utils/cpufeatures.h>
+#include <Libpfs/utils/float16.h>
+
+using namespace pfs;
+using namespace pfs::utils;
+
+TEST(TestFloat16, Exact) {
+    // values with at most 11 significant bits are represented exactly
+    const float values[] = {0.f,      1.f,         -2.f,   0.5f,
+                            1024.f,   2047.f,      0.375f, FLOAT16_MAX,
+                            -65504.f, 6.103515625e-05f};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        EXPECT_EQ(values[i], halfToFloat(floatToHalf(values[i])));
+    }
+
+    EXPECT_EQ(0x3c00, floatToHalf(1.f));
+    EXPECT_EQ(0x7bff, floatToHalf(FLOAT16_MAX));
+    EXPECT_EQ(0x8000, floatToHalf(-0.f));
+}
+
+TEST(TestFloat16, Rounding) {
+    // halfway between 2048 and 2050: to the nearest even
+    EXPECT_EQ(2048.f, halfToFloat(floatToHalf(2049.f)));
+    EXPECT_EQ(2052.f, halfToFloat(floatToHalf(2051.f)));
+    EXPECT_EQ(2050.f, halfToFloat(floatToHalf(2050.5f)));
+
+    for (float v = 1e-3f; v < 6e4f; v *= 1.37f) {
+        EXPECT_NEAR(v, halfToFloat(floatToHalf(v)), v / 2048.f);
+    }
+}
+
+TEST(TestFloat16, Denormals) {
+    // smallest subnormal
+    const float tiny = std::ldexp(1.f, -24);
+    EXPECT_EQ(0x0001, floatToHalf(tiny));
+    EXPECT_EQ(tiny, halfToFloat(0x0001));
+    EXPECT_EQ(3 * tiny, halfToFloat(floatToHalf(3 * tiny)));
+    // underflow
+    EXPECT_EQ(0.f, halfToFloat(floatToHalf(tiny / 4)));
+}
+
+TEST(TestFloat16, Specials) {
+    const float inf = std::numeric_limits<float>::infinity();
+    EXPECT_EQ(inf, halfToFloat(floatToHalf(inf)));
+    EXPECT_EQ(-inf, halfToFloat(floatToHalf(1e6f * -1.f)));
+    EXPECT_TRUE(std::isnan(
+        halfToFloat(floatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(TestFloat16, Bulk) {
+    // more than a vector of 8, with a tail
+    std::vector<float> in;
+    for (int i = 0; i < 1003; ++i) {
+        in.push_back((i - 500) * 0.731f);
+    }
+    in.push_back(1e9f);
+    in.push_back(-1e9f);
+    in.push_back(std::numeric_limits<float>::quiet_NaN());
+
+    std::vector<float16> half(in.size());
+    floatToHalf(in.data(), half.data(), in.size());
+
+    std::vector<float> out(in.size());
+    halfToFloat(half.data(), out.data(), half.size());
+
+    for (size_t i = 0; i < 1003; ++i) {
+        ASSERT_EQ(floatToHalf(in[i]), half[i]) << i;
+        ASSERT_EQ(halfToFloat(half[i]), out[i]) << i;
+    }
+    // clamped instead of infinite
+    EXPECT_EQ(FLOAT16_MAX, out[1003]);
+    EXPECT_EQ(-FLOAT16_MAX, out[1004]);
+    EXPECT_TRUE(std::isnan(out[1005]));
+}
+
+TEST(TestFloat16, Dispatch) {
+    // the F16C and the scalar conversions give the same bits
+    std::vector<float> in;
+    for (int i = 0; i < 4099; ++i) {
+        in.push_back(std::ldexp((i % 97) * 0.013f - 0.6f, i % 41 - 25));
+    }
+    std::vector<float16> dispatched(in.size());
+    floatToHalf(in.data(), dispatched.data(), in.size());
+    std::vector<float> back(in.size());
+    halfToFloat(dispatched.data(), back.data(), in.size());
+
+    const SimdLevel level = simdLevel();
+    setSimdLevel(SIMD_SSE2);
+    EXPECT_FALSE(hasF16C());
+    std::vector<float16> scalar(in.size());
+    floatToHalf(in.data(), scalar.data(), in.size());
+    std::vector<float> scalarBack(in.size());
+    halfToFloat(scalar.data(), scalarBack.data(), in.size());
+    setSimdLevel(level);
+
+    for (size_t i = 0; i < in.size(); ++i) {
+        ASSERT_EQ(scalar[i], dispatched[i]) << i;
+        ASSERT_EQ(scalarBack[i], back[i]) << i;
+    }
+}
+
+namespace {
+
+void fillFrame(Frame &frame) {
+    Channel *Ch[3];
+    frame.createXYZChannels(Ch[0], Ch[1], Ch[2]);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t y = 0; y < frame.getHeight(); ++y) {
+            for (size_t x = 0; x < frame.getWidth(); ++x) {
+                (*Ch[c])(x, y) = 0.25f * (c + 1) + x + 16.f * y;
+            }
+        }
+    }
+}
+}
+
+TEST(TestHalfFrame, EncodeDecode) {
+    Frame frame(13, 7);
+    fillFrame(frame);
+    frame.getTags().setTag("LUMINANCE", "ABSOLUTE");
+    frame.getChannel("Y")->getTags().setTag("TAG", "value");
+
+    HalfFrame half(frame);
+    ASSERT_EQ(frame.getWidth(), half.getWidth());
+    ASSERT_EQ(frame.getHeight(), half.getHeight());
+    ASSERT_EQ(3u, half.getChannels().size());
+    EXPECT_EQ(NULL, half.getChannel("W"));
+
+    Frame decoded;
+    half.decode(decoded);
+    ASSERT_EQ(frame.getWidth(), decoded.getWidth());
+    ASSERT_EQ(frame.getHeight(), decoded.getHeight());
+    EXPECT_EQ("ABSOLUTE", decoded.getTags().getTag("LUMINANCE"));
+    EXPECT_EQ("value", decoded.getChannel("Y")->getTags().getTag("TAG"));
+
+    const char *names[] = {"X", "Y", "Z"};
+    for (int c = 0; c < 3; ++c) {
+        const Channel *in = frame.getChannel(names[c]);
+        const Channel *out = decoded.getChannel(names[c]);
+        ASSERT_TRUE(out != NULL);
+        for (size_t i = 0; i < frame.size(); ++i) {
+            // all the values are exact in half precision
+            ASSERT_EQ((*in)(i), (*out)(i));
+        }
+    }
+}
+
+TEST(TestHalfFrame, Rows) {
+    Frame frame(11, 20);
+    fillFrame(frame);
+
+    HalfFrame half(frame.getWidth(), frame.getHeight());
+    // encode and decode in bands of 6 rows, the last one partial
+    const size_t bandRows = 6;
+    for (size_t row = 0; row < frame.getHeight(); row += bandRows) {
+        const size_t rows = std::min(bandRows, frame.getHeight() - row);
+        Frame band(frame.getWidth(), rows);
+        const Channel *Ch[3];
+        frame.getXYZChannels(Ch[0], Ch[1], Ch[2]);
+        Channel *B[3];
+        band.createXYZChannels(B[0], B[1], B[2]);
+        for (int c = 0; c < 3; ++c) {
+            std::copy(Ch[c]->row_begin(row), Ch[c]->row_begin(row + rows),
+                      B[c]->begin());
+        }
+        half.encodeRows(band, row);
+    }
+    ASSERT_EQ(3u, half.getChannels().size());
+
+    Frame band;
+    half.decodeRows(5, 4, band);
+    ASSERT_EQ(frame.getWidth(), band.getWidth());
+    ASSERT_EQ(4u, band.getHeight());
+
+    const Channel *X = frame.getChannel("X");
+    const Channel *bandX = band.getChannel("X");
+    ASSERT_TRUE(bandX != NULL);
+    for (size_t y = 0; y < band.getHeight(); ++y) {
+        for (size_t x = 0; x < band.getWidth(); ++x) {
+            ASSERT_EQ((*X)(x, y + 5), (*bandX)(x, y));
+        }
+    }
+}
+
+namespace {
+
+//! \brief frame storing the channels of \a frame in half precision
+void makeHalf(const Frame &frame, Frame &half) {
+    half.getTags() = frame.getTags();
+    half.setHalfChannels(HalfFrame(frame));
+}
+
+void expectEqual(const Frame &expected, const Frame &actual) {
+    ASSERT_EQ(expected.getWidth(), actual.getWidth());
+    ASSERT_EQ(expected.getHeight(), actual.getHeight());
+    const char *names[] = {"X", "Y", "Z"};
+    for (int c = 0; c < 3; ++c) {
+        const Channel *in = expected.getChannel(names[c]);
+        const Channel *out = actual.getChannel(names[c]);
+        ASSERT_TRUE(out != NULL);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ((*in)(i), (*out)(i)) << names[c] << " " << i;
+        }
+    }
+}
+}
+
+TEST(TestHalfFrame, FrameStorage) {
+    Frame frame(13, 7);
+    fillFrame(frame);
+    frame.getTags().setTag("LUMINANCE", "ABSOLUTE");
+    frame.getChannel("Y")->getTags().setTag("TAG", "value");
+
+    Frame half;
+    makeHalf(frame, half);
+    ASSERT_TRUE(half.isHalf());
+    ASSERT_TRUE(half.halfChannels() != NULL);
+    EXPECT_EQ(frame.getWidth(), half.getWidth());
+    EXPECT_EQ(frame.getHeight(), half.getHeight());
+    EXPECT_EQ(3u, half.halfChannels()->getChannels().size());
+
+    // the copy shares the half precision channels
+    Frame copy(half);
+    ASSERT_TRUE(copy.isHalf());
+    EXPECT_EQ(half.halfChannels(), copy.halfChannels());
+
+    // the first access to a channel inflates the frame
+    const Frame &constHalf = half;
+    const Channel *Y = constHalf.getChannel("Y");
+    ASSERT_TRUE(Y != NULL);
+    EXPECT_FALSE(half.isHalf());
+    EXPECT_EQ("value", Y->getTags().getTag("TAG"));
+    EXPECT_EQ("ABSOLUTE", half.getTags().getTag("LUMINANCE"));
+    expectEqual(frame, half);
+
+    EXPECT_TRUE(copy.isHalf());
+    copy.inflate();
+    EXPECT_FALSE(copy.isHalf());
+    expectEqual(frame, copy);
+}
+
+TEST(TestHalfFrame, Resize) {
+    Frame source(301, 203);
+    fillFrame(source);
+    Frame half;
+    makeHalf(source, half);
+    // the float reference holds the same (rounded) samples
+    Frame frame(half);
+    frame.inflate();
+
+    const InterpolationMethod methods[] = {BilinearInterp, LanczosInterp};
+    const int widths[] = {301, 120, 31, 760};
+    for (int m = 0; m < 2; ++m) {
+        for (int w = 0; w < 4; ++w) {
+            SCOPED_TRACE(widths[w]);
+            std::unique_ptr<Frame> expected(
+                resize(&frame, widths[w], methods[m]));
+            std::unique_ptr<Frame> actual(resize(&half, widths[w], methods[m]));
+            ASSERT_TRUE(half.isHalf());
+            expectEqual(*expected, *actual);
+        }
+
+        // a rectangle
+        SCOPED_TRACE("rectangle");
+        std::unique_ptr<Frame> expected(
+            resize(FrameView(frame, 17, 9, 250, 180), 97, methods[m]));
+        std::unique_ptr<Frame> actual(
+            resize(FrameView(half, 17, 9, 250, 180), 97, methods[m]));
+        ASSERT_TRUE(half.isHalf());
+        expectEqual(*expected, *actual);
+    }
+}
+
+TEST(TestHalfFrame, Cut) {
+    Frame frame(41, 23);
+    fillFrame(frame);
+    frame.getTags().setTag("LUMINANCE", "ABSOLUTE");
+    Frame half;
+    makeHalf(frame, half);
+
+    std::unique_ptr<Frame> expected(cut(&frame, 3, 5, 30, 21));
+    std::unique_ptr<Frame> actual(cut(&half, 3, 5, 30, 21));
+    ASSERT_TRUE(half.isHalf());
+    EXPECT_EQ("ABSOLUTE", actual->getTags().getTag("LUMINANCE"));
+    expectEqual(*expected, *actual);
+}
@@ -0,0 +1,153 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <Libpfs/frame.h>
+#include <Libpfs/io/jpegreader.h>
+#include <Libpfs/io/jpegwriter.h>
+
+using namespace pfs;
+using namespace pfs::io;
+
+namespace {
+
+const size_t W = 160;
+const size_t H = 96;
+
+//! \brief write a smooth gradient, so that the scaled decode is close to the
+//! average of the full resolution one
+std::string writeTestJpeg() {
+    const std::string filename("TestJpegPreview.jpg");
+
+    Frame frame(W, H);
+    Channel *X, *Y, *Z;
+    frame.createXYZChannels(X, Y, Z);
+    for (size_t y = 0; y < H; ++y) {
+        for (size_t x = 0; x < W; ++x) {
+            (*X)(x, y) = 0.1f + 0.8f * x / W;
+            (*Y)(x, y) = 0.1f + 0.8f * y / H;
+            (*Z)(x, y) = 0.5f;
+        }
+    }
+
+    JpegWriter writer(filename);
+    EXPECT_TRUE(writer.write(frame, Params("quality", size_t(100))));
+    return filename;
+}
+
+//! \brief every pixel of \a preview is close to the average of the
+//! corresponding block of \a full
+void compareWithFull(const Frame &full, const Frame &preview) {
+    const size_t step = full.getWidth() / preview.getWidth();
+    ASSERT_EQ(full.getHeight() / step, preview.getHeight());
+
+    const Channel *f[3];
+    full.getXYZChannels(f[0], f[1], f[2]);
+    const Channel *p[3];
+    preview.getXYZChannels(p[0], p[1], p[2]);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t y = 0; y < preview.getHeight(); ++y) {
+            for (size_t x = 0; x < preview.getWidth(); ++x) {
+                float mean = 0.f;
+                for (size_t j = 0; j < step; ++j) {
+                    for (size_t i = 0; i < step; ++i) {
+                        mean += (*f[c])(x * step + i, y * step + j);
+                    }
+                }
+                mean /= (step * step);
+                ASSERT_NEAR(mean, (*p[c])(x, y), 0.02f) << "channel " << c
+                                                        << " pixel " << x
+                                                        << ", " << y;
+            }
+        }
+    }
+}
+}
+
+TEST(TestJpegPreview, DctScaling) {
+    const std::string filename = writeTestJpeg();
+
+    Frame full;
+    JpegReader(filename).read(full, Params());
+    ASSERT_EQ(W, full.getWidth());
+    ASSERT_EQ(H, full.getHeight());
+
+    // 1/8 is too small, 1/4 is enough
+    Frame preview;
+    JpegReader reader(filename);
+    reader.readPreview(preview, W / 4, Params());
+    EXPECT_EQ(W / 4, preview.getWidth());
+    EXPECT_EQ(H / 4, preview.getHeight());
+    compareWithFull(full, preview);
+
+    // the same reader can be used again
+    reader.readPreview(preview, W / 8, Params());
+    EXPECT_EQ(W / 8, preview.getWidth());
+    EXPECT_EQ(H / 8, preview.getHeight());
+    compareWithFull(full, preview);
+
+    // the image is smaller than the requested preview
+    reader.readPreview(preview, 2 * W, Params());
+    EXPECT_EQ(W, preview.getWidth());
+    EXPECT_EQ(H, preview.getHeight());
+
+    std::remove(filename.c_str());
+}
+
+TEST(TestJpegPreview, Buffer) {
+    const std::string filename = writeTestJpeg();
+
+    Frame expected;
+    JpegReader(filename).readPreview(expected, W / 2, Params());
+
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    const std::vector<unsigned char> buffer(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+    file.close();
+
+    Frame preview;
+    readJpegPreview(buffer.data(), buffer.size(), W / 2, preview);
+    ASSERT_EQ(expected.getWidth(), preview.getWidth());
+    ASSERT_EQ(expected.getHeight(), preview.getHeight());
+
+    // the reader might apply the embedded sRGB profile
+    const Channel *e[3];
+    expected.getXYZChannels(e[0], e[1], e[2]);
+    const Channel *p[3];
+    preview.getXYZChannels(p[0], p[1], p[2]);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t k = 0; k < preview.getWidth() * preview.getHeight(); ++k) {
+            ASSERT_NEAR((*e[c])(k), (*p[c])(k), 2.f / 255.f);
+        }
+    }
+
+    EXPECT_THROW(readJpegPreview(buffer.data(), 16, W / 2, preview),
+                 pfs::io::ReadException);
+
+    std::remove(filename.c_str());
+}
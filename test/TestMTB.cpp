@@ -1,8 +1,143 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdlib>
+
 #include <HdrCreation/mtb_alignment.h>
+#include <HdrCreation/mtb_bitmap.h>
+
+#include <Libpfs/array2d.h>
+#include <Libpfs/frame.h>
+#include <Libpfs/manip/shift.h>
+
+using namespace pfs;
+using namespace libhdr;
+
+namespace {
+
+// reference implementation of the XOR count on unpacked bitmaps
+long referenceXOR(const Array2D<uint8_t> &img, int threshold1, int threshold2,
+                  int noise, int dx, int dy) {
+    Array2D<uint8_t> shifted(img.getCols(), img.getRows());
+    Array2D<uint8_t> valid(img.getCols(), img.getRows());
+    Array2D<uint8_t> ones(img.getCols(), img.getRows());
+    ones.fill(1);
+    pfs::shift(img, dx, dy, shifted);
+    pfs::shift(ones, dx, dy, valid);
+
+    long err = 0;
+    for (size_t idx = 0; idx < img.size(); ++idx) {
+        int v1 = img(idx);
+        int v2 = shifted(idx);
+
+        bool t1 = v1 >= threshold1;
+        bool m1 = v1 <= threshold1 - noise || v1 >= threshold1 + noise;
+        bool t2 = valid(idx) && v2 >= threshold2;
+        bool m2 = valid(idx) &&
+                  (v2 <= threshold2 - noise || v2 >= threshold2 + noise);
+
+        err += ((t1 != t2) && m1 && m2);
+    }
+    return err;
+}
+
+void fillPattern(Frame &frame, int offsetX, int offsetY) {
+    Channel *X;
+    Channel *Y;
+    Channel *Z;
+    frame.createXYZChannels(X, Y, Z);
+
+    for (size_t r = 0; r < frame.getHeight(); ++r) {
+        for (size_t c = 0; c < frame.getWidth(); ++c) {
+            float x = static_cast<float>(c) + offsetX;
+            float y = static_cast<float>(r) + offsetY;
+            float v = 0.5f + 0.25f * std::sin(x / 7.f) * std::cos(y / 11.f) +
+                      0.2f * std::sin((x + y) / 23.f);
+
+            (*X)(c, r) = v;
+            (*Y)(c, r) = v;
+            (*Z)(c, r) = v;
+        }
+    }
+}
+}
+
+TEST(TestMTB, BitmapSetGet)
+{
+    MTBBitmap bitmap(130, 3);
+    ASSERT_EQ(bitmap.getWordsPerRow(), 3u);
+
+    bitmap.set(0, 0, true);
+    bitmap.set(63, 1, true);
+    bitmap.set(64, 1, true);
+    bitmap.set(129, 2, true);
+
+    EXPECT_TRUE(bitmap(0, 0));
+    EXPECT_FALSE(bitmap(1, 0));
+    EXPECT_TRUE(bitmap(63, 1));
+    EXPECT_TRUE(bitmap(64, 1));
+    EXPECT_TRUE(bitmap(129, 2));
+
+    bitmap.set(64, 1, false);
+    EXPECT_FALSE(bitmap(64, 1));
+}
 
-TEST(TestMTB, getLum)
+TEST(TestMTB, XORimages)
 {
+    const size_t cols = 197;
+    const size_t rows = 31;
+
+    Array2D<uint8_t> img(cols, rows);
+    srand(42);
+    for (size_t idx = 0; idx < img.size(); ++idx) {
+        img(idx) = static_cast<uint8_t>(rand() % 256);
+    }
+
+    const int noise = 4;
+    const int threshold1 = 120;
+    const int threshold2 = 130;
+
+    MTBBitmap t1(cols, rows);
+    MTBBitmap m1(cols, rows);
+    MTBBitmap t2(cols, rows);
+    MTBBitmap m2(cols, rows);
+    setThreshold(img, threshold1, noise, t1, m1);
+    setThreshold(img, threshold2, noise, t2, m2);
+
+    const int shifts[] = {-70, -64, -3, -1, 0, 1, 5, 64, 65};
+    for (int dx : shifts) {
+        for (int dy = -3; dy <= 3; ++dy) {
+            EXPECT_EQ(referenceXOR(img, threshold1, threshold2, noise, dx, dy),
+                      XORimages(t1, m1, t2, m2, dx, dy))
+                << "dx = " << dx << ", dy = " << dy;
+        }
+    }
+}
+
+TEST(TestMTB, Alignment)
+{
+    const size_t size = 256;
+
+    std::vector<FramePtr> frames;
+    frames.push_back(std::make_shared<Frame>(size, size));
+    frames.push_back(std::make_shared<Frame>(size, size));
+    frames.push_back(std::make_shared<Frame>(size, size));
+
+    fillPattern(*frames[0], 0, 0);
+    fillPattern(*frames[1], -3, 2);
+    fillPattern(*frames[2], -5, -1);
+
+    mtb_alignment(frames);
 
+    // away from the borders the frames must be identical
+    const Channel *ref = frames[0]->getChannel("Y");
+    for (size_t f = 1; f < frames.size(); ++f) {
+        const Channel *aligned = frames[f]->getChannel("Y");
+        for (size_t r = 16; r < size - 16; ++r) {
+            for (size_t c = 16; c < size - 16; ++c) {
+                ASSERT_NEAR((*ref)(c, r), (*aligned)(c, r), 10e-5f)
+                    << "frame " << f << " at (" << c << ", " << r << ")";
+            }
+        }
+    }
 }
@@ -21,8 +21,13 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <cmath>
 #include <tuple>
+#include <vector>
 
+#include "Libpfs/progress.h"
+
+#include "TonemappingOperators/mantiuk06/contrast_domain.h"
 #include "TonemappingOperators/mantiuk06/pyramid.h"
 #include "mantiuk06/contrast_domain.h"
 
@@ -180,6 +185,31 @@ TEST_P(TestPyramidT, SumOfDivergence)
     compareVectors(samplesRef.data(), samplesTest.data(), size());
 }
 
+// levels from the second one: same as a pyramid of the size of the second level
+TEST_P(TestPyramidT, SumOfDivergenceLevel)
+{
+    populatePyramids();
+
+    pfs::Array2Df samplesRef( cols(), rows() );
+    newPyramid_.computeSumOfDivergence( samplesRef );
+    pfs::Array2Df samplesTest( cols(), rows() );
+    newPyramid_.computeSumOfDivergence( samplesTest, 0 );
+
+    compareVectors(samplesRef.data(), samplesTest.data(), size());
+
+    PyramidT::iterator second = newPyramid_.begin() + 1;
+    PyramidT coarser(second->getRows(), second->getCols());
+    ASSERT_EQ(newPyramid_.numLevels() - 1, coarser.numLevels());
+    std::copy(second, newPyramid_.end(), coarser.begin());
+
+    pfs::Array2Df coarseRef( second->getCols(), second->getRows() );
+    coarser.computeSumOfDivergence( coarseRef );
+    pfs::Array2Df coarseTest( second->getCols(), second->getRows() );
+    newPyramid_.computeSumOfDivergence( coarseTest, 1 );
+
+    compareVectors(coarseRef.data(), coarseTest.data(), coarseRef.size());
+}
+
 TEST_P(TestPyramidT, TranformToR)
 {
     populatePyramids();
@@ -375,3 +405,125 @@ INSTANTIATE_TEST_CASE_P(Mantiuk06,
                         Combine(Values(765, 320, 96),
                                 Values(521, 123))
                         );
+
+TEST_P(TestDualPyramidT, ScaledSumOfDivergence)
+{
+    pfs::Array2Df frame(cols(), rows());
+    std::generate(frame.begin(), frame.end(), RandZeroOne());
+
+    // reference
+    std::vector<float> samplesRef( size() );
+    test_mantiuk06::multiplyA(oldPyramid1_, oldPyramid2_,
+                              frame.data(), samplesRef.data());
+
+    // under test: the gradients of newPyramid2_ are the scaling factors
+    pfs::Array2Df samplesTest(cols(), rows());
+    newPyramid2_.computeScaledSumOfDivergence(frame, samplesTest);
+
+    compareVectors(samplesRef.data(), samplesTest.data(), size());
+
+    // same as multiplyA() on the levels from the second one
+    PyramidT::iterator second = newPyramid2_.begin() + 1;
+    PyramidT scale(second->getRows(), second->getCols());
+    std::copy(second, newPyramid2_.end(), scale.begin());
+    PyramidT gradients(second->getRows(), second->getCols());
+
+    pfs::Array2Df coarseFrame(second->getCols(), second->getRows());
+    std::generate(coarseFrame.begin(), coarseFrame.end(), RandZeroOne());
+
+    pfs::Array2Df coarseRef(second->getCols(), second->getRows());
+    multiplyA(gradients, scale, coarseFrame, coarseRef);
+    pfs::Array2Df coarseTest(second->getCols(), second->getRows());
+    newPyramid2_.computeScaledSumOfDivergence(coarseFrame, coarseTest, 1);
+
+    compareVectors(coarseRef.data(), coarseTest.data(), coarseRef.size());
+}
+
+namespace {
+void tonemap(const pfs::Array2Df& frame, float contrastFactor,
+             pfs::Array2Df& output, Mantiuk06WarmStart* warmStart = 0)
+{
+    // independent buffers: the operator writes its inputs in place
+    pfs::Array2Df R(frame.getCols(), frame.getRows());
+    std::copy(frame.begin(), frame.end(), R.begin());
+    pfs::Array2Df G(frame.getCols(), frame.getRows());
+    std::copy(frame.begin(), frame.end(), G.begin());
+    pfs::Array2Df B(frame.getCols(), frame.getRows());
+    std::copy(frame.begin(), frame.end(), B.begin());
+    pfs::Array2Df Y(frame.getCols(), frame.getRows());
+    std::copy(frame.begin(), frame.end(), Y.begin());
+    pfs::Progress ph;
+
+    tmo_mantiuk06_contmap(R, G, B, Y, contrastFactor, 0.8f, 1.0f,
+                          200, 5e-3f, ph, warmStart);
+    output = G;
+}
+}
+
+// the solver starts from the solution of the previous run on the same frame
+TEST(TestMantiuk06, WarmStart)
+{
+    pfs::Array2Df frame(320, 241);
+    for (size_t y = 0; y < frame.getRows(); ++y) {
+        for (size_t x = 0; x < frame.getCols(); ++x) {
+            frame(x, y) = (x < 160 ? 1000.f : 1.f) *
+                          (1.5f + std::sin(0.1f * x)) * (1.f + RandZeroOne()());
+        }
+    }
+    // same tone mapping, but the solver cannot start from the solution of
+    // frame (the log luminance of the two frames differs by a constant)
+    // deep copy: a buffer shared with frame would follow its writes
+    pfs::Array2Df reference(frame.getCols(), frame.getRows());
+    std::copy(frame.begin(), frame.end(), reference.begin());
+    pfs::Array2Df brighter(frame.getCols(), frame.getRows());
+    for (size_t idx = 0; idx < brighter.size(); ++idx) {
+        brighter(idx) = 2.f * reference(idx);
+        ASSERT_NE(frame(idx), brighter(idx));
+    }
+
+    Mantiuk06WarmStart warmStart;
+    pfs::Array2Df first, warm, cold, again;
+    tonemap(frame, 0.1f, first, &warmStart);
+    tonemap(frame, 0.2f, warm, &warmStart);
+    tonemap(brighter, 0.2f, cold, &warmStart);
+    tonemap(brighter, 0.2f, again, &warmStart);
+
+    // the inputs are left untouched
+    for (size_t idx = 0; idx < frame.size(); ++idx) {
+        ASSERT_EQ(reference(idx), frame(idx));
+        ASSERT_EQ(2.f * reference(idx), brighter(idx));
+    }
+
+    double error = 0.;
+    for (size_t idx = 0; idx < warm.size(); ++idx) {
+        EXPECT_NEAR(warm(idx), cold(idx), 0.1f);
+        error += std::fabs(warm(idx) - cold(idx));
+    }
+    EXPECT_LT(error / warm.size(), 5e-3);
+
+    // nothing left to solve: the previous solution
+    for (size_t idx = 0; idx < cold.size(); ++idx) {
+        ASSERT_EQ(cold(idx), again(idx));
+    }
+}
+
+// without a warm start, a run does not depend on the runs before it
+TEST(TestMantiuk06, NoWarmStart)
+{
+    pfs::Array2Df frame(160, 121);
+    for (size_t y = 0; y < frame.getRows(); ++y) {
+        for (size_t x = 0; x < frame.getCols(); ++x) {
+            frame(x, y) = (x < 80 ? 1000.f : 1.f) *
+                          (1.5f + std::sin(0.1f * x)) * (1.f + RandZeroOne()());
+        }
+    }
+
+    pfs::Array2Df before, other, after;
+    tonemap(frame, 0.2f, before);
+    tonemap(frame, 0.1f, other);
+    tonemap(frame, 0.2f, after);
+
+    for (size_t idx = 0; idx < before.size(); ++idx) {
+        ASSERT_EQ(before(idx), after(idx));
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <Libpfs/array2d.h>
+#include <Libpfs/progress.h>
+#include <Libpfs/utils/monotoneinverse.h>
+#include <TonemappingOperators/vanhateren06/tmo_vanhateren06.h>
+
+using namespace pfs::utils;
+
+namespace {
+struct Square {
+    double operator()(double x) const { return x * x; }
+    double derivative(double x) const { return 2.0 * x; }
+};
+
+//! \brief positive root of a * x^5 + x^4 = rhs, by bisection in long double:
+//! the reference of the table of tmo_vanhateren06
+long double coneRoot(long double rhs) {
+    const long double a_C = 9e-2f;
+    long double lo = 0.L;
+    long double hi = 16.L;
+    for (int i = 0; i < 200; ++i) {
+        const long double mid = 0.5L * (lo + hi);
+        if (mid * mid * mid * mid * (1.L + a_C * mid) < rhs) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return 0.5L * (lo + hi);
+}
+}
+
+TEST(TestMonotoneInverse, Sqrt) {
+    const MonotoneInverse<Square> inverse(Square(), 1e-6f, 1e6f);
+    // 40 octaves
+    EXPECT_GE(size_t(42 * MonotoneInverse<Square>::NODES_PER_OCTAVE),
+              inverse.tableSize());
+
+    std::vector<float> in;
+    for (float y = 1e-6f; y <= 1e6f; y *= 1.013f) {
+        in.push_back(y);
+    }
+    std::vector<float> out(in.size());
+    inverse(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); ++i) {
+        const double expected = std::sqrt(double(in[i]));
+        ASSERT_NEAR(expected, out[i], 1e-6 * expected) << in[i];
+    }
+
+    // out of range samples are clamped
+    EXPECT_FLOAT_EQ(1e-3f, inverse(0.f));
+    EXPECT_FLOAT_EQ(1e-3f, inverse(-5.f));
+    EXPECT_FLOAT_EQ(1e3f, inverse(std::numeric_limits<float>::infinity()));
+    const float nan = inverse(std::numeric_limits<float>::quiet_NaN());
+    EXPECT_TRUE(nan >= 1e-3f && nan <= 1e3f);
+}
+
+TEST(TestMonotoneInverse, VanHateren06) {
+    const float pupil_area = 10.f;
+    const float k_beta = 1.6e-4f;
+    const float C_beta = 2.8e-3f;
+
+    // from darkness to the sun, in cd/m^2
+    std::vector<float> luminance;
+    for (float l = 1e-5f; l < 1e6f; l *= 1.01f) {
+        luminance.push_back(l);
+    }
+    luminance.push_back(0.f);
+
+    pfs::Array2Df L(luminance.size(), 1);
+    std::copy(luminance.begin(), luminance.end(), L.begin());
+    pfs::Progress ph;
+    tmo_vanhateren06(L, pupil_area, ph);
+
+    const long double maxIos = coneRoot(1.L / C_beta);
+    for (size_t i = 0; i < luminance.size(); ++i) {
+        const float rhs =
+            1.0f / (C_beta + k_beta * (luminance[i] * pupil_area));
+        const double expected = double(1.L - coneRoot(rhs) / maxIos);
+        // the documented tolerance of the table
+        ASSERT_NEAR(expected, L(i), 1e-6) << luminance[i];
+    }
+}
@@ -0,0 +1,95 @@
+/**
+* This file is a part of LuminanceHDR package.
+* ----------------------------------------------------------------------
+* Copyright (C) 2026 agent
+*
+*  This program is free software; you can redistribute it and/or modify
+*  it under the terms of the GNU General Public License as published by
+*  the Free Software Foundation; either version 2 of the License, or
+*  (at your option) any later version.
+*
+*  This program is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program; if not, write to the Free Software
+*  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+* ----------------------------------------------------------------------
+*
+*/
+#include <gtest/gtest.h>
+#include <algorithm>
+
+#include "Libpfs/array2d.h"
+#include "Libpfs/frame.h"
+#include "Libpfs/manip/projection.h"
+
+#include "SeqInt.h"
+
+using namespace pfs;
+
+TEST(TestPfsProjection, FrameMatchesArray)
+{
+    const size_t cols = 64;
+    const size_t rows = 32;
+
+    Frame input(cols, rows);
+    Channel* r = input.createChannel("X");
+    Channel* g = input.createChannel("Y");
+    Channel* b = input.createChannel("Z");
+    std::generate(r->begin(), r->end(), SeqInt());
+    std::generate(g->begin(), g->end(), SeqInt());
+    std::transform(g->begin(), g->end(), g->begin(),
+                   [](float v) { return 3.f * v + 1.f; });
+    std::fill(b->begin(), b->end(), 0.5f);
+
+    TransformInfo info;
+    info.srcProjection = &PolarProjection::singleton;
+    info.dstProjection = &MirrorBallProjection::singleton;
+    info.oversampleFactor = 2;
+    info.xRotate = 15;
+    info.yRotate = -30;
+    info.zRotate = 45;
+
+    Frame output(32, 32);
+    transformFrame(input, output, info);
+    ASSERT_EQ(output.getChannels().size(), 3u);
+
+    const ChannelContainer& channels = input.getChannels();
+    for (ChannelContainer::const_iterator it = channels.begin();
+         it != channels.end(); ++it)
+    {
+        Array2Df reference(32, 32);
+        transformArray(*it, &reference, &info);
+
+        const Channel* out = output.getChannel((*it)->getName());
+        ASSERT_TRUE(out != NULL);
+        for (size_t idx = 0; idx < reference.size(); ++idx)
+        {
+            ASSERT_FLOAT_EQ(reference(idx), (*out)(idx));
+        }
+    }
+}
+
+TEST(TestPfsProjection, IdentityPolar)
+{
+    const size_t cols = 64;
+    const size_t rows = 32;
+
+    Array2Df input(cols, rows);
+    std::fill(input.begin(), input.end(), 2.f);
+
+    TransformInfo info;
+    info.srcProjection = &PolarProjection::singleton;
+    info.dstProjection = &PolarProjection::singleton;
+
+    Array2Df output(cols, rows);
+    transformArray(&input, &output, &info);
+
+    for (size_t idx = 0; idx < output.size(); ++idx)
+    {
+        ASSERT_NEAR(2.f, output(idx), 10e-5f);
+    }
+}
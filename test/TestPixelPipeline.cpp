@@ -0,0 +1,139 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include <Libpfs/colorspace/gamma.h>
+#include <Libpfs/frame.h>
+#include <Libpfs/frameview.h>
+#include <Libpfs/manip/cut.h>
+#include <Libpfs/manip/gamma.h>
+#include <Libpfs/manip/pixelpipeline.h>
+#include <Libpfs/utils/chain.h>
+
+using namespace pfs;
+
+namespace {
+
+void fillFrame(Frame &frame) {
+    Channel *Ch[3];
+    frame.createXYZChannels(Ch[0], Ch[1], Ch[2]);
+    Channel *alpha = frame.createChannel("ALPHA");
+    for (size_t y = 0; y < frame.getHeight(); ++y) {
+        for (size_t x = 0; x < frame.getWidth(); ++x) {
+            for (int c = 0; c < 3; ++c) {
+                // with some negative samples
+                (*Ch[c])(x, y) = 0.05f * (c + 1) * x - 0.1f * y + 0.5f;
+            }
+            (*alpha)(x, y) = 0.5f * x;
+        }
+    }
+    frame.getTags().setTag("LUMINANCE", "RELATIVE");
+}
+
+void expectSameChannels(const Frame &expected, const Frame &actual) {
+    ASSERT_EQ(expected.getWidth(), actual.getWidth());
+    ASSERT_EQ(expected.getHeight(), actual.getHeight());
+    ASSERT_EQ(expected.getChannels().size(), actual.getChannels().size());
+
+    const ChannelContainer &channels = expected.getChannels();
+    for (ChannelContainer::const_iterator it = channels.begin();
+         it != channels.end(); ++it) {
+        const Channel *ch = actual.getChannel((*it)->getName());
+        ASSERT_TRUE(ch != NULL) << (*it)->getName();
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_FLOAT_EQ((**it)(i), (*ch)(i)) << (*it)->getName() << i;
+        }
+    }
+}
+}
+
+TEST(TestPixelPipeline, CutAndGamma) {
+    Frame frame(23, 17);
+    fillFrame(frame);
+
+    FrameView view(frame, 3, 2, 20, 15);
+    std::unique_ptr<Frame> fused(
+        transformRGB(view, colorspace::ChangeGamma(2.2f)));
+
+    std::unique_ptr<Frame> reference(cut(view));
+    applyGamma(reference.get(), 2.2f);
+
+    expectSameChannels(*reference, *fused);
+    EXPECT_EQ("RELATIVE", fused->getTags().getTag("LUMINANCE"));
+    // the source is not modified
+    EXPECT_FLOAT_EQ(0.5f, (*frame.getChannel("X"))(0, 0));
+}
+
+TEST(TestPixelPipeline, FullFrame) {
+    Frame frame(31, 9);
+    fillFrame(frame);
+
+    std::unique_ptr<Frame> fused(
+        transformRGB(FrameView(frame), colorspace::ChangeGamma(1.8f)));
+
+    // one channel at a time
+    Frame reference(frame);
+    Channel *X, *Y, *Z;
+    reference.getXYZChannels(X, Y, Z);
+    applyGamma(X, 1.f / 1.8f);
+    applyGamma(Y, 1.f / 1.8f);
+    applyGamma(Z, 1.f / 1.8f);
+
+    expectSameChannels(reference, *fused);
+}
+
+TEST(TestPixelPipeline, Chain) {
+    Frame frame(16, 16);
+    fillFrame(frame);
+
+    Frame fused(frame);
+    transformRGB(fused, utils::chain(colorspace::ChangeGamma(2.f),
+                                     colorspace::ChangeGamma(0.8f)));
+
+    Frame reference(frame);
+    applyGamma(&reference, 2.f);
+    applyGamma(&reference, 0.8f);
+
+    expectSameChannels(reference, fused);
+}
+
+TEST(TestPixelPipeline, BlockForm) {
+    typedef utils::Chain<colorspace::ChangeGamma, colorspace::ChangeGamma>
+        GammaChain;
+    EXPECT_TRUE(detail::HasBlockForm<colorspace::ChangeGamma>::value);
+    EXPECT_FALSE(detail::HasBlockForm<GammaChain>::value);
+
+    // the copy of a view and the in place pass run the same kernel
+    Frame frame(40000, 2);
+    fillFrame(frame);
+
+    Frame blocks(frame);
+    transformRGB(blocks, colorspace::ChangeGamma(2.2f));
+
+    std::unique_ptr<Frame> pixels(
+        transformRGB(FrameView(frame), colorspace::ChangeGamma(2.2f)));
+
+    expectSameChannels(*pixels, blocks);
+}
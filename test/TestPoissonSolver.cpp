@@ -22,9 +22,11 @@
 #include <gtest/gtest.h>
 
 #include <Libpfs/array2d.h>
+#include <Libpfs/progress.h>
 #include <TonemappingOperators/fattal02/pde.h>
 #include <HdrWizard/AutoAntighosting.h>
 
+#include <algorithm>
 #include <cmath>
 
 TEST(solve_pde_dct, Test1)
@@ -43,8 +45,108 @@ TEST(solve_pde_dct, Test1)
     }
 
     solve_pde_dct(divergence, U);
-    float residual = residual_pde(&U, &divergence);
+    float residual = residual_pde(U, divergence);
 
     ASSERT_LE(residual, 1e-2);
 }
 
+
+namespace {
+//! \brief right hand side of \a U for the pde of solve_pde_fft(): the 5
+//! point Laplacian, with the frame mirrored around its first and last
+//! samples
+void laplacian(const pfs::Array2Df &U, pfs::Array2Df &F) {
+    const int w = U.getCols();
+    const int h = U.getRows();
+    auto mirror = [](int i, int n) {
+        return i < 0 ? -i : (i >= n ? 2 * (n - 1) - i : i);
+    };
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            F(x, y) = U(mirror(x - 1, w), y) + U(mirror(x + 1, w), y) +
+                      U(x, mirror(y - 1, h)) + U(x, mirror(y + 1, h)) -
+                      4.f * U(x, y);
+        }
+    }
+}
+
+//! \brief fill \a exact with a smooth solution
+void exactSolution(pfs::Array2Df &exact) {
+    for (size_t y = 0; y < exact.getRows(); ++y) {
+        for (size_t x = 0; x < exact.getCols(); ++x) {
+            exact(x, y) = std::sin(0.013f * x) * std::cos(0.021f * y) +
+                          0.3f * std::sin(0.2f * x + 0.1f * y);
+        }
+    }
+}
+
+//! \brief largest difference between \a U and \a exact (up to a constant)
+float solutionError(const pfs::Array2Df &U, const pfs::Array2Df &exact) {
+    double offset = 0.;
+    float maxU = U(0);
+    for (size_t i = 0; i < U.size(); ++i) {
+        offset += U(i) - exact(i);
+        maxU = std::max(maxU, U(i));
+    }
+    offset /= U.size();
+    // the solution is shifted to a maximum of 0, as in solve_pde_fft()
+    EXPECT_EQ(0.f, maxU);
+
+    float error = 0.f;
+    for (size_t i = 0; i < U.size(); ++i) {
+        error = std::max(error, std::fabs(float(U(i) - exact(i) - offset)));
+    }
+    return error;
+}
+
+//! \brief largest difference between \a U and the exact solution of
+//! solve_pde_redblack() on a \a w x \a h frame (up to a constant)
+float redBlackError(int w, int h, MultigridCycle cycle) {
+    pfs::Array2Df exact(w, h);
+    exactSolution(exact);
+    pfs::Array2Df F(w, h);
+    laplacian(exact, F);
+
+    pfs::Array2Df U(w, h);
+    pfs::Progress ph;
+    const int cycles = solve_pde_redblack(F, U, ph, cycle);
+    EXPECT_LT(cycles, 30);
+    return solutionError(U, exact);
+}
+
+//! \brief the same for solve_pde_fft(), the plans of which are cached
+float fftError(int w, int h) {
+    pfs::Array2Df exact(w, h);
+    exactSolution(exact);
+    pfs::Array2Df F(w, h);
+    laplacian(exact, F);
+
+    pfs::Array2Df U(w, h);
+    pfs::Array2Df F_tr(w, h);
+    pfs::Progress ph;
+    solve_pde_fft(F, U, F_tr, ph, true);
+    return solutionError(U, exact);
+}
+}
+
+TEST(solve_pde_redblack, Sizes) {
+    // odd, even and elongated frames coarsen differently
+    EXPECT_LT(redBlackError(129, 97, MULTIGRID_F_CYCLE), 2e-3f);
+    EXPECT_LT(redBlackError(128, 64, MULTIGRID_F_CYCLE), 2e-3f);
+    EXPECT_LT(redBlackError(600, 40, MULTIGRID_F_CYCLE), 2e-3f);
+    EXPECT_LT(redBlackError(3, 2, MULTIGRID_F_CYCLE), 2e-3f);
+}
+
+TEST(solve_pde_redblack, Cycles) {
+    EXPECT_LT(redBlackError(200, 150, MULTIGRID_V_CYCLE), 2e-3f);
+    EXPECT_LT(redBlackError(200, 150, MULTIGRID_W_CYCLE), 2e-3f);
+    EXPECT_LT(redBlackError(200, 150, MULTIGRID_F_CYCLE), 2e-3f);
+}
+
+TEST(solve_pde_fft, Sizes) {
+    EXPECT_LT(fftError(129, 97), 2e-3f);
+    EXPECT_LT(fftError(128, 64), 2e-3f);
+    EXPECT_LT(fftError(600, 40), 2e-3f);
+    // planned once, executed on new arrays
+    EXPECT_LT(fftError(128, 64), 2e-3f);
+}
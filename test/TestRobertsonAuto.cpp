@@ -0,0 +1,144 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <HdrCreation/robertson02.h>
+#include <Libpfs/frame.h>
+
+using namespace pfs;
+using namespace libhdr::fusion;
+
+namespace {
+
+const size_t W = 512;
+const size_t H = 384;
+
+//! \brief smooth scene with some texture
+float radiance(size_t x, size_t y, size_t c) {
+    return 0.005f * std::pow(200.f, float(x) / W) *
+           (1.f + 0.3f * std::sin(0.05f * y + c)) *
+           (((x / 16 + y / 16) % 2) ? 1.f : 0.8f);
+}
+
+FramePtr buildRadiance() {
+    FramePtr frame(new Frame(W, H));
+    Channel *Ch[3];
+    frame->createXYZChannels(Ch[0], Ch[1], Ch[2]);
+    for (size_t c = 0; c < 3; ++c) {
+        for (size_t y = 0; y < H; ++y) {
+            for (size_t x = 0; x < W; ++x) {
+                (*Ch[c])(x, y) = radiance(x, y, c);
+            }
+        }
+    }
+    return frame;
+}
+
+//! \brief exposures of the scene taken by an 8 bits camera with a 2.2 gamma
+//! response
+std::vector<FrameEnhanced> buildExposures() {
+    const float times[] = {0.125f, 0.5f, 2.f, 8.f};
+
+    std::vector<FrameEnhanced> images;
+    for (size_t i = 0; i < 4; ++i) {
+        FramePtr frame(new Frame(W, H));
+        Channel *Ch[3];
+        frame->createXYZChannels(Ch[0], Ch[1], Ch[2]);
+        for (size_t c = 0; c < 3; ++c) {
+            for (size_t y = 0; y < H; ++y) {
+                for (size_t x = 0; x < W; ++x) {
+                    const float v = std::min(radiance(x, y, c) * times[i], 1.f);
+                    (*Ch[c])(x, y) =
+                        std::floor(std::pow(v, 1.f / 2.2f) * 255.f) / 255.f;
+                }
+            }
+        }
+        images.push_back(FrameEnhanced(frame, times[i]));
+    }
+    return images;
+}
+
+//! \brief mean relative difference between \a actual and \a expected, once
+//! \a actual is scaled to \a expected (the response is calibrated up to a
+//! scale factor)
+double meanRelativeError(const Frame &expected, const Frame &actual) {
+    const Channel *e[3];
+    expected.getXYZChannels(e[0], e[1], e[2]);
+    const Channel *a[3];
+    actual.getXYZChannels(a[0], a[1], a[2]);
+
+    std::vector<float> ratios;
+    for (int c = 0; c < 3; ++c) {
+        for (size_t k = 0; k < W * H; ++k) {
+            ratios.push_back((*a[c])(k) / (*e[c])(k));
+        }
+    }
+    std::nth_element(ratios.begin(), ratios.begin() + ratios.size() / 2,
+                     ratios.end());
+    const double scale = ratios[ratios.size() / 2];
+
+    double error = 0.0;
+    for (int c = 0; c < 3; ++c) {
+        for (size_t k = 0; k < W * H; ++k) {
+            error += std::fabs((*a[c])(k) / scale - (*e[c])(k)) / (*e[c])(k);
+        }
+    }
+    return error / (3 * W * H);
+}
+
+Frame *calibrateAndMerge(size_t calibrationSamples,
+                         const std::vector<FrameEnhanced> &images) {
+    RobertsonOperatorAuto robertson(calibrationSamples);
+    ResponseCurve response(RESPONSE_LINEAR);
+    WeightFunction weight(WEIGHT_TRIANGULAR);
+    return static_cast<IFusionOperator &>(robertson).computeFusion(
+        response, weight, images);
+}
+
+//! \brief the calibration on \a calibrationSamples pixels must be about as
+//! accurate as the calibration on the whole image
+void compareCalibration(size_t calibrationSamples, double tolerance) {
+    FramePtr truth = buildRadiance();
+    std::vector<FrameEnhanced> images = buildExposures();
+
+    std::unique_ptr<Frame> full(calibrateAndMerge(0, images));
+    std::unique_ptr<Frame> sampled(
+        calibrateAndMerge(calibrationSamples, images));
+
+    ASSERT_EQ(W, sampled->getWidth());
+    ASSERT_EQ(H, sampled->getHeight());
+    EXPECT_LT(meanRelativeError(*truth, *sampled),
+              meanRelativeError(*truth, *full) + tolerance);
+}
+}
+
+TEST(TestRobertsonAuto, DefaultSamples) {
+    compareCalibration(RobertsonOperatorAuto::DEFAULT_CALIBRATION_SAMPLES,
+                       0.01);
+}
+
+TEST(TestRobertsonAuto, FewSamples) { compareCalibration(4096, 0.02); }
@@ -0,0 +1,146 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <HdrCreation/streamingfusion.h>
+#include <Libpfs/frame.h>
+#include <Libpfs/manip/copy.h>
+
+using namespace pfs;
+using namespace libhdr::fusion;
+
+namespace {
+
+//! \brief reader serving a frame held in memory, through the default
+//! (fully decoded) band interface
+class MemoryReader : public pfs::io::FrameReader {
+   public:
+    explicit MemoryReader(const FramePtr &frame)
+        : pfs::io::FrameReader("memory"), m_frame(frame), m_reads(0) {
+        open();
+    }
+
+    void open() {
+        setWidth(m_frame->getWidth());
+        setHeight(m_frame->getHeight());
+    }
+    bool isOpen() const { return true; }
+    void close() {}
+    void read(Frame &frame, const Params &) {
+        std::unique_ptr<Frame> temp(pfs::copy(m_frame.get()));
+        frame.swap(*temp);
+        ++m_reads;
+    }
+
+    //! \brief number of calls to read()
+    int reads() const { return m_reads; }
+
+   private:
+    FramePtr m_frame;
+    int m_reads;
+};
+
+std::vector<FrameEnhanced> buildExposures(size_t W, size_t H) {
+    const float times[] = {0.25f, 1.f, 4.f};
+
+    std::vector<FrameEnhanced> images;
+    for (size_t i = 0; i < 3; ++i) {
+        FramePtr frame(new Frame(W, H));
+        Channel *Ch[3];
+        frame->createXYZChannels(Ch[0], Ch[1], Ch[2]);
+        for (size_t c = 0; c < 3; ++c) {
+            for (size_t k = 0; k < W * H; ++k) {
+                const float radiance =
+                    0.02f + float((k * 7 + c * 13) % 97) / 97.f;
+                (*Ch[c])(k) = std::min(radiance * times[i], 1.f);
+            }
+        }
+        images.push_back(FrameEnhanced(frame, times[i]));
+    }
+    return images;
+}
+
+void compareFusion(FusionOperator type) {
+    const size_t W = 37;
+    const size_t H = 23;
+    std::vector<FrameEnhanced> images = buildExposures(W, H);
+
+    ResponseCurve response(RESPONSE_GAMMA);
+    WeightFunction weight(WEIGHT_TRIANGULAR);
+    std::unique_ptr<Frame> reference(
+        IFusionOperator::build(type)->computeFusion(response, weight,
+                                                    images));
+
+    std::vector<StreamingExposure> exposures;
+    for (size_t i = 0; i < images.size(); ++i) {
+        exposures.push_back(StreamingExposure(
+            std::make_shared<MemoryReader>(images[i].frame()),
+            images[i].averageLuminance()));
+    }
+    StreamingFusionParams params;
+    params.bandHeight = 5;  // last band is partial
+
+    ResponseCurve streamingResponse(RESPONSE_GAMMA);
+    Frame streamed;
+    streamingFusion(type, streamingResponse, weight, exposures, streamed,
+                    params);
+
+    ASSERT_EQ(W, streamed.getWidth());
+    ASSERT_EQ(H, streamed.getHeight());
+
+    const Channel *ref[3];
+    reference->getXYZChannels(ref[0], ref[1], ref[2]);
+    const Channel *out[3];
+    streamed.getXYZChannels(out[0], out[1], out[2]);
+    for (int c = 0; c < 3; ++c) {
+        for (size_t k = 0; k < W * H; ++k) {
+            ASSERT_FLOAT_EQ((*ref[c])(k), (*out[c])(k))
+                << "channel " << c << " pixel " << k;
+        }
+    }
+}
+}
+
+TEST(TestStreamingFusion, Debevec) { compareFusion(DEBEVEC); }
+
+TEST(TestStreamingFusion, Robertson) { compareFusion(ROBERTSON); }
+
+TEST(TestStreamingFusion, DefaultBands) {
+    std::vector<FrameEnhanced> images = buildExposures(37, 23);
+    MemoryReader reader(images[0].frame());
+    EXPECT_FALSE(reader.streamsBands());
+
+    // the decoded image is released with its last band, and decoded again
+    // by the next pass
+    Frame band;
+    reader.openBands(Params());
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t y0 = 0; y0 < 23; y0 += 5) {
+            reader.readBand(band, y0, std::min<size_t>(5, 23 - y0), Params());
+        }
+    }
+    EXPECT_EQ(2, reader.reads());
+}
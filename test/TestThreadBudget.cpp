@@ -0,0 +1,94 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <Libpfs/utils/threadbudget.h>
+
+using namespace pfs::utils;
+
+TEST(TestThreadBudget, Leases) {
+    ThreadBudget budget(8);
+    EXPECT_EQ(8u, budget.size());
+    EXPECT_EQ(4u, budget.share(2));
+    EXPECT_EQ(1u, budget.share(16));
+
+    {
+        ThreadLease first(3, budget);
+        EXPECT_EQ(3u, first.count());
+        EXPECT_EQ(5u, budget.available());
+        // from another thread: gets what is left
+        std::thread([&budget] {
+            ThreadLease second(0, budget);
+            EXPECT_EQ(5u, second.count());
+            EXPECT_EQ(0u, budget.available());
+            // the budget is exhausted: the job runs on its own thread
+            std::thread([&budget] {
+                ThreadLease third(4, budget);
+                EXPECT_EQ(1u, third.count());
+            }).join();
+        }).join();
+        EXPECT_EQ(5u, budget.available());
+    }
+    EXPECT_EQ(8u, budget.available());
+
+    ThreadBudget all;
+    EXPECT_EQ(ThreadBudget::hardwareThreads(), all.size());
+}
+
+TEST(TestThreadBudget, Nested) {
+    ThreadBudget budget(6);
+    ThreadLease outer(4, budget);
+    EXPECT_EQ(4u, ThreadLease::current());
+    {
+        // carved out of the outer lease
+        ThreadLease inner(8, budget);
+        EXPECT_EQ(4u, inner.count());
+        EXPECT_EQ(2u, budget.available());
+
+        ThreadLease single(1, budget);
+        EXPECT_EQ(1u, ThreadLease::current());
+    }
+    EXPECT_EQ(4u, ThreadLease::current());
+    EXPECT_EQ(2u, budget.available());
+}
+
+#ifdef _OPENMP
+TEST(TestThreadBudget, OpenMPTeam) {
+    ThreadBudget budget(2);
+    std::thread([&budget] {
+        ThreadLease lease(0, budget);
+        int team = 0;
+#pragma omp parallel
+        {
+#pragma omp single
+            team = omp_get_num_threads();
+        }
+        EXPECT_EQ(2, team);
+    }).join();
+}
+#endif
@@ -0,0 +1,98 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include <Libpfs/utils/trace.h>
+
+using namespace pfs::utils;
+
+namespace {
+std::string readFile(const std::string &filename) {
+    std::ifstream file(filename.c_str());
+    return std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+}
+
+size_t count(const std::string &text, const std::string &pattern) {
+    size_t n = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos;
+         pos = text.find(pattern, pos + 1)) {
+        ++n;
+    }
+    return n;
+}
+}
+
+TEST(TestTrace, Disabled) {
+    Trace trace;
+    EXPECT_FALSE(trace.isEnabled());
+    // nothing to write to
+    TraceScope scope("disabled", "test", trace);
+    scope.setBytes(10);
+}
+
+TEST(TestTrace, Events) {
+    const std::string filename = "TestTrace.json";
+    Trace trace;
+    ASSERT_TRUE(trace.start(filename));
+    EXPECT_TRUE(trace.isEnabled());
+    {
+        TraceScope outer("outer", "test", trace);
+        outer.setBytes(1024);
+        outer.setDetail("C:\\images\\\"hdr\".exr");
+        {
+            TraceScope inner("inner", "test", trace);
+        }
+        std::thread([&trace] { TraceScope other("other", "test", trace); })
+            .join();
+    }
+    trace.stop();
+    EXPECT_FALSE(trace.isEnabled());
+
+    const std::string json = readFile(filename);
+    std::remove(filename.c_str());
+
+    ASSERT_EQ('[', json[0]);
+    EXPECT_EQ("\n]\n", json.substr(json.size() - 3));
+    EXPECT_EQ(3u, count(json, "\"ph\":\"X\""));
+    EXPECT_EQ(3u, count(json, "\"ph\":\"C\""));
+    // the inner scope completes first
+    EXPECT_LT(json.find("\"inner\""), json.find("\"outer\""));
+    EXPECT_NE(std::string::npos, json.find("\"bytes\":1024"));
+    EXPECT_NE(std::string::npos,
+              json.find("\"detail\":\"C:\\\\images\\\\\\\"hdr\\\".exr\""));
+    // two threads
+    const std::string tid = "\"tid\":" + std::to_string(Trace::threadId());
+    EXPECT_EQ(2u, count(json, tid + ","));
+}
+
+TEST(TestTrace, PeakMemory) {
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+    EXPECT_GT(Trace::peakMemory(), 0u);
+#endif
+}
@@ -0,0 +1,166 @@
+/*
+ * This file is a part of Luminance HDR package.
+ * ----------------------------------------------------------------------
+ * Copyright (C) 2026 agent
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * ----------------------------------------------------------------------
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <Libpfs/utils/cpufeatures.h>
+#include <Libpfs/utils/vecmath.h>
+
+using namespace pfs::utils;
+
+namespace {
+// not a multiple of any vector width, to run the remainders as well
+const size_t SIZE = 1003;
+
+//! \brief run \a test at every level supported by the CPU
+template <typename Test>
+void forEachSimdLevel(Test test) {
+    const SimdLevel initial = simdLevel();
+    for (int level = SIMD_NONE; level <= detectedSimdLevel(); ++level) {
+        setSimdLevel(SimdLevel(level));
+        SCOPED_TRACE(simdLevelName(simdLevel()));
+        test();
+    }
+    setSimdLevel(initial);
+}
+
+std::vector<float> ramp(float from, float to) {
+    std::vector<float> v(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        v[i] = from + (to - from) * i / (SIZE - 1);
+    }
+    return v;
+}
+}
+
+TEST(TestVecMath, SimdLevel) {
+    const SimdLevel detected = detectedSimdLevel();
+    setSimdLevel(SIMD_NONE);
+    EXPECT_EQ(SIMD_NONE, simdLevel());
+    // never above what the CPU supports
+    setSimdLevel(SIMD_AVX512);
+    EXPECT_EQ(detected, simdLevel());
+    EXPECT_STREQ("avx2", simdLevelName(SIMD_AVX2));
+}
+
+TEST(TestVecMath, Exp) {
+    const std::vector<float> in = ramp(-80.f, 80.f);
+    forEachSimdLevel([&] {
+        std::vector<float> out(SIZE);
+        vexp(in.data(), out.data(), SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            const double expected = std::exp(double(in[i]));
+            ASSERT_NEAR(expected, out[i], 1e-5 * expected) << in[i];
+        }
+    });
+}
+
+TEST(TestVecMath, Log) {
+    std::vector<float> in = ramp(1e-3f, 1e3f);
+    // tiny and huge samples
+    in[0] = 1e-30f;
+    in[1] = 3e38f;
+    forEachSimdLevel([&] {
+        std::vector<float> out(SIZE);
+        vlog(in.data(), out.data(), SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            const float expected = std::log(in[i]);
+            ASSERT_NEAR(expected, out[i],
+                        1e-6f * std::max(1.f, std::fabs(expected)))
+                << in[i];
+        }
+    });
+}
+
+TEST(TestVecMath, Pow) {
+    const std::vector<float> in = ramp(-1.f, 10.f);
+    forEachSimdLevel([&] {
+        // in place
+        std::vector<float> out(in);
+        vpow(out.data(), out.data(), SIZE, 1.f / 2.2f, 0.5f);
+        for (size_t i = 0; i < SIZE; ++i) {
+            const float expected =
+                in[i] > 0.f ? std::pow(in[i] * 0.5f, 1.f / 2.2f) : 0.f;
+            ASSERT_NEAR(expected, out[i], 2e-6f * std::max(1.f, expected))
+                << in[i];
+        }
+    });
+}
+
+TEST(TestVecMath, LogAccumulate) {
+    const std::vector<float> in = ramp(0.01f, 1.f);
+    const std::vector<float> weight = ramp(0.f, 2.f);
+    const std::vector<float> wsum = ramp(1.f, 3.f);
+    forEachSimdLevel([&] {
+        std::vector<float> acc(SIZE, 1.f);
+        vlogAccumulate(in.data(), weight.data(), 0.5f, acc.data(), SIZE);
+        std::vector<float> result(SIZE);
+        vexpDiv(acc.data(), wsum.data(), result.data(), SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            const float a = 1.f + (std::log(in[i]) + 0.5f) * weight[i];
+            ASSERT_NEAR(a, acc[i], 1e-5f * std::max(1.f, std::fabs(a)));
+            const float expected = std::exp(a / wsum[i]);
+            ASSERT_NEAR(expected, result[i], 1e-5f * expected);
+        }
+    });
+}
+
+TEST(TestVecMath, Matrix3) {
+    const float matrix[3][3] = {
+        {0.4124564f, 0.3575761f, 0.1804375f},
+        {0.2126729f, 0.7151522f, 0.0721750f},
+        {0.0193339f, 0.1191920f, 0.9503041f}};
+    const std::vector<float> r = ramp(0.f, 1.f);
+    const std::vector<float> g = ramp(1.f, 0.f);
+    const std::vector<float> b = ramp(-1.f, 2.f);
+    forEachSimdLevel([&] {
+        // in place
+        std::vector<float> x(r), y(g), z(b);
+        vmatrix3(matrix, x.data(), y.data(), z.data(), x.data(), y.data(),
+                 z.data(), SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            const float in[3] = {r[i], g[i], b[i]};
+            const float *out[3] = {x.data(), y.data(), z.data()};
+            for (int c = 0; c < 3; ++c) {
+                ASSERT_NEAR(matrix[c][0] * in[0] + matrix[c][1] * in[1] +
+                                matrix[c][2] * in[2],
+                            out[c][i], 1e-6f);
+            }
+        }
+    });
+}
+
+TEST(TestVecMath, MinMax) {
+    std::vector<float> in = ramp(-3.f, 5.f);
+    std::swap(in[0], in[SIZE / 2]);
+    std::swap(in[SIZE - 1], in[SIZE / 3]);
+    forEachSimdLevel([&] {
+        float minValue = 0.f;
+        float maxValue = 0.f;
+        vminmax(in.data(), SIZE, minValue, maxValue);
+        EXPECT_EQ(-3.f, minValue);
+        EXPECT_EQ(5.f, maxValue);
+    });
+}